@@ -10,8 +10,10 @@
 #include <c++utilities/io/bitreader.h>
 #include <c++utilities/misc/memory.h>
 
+#include <array>
 #include <istream>
 #include <limits>
+#include <utility>
 
 using namespace std;
 using namespace IoUtilities;
@@ -943,13 +945,89 @@ byte AacFrameElementParser::parseDynamicRange()
     return size;
 }
 
+/// \brief The number of bits looked up at once when decoding Huffman codes.
+constexpr byte huffmanLookupBits = 8;
+
+/*!
+ * \brief The HuffmanLookupEntry struct is an entry of a table to decode Huffman codes by looking up multiple bits at once.
+ *
+ * The table is indexed by the next huffmanLookupBits bits. Each entry denotes the node of the Huffman tree reached after
+ * consuming the first \a bits of these bits. It is a leaf unless the code is longer than huffmanLookupBits.
+ */
+struct HuffmanLookupEntry {
+    int16 node;
+    byte bits;
+    bool isLeaf;
+};
+
+using HuffmanLookupTable = array<HuffmanLookupEntry, 1 << huffmanLookupBits>;
+
+/*!
+ * \brief Makes a lookup table for the Huffman tree with the specified \a root.
+ * \remarks The tree is described by \a isLeaf (whether a node is a leaf) and \a next (the node reached from a node via a bit).
+ */
+template <typename IsLeaf, typename Next> static HuffmanLookupTable makeHuffmanLookupTable(int16 root, IsLeaf isLeaf, Next next)
+{
+    HuffmanLookupTable table;
+    for (size_t code = 0; code != table.size(); ++code) {
+        HuffmanLookupEntry &entry = table[code];
+        entry.node = root;
+        entry.bits = 0;
+        while (!(entry.isLeaf = isLeaf(entry.node)) && entry.bits < huffmanLookupBits) {
+            entry.node = next(entry.node, static_cast<byte>((code >> (huffmanLookupBits - 1 - entry.bits)) & 0x1u));
+            ++entry.bits;
+        }
+    }
+    return table;
+}
+
+/*!
+ * \brief Decodes the next Huffman code read via \a reader using the specified lookup \a table.
+ * \returns Returns the leaf of the Huffman tree.
+ * \remarks Codes longer than huffmanLookupBits and codes at the end of the data are decoded bit by bit.
+ */
+template <typename IsLeaf, typename Next>
+static int16 decodeHuffmanCode(BitReader &reader, const HuffmanLookupTable &table, int16 root, IsLeaf isLeaf, Next next)
+{
+    int16 node = root;
+    if (reader.bitsAvailable() >= huffmanLookupBits) {
+        const HuffmanLookupEntry &entry = table[reader.showBits<byte>(huffmanLookupBits)];
+        reader.skipBits(entry.bits);
+        if (entry.isLeaf) {
+            return entry.node;
+        }
+        node = entry.node;
+    }
+    while (!isLeaf(node)) {
+        node = next(node, reader.readBit());
+    }
+    return node;
+}
+
 int16 AacFrameElementParser::sbrHuffmanDec(SbrHuffTab table)
 {
-    byte bit;
+    // leafs are denoted by negative indices
+    static const auto isLeaf = [](int16 index) { return index < 0; };
+    static const array<pair<SbrHuffTab, HuffmanLookupTable>, 10> lookupTables = [] {
+        array<pair<SbrHuffTab, HuffmanLookupTable>, 10> lookupTables;
+        const SbrHuffTab tables[] = { tHuffmanEnv15dB, fHuffmanEnv15dB, tHuffmanEnvBal15dB, fHuffmanEnvBal15dB, tHuffmanEnv30dB,
+            fHuffmanEnv30dB, tHuffmanEnvBal30dB, fHuffmanEnvBal30dB, tHuffmanNoise30dB, tHuffmanNoiseBal30dB };
+        for (size_t i = 0; i != lookupTables.size(); ++i) {
+            const SbrHuffTab table = tables[i];
+            lookupTables[i].first = table;
+            lookupTables[i].second = makeHuffmanLookupTable(0, isLeaf, [table](int16 index, byte bit) -> int16 { return table[index][bit]; });
+        }
+        return lookupTables;
+    }();
+    const auto next = [table](int16 index, byte bit) -> int16 { return table[index][bit]; };
+    for (const auto &lookupTable : lookupTables) {
+        if (lookupTable.first == table) {
+            return decodeHuffmanCode(m_reader, lookupTable.second, 0, isLeaf, next) + 64;
+        }
+    }
     int16 index = 0;
-    while (index >= 0) {
-        bit = m_reader.readBit();
-        index = table[index][bit];
+    while (!isLeaf(index)) {
+        index = next(index, m_reader.readBit());
     }
     return index + 64;
 }
@@ -1371,14 +1449,15 @@ void AacFrameElementParser::parseSbrExtensionData(byte sbrElement, uint16 count,
 
 byte AacFrameElementParser::parseHuffmanScaleFactor()
 {
-    uint16 offset = 0;
-    while (aacHcbSf[offset][1]) {
-        offset += aacHcbSf[offset][m_reader.readBit()];
-        if (offset > 240) {
+    static const auto isLeaf = [](int16 offset) { return !aacHcbSf[offset][1]; };
+    static const auto next = [](int16 offset, byte bit) -> int16 {
+        if ((offset += aacHcbSf[offset][bit]) > 240) {
             throw InvalidDataException();
         }
-    }
-    return aacHcbSf[offset][0];
+        return offset;
+    };
+    static const HuffmanLookupTable lookupTable = makeHuffmanLookupTable(0, isLeaf, next);
+    return aacHcbSf[decodeHuffmanCode(m_reader, lookupTable, 0, isLeaf, next)][0];
 }
 
 void AacFrameElementParser::parseHuffmanSpectralData(byte cb, int16 *sp)
@@ -1391,11 +1470,11 @@ void AacFrameElementParser::parseHuffmanSpectralData(byte cb, int16 *sp)
     case 3: // binary search for data quadruples
         huffmanBinaryQuadSign(cb, sp);
         break;
-    case 4: // binary search for data paris
-        huffmanBinaryPair(cb, sp);
+    case 4: // 2-step method for data quadruples
+        huffman2StepQuadSign(cb, sp);
         break;
-    case 5: // 2-step method for data pairs
-        huffman2StepPair(cb, sp);
+    case 5: // binary search for data pairs
+        huffmanBinaryPair(cb, sp);
         break;
     case 6: // 2-step method for data pairs
         huffman2StepPair(cb, sp);
@@ -1495,7 +1574,7 @@ void AacFrameElementParser::huffman2StepQuad(byte cb, int16 *sp)
     sp[3] = aacHcb2QuadTable[cb][offset].w;
 }
 
-void AacFrameElementParser::huffmanBinaryQuadSign(byte cb, int16 *sp)
+void AacFrameElementParser::huffman2StepQuadSign(byte cb, int16 *sp)
 {
     try {
         huffman2StepQuad(cb, sp);
@@ -1506,12 +1585,54 @@ void AacFrameElementParser::huffmanBinaryQuadSign(byte cb, int16 *sp)
     huffmanSignBits(sp, 4);
 }
 
+void AacFrameElementParser::huffmanBinaryQuad(byte cb, int16 *sp)
+{
+    // only codebook 3 uses a binary tree for data quadruples
+    static const auto isLeaf = [](int16 offset) { return offset > aacHcbBinTableSize[3] || aacHcb3[offset].isLeaf; };
+    static const auto next = [](int16 offset, byte bit) -> int16 { return offset + aacHcb3[offset].data[bit]; };
+    static const HuffmanLookupTable lookupTable = makeHuffmanLookupTable(0, isLeaf, next);
+    if (cb != 3) {
+        throw InvalidDataException();
+    }
+    const int16 offset = decodeHuffmanCode(m_reader, lookupTable, 0, isLeaf, next);
+    if (offset > aacHcbBinTableSize[cb]) {
+        throw InvalidDataException();
+    }
+    sp[0] = aacHcb3[offset].data[0];
+    sp[1] = aacHcb3[offset].data[1];
+    sp[2] = aacHcb3[offset].data[2];
+    sp[3] = aacHcb3[offset].data[3];
+}
+
+void AacFrameElementParser::huffmanBinaryQuadSign(byte cb, int16 *sp)
+{
+    try {
+        huffmanBinaryQuad(cb, sp);
+    } catch (const InvalidDataException &) {
+        huffmanSignBits(sp, 4);
+        throw;
+    }
+    huffmanSignBits(sp, 4);
+}
+
 void AacFrameElementParser::huffmanBinaryPair(byte cb, int16 *sp)
 {
-    uint16 offset = 0;
-    while (!aacHcbBinTable[cb][offset].isLeaf) {
-        offset += aacHcbBinTable[cb][offset].data[m_reader.readBit()];
+    // codebooks 5, 7 and 9 use binary trees for data pairs
+    static const array<HuffmanLookupTable, 10> lookupTables = [] {
+        array<HuffmanLookupTable, 10> lookupTables;
+        for (const byte cb : { 5, 7, 9 }) {
+            lookupTables[cb] = makeHuffmanLookupTable(0,
+                [cb](int16 offset) { return offset > aacHcbBinTableSize[cb] || aacHcbBinTable[cb][offset].isLeaf; },
+                [cb](int16 offset, byte bit) -> int16 { return offset + aacHcbBinTable[cb][offset].data[bit]; });
+        }
+        return lookupTables;
+    }();
+    if (cb >= lookupTables.size() || !aacHcbBinTable[cb]) {
+        throw InvalidDataException();
     }
+    const int16 offset = decodeHuffmanCode(m_reader, lookupTables[cb], 0,
+        [cb](int16 offset) { return offset > aacHcbBinTableSize[cb] || aacHcbBinTable[cb][offset].isLeaf; },
+        [cb](int16 offset, byte bit) -> int16 { return offset + aacHcbBinTable[cb][offset].data[bit]; });
     if (offset > aacHcbBinTableSize[cb]) {
         throw InvalidDataException();
     }
@@ -1731,6 +1852,7 @@ void AacFrameElementParser::parseSingleChannelElement()
     }
     // check wheter next bitstream element is a fill element (for SBR decoding)
     if (m_reader.showBits<byte>(3) == AacSyntaxElementTypes::FillElement) {
+        m_reader.skipBits(3); // skip element type
         parseFillElement(m_elementCount);
     }
     // TODO: reconstruct single channel element
@@ -1785,6 +1907,7 @@ void AacFrameElementParser::parseChannelPairElement()
     parseIndividualChannelStream(m_ics2, specData2);
     // check if next bitstream element is a fill element (for SBR decoding)
     if (m_reader.showBits<byte>(3) == AacSyntaxElementTypes::FillElement) {
+        m_reader.skipBits(3); // skip element type
         parseFillElement(m_elementCount);
     }
     // TODO: reconstruct channel pair
@@ -1968,17 +2091,30 @@ void AacFrameElementParser::parseFillElement(byte sbrElement)
             if (sbrElement == aacInvalidSbrElement) {
                 throw InvalidDataException();
             } else {
-                // ensure SBR element exists
-                if (!m_sbrElements[sbrElement]) {
-                    m_sbrElements[sbrElement] = makeSbrInfo(sbrElement);
-                }
-                parseSbrExtensionData(sbrElement, count, crcFlag);
-                // set global flags
+                // the presence of SBR data is sufficient to detect SBR
                 m_sbrPresentFlag = 1;
-                if (m_sbrElements[sbrElement]->ps) {
-                    m_psUsed[sbrElement] = 1;
-                    m_psUsedGlobal = 1;
+                const auto payloadBits = static_cast<size_t>(8 * count - 4);
+                const auto bitsAvailable = m_reader.bitsAvailable();
+                try {
+                    // ensure SBR element exists
+                    if (!m_sbrElements[sbrElement]) {
+                        m_sbrElements[sbrElement] = makeSbrInfo(sbrElement);
+                    }
+                    parseSbrExtensionData(sbrElement, count, crcFlag);
+                    // set global flags
+                    if (m_sbrElements[sbrElement]->ps) {
+                        m_psUsed[sbrElement] = 1;
+                        m_psUsedGlobal = 1;
+                    }
+                } catch (const NotImplementedException &) {
+                    // parsing SBR data is not complete yet
                 }
+                // skip the SBR data which has not been parsed
+                const auto parsedBits = bitsAvailable - m_reader.bitsAvailable();
+                if (parsedBits > payloadBits) {
+                    throw InvalidDataException();
+                }
+                m_reader.skipBits(payloadBits - parsedBits);
             }
             count = 0;
             break;
@@ -2108,9 +2244,20 @@ void AacFrameElementParser::parse(const AdtsFrame &adtsFrame, std::istream &stre
  */
 void AacFrameElementParser::parse(const AdtsFrame &adtsFrame, std::unique_ptr<char[]> &data, std::size_t dataSize)
 {
-    m_reader.reset(data.get(), dataSize);
     m_mpeg4AudioObjectId = adtsFrame.mpeg4AudioObjectId();
     m_mpeg4SamplingFrequencyIndex = adtsFrame.mpeg4SamplingFrequencyIndex();
+    parse(data.get(), dataSize);
+}
+
+/*!
+ * \brief Parses the specified raw data block (eg. a sample of an MP4 track) using the setup information specified when
+ *        constructing the parser.
+ * \remarks Information about SBR and PS is kept across raw data blocks. See isSbrPresent() and isPsPresent().
+ */
+void AacFrameElementParser::parse(const char *data, std::size_t dataSize)
+{
+    m_reader.reset(data, dataSize);
+    m_channelCount = m_elementCount = 0;
     parseRawDataBlock();
 }
 
@@ -26,6 +26,8 @@ constexpr auto aacSbrRate = 2;
 constexpr auto aacSbrM = 49;
 constexpr auto aacSbrMaxLe = 5;
 constexpr auto aacSbrMaxNtsrhfg = 40;
+constexpr auto aacSbrProbingBlockCount = 8;
+constexpr auto aacSbrProbingByteBudget = 0x2000;
 
 typedef const sbyte (*SbrHuffTab)[2];
 
@@ -398,6 +400,9 @@ public:
 
     void parse(const AdtsFrame &adtsFrame, std::unique_ptr<char[]> &data, std::size_t dataSize);
     void parse(const AdtsFrame &adtsFrame, std::istream &stream, std::size_t dataSize);
+    void parse(const char *data, std::size_t dataSize);
+    bool isSbrPresent() const;
+    bool isPsPresent() const;
 
 private:
     void parseLtpInfo(const AacIcsInfo &ics, AacLtpInfo &ltp);
@@ -432,6 +437,8 @@ private:
     void parseHuffmanSpectralData(byte cb, int16 *sp);
     void huffmanSignBits(int16 *sp, byte len);
     void huffman2StepQuad(byte cb, int16 *sp);
+    void huffman2StepQuadSign(byte cb, int16 *sp);
+    void huffmanBinaryQuad(byte cb, int16 *sp);
     void huffmanBinaryQuadSign(byte cb, int16 *sp);
     void huffmanBinaryPair(byte cb, int16 *sp);
     void huffman2StepPair(byte cb, int16 *sp);
@@ -515,6 +522,22 @@ inline AacFrameElementParser::AacFrameElementParser(
 {
 }
 
+/*!
+ * \brief Returns whether SBR data has been found in any of the raw data blocks parsed so far.
+ */
+inline bool AacFrameElementParser::isSbrPresent() const
+{
+    return m_sbrPresentFlag;
+}
+
+/*!
+ * \brief Returns whether PS data has been found in any of the raw data blocks parsed so far.
+ */
+inline bool AacFrameElementParser::isPsPresent() const
+{
+    return m_psUsedGlobal;
+}
+
 inline sbyte AacFrameElementParser::sbrLog2(const sbyte val)
 {
     static const int log2tab[] = { 0, 0, 1, 2, 2, 3, 3, 3, 3, 4 };
@@ -6,6 +6,7 @@
 #include <c++utilities/io/catchiofailure.h>
 #include <c++utilities/io/copy.h>
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -69,17 +70,47 @@ void StreamDataBlock::makeBuffer() const
 
 /*!
  * \brief Copies the data to the specified \a stream.
- * \remarks Makes use of the buffer allocated with makeBuffer() if this method has been called before.
+ * \remarks
+ * - Makes use of the buffer allocated with makeBuffer() if this method has been called before.
+ * - Otherwise the data is copied in chunks directly from the associated stream so it is never held in memory
+ *   as a whole.
+ * - The specified \a stream might be the associated stream itself (eg. when a file is modified in-place). In this case
+ *   the data is moved within the stream to the current write position. The data is copied in an order which keeps
+ *   overlapping source and target ranges intact.
  */
 void StreamDataBlock::copyTo(ostream &stream) const
 {
     if (buffer()) {
         stream.write(buffer().get(), size());
-    } else {
-        CopyHelper<0x2000> copyHelper;
-        m_stream().seekg(startOffset());
-        copyHelper.copy(m_stream(), stream, size());
+        return;
     }
+    istream &inputStream = m_stream();
+    if (inputStream.rdbuf() != stream.rdbuf()) {
+        CopyHelper<0x10000> copyHelper;
+        inputStream.seekg(startOffset());
+        copyHelper.copy(inputStream, stream, static_cast<uint64>(size()));
+        return;
+    }
+
+    // input and output share the same buffer and hence the same position: seek explicitly for each chunk
+    const auto targetOffset = static_cast<uint64>(stream.tellp());
+    const auto sourceOffset = static_cast<uint64>(startOffset());
+    const auto totalSize = static_cast<uint64>(size());
+    if (targetOffset != sourceOffset) {
+        CopyHelper<0x10000> copyHelper;
+        char *const buffer = copyHelper.buffer();
+        const bool backwards = targetOffset > sourceOffset;
+        for (uint64 remaining = totalSize; remaining;) {
+            const auto chunkSize = min<uint64>(remaining, 0x10000);
+            remaining -= chunkSize;
+            const auto chunkOffset = backwards ? remaining : (totalSize - remaining - chunkSize);
+            inputStream.seekg(static_cast<istream::off_type>(sourceOffset + chunkOffset));
+            inputStream.read(buffer, static_cast<streamsize>(chunkSize));
+            stream.seekp(static_cast<ostream::off_type>(targetOffset + chunkOffset));
+            stream.write(buffer, static_cast<streamsize>(chunkSize));
+        }
+    }
+    stream.seekp(static_cast<ostream::off_type>(targetOffset + totalSize));
 }
 
 /*!
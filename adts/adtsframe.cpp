@@ -2,10 +2,12 @@
 
 #include "../exceptions.h"
 
+#include <c++utilities/conversion/binaryconversion.h>
 #include <c++utilities/io/binaryreader.h>
 
 using namespace std;
 using namespace IoUtilities;
+using namespace ConversionUtilities;
 
 namespace TagParser {
 
@@ -33,4 +35,17 @@ void AdtsFrame::parseHeader(IoUtilities::BinaryReader &reader)
     }
 }
 
+/*!
+ * \brief Parses the header from the specified \a buffer.
+ *
+ * The \a buffer must contain at least 7 bytes. In contrast to the overload reading from a BinaryReader, the CRC-16
+ * checksum is not read and no exception is thrown. Use isValid() to check whether the header is valid. This is meant
+ * to walk through all frames of a stream which has been read into a buffer.
+ */
+void AdtsFrame::parseHeader(const char *buffer)
+{
+    m_header1 = BE::toUInt16(buffer);
+    m_header2 = (static_cast<uint64>(BE::toUInt32(buffer + 2)) << 24 | static_cast<uint64>(static_cast<byte>(buffer[6])) << 16);
+}
+
 } // namespace TagParser
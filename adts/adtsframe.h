@@ -16,6 +16,7 @@ public:
     AdtsFrame();
 
     void parseHeader(IoUtilities::BinaryReader &reader);
+    void parseHeader(const char *buffer);
 
     bool isValid() const;
     bool isMpeg4() const;
@@ -29,6 +30,7 @@ public:
     uint16 bufferFullness() const;
     byte frameCount() const;
     uint16 crc() const;
+    bool isCompatible(const AdtsFrame &other) const;
 
 private:
     uint16 m_header1;
@@ -40,6 +42,7 @@ private:
  */
 inline AdtsFrame::AdtsFrame()
     : m_header1(0)
+    , m_header2(0)
 {
 }
 
@@ -145,6 +148,18 @@ inline uint16 AdtsFrame::crc() const
     return m_header2 & 0xFFFFu;
 }
 
+/*!
+ * \brief Returns whether \a other belongs to the same stream as the current frame.
+ *
+ * That is the case if the MPEG version, the audio object type, the sampling frequency and the channel
+ * configuration are equal.
+ */
+inline bool AdtsFrame::isCompatible(const AdtsFrame &other) const
+{
+    return ((m_header1 & 0xFFF8u) == (other.m_header1 & 0xFFF8u)) && ((m_header2 & 0xFC000000000000u) == (other.m_header2 & 0xFC000000000000u))
+        && mpeg4ChannelConfig() == other.mpeg4ChannelConfig();
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_ADTSFRAME_H
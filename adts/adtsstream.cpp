@@ -1,15 +1,28 @@
 #include "./adtsstream.h"
 
+#include "../aac/aacframe.h"
+
 #include "../mp4/mp4ids.h"
 
+#include "../bufferedsyncscanner.h"
 #include "../exceptions.h"
 
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/io/catchiofailure.h>
+
+#include <algorithm>
 #include <string>
 
 using namespace std;
+using namespace IoUtilities;
+using namespace ConversionUtilities;
+using namespace ChronoUtilities;
 
 namespace TagParser {
 
+/// \brief The number of samples per raw data block (ADTS does not allow signaling the 960 samples variant).
+constexpr uint64 samplesPerRawDataBlock = 1024;
+
 /*!
  * \class TagParser::AdtsStream
  * \brief Implementation of TagParser::AbstractTrack for ADTS streams.
@@ -17,9 +30,6 @@ namespace TagParser {
 
 void AdtsStream::internalParseHeader(Diagnostics &diag)
 {
-    VAR_UNUSED(diag)
-
-    //static const string context("parsing ADTS frame header");
     if (!m_istream) {
         throw NoDataFoundException();
     }
@@ -37,6 +47,141 @@ void AdtsStream::internalParseHeader(Diagnostics &diag)
     m_channelCount = Mpeg4ChannelConfigs::channelCount(m_channelConfig = m_firstFrame.mpeg4ChannelConfig());
     byte sampleRateIndex = m_firstFrame.mpeg4SamplingFrequencyIndex();
     m_samplingFrequency = sampleRateIndex < sizeof(mpeg4SamplingFrequencyTable) ? mpeg4SamplingFrequencyTable[sampleRateIndex] : 0;
+    // walk through the frames to determine duration and bitrate which are not stored anywhere
+    walkFrames(diag);
+    // check for implicitly signaled SBR/PS
+    probeSbr(diag);
+}
+
+/*!
+ * \brief Parses the first raw data blocks to detect implicitly signaled SBR and PS (HE-AAC).
+ *
+ * ADTS can not signal SBR explicitly. Hence the sampling frequency of HE-AAC streams would be reported as half of the
+ * actual output sampling frequency. At most aacSbrProbingBlockCount blocks and aacSbrProbingByteBudget bytes are parsed.
+ */
+void AdtsStream::probeSbr(Diagnostics &diag)
+{
+    static const string context("probing ADTS stream for SBR");
+    if (m_firstFrame.mpeg4AudioObjectId() != Mpeg4AudioObjectIds::AacLc) {
+        return;
+    }
+    // pass an invalid extension sampling frequency index so SBR is assumed to run at twice the sampling frequency
+    AacFrameElementParser parser(m_firstFrame.mpeg4AudioObjectId(), m_firstFrame.mpeg4SamplingFrequencyIndex(), 0xFF, m_channelConfig);
+    try {
+        AdtsFrame frame;
+        uint64 offset = m_startOffset, remainingBytes = aacSbrProbingByteBudget;
+        for (auto blockCount = 0; blockCount != aacSbrProbingBlockCount && !parser.isSbrPresent(); ++blockCount) {
+            m_istream->seekg(static_cast<streamoff>(offset));
+            frame.parseHeader(m_reader);
+            // skip frames with multiple raw data blocks (those would require parsing the position of each block)
+            if (!frame.isCompatible(m_firstFrame) || frame.totalSize() > remainingBytes || offset + frame.totalSize() > m_startOffset + m_size) {
+                break;
+            }
+            if (frame.frameCount() == 1) {
+                parser.parse(frame, *m_istream, frame.dataSize());
+            }
+            remainingBytes -= frame.totalSize();
+            offset += frame.totalSize();
+        }
+    } catch (const Failure &) {
+        diag.emplace_back(DiagLevel::Information, "Unable to parse raw data block; SBR/PS might not be detected.", context);
+    } catch (...) {
+        catchIoFailure();
+        m_istream->clear();
+        diag.emplace_back(DiagLevel::Information, "Raw data block is truncated; SBR/PS might not be detected.", context);
+    }
+    if (parser.isSbrPresent()) {
+        m_format = Mpeg4AudioObjectIds::idToMediaFormat(m_firstFrame.mpeg4AudioObjectId(), true, parser.isPsPresent());
+        m_extensionSamplingFrequency = m_samplingFrequency * 2;
+        if (parser.isPsPresent()) {
+            m_extensionChannelConfig = Mpeg4ChannelConfigs::FrontLeftFrontRight;
+        }
+    }
+}
+
+/*!
+ * \brief Returns the absolute offset of the frame to start decoding at for seeking to the specified \a time.
+ * \remarks Performs a binary search within seekIndex(). Returns startOffset() if no seek index has been recorded.
+ */
+uint64 AdtsStream::seekOffset(TimeSpan time) const
+{
+    const auto seekPoint = upper_bound(m_seekIndex.cbegin(), m_seekIndex.cend(), time,
+        [](TimeSpan time, const SeekPoint &seekPoint) { return time < seekPoint.time; });
+    return seekPoint == m_seekIndex.cbegin() ? m_startOffset : (seekPoint - 1)->offset;
+}
+
+/*!
+ * \brief Hops from frame to frame using the frame length of each header to determine the exact sample count,
+ *        duration, average bitrate and maximum bitrate.
+ *
+ * The stream is read sequentially in large chunks up to the end of the stream (which excludes an ID3v1 tag). If a
+ * header is invalid, the next sync word is searched and the subsequent header must be valid as well.
+ */
+void AdtsStream::walkFrames(Diagnostics &diag)
+{
+    static const string context("walking through ADTS frames");
+    m_seekIndex.clear();
+    if (!m_samplingFrequency) {
+        diag.emplace_back(DiagLevel::Warning, "The sampling frequency is unknown; unable to determine the duration.", context);
+        return;
+    }
+    const uint64 endOffset = m_startOffset + m_size;
+    BufferedSyncScanner scanner(*m_istream, endOffset);
+
+    const uint64 samplesPerSeekPoint = m_samplingFrequency;
+    uint64 offset = m_startOffset, sampleCount = 0, dataSize = 0, skippedSize = 0, nextSeekPoint = 0;
+    uint32 maxFrameBitrate = 0;
+    bool synchronized = false;
+    AdtsFrame frame, nextFrame;
+    for (const char *bytes; (bytes = scanner.bytesAt(offset, 7));) {
+        frame.parseHeader(bytes);
+        bool valid = frame.isValid() && frame.isCompatible(m_firstFrame);
+        if (valid && !synchronized && offset + frame.totalSize() < endOffset) {
+            const char *const nextBytes = scanner.bytesAt(offset + frame.totalSize(), 7);
+            if (nextBytes) {
+                nextFrame.parseHeader(nextBytes);
+            }
+            valid = nextBytes && nextFrame.isValid() && nextFrame.isCompatible(m_firstFrame);
+        }
+        if (!valid) {
+            const uint64 syncOffset = scanner.findSync(offset + 1, 0xF6, 0xF0, 7);
+            skippedSize += syncOffset - offset;
+            offset = syncOffset;
+            synchronized = false;
+            continue;
+        }
+        if (offset + frame.totalSize() > endOffset) {
+            diag.emplace_back(DiagLevel::Warning, argsToString("The last frame at ", offset, " is truncated and will be ignored."), context);
+            skippedSize += endOffset - offset;
+            break;
+        }
+        synchronized = true;
+
+        if (m_recordingSeekIndex && sampleCount >= nextSeekPoint) {
+            m_seekIndex.emplace_back(SeekPoint{ TimeSpan::fromSeconds(static_cast<double>(sampleCount) / m_samplingFrequency), offset });
+            nextSeekPoint += samplesPerSeekPoint;
+        }
+        const uint64 frameSampleCount = samplesPerRawDataBlock * frame.frameCount();
+        sampleCount += frameSampleCount;
+        dataSize += frame.totalSize();
+        maxFrameBitrate = max(maxFrameBitrate, static_cast<uint32>(static_cast<uint64>(frame.totalSize()) * 8u * m_samplingFrequency / frameSampleCount));
+        offset += frame.totalSize();
+    }
+
+    if (skippedSize) {
+        diag.emplace_back(DiagLevel::Warning, argsToString(skippedSize, " bytes between the frames could not be assigned to a valid frame."), context);
+    }
+    if (!sampleCount) {
+        diag.emplace_back(DiagLevel::Warning, "No valid frames found; unable to determine the duration.", context);
+        return;
+    }
+    const double seconds = static_cast<double>(sampleCount) / m_samplingFrequency;
+    m_sampleCount = sampleCount;
+    m_duration = TimeSpan::fromSeconds(seconds);
+    m_bitrate = static_cast<double>(dataSize) * 8.0 / seconds / 1000.0;
+    m_maxBitrate = maxFrameBitrate / 1000.0;
+    m_bytesPerSecond = static_cast<uint32>(static_cast<double>(dataSize) / seconds);
+    m_seekIndex.shrink_to_fit();
 }
 
 } // namespace TagParser
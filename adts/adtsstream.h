@@ -4,6 +4,9 @@
 #include "./adtsframe.h"
 
 #include "../abstracttrack.h"
+#include "../seekpoint.h"
+
+#include <vector>
 
 namespace TagParser {
 
@@ -13,12 +16,21 @@ public:
     ~AdtsStream() override;
 
     TrackType type() const override;
+    bool isRecordingSeekIndex() const;
+    void setRecordingSeekIndex(bool recordingSeekIndex);
+    const std::vector<SeekPoint> &seekIndex() const;
+    uint64 seekOffset(ChronoUtilities::TimeSpan time) const;
 
 protected:
     void internalParseHeader(Diagnostics &diag) override;
 
 private:
+    void walkFrames(Diagnostics &diag);
+    void probeSbr(Diagnostics &diag);
+
     AdtsFrame m_firstFrame;
+    std::vector<SeekPoint> m_seekIndex;
+    bool m_recordingSeekIndex;
 };
 
 /*!
@@ -26,6 +38,7 @@ private:
  */
 inline AdtsStream::AdtsStream(std::iostream &stream, uint64 startOffset)
     : AbstractTrack(stream, startOffset)
+    , m_recordingSeekIndex(false)
 {
     m_mediaType = MediaType::Audio;
 }
@@ -39,6 +52,37 @@ inline TrackType AdtsStream::type() const
     return TrackType::AdtsStream;
 }
 
+/*!
+ * \brief Returns whether a seek index is recorded when parsing the header.
+ * \sa setRecordingSeekIndex()
+ */
+inline bool AdtsStream::isRecordingSeekIndex() const
+{
+    return m_recordingSeekIndex;
+}
+
+/*!
+ * \brief Sets whether a seek index is recorded when parsing the header.
+ *
+ * The seek index contains the offset of the frame starting at roughly every second. It is returned by seekIndex()
+ * and used by seekOffset().
+ *
+ * \remarks Must be set before parseHeader() is called to take effect.
+ */
+inline void AdtsStream::setRecordingSeekIndex(bool recordingSeekIndex)
+{
+    m_recordingSeekIndex = recordingSeekIndex;
+}
+
+/*!
+ * \brief Returns the seek index sorted by time (and offset).
+ * \remarks Only populated if recording the seek index has been enabled. See setRecordingSeekIndex().
+ */
+inline const std::vector<SeekPoint> &AdtsStream::seekIndex() const
+{
+    return m_seekIndex;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_ADTSSTREAM_H
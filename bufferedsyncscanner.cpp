@@ -0,0 +1,83 @@
+#include "./bufferedsyncscanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+
+using namespace std;
+
+namespace TagParser {
+
+/*!
+ * \class TagParser::BufferedSyncScanner
+ * \brief The BufferedSyncScanner class reads a stream sequentially in large chunks to hop from frame to frame and to
+ *        search for sync codes.
+ *
+ * It is internally used to walk through the frames of raw audio streams (eg. MPEG audio, ADTS and FLAC) where the
+ * frame headers are located by a sync code consisting of 0xFF followed by a byte with a format specific bit pattern.
+ */
+
+/*!
+ * \brief Constructs a new scanner for the specified \a stream which reads at most up to the specified \a endOffset.
+ */
+BufferedSyncScanner::BufferedSyncScanner(istream &stream, uint64 endOffset, uint64 bufferSize)
+    : m_stream(stream)
+    , m_buffer(make_unique<char[]>(bufferSize))
+    , m_bufferSize(bufferSize)
+    , m_endOffset(endOffset)
+    , m_bufferOffset(0)
+    , m_bufferEndOffset(0)
+{
+}
+
+/*!
+ * \brief Returns a pointer to the specified number of bytes at the specified \a offset.
+ * \returns Returns nullptr if less than \a count bytes are available before endOffset().
+ * \remarks
+ * - Reads the next chunk if the bytes are not buffered yet. Hence the returned pointer is only valid until the next call.
+ * - The \a count must not exceed the buffer size.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+const char *BufferedSyncScanner::bytesAt(uint64 offset, uint64 count)
+{
+    if (offset + count > m_endOffset) {
+        return nullptr;
+    }
+    if (offset < m_bufferOffset || offset + count > m_bufferEndOffset) {
+        const uint64 bytesToRead = min(m_bufferSize, m_endOffset - offset);
+        m_stream.seekg(static_cast<streamoff>(offset));
+        m_stream.read(m_buffer.get(), static_cast<streamsize>(bytesToRead));
+        m_bufferOffset = offset;
+        m_bufferEndOffset = offset + bytesToRead;
+    }
+    return m_buffer.get() + (offset - m_bufferOffset);
+}
+
+/*!
+ * \brief Returns the offset of the next sync code at or after the specified \a offset.
+ *
+ * A sync code is 0xFF followed by a byte which equals \a secondByteValue after applying \a secondByteMask. The buffered
+ * data is searched using memchr() which is vectorized by the C library.
+ *
+ * \returns Returns endOffset() if there is no further sync code with at least \a minSize bytes (including the sync code)
+ *          available before endOffset().
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+uint64 BufferedSyncScanner::findSync(uint64 offset, byte secondByteMask, byte secondByteValue, uint64 minSize)
+{
+    minSize = max<uint64>(minSize, 2);
+    for (const char *begin; (begin = bytesAt(offset, minSize));) {
+        const char *const end = m_buffer.get() + (m_bufferEndOffset - m_bufferOffset) - 1;
+        for (const char *i = begin; i < end && (i = static_cast<const char *>(memchr(i, 0xFF, static_cast<size_t>(end - i)))); ++i) {
+            if ((static_cast<byte>(i[1]) & secondByteMask) == secondByteValue) {
+                const uint64 syncOffset = offset + static_cast<uint64>(i - begin);
+                return syncOffset + minSize <= m_endOffset ? syncOffset : m_endOffset;
+            }
+        }
+        // the last byte of the chunk might be the first byte of a sync code
+        offset = m_bufferEndOffset - 1;
+    }
+    return m_endOffset;
+}
+
+} // namespace TagParser
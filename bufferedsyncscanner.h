@@ -0,0 +1,43 @@
+#ifndef TAG_PARSER_BUFFEREDSYNCSCANNER_H
+#define TAG_PARSER_BUFFEREDSYNCSCANNER_H
+
+#include "./global.h"
+
+#include <c++utilities/conversion/types.h>
+
+#include <iosfwd>
+#include <memory>
+
+namespace TagParser {
+
+class TAG_PARSER_EXPORT BufferedSyncScanner {
+public:
+    /// \brief The default size of the buffer used to read the stream.
+    static constexpr uint64 defaultBufferSize = 0x100000;
+
+    BufferedSyncScanner(std::istream &stream, uint64 endOffset, uint64 bufferSize = defaultBufferSize);
+
+    uint64 endOffset() const;
+    const char *bytesAt(uint64 offset, uint64 count);
+    uint64 findSync(uint64 offset, byte secondByteMask, byte secondByteValue, uint64 minSize);
+
+private:
+    std::istream &m_stream;
+    std::unique_ptr<char[]> m_buffer;
+    uint64 m_bufferSize;
+    uint64 m_endOffset;
+    uint64 m_bufferOffset;
+    uint64 m_bufferEndOffset;
+};
+
+/*!
+ * \brief Returns the offset up to which the stream is read.
+ */
+inline uint64 BufferedSyncScanner::endOffset() const
+{
+    return m_endOffset;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_BUFFEREDSYNCSCANNER_H
@@ -14,6 +14,9 @@ namespace TagParser {
  * \brief The Diagnostics class is a container for DiagMessage.
  * \remarks A lot of methods in this library take such a container as argument. The method will add additional
  *          information, warnings or errors to it.
+ * \remarks The underlying std::vector is not exposed so messages can only be added via emplace_back(), emplaceFormatted(),
+ *          push_back(), insert() and append() which filter them according to minimumLevel(). The messages are only
+ *          accessible for reading and removal.
  */
 
 /*!
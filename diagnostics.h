@@ -4,8 +4,11 @@
 #include "./global.h"
 
 #include <c++utilities/chrono/datetime.h>
+#include <c++utilities/conversion/stringbuilder.h>
 
+#include <initializer_list>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TagParser {
@@ -44,6 +47,7 @@ public:
     DiagMessage(DiagLevel level, std::string &&message, const std::string &context);
     DiagMessage(DiagLevel level, const std::string &message, std::string &&context);
     DiagMessage(DiagLevel level, std::string &&message, std::string &&context);
+    DiagMessage(DiagLevel level, std::string &&message, std::string &&context, const ChronoUtilities::DateTime &creationTime);
 
     DiagLevel level() const;
     const char *levelName() const;
@@ -77,7 +81,7 @@ inline DiagMessage::DiagMessage(DiagLevel level, const std::string &message, con
  */
 inline DiagMessage::DiagMessage(DiagLevel level, std::string &&message, const std::string &context)
     : m_level(level)
-    , m_message(message)
+    , m_message(std::move(message))
     , m_context(context)
     , m_creationTime(ChronoUtilities::DateTime::gmtNow())
 {
@@ -89,7 +93,7 @@ inline DiagMessage::DiagMessage(DiagLevel level, std::string &&message, const st
 inline DiagMessage::DiagMessage(DiagLevel level, const std::string &message, std::string &&context)
     : m_level(level)
     , m_message(message)
-    , m_context(context)
+    , m_context(std::move(context))
     , m_creationTime(ChronoUtilities::DateTime::gmtNow())
 {
 }
@@ -99,12 +103,23 @@ inline DiagMessage::DiagMessage(DiagLevel level, const std::string &message, std
  */
 inline DiagMessage::DiagMessage(DiagLevel level, std::string &&message, std::string &&context)
     : m_level(level)
-    , m_message(message)
-    , m_context(context)
+    , m_message(std::move(message))
+    , m_context(std::move(context))
     , m_creationTime(ChronoUtilities::DateTime::gmtNow())
 {
 }
 
+/*!
+ * \brief Constructs a new DiagMessage with the specified \a creationTime.
+ */
+inline DiagMessage::DiagMessage(DiagLevel level, std::string &&message, std::string &&context, const ChronoUtilities::DateTime &creationTime)
+    : m_level(level)
+    , m_message(std::move(message))
+    , m_context(std::move(context))
+    , m_creationTime(creationTime)
+{
+}
+
 /*!
  * \brief Returns the level.
  */
@@ -139,6 +154,8 @@ inline const std::string &DiagMessage::context() const
 
 /*!
  * \brief Returns the creation time (using GMT timezone).
+ * \remarks Returns a null DateTime if the message has been added to Diagnostics not recording the creation time.
+ * \sa Diagnostics::isRecordingCreationTime()
  */
 inline const ChronoUtilities::DateTime &DiagMessage::creationTime() const
 {
@@ -153,21 +170,399 @@ inline bool DiagMessage::operator==(const DiagMessage &other) const
     return m_level == other.m_level && m_message == other.m_message && m_context == other.m_context;
 }
 
-class TAG_PARSER_EXPORT Diagnostics : public std::vector<DiagMessage> {
+class TAG_PARSER_EXPORT Diagnostics : private std::vector<DiagMessage> {
 public:
-    Diagnostics() = default;
+    using value_type = DiagMessage;
+    using size_type = std::vector<DiagMessage>::size_type;
+    using difference_type = std::vector<DiagMessage>::difference_type;
+    using const_reference = std::vector<DiagMessage>::const_reference;
+    using reference = const_reference;
+    using const_iterator = std::vector<DiagMessage>::const_iterator;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::vector<DiagMessage>::const_reverse_iterator;
+    using reverse_iterator = const_reverse_iterator;
+
+    Diagnostics();
     Diagnostics(std::initializer_list<DiagMessage> list);
 
+    const_iterator begin() const;
+    const_iterator end() const;
+    using std::vector<DiagMessage>::cbegin;
+    using std::vector<DiagMessage>::cend;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+    using std::vector<DiagMessage>::crbegin;
+    using std::vector<DiagMessage>::crend;
+    using std::vector<DiagMessage>::size;
+    using std::vector<DiagMessage>::empty;
+    using std::vector<DiagMessage>::capacity;
+    using std::vector<DiagMessage>::reserve;
+    using std::vector<DiagMessage>::clear;
+    const_reference front() const;
+    const_reference back() const;
+    const_reference at(size_type index) const;
+    const_reference operator[](size_type index) const;
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+    bool operator==(const Diagnostics &other) const;
+    bool operator!=(const Diagnostics &other) const;
+
+    template <typename MessageType, typename ContextType> void emplace_back(DiagLevel level, MessageType &&message, ContextType &&context);
+    template <typename ContextType, typename... MessageParts>
+    void emplaceFormatted(DiagLevel level, ContextType &&context, MessageParts &&... messageParts);
+    void push_back(const DiagMessage &message);
+    void push_back(DiagMessage &&message);
+    iterator insert(const_iterator position, const DiagMessage &message);
+    iterator insert(const_iterator position, DiagMessage &&message);
+    iterator insert(const_iterator position, size_type count, const DiagMessage &message);
+    template <typename InputIterator> iterator insert(const_iterator position, InputIterator first, InputIterator last);
+    iterator insert(const_iterator position, std::initializer_list<DiagMessage> messages);
+    void append(const Diagnostics &other);
+    void append(Diagnostics &&other);
+    bool isRecording(DiagLevel level) const;
+    DiagLevel minimumLevel() const;
+    void setMinimumLevel(DiagLevel minimumLevel);
+    bool isRecordingCreationTime() const;
+    void setRecordingCreationTime(bool recordingCreationTime);
+    void adoptSettings(const Diagnostics &other);
     bool has(DiagLevel level) const;
     DiagLevel level() const;
+
+private:
+    DiagLevel m_minimumLevel;
+    bool m_recordingCreationTime;
 };
 
+/*!
+ * \brief Constructs a new container recording all messages including their creation time.
+ */
+inline Diagnostics::Diagnostics()
+    : m_minimumLevel(DiagLevel::Debug)
+    , m_recordingCreationTime(true)
+{
+}
+
 /*!
  * \brief Constructs a new container with the specified messages.
  */
 inline Diagnostics::Diagnostics(std::initializer_list<DiagMessage> list)
     : std::vector<DiagMessage>(list)
+    , m_minimumLevel(DiagLevel::Debug)
+    , m_recordingCreationTime(true)
+{
+}
+
+/*!
+ * \brief Returns an iterator to the first message.
+ */
+inline Diagnostics::const_iterator Diagnostics::begin() const
+{
+    return std::vector<DiagMessage>::cbegin();
+}
+
+/*!
+ * \brief Returns an iterator behind the last message.
+ */
+inline Diagnostics::const_iterator Diagnostics::end() const
+{
+    return std::vector<DiagMessage>::cend();
+}
+
+/*!
+ * \brief Returns a reverse iterator to the last message.
+ */
+inline Diagnostics::const_reverse_iterator Diagnostics::rbegin() const
+{
+    return std::vector<DiagMessage>::crbegin();
+}
+
+/*!
+ * \brief Returns a reverse iterator before the first message.
+ */
+inline Diagnostics::const_reverse_iterator Diagnostics::rend() const
+{
+    return std::vector<DiagMessage>::crend();
+}
+
+/*!
+ * \brief Returns the first message.
+ */
+inline Diagnostics::const_reference Diagnostics::front() const
+{
+    return std::vector<DiagMessage>::front();
+}
+
+/*!
+ * \brief Returns the last message.
+ */
+inline Diagnostics::const_reference Diagnostics::back() const
+{
+    return std::vector<DiagMessage>::back();
+}
+
+/*!
+ * \brief Returns the message at the specified \a index.
+ * \throws Throws std::out_of_range if \a index is out of range.
+ */
+inline Diagnostics::const_reference Diagnostics::at(size_type index) const
+{
+    return std::vector<DiagMessage>::at(index);
+}
+
+/*!
+ * \brief Returns the message at the specified \a index.
+ */
+inline Diagnostics::const_reference Diagnostics::operator[](size_type index) const
+{
+    return std::vector<DiagMessage>::operator[](index);
+}
+
+/*!
+ * \brief Removes the message at the specified \a position.
+ */
+inline Diagnostics::iterator Diagnostics::erase(const_iterator position)
+{
+    return std::vector<DiagMessage>::erase(position);
+}
+
+/*!
+ * \brief Removes the messages from \a first to \a last.
+ */
+inline Diagnostics::iterator Diagnostics::erase(const_iterator first, const_iterator last)
+{
+    return std::vector<DiagMessage>::erase(first, last);
+}
+
+/*!
+ * \brief Returns whether the messages of the current instance equal the messages of \a other.
+ * \remarks The settings (eg. minimumLevel()) are not considered.
+ */
+inline bool Diagnostics::operator==(const Diagnostics &other) const
+{
+    return static_cast<const std::vector<DiagMessage> &>(*this) == static_cast<const std::vector<DiagMessage> &>(other);
+}
+
+/*!
+ * \brief Returns whether the messages of the current instance differ from the messages of \a other.
+ */
+inline bool Diagnostics::operator!=(const Diagnostics &other) const
+{
+    return !(*this == other);
+}
+
+/*!
+ * \brief Adds a new DiagMessage with the specified \a level, \a message and \a context.
+ *
+ * Does nothing if messages of the specified \a level are not recorded. In this case the \a message and the \a context
+ * are not even converted to std::string.
+ */
+template <typename MessageType, typename ContextType>
+inline void Diagnostics::emplace_back(DiagLevel level, MessageType &&message, ContextType &&context)
+{
+    if (!isRecording(level)) {
+        return;
+    }
+    std::vector<DiagMessage>::emplace_back(level, std::string(std::forward<MessageType>(message)),
+        std::string(std::forward<ContextType>(context)),
+        m_recordingCreationTime ? ChronoUtilities::DateTime::gmtNow() : ChronoUtilities::DateTime());
+}
+
+/// \cond
+namespace DiagnosticsPrivate {
+
+inline const std::string &makeContext(const std::string &context)
+{
+    return context;
+}
+
+inline std::string makeContext(const char *context)
+{
+    return context;
+}
+
+template <typename ContextFunction> inline auto makeContext(const ContextFunction &contextFunction) -> decltype(std::string(contextFunction()))
+{
+    return contextFunction();
+}
+
+} // namespace DiagnosticsPrivate
+/// \endcond
+
+/*!
+ * \brief Adds a new DiagMessage with the specified \a level and \a context and the concatenation of \a messageParts
+ *        as message.
+ *
+ * The message is only formatted (using ConversionUtilities::argsToString()) if messages of the specified \a level are
+ * recorded. So this function should be preferred over emplace_back() when the message needs to be formatted and might be
+ * emitted frequently (eg. when trying to resync within corrupted data).
+ *
+ * The \a context might also be a function returning the context. It is only invoked if messages of the specified \a level
+ * are recorded. That is useful if computing the context is expensive (eg. EbmlElement::parsingContext()).
+ */
+template <typename ContextType, typename... MessageParts>
+inline void Diagnostics::emplaceFormatted(DiagLevel level, ContextType &&context, MessageParts &&... messageParts)
+{
+    if (isRecording(level)) {
+        emplace_back(level, ConversionUtilities::argsToString(std::forward<MessageParts>(messageParts)...),
+            DiagnosticsPrivate::makeContext(std::forward<ContextType>(context)));
+    }
+}
+
+/*!
+ * \brief Adds the specified \a message unless messages of its level are not recorded.
+ */
+inline void Diagnostics::push_back(const DiagMessage &message)
+{
+    if (isRecording(message.level())) {
+        std::vector<DiagMessage>::push_back(message);
+    }
+}
+
+/*!
+ * \brief Adds the specified \a message unless messages of its level are not recorded.
+ */
+inline void Diagnostics::push_back(DiagMessage &&message)
+{
+    if (isRecording(message.level())) {
+        std::vector<DiagMessage>::push_back(std::move(message));
+    }
+}
+
+/*!
+ * \brief Inserts the specified \a message before \a position unless messages of its level are not recorded.
+ * \returns Returns an iterator pointing to the inserted message or \a position if the message has been discarded.
+ */
+inline Diagnostics::iterator Diagnostics::insert(const_iterator position, const DiagMessage &message)
+{
+    return isRecording(message.level()) ? std::vector<DiagMessage>::insert(position, message) : position;
+}
+
+/*!
+ * \brief Inserts the specified \a message before \a position unless messages of its level are not recorded.
+ * \returns Returns an iterator pointing to the inserted message or \a position if the message has been discarded.
+ */
+inline Diagnostics::iterator Diagnostics::insert(const_iterator position, DiagMessage &&message)
+{
+    return isRecording(message.level()) ? std::vector<DiagMessage>::insert(position, std::move(message)) : position;
+}
+
+/*!
+ * \brief Inserts \a count copies of the specified \a message before \a position unless messages of its level are not recorded.
+ * \returns Returns an iterator pointing to the first inserted message or \a position if the message has been discarded.
+ */
+inline Diagnostics::iterator Diagnostics::insert(const_iterator position, size_type count, const DiagMessage &message)
+{
+    return isRecording(message.level()) ? std::vector<DiagMessage>::insert(position, count, message) : position;
+}
+
+/*!
+ * \brief Inserts the messages from \a first to \a last before \a position; messages of levels which are not recorded are
+ *        discarded.
+ * \returns Returns an iterator pointing to the first inserted message or \a position if no message has been inserted.
+ */
+template <typename InputIterator>
+inline Diagnostics::iterator Diagnostics::insert(const_iterator position, InputIterator first, InputIterator last)
+{
+    const auto offset = position - cbegin();
+    auto current = position;
+    for (; first != last; ++first) {
+        if (isRecording(static_cast<const DiagMessage &>(*first).level())) {
+            current = std::vector<DiagMessage>::insert(current, *first) + 1;
+        }
+    }
+    return cbegin() + offset;
+}
+
+/*!
+ * \brief Inserts the specified \a messages before \a position; messages of levels which are not recorded are discarded.
+ * \returns Returns an iterator pointing to the first inserted message or \a position if no message has been inserted.
+ */
+inline Diagnostics::iterator Diagnostics::insert(const_iterator position, std::initializer_list<DiagMessage> messages)
+{
+    return insert(position, messages.begin(), messages.end());
+}
+
+/*!
+ * \brief Appends the messages of \a other; messages of levels which are not recorded are discarded.
+ * \remarks Use this to merge temporary containers (see adoptSettings()).
+ */
+inline void Diagnostics::append(const Diagnostics &other)
+{
+    insert(cend(), other.cbegin(), other.cend());
+}
+
+/*!
+ * \brief Moves the messages of \a other to the end; messages of levels which are not recorded are discarded.
+ * \remarks Use this to merge temporary containers (see adoptSettings()). \a other is empty afterwards.
+ */
+inline void Diagnostics::append(Diagnostics &&other)
+{
+    reserve(size() + other.size());
+    for (DiagMessage &message : static_cast<std::vector<DiagMessage> &>(other)) {
+        push_back(std::move(message));
+    }
+    other.clear();
+}
+
+/*!
+ * \brief Returns whether messages of the specified \a level are recorded.
+ * \remarks Can be used to avoid computing the message or context if it would be discarded anyways.
+ * \sa minimumLevel()
+ */
+inline bool Diagnostics::isRecording(DiagLevel level) const
+{
+    return level >= m_minimumLevel;
+}
+
+/*!
+ * \brief Returns the minimum level of messages to be recorded.
+ *
+ * Messages of a lower level are discarded without being formatted or stored. By default, all messages are recorded.
+ *
+ * \remarks Messages which have been added before changing the minimum level are not removed.
+ */
+inline DiagLevel Diagnostics::minimumLevel() const
+{
+    return m_minimumLevel;
+}
+
+/*!
+ * \brief Sets the minimum level of messages to be recorded.
+ * \sa minimumLevel()
+ */
+inline void Diagnostics::setMinimumLevel(DiagLevel minimumLevel)
+{
+    m_minimumLevel = minimumLevel;
+}
+
+/*!
+ * \brief Returns whether the creation time of messages is recorded (see DiagMessage::creationTime()).
+ *
+ * Determining the current time is relatively expensive so it might be useful to disable this when parsing a lot of files
+ * and the creation time is not of interest. This is enabled by default.
+ */
+inline bool Diagnostics::isRecordingCreationTime() const
+{
+    return m_recordingCreationTime;
+}
+
+/*!
+ * \brief Sets whether the creation time of messages is recorded.
+ * \sa isRecordingCreationTime()
+ */
+inline void Diagnostics::setRecordingCreationTime(bool recordingCreationTime)
+{
+    m_recordingCreationTime = recordingCreationTime;
+}
+
+/*!
+ * \brief Applies the settings (but not the messages) of \a other to the current instance.
+ * \remarks Use this for temporary containers whose messages are appended to \a other later on.
+ */
+inline void Diagnostics::adoptSettings(const Diagnostics &other)
 {
+    m_minimumLevel = other.m_minimumLevel;
+    m_recordingCreationTime = other.m_recordingCreationTime;
 }
 
 /*!
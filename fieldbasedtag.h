@@ -1,10 +1,10 @@
 #ifndef TAG_PARSER_FIELDBASEDTAG_H
 #define TAG_PARSER_FIELDBASEDTAG_H
 
+#include "./flatmultimap.h"
 #include "./tag.h"
 
 #include <functional>
-#include <map>
 
 namespace TagParser {
 
@@ -20,7 +20,7 @@ template <typename ImplementationType> class FieldMapBasedTagTraits {
 /*!
  * \class TagParser::FieldMapBasedTag
  * \brief The FieldMapBasedTag provides a generic implementation of Tag which stores
- *        the tag fields using std::multimap.
+ *        the tag fields using FlatMultiMap.
  *
  * The FieldMapBasedTag class only provides the interface and common functionality.
  * It is meant to be subclassed using CRTP pattern.
@@ -35,6 +35,7 @@ public:
     typedef typename FieldMapBasedTagTraits<ImplementationType>::FieldType FieldType;
     typedef typename FieldMapBasedTagTraits<ImplementationType>::FieldType::IdentifierType IdentifierType;
     typedef typename FieldMapBasedTagTraits<ImplementationType>::Compare Compare;
+    typedef FlatMultiMap<IdentifierType, FieldType, Compare> FieldContainer;
 
     FieldMapBasedTag();
 
@@ -46,14 +47,18 @@ public:
     std::vector<const TagValue *> values(const IdentifierType &id) const;
     std::vector<const TagValue *> values(KnownField field) const;
     bool setValue(const IdentifierType &id, const TagValue &value);
+    bool setValue(const IdentifierType &id, TagValue &&value);
     bool setValue(KnownField field, const TagValue &value);
+    bool setValue(KnownField field, TagValue &&value);
     bool setValues(const IdentifierType &id, const std::vector<TagValue> &values);
+    bool setValues(const IdentifierType &id, std::vector<TagValue> &&values);
     bool setValues(KnownField field, const std::vector<TagValue> &values);
+    bool setValues(KnownField field, std::vector<TagValue> &&values);
     bool hasField(KnownField field) const;
     bool hasField(const IdentifierType &id) const;
     void removeAllFields();
-    const std::multimap<IdentifierType, FieldType, Compare> &fields() const;
-    std::multimap<IdentifierType, FieldType, Compare> &fields();
+    const FieldContainer &fields() const;
+    FieldContainer &fields();
     unsigned int fieldCount() const;
     IdentifierType fieldId(KnownField value) const;
     KnownField knownField(const IdentifierType &id) const;
@@ -66,14 +71,19 @@ public:
 
 protected:
     const TagValue &internallyGetValue(const IdentifierType &id) const;
+    std::vector<const TagValue *> internallyGetValues(const IdentifierType &id) const;
     bool internallySetValue(const IdentifierType &id, const TagValue &value);
+    bool internallySetValue(const IdentifierType &id, TagValue &&value);
+    bool internallySetValues(const IdentifierType &id, const std::vector<TagValue> &values);
+    bool internallySetValues(const IdentifierType &id, std::vector<TagValue> &&values);
     bool internallyHasField(const IdentifierType &id) const;
     // no default implementation: IdentifierType internallyGetFieldId(KnownField field) const;
     // no default implementation: KnownField internallyGetKnownField(const IdentifierType &id) const;
     TagDataType internallyGetProposedDataType(const IdentifierType &id) const;
+    int insertField(const FieldType &fromField, bool overwrite);
 
 private:
-    std::multimap<IdentifierType, FieldType, Compare> m_fields;
+    FieldContainer m_fields;
 };
 
 /*!
@@ -137,10 +147,11 @@ template <class ImplementationType> inline const TagValue &FieldMapBasedTag<Impl
 }
 
 /*!
- * \brief Returns the values of the field with the specified \a id.
- * \sa Tag::values()
+ * \brief Default implementation for values().
+ * \remarks Shadow in subclass to provide custom implementation.
  */
-template <class ImplementationType> inline std::vector<const TagValue *> FieldMapBasedTag<ImplementationType>::values(const IdentifierType &id) const
+template <class ImplementationType>
+std::vector<const TagValue *> FieldMapBasedTag<ImplementationType>::internallyGetValues(const IdentifierType &id) const
 {
     auto range = m_fields.equal_range(id);
     std::vector<const TagValue *> values;
@@ -152,6 +163,15 @@ template <class ImplementationType> inline std::vector<const TagValue *> FieldMa
     return values;
 }
 
+/*!
+ * \brief Returns the values of the field with the specified \a id.
+ * \sa Tag::values()
+ */
+template <class ImplementationType> inline std::vector<const TagValue *> FieldMapBasedTag<ImplementationType>::values(const IdentifierType &id) const
+{
+    return static_cast<const ImplementationType *>(this)->internallyGetValues(id);
+}
+
 template <class ImplementationType> inline std::vector<const TagValue *> FieldMapBasedTag<ImplementationType>::values(KnownField field) const
 {
     return values(fieldId(field));
@@ -162,6 +182,11 @@ template <class ImplementationType> inline bool FieldMapBasedTag<ImplementationT
     return setValue(fieldId(field), value);
 }
 
+template <class ImplementationType> inline bool FieldMapBasedTag<ImplementationType>::setValue(KnownField field, TagValue &&value)
+{
+    return setValue(fieldId(field), std::move(value));
+}
+
 /*!
  * \brief Default implementation for setValue().
  * \remarks Shadow in subclass to provide custom implementation.
@@ -179,6 +204,23 @@ template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::i
     return true;
 }
 
+/*!
+ * \brief Default implementation for setValue() moving the specified \a value into the field.
+ * \remarks Shadow in subclass to provide custom implementation.
+ */
+template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::internallySetValue(const IdentifierType &id, TagValue &&value)
+{
+    auto i = m_fields.find(id);
+    if (i != m_fields.end()) { // field already exists -> set its value
+        i->second.setValue(std::move(value));
+    } else if (!value.isEmpty()) { // field doesn't exist -> create new one if value is not null
+        m_fields.emplace(id, FieldType(id, std::move(value)));
+    } else { // otherwise return false
+        return false;
+    }
+    return true;
+}
+
 /*!
  * \brief Assigns the given \a value to the field with the specified \a id.
  * \sa Tag::setValue()
@@ -189,13 +231,20 @@ template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::s
 }
 
 /*!
- * \brief Assigns the given \a values to the field with the specified \a id.
- * \remarks There might me more than one value assigned to an \a id. Whereas setValue() only alters the first value, this
- *          method will replace all currently assigned values with the specified \a values.
- * \sa Tag::setValues()
+ * \brief Moves the given \a value into the field with the specified \a id.
+ * \sa Tag::setValue()
+ */
+template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::setValue(const IdentifierType &id, TagValue &&value)
+{
+    return static_cast<ImplementationType *>(this)->internallySetValue(id, std::move(value));
+}
+
+/*!
+ * \brief Default implementation for setValues().
+ * \remarks Shadow in subclass to provide custom implementation.
  */
 template <class ImplementationType>
-bool FieldMapBasedTag<ImplementationType>::setValues(const IdentifierType &id, const std::vector<TagValue> &values)
+bool FieldMapBasedTag<ImplementationType>::internallySetValues(const IdentifierType &id, const std::vector<TagValue> &values)
 {
     auto valuesIterator = values.cbegin();
     auto range = m_fields.equal_range(id);
@@ -207,17 +256,68 @@ bool FieldMapBasedTag<ImplementationType>::setValues(const IdentifierType &id, c
             ++range.first;
         }
     }
+    // remove remaining existing values (there are more existing values than specified ones)
+    for (; range.first != range.second; ++range.first) {
+        range.first->second.setValue(TagValue());
+    }
     // add remaining specified values (there are more specified values than existing ones)
+    // note: this invalidates range so it must be done last
     for (; valuesIterator != values.cend(); ++valuesIterator) {
         m_fields.insert(std::make_pair(id, FieldType(id, *valuesIterator)));
     }
+    return true;
+}
+
+/*!
+ * \brief Default implementation for setValues() moving the specified \a values into the fields.
+ * \remarks Shadow in subclass to provide custom implementation.
+ */
+template <class ImplementationType>
+bool FieldMapBasedTag<ImplementationType>::internallySetValues(const IdentifierType &id, std::vector<TagValue> &&values)
+{
+    auto valuesIterator = values.begin();
+    auto range = m_fields.equal_range(id);
+    // iterate through all specified and all existing values
+    for (; valuesIterator != values.end() && range.first != range.second; ++valuesIterator) {
+        // replace existing value with non-empty specified value
+        if (!valuesIterator->isEmpty()) {
+            range.first->second.setValue(std::move(*valuesIterator));
+            ++range.first;
+        }
+    }
     // remove remaining existing values (there are more existing values than specified ones)
     for (; range.first != range.second; ++range.first) {
         range.first->second.setValue(TagValue());
     }
+    // add remaining specified values (there are more specified values than existing ones)
+    // note: this invalidates range so it must be done last
+    for (; valuesIterator != values.end(); ++valuesIterator) {
+        m_fields.emplace(id, FieldType(id, std::move(*valuesIterator)));
+    }
     return true;
 }
 
+/*!
+ * \brief Assigns the given \a values to the field with the specified \a id.
+ * \remarks There might me more than one value assigned to an \a id. Whereas setValue() only alters the first value, this
+ *          method will replace all currently assigned values with the specified \a values.
+ * \sa Tag::setValues()
+ */
+template <class ImplementationType>
+inline bool FieldMapBasedTag<ImplementationType>::setValues(const IdentifierType &id, const std::vector<TagValue> &values)
+{
+    return static_cast<ImplementationType *>(this)->internallySetValues(id, values);
+}
+
+/*!
+ * \brief Moves the given \a values into the field with the specified \a id.
+ * \sa setValues(const IdentifierType &, const std::vector<TagValue> &)
+ */
+template <class ImplementationType> inline bool FieldMapBasedTag<ImplementationType>::setValues(const IdentifierType &id, std::vector<TagValue> &&values)
+{
+    return static_cast<ImplementationType *>(this)->internallySetValues(id, std::move(values));
+}
+
 /*!
  * \brief Assigns the given \a values to the field with the specified \a id.
  * \remarks There might me more than one value assigned to a \a field. Whereas setValue() only alters the first value, this
@@ -229,6 +329,15 @@ template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::s
     return setValues(fieldId(field), values);
 }
 
+/*!
+ * \brief Moves the given \a values into the specified \a field.
+ * \sa setValues(KnownField, const std::vector<TagValue> &)
+ */
+template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::setValues(KnownField field, std::vector<TagValue> &&values)
+{
+    return setValues(fieldId(field), std::move(values));
+}
+
 template <class ImplementationType> inline bool FieldMapBasedTag<ImplementationType>::hasField(KnownField field) const
 {
     return hasField(fieldId(field));
@@ -263,17 +372,24 @@ template <class ImplementationType> inline void FieldMapBasedTag<ImplementationT
 
 /*!
  * \brief Returns the fields of the tag by providing direct access to the field map of the tag.
+ * \remarks The fields are stored contiguously so adding or removing fields invalidates iterators, pointers and references
+ *          to other fields and their values (see FlatMultiMap).
+ * \remarks Up to version 7 the fields were stored in a std::multimap. The FieldContainer has been changed to FlatMultiMap
+ *          in version 8 which breaks API and ABI compatibility. FlatMultiMap provides the parts of the std::multimap
+ *          interface used within the library but it is not a drop-in replacement: The key of value_type is not const and
+ *          references are not stable.
  */
-template <class ImplementationType>
-inline auto FieldMapBasedTag<ImplementationType>::fields() const -> const std::multimap<IdentifierType, FieldType, Compare> &
+template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::fields() const -> const FieldContainer &
 {
     return m_fields;
 }
 
 /*!
  * \brief Returns the fields of the tag by providing direct access to the field map of the tag.
+ * \remarks The fields are stored contiguously so adding or removing fields invalidates iterators, pointers and references
+ *          to other fields and their values (see FlatMultiMap).
  */
-template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::fields() -> std::multimap<IdentifierType, FieldType, Compare> &
+template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::fields() -> FieldContainer &
 {
     return m_fields;
 }
@@ -343,28 +459,39 @@ int FieldMapBasedTag<ImplementationType>::insertFields(const FieldMapBasedTag<Im
 {
     int fieldsInserted = 0;
     for (const auto &pair : from.fields()) {
-        const FieldType &fromField = pair.second;
-        if (fromField.value().isEmpty()) {
-            continue;
-        }
-        bool fieldInserted = false;
-        auto range = fields().equal_range(fromField.id());
-        for (auto i = range.first; i != range.second; ++i) {
-            FieldType &ownField = i->second;
-            if ((fromField.isTypeInfoAssigned() && ownField.isTypeInfoAssigned() && fromField.typeInfo() == ownField.typeInfo())
-                || (!fromField.isTypeInfoAssigned() && !ownField.isTypeInfoAssigned())) {
-                if (overwrite || ownField.value().isEmpty()) {
-                    ownField = fromField;
-                    ++fieldsInserted;
-                }
-                fieldInserted = true;
-                continue;
+        fieldsInserted += insertField(pair.second, overwrite);
+    }
+    return fieldsInserted;
+}
+
+/*!
+ * \brief Inserts the specified field \a fromField of another tag.
+ * \return Returns the number of fields that have been inserted (or overwritten).
+ * \sa insertFields()
+ */
+template <class ImplementationType> int FieldMapBasedTag<ImplementationType>::insertField(const FieldType &fromField, bool overwrite)
+{
+    if (fromField.value().isEmpty()) {
+        return 0;
+    }
+    int fieldsInserted = 0;
+    bool fieldPresent = false;
+    auto range = fields().equal_range(fromField.id());
+    for (auto i = range.first; i != range.second; ++i) {
+        FieldType &ownField = i->second;
+        if ((fromField.isTypeInfoAssigned() && ownField.isTypeInfoAssigned() && fromField.typeInfo() == ownField.typeInfo())
+            || (!fromField.isTypeInfoAssigned() && !ownField.isTypeInfoAssigned())) {
+            if (overwrite || ownField.value().isEmpty()) {
+                ownField = fromField;
+                ownField.setDirty(true);
+                ++fieldsInserted;
             }
+            fieldPresent = true;
         }
-        if (!fieldInserted) {
-            fields().insert(std::make_pair(fromField.id(), fromField));
-            ++fieldsInserted;
-        }
+    }
+    if (!fieldPresent) {
+        fields().insert(std::make_pair(fromField.id(), fromField))->second.setDirty(true);
+        ++fieldsInserted;
     }
     return fieldsInserted;
 }
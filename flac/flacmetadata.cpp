@@ -77,11 +77,14 @@ void FlacMetaDataBlockStreamInfo::parse(const char *buffer)
  */
 
 /*!
- * \brief Parses the FLAC "METADATA_BLOCK_PICTURE".
+ * \brief Parses the FLAC "METADATA_BLOCK_PICTURE" except the picture data itself.
+ *
+ * The MIME type and the description are assigned to the tag value. The stream is left at the start of
+ * the picture data whose size is returned by dataSize().
  *
  * \a maxSize specifies the maximum size of the structure.
  */
-void FlacMetaDataBlockPicture::parse(istream &inputStream, uint32 maxSize)
+void FlacMetaDataBlockPicture::parseHeader(istream &inputStream, uint32 maxSize)
 {
     CHECK_MAX_SIZE(32);
     BinaryReader reader(&inputStream);
@@ -92,14 +95,26 @@ void FlacMetaDataBlockPicture::parse(istream &inputStream, uint32 maxSize)
     size = reader.readUInt32BE();
     CHECK_MAX_SIZE(size);
     m_value.setDescription(reader.readString(size));
-    // skip width, height, color depth, number of colors used
-    inputStream.seekg(4 * 4, ios_base::cur);
-    size = reader.readUInt32BE();
-    CHECK_MAX_SIZE(size);
-    if (size) {
-        auto data = make_unique<char[]>(size);
-        inputStream.read(data.get(), size);
-        m_value.assignData(move(data), size, TagDataType::Picture);
+    m_width = reader.readUInt32BE();
+    m_height = reader.readUInt32BE();
+    m_colorDepth = reader.readUInt32BE();
+    m_colorCount = reader.readUInt32BE();
+    m_dataSize = reader.readUInt32BE();
+    CHECK_MAX_SIZE(m_dataSize);
+}
+
+/*!
+ * \brief Parses the FLAC "METADATA_BLOCK_PICTURE".
+ *
+ * \a maxSize specifies the maximum size of the structure.
+ */
+void FlacMetaDataBlockPicture::parse(istream &inputStream, uint32 maxSize)
+{
+    parseHeader(inputStream, maxSize);
+    if (m_dataSize) {
+        auto data = make_unique<char[]>(m_dataSize);
+        inputStream.read(data.get(), m_dataSize);
+        m_value.assignData(move(data), m_dataSize, TagDataType::Picture);
     } else {
         m_value.clearData();
     }
@@ -140,7 +155,7 @@ void FlacMetaDataBlockPicture::make(ostream &outputStream)
     writer.writeUInt32BE(0); // skip color depth
     writer.writeUInt32BE(0); // skip number of colors used
     writer.writeUInt32BE(static_cast<uint32>(m_value.dataSize()));
-    writer.write(value().dataPointer(), static_cast<streamoff>(m_value.dataSize()));
+    m_value.copyDataTo(outputStream);
 }
 
 } // namespace TagParser
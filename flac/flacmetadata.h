@@ -246,20 +246,58 @@ inline const char *FlacMetaDataBlockStreamInfo::md5Sum() const
     return m_md5Sum;
 }
 
+/*!
+ * \brief The FlacSeekPoint struct describes a seek point of a FLAC "METADATA_BLOCK_SEEKTABLE".
+ */
+struct TAG_PARSER_EXPORT FlacSeekPoint {
+    /// \brief The sample number denoting a placeholder point.
+    static constexpr uint64 placeholder = 0xFFFFFFFFFFFFFFFFul;
+    /// \brief The size of a seek point within the "METADATA_BLOCK_SEEKTABLE".
+    static constexpr uint32 size = 18;
+
+    bool isPlaceholder() const;
+
+    /// \brief Specifies the number of the first sample in the target frame or placeholder for a placeholder point.
+    uint64 sampleNumber = placeholder;
+    /// \brief Specifies the offset of the target frame header relative to the first frame header.
+    uint64 offset = 0;
+    /// \brief Specifies the number of samples in the target frame.
+    uint16 sampleCount = 0;
+};
+
+/*!
+ * \brief Returns whether the seek point is a placeholder point.
+ */
+inline bool FlacSeekPoint::isPlaceholder() const
+{
+    return sampleNumber == placeholder;
+}
+
 class TAG_PARSER_EXPORT FlacMetaDataBlockPicture {
 public:
     FlacMetaDataBlockPicture(TagValue &tagValue);
 
+    void parseHeader(std::istream &inputStream, uint32 maxSize);
     void parse(std::istream &inputStream, uint32 maxSize);
     uint32 requiredSize() const;
     void make(std::ostream &outputStream);
 
     uint32 pictureType() const;
     void setPictureType(uint32 pictureType);
+    uint32 width() const;
+    uint32 height() const;
+    uint32 colorDepth() const;
+    uint32 colorCount() const;
+    uint32 dataSize() const;
     TagValue &value();
 
 private:
     uint32 m_pictureType;
+    uint32 m_width;
+    uint32 m_height;
+    uint32 m_colorDepth;
+    uint32 m_colorCount;
+    uint32 m_dataSize;
     TagValue &m_value;
 };
 
@@ -272,6 +310,11 @@ private:
  */
 inline FlacMetaDataBlockPicture::FlacMetaDataBlockPicture(TagValue &tagValue)
     : m_pictureType(0)
+    , m_width(0)
+    , m_height(0)
+    , m_colorDepth(0)
+    , m_colorCount(0)
+    , m_dataSize(0)
     , m_value(tagValue)
 {
 }
@@ -292,6 +335,46 @@ inline void FlacMetaDataBlockPicture::setPictureType(uint32 pictureType)
     m_pictureType = pictureType;
 }
 
+/*!
+ * \brief Returns the width of the picture in pixels as read by parseHeader().
+ */
+inline uint32 FlacMetaDataBlockPicture::width() const
+{
+    return m_width;
+}
+
+/*!
+ * \brief Returns the height of the picture in pixels as read by parseHeader().
+ */
+inline uint32 FlacMetaDataBlockPicture::height() const
+{
+    return m_height;
+}
+
+/*!
+ * \brief Returns the color depth of the picture in bits-per-pixel as read by parseHeader().
+ */
+inline uint32 FlacMetaDataBlockPicture::colorDepth() const
+{
+    return m_colorDepth;
+}
+
+/*!
+ * \brief Returns the number of colors used for indexed-color pictures as read by parseHeader().
+ */
+inline uint32 FlacMetaDataBlockPicture::colorCount() const
+{
+    return m_colorCount;
+}
+
+/*!
+ * \brief Returns the size of the picture data as read by parseHeader().
+ */
+inline uint32 FlacMetaDataBlockPicture::dataSize() const
+{
+    return m_dataSize;
+}
+
 /*!
  * \brief Returns the tag value the picture is read from/stored to.
  */
@@ -2,15 +2,21 @@
 #include "./flacmetadata.h"
 
 #include "../vorbis/vorbiscomment.h"
+#include "../vorbis/vorbiscommentids.h"
 
+#include "../abstractattachment.h"
+#include "../bufferedsyncscanner.h"
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
 #include "../mediaformat.h"
+#include "../paddinghelper.h"
 
 #include "resources/config.h"
 
+#include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/copy.h>
 
+#include <algorithm>
 #include <sstream>
 
 using namespace std;
@@ -20,6 +26,180 @@ using namespace ChronoUtilities;
 
 namespace TagParser {
 
+/// \brief The maximum size of a FLAC frame header (including the CRC-8).
+constexpr uint64 maxFrameHeaderSize = 16;
+
+/*!
+ * \brief The FlacFrameHeader struct holds the information of a FLAC frame header required to build a seek table.
+ */
+struct FlacFrameHeader {
+    uint64 number = 0;
+    uint32 blockSize = 0;
+    uint16 properties = 0;
+    byte size = 0;
+    bool variableBlockSize = false;
+
+    bool isCompatible(const FlacFrameHeader &other) const;
+};
+
+/*!
+ * \brief Returns whether the sample rate, channel assignment, sample size and blocking strategy match the ones of the
+ *        specified \a other frame header.
+ */
+inline bool FlacFrameHeader::isCompatible(const FlacFrameHeader &other) const
+{
+    return properties == other.properties && variableBlockSize == other.variableBlockSize;
+}
+
+/*!
+ * \brief Returns the CRC-8 (polynomial x^8 + x^2 + x^1 + x^0) of the specified \a data as used in FLAC frame headers.
+ */
+static byte flacCrc8(const byte *data, std::size_t size)
+{
+    byte crc = 0;
+    for (const byte *const end = data + size; data != end; ++data) {
+        crc ^= *data;
+        for (byte bit = 0; bit != 8; ++bit) {
+            crc = static_cast<byte>(crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Parses the FLAC frame header within the specified \a buffer of the specified \a size.
+ * \returns Returns whether a valid frame header (including a matching CRC-8) is present.
+ */
+static bool parseFrameHeader(const char *buffer, std::size_t size, FlacFrameHeader &header)
+{
+    const auto *const bytes = reinterpret_cast<const byte *>(buffer);
+    if (size < 6 || bytes[0] != 0xFF || (bytes[1] & 0xFE) != 0xF8) {
+        return false;
+    }
+    const byte blockSizeCode = bytes[2] >> 4, sampleRateCode = bytes[2] & 0x0F;
+    if (!blockSizeCode || sampleRateCode == 0x0F || (bytes[3] >> 4) > 0x0A || ((bytes[3] >> 1) & 0x07) == 0x03 || (bytes[3] & 0x01)) {
+        return false;
+    }
+
+    // read frame/sample number (coded like UTF-8 but up to 36 bit)
+    std::size_t index = 4;
+    uint64 number = bytes[index++];
+    if (number & 0x80) {
+        byte additionalBytes = 0;
+        for (byte mask = 0x40; number & mask; mask >>= 1) {
+            ++additionalBytes;
+        }
+        if (!additionalBytes || additionalBytes > 6 || index + additionalBytes > size) {
+            return false;
+        }
+        number &= 0x3Fu >> additionalBytes;
+        for (; additionalBytes; --additionalBytes) {
+            const byte nextByte = bytes[index++];
+            if ((nextByte & 0xC0) != 0x80) {
+                return false;
+            }
+            number = (number << 6) | (nextByte & 0x3F);
+        }
+    }
+
+    // read block size
+    uint32 blockSize;
+    switch (blockSizeCode) {
+    case 0x1:
+        blockSize = 192;
+        break;
+    case 0x2:
+    case 0x3:
+    case 0x4:
+    case 0x5:
+        blockSize = 576u << (blockSizeCode - 2);
+        break;
+    case 0x6:
+        if (index + 1 > size) {
+            return false;
+        }
+        blockSize = bytes[index++] + 1u;
+        break;
+    case 0x7:
+        if (index + 2 > size) {
+            return false;
+        }
+        blockSize = BE::toUInt16(buffer + index) + 1u;
+        index += 2;
+        // a block size of 65536 can be denoted but is not allowed (and could not be stored within a seek point)
+        if (blockSize > 0xFFFF) {
+            return false;
+        }
+        break;
+    default:
+        blockSize = 256u << (blockSizeCode - 8);
+    }
+
+    // skip sample rate
+    switch (sampleRateCode) {
+    case 0xC:
+        index += 1;
+        break;
+    case 0xD:
+    case 0xE:
+        index += 2;
+        break;
+    default:;
+    }
+
+    // verify CRC-8
+    if (index + 1 > size || flacCrc8(bytes, index) != bytes[index]) {
+        return false;
+    }
+    header.number = number;
+    header.blockSize = blockSize;
+    header.properties = static_cast<uint16>(sampleRateCode << 8 | bytes[3]);
+    header.size = static_cast<byte>(index + 1);
+    header.variableBlockSize = bytes[1] & 0x01;
+    return true;
+}
+
+/*!
+ * \brief The FlacPictureBlockLocation type specifies the offset and the size of the data of a "METADATA_BLOCK_PICTURE".
+ */
+using FlacPictureBlockLocation = pair<uint64, uint32>;
+
+/*!
+ * \brief Returns the "METADATA_BLOCK_PICTURE" within \a originalStream the specified \a coverField has been parsed from if
+ *        the cover has not been modified since parsing; otherwise returns nullptr.
+ * \remarks The data of the cover is only considered unmodified if it still refers to the data within \a originalStream
+ *          (see MediaFileInfo::isReferencingPictureData()).
+ */
+static const FlacPictureBlockLocation *findUnmodifiedPictureBlock(
+    istream &originalStream, const vector<FlacPictureBlockLocation> &pictureBlocks, const VorbisCommentField &coverField)
+{
+    const TagValue &value = coverField.value();
+    const StreamDataBlock *const dataBlock = value.dataBlock();
+    if (!dataBlock || &dataBlock->stream() != &originalStream) {
+        return nullptr;
+    }
+    // the picture data is located at the end of the block
+    const auto dataEndOffset = static_cast<uint64>(static_cast<streamoff>(dataBlock->endOffset()));
+    const auto block = find_if(pictureBlocks.cbegin(), pictureBlocks.cend(),
+        [dataEndOffset](const FlacPictureBlockLocation &block) { return block.first + block.second == dataEndOffset; });
+    if (block == pictureBlocks.cend()) {
+        return nullptr;
+    }
+    // check whether the meta data has been modified
+    TagValue originalValue;
+    FlacMetaDataBlockPicture originalPicture(originalValue);
+    try {
+        originalStream.seekg(static_cast<streamoff>(block->first));
+        originalPicture.parseHeader(originalStream, block->second);
+    } catch (const Failure &) {
+        return nullptr;
+    }
+    return originalPicture.pictureType() == coverField.typeInfo() && originalPicture.dataSize() == value.dataSize()
+            && originalValue.mimeType() == value.mimeType() && originalValue.description() == value.description()
+        ? &*block
+        : nullptr;
+}
+
 /*!
  * \class TagParser::FlacStream
  * \brief Implementation of TagParser::AbstractTrack for raw FLAC streams.
@@ -35,6 +215,8 @@ FlacStream::FlacStream(MediaFileInfo &mediaFileInfo, uint64 startOffset)
     , m_mediaFileInfo(mediaFileInfo)
     , m_paddingSize(0)
     , m_streamOffset(0)
+    , m_minBlockSize(0)
+    , m_maxFrameSize(0)
 {
     m_mediaType = MediaType::Audio;
 }
@@ -101,6 +283,8 @@ void FlacStream::internalParseHeader(Diagnostics &diag)
                 m_samplingFrequency = streamInfo.samplingFrequency();
                 m_sampleCount = streamInfo.totalSampleCount();
                 m_bitsPerSample = streamInfo.bitsPerSample();
+                m_minBlockSize = streamInfo.minBlockSize();
+                m_maxFrameSize = streamInfo.maxFrameSize();
                 m_duration = TimeSpan::fromSeconds(static_cast<double>(m_sampleCount) / m_samplingFrequency);
             } else {
                 diag.emplace_back(DiagLevel::Critical, "\"METADATA_BLOCK_STREAMINFO\" is truncated and will be ignored.", context);
@@ -124,12 +308,22 @@ void FlacStream::internalParseHeader(Diagnostics &diag)
             try {
                 // parse the cover
                 VorbisCommentField coverField;
-                coverField.setId(m_vorbisComment->fieldId(KnownField::Cover));
+                coverField.setId(VorbisCommentIds::cover());
                 FlacMetaDataBlockPicture picture(coverField.value());
-                picture.parse(*m_istream, header.dataSize());
+                if (m_mediaFileInfo.isReferencingPictureData()) {
+                    // refer to the picture data within the file instead of reading it
+                    picture.parseHeader(*m_istream, header.dataSize());
+                    MediaFileInfo &fileInfo = m_mediaFileInfo;
+                    const auto dataOffset = static_cast<streamoff>(m_istream->tellg());
+                    coverField.value().assignData(make_shared<StreamDataBlock>([&fileInfo]() -> istream & { return fileInfo.stream(); },
+                                                      dataOffset, ios_base::beg, dataOffset + picture.dataSize(), ios_base::beg),
+                        TagDataType::Picture);
+                } else {
+                    picture.parse(*m_istream, header.dataSize());
+                }
                 coverField.setTypeInfo(picture.pictureType());
 
-                if (coverField.value().isEmpty()) {
+                if (!picture.dataSize()) {
                     diag.emplace_back(DiagLevel::Warning, "\"METADATA_BLOCK_PICTURE\" contains no picture.", context);
                 } else {
                     // add the cover to the Vorbis comment
@@ -146,6 +340,19 @@ void FlacStream::internalParseHeader(Diagnostics &diag)
             }
             break;
 
+        case FlacMetaDataBlockType::SeekTable:
+            // read seek points (there should be only one "METADATA_BLOCK_SEEKTABLE" so points of multiple blocks are just merged)
+            m_seekTable.reserve(m_seekTable.size() + header.dataSize() / FlacSeekPoint::size);
+            for (uint32 i = 0, count = header.dataSize() / FlacSeekPoint::size; i != count; ++i) {
+                m_istream->read(buffer, FlacSeekPoint::size);
+                m_seekTable.emplace_back();
+                FlacSeekPoint &point = m_seekTable.back();
+                point.sampleNumber = BE::toUInt64(buffer);
+                point.offset = BE::toUInt64(buffer + 8);
+                point.sampleCount = BE::toUInt16(buffer + 16);
+            }
+            break;
+
         case FlacMetaDataBlockType::Padding:
             m_paddingSize += 4 + header.dataSize();
             break;
@@ -162,6 +369,100 @@ void FlacStream::internalParseHeader(Diagnostics &diag)
     m_streamOffset = static_cast<uint32>(m_istream->tellg());
 }
 
+/*!
+ * \brief Builds the seek table by scanning the FLAC frames.
+ *
+ * The whole stream (excluding an ID3v1 tag) is read in chunks and searched for frame headers. A frame header is only
+ * considered valid if its CRC-8 matches and its sample rate, channel assignment and sample size match the ones of the
+ * first frame. Additionally, its sample number must follow the previous frame. Otherwise the frame is only accepted if
+ * its sample number is greater and (if known) the distance to the previous frame exceeds the maximum frame size, so
+ * missing or corrupted frames are skipped without locking onto sync codes within the frame data. A seek point is added
+ * for the frame containing every multiple of the specified \a spacing. The seek points replace the seek points returned
+ * by seekTable() so the new seek table is written when applying changes (see MediaFileInfo::applyChanges()). It is
+ * written into the existing padding if it fits.
+ *
+ * \throws Throws InvalidDataException if the header has not been parsed successfully or the \a spacing is invalid.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void FlacStream::buildSeekTable(TimeSpan spacing, Diagnostics &diag)
+{
+    static const string context("building FLAC seek table");
+    if (!isHeaderValid() || !m_samplingFrequency || !m_streamOffset) {
+        diag.emplace_back(DiagLevel::Critical, "The header has not been parsed successfully.", context);
+        throw InvalidDataException();
+    }
+    const auto spacingInSamples = static_cast<uint64>(spacing.totalSeconds() * m_samplingFrequency);
+    if (!spacingInSamples) {
+        diag.emplace_back(DiagLevel::Critical, "The spacing of the seek points must be at least one sample.", context);
+        throw InvalidDataException();
+    }
+
+    // exclude an ID3v1 tag at the end of the file
+    uint64 endOffset = m_mediaFileInfo.size();
+    if (endOffset >= m_streamOffset + 128) {
+        m_istream->seekg(-128, ios_base::end);
+        if (m_reader.readUInt24BE() == 0x544147) {
+            endOffset -= 128;
+        }
+    }
+    BufferedSyncScanner scanner(*m_istream, endOffset);
+
+    vector<FlacSeekPoint> seekTable;
+    uint64 offset = m_streamOffset, lastFrameOffset = m_streamOffset, firstSample = 0, nextSample = 0, nextTargetSample = 0;
+    std::size_t skippedFrames = 0;
+    FlacFrameHeader firstFrame, frame;
+    while ((offset = scanner.findSync(offset, 0xFE, 0xF8, 2)) < endOffset) {
+        const auto headerSize = min(maxFrameHeaderSize, endOffset - offset);
+        if (!parseFrameHeader(scanner.bytesAt(offset, headerSize), static_cast<std::size_t>(headerSize), frame)
+            || (firstFrame.size && !frame.isCompatible(firstFrame))) {
+            ++offset;
+            continue;
+        }
+        const uint64 sample = frame.variableBlockSize ? frame.number : frame.number * m_minBlockSize;
+        if (!firstFrame.size) {
+            // the first frame does not necessarily start at sample zero
+            firstFrame = frame;
+            firstSample = nextTargetSample = sample;
+        } else if (sample != nextSample) {
+            // accept gaps only if the sample number increases and the distance to the previous frame exceeds the maximum
+            // frame size (which means frames are missing and not that the sync code is just part of the frame data)
+            if (sample < nextSample || (m_sampleCount && sample - firstSample >= m_sampleCount)
+                || (m_maxFrameSize && offset - lastFrameOffset <= m_maxFrameSize)) {
+                ++offset;
+                continue;
+            }
+            ++skippedFrames;
+        }
+        // add seek point if the frame contains the next target sample
+        if (nextTargetSample < sample + frame.blockSize) {
+            seekTable.emplace_back();
+            FlacSeekPoint &point = seekTable.back();
+            point.sampleNumber = sample;
+            point.offset = offset - m_streamOffset;
+            point.sampleCount = static_cast<uint16>(frame.blockSize);
+            do {
+                nextTargetSample += spacingInSamples;
+            } while (nextTargetSample < sample + frame.blockSize);
+        }
+        nextSample = sample + frame.blockSize;
+        lastFrameOffset = offset;
+        offset += frame.size;
+    }
+
+    if (skippedFrames) {
+        diag.emplace_back(DiagLevel::Warning, argsToString("Frames are missing or corrupted at ", skippedFrames, " locations."), context);
+    }
+    if (seekTable.empty()) {
+        diag.emplace_back(DiagLevel::Critical, "No valid frames found; the seek table is not altered.", context);
+        return;
+    }
+    if (seekTable.size() * FlacSeekPoint::size > 0xFFFFFF) {
+        diag.emplace_back(DiagLevel::Critical, "Too many seek points; choose a bigger spacing. The seek table is not altered.", context);
+        return;
+    }
+    m_seekTable = move(seekTable);
+}
+
 /*!
  * \brief Writes the FLAC metadata header to the specified \a outputStream.
  *
@@ -169,6 +470,7 @@ void FlacStream::internalParseHeader(Diagnostics &diag)
  *
  *  - Vorbis comment is updated.
  *  - "METADATA_BLOCK_PICTURE" are updated.
+ *  - "METADATA_BLOCK_SEEKTABLE" is made from seekTable().
  *  - Padding is skipped
  *
  * \returns Returns the start offset of the last "METADATA_BLOCK_HEADER" within \a outputStream.
@@ -189,6 +491,8 @@ uint32 FlacStream::makeHeader(ostream &outputStream, Diagnostics &diag)
     // write meta data blocks which don't need to be adjusted
     FlacMetaDataBlockHeader header;
     FlacMetaDataBlockHeader lastActuallyWrittenHeader;
+    bool seekTableWritten = m_seekTable.empty();
+    vector<FlacPictureBlockLocation> pictureBlocks;
     do {
         // parse block header
         originalStream.read(copy.buffer(), 4);
@@ -196,8 +500,25 @@ uint32 FlacStream::makeHeader(ostream &outputStream, Diagnostics &diag)
 
         // skip/copy block
         switch (static_cast<FlacMetaDataBlockType>(header.type())) {
-        case FlacMetaDataBlockType::VorbisComment:
+        case FlacMetaDataBlockType::SeekTable:
+            // replace (first) seek table with the current seek points
+            originalStream.seekg(header.dataSize(), ios_base::cur);
+            if (seekTableWritten) {
+                break;
+            }
+            lastStartOffset = outputStream.tellp();
+            makeSeekTable(outputStream, header.isLast(), diag);
+            lastActuallyWrittenHeader.setType(FlacMetaDataBlockType::SeekTable);
+            lastActuallyWrittenHeader.setLast(header.isLast());
+            lastActuallyWrittenHeader.setDataSize(static_cast<uint32>(m_seekTable.size() * FlacSeekPoint::size));
+            seekTableWritten = true;
+            break;
         case FlacMetaDataBlockType::Picture:
+            // skip separately written block but keep its location to be able to copy it if it has not been modified
+            pictureBlocks.emplace_back(static_cast<uint64>(originalStream.tellg()), header.dataSize());
+            originalStream.seekg(header.dataSize(), ios_base::cur);
+            break;
+        case FlacMetaDataBlockType::VorbisComment:
         case FlacMetaDataBlockType::Padding:
             // skip separately written block
             originalStream.seekg(header.dataSize(), ios_base::cur);
@@ -212,12 +533,18 @@ uint32 FlacStream::makeHeader(ostream &outputStream, Diagnostics &diag)
     } while (!header.isLast());
 
     // adjust "isLast" flag if neccassary
-    if (lastStartOffset >= 4
-        && ((!m_vorbisComment && !lastActuallyWrittenHeader.isLast()) || (m_vorbisComment && lastActuallyWrittenHeader.isLast()))) {
+    const bool furtherBlocks = m_vorbisComment || !seekTableWritten;
+    if (lastStartOffset >= 4 && ((!furtherBlocks && !lastActuallyWrittenHeader.isLast()) || (furtherBlocks && lastActuallyWrittenHeader.isLast()))) {
         outputStream.seekp(lastStartOffset);
-        lastActuallyWrittenHeader.setLast(!m_vorbisComment);
+        lastActuallyWrittenHeader.setLast(!furtherBlocks);
         lastActuallyWrittenHeader.makeHeader(outputStream);
-        originalStream.seekg(lastActuallyWrittenHeader.dataSize(), ios_base::cur);
+        outputStream.seekp(lastActuallyWrittenHeader.dataSize(), ios_base::cur);
+    }
+
+    // write seek table if not written yet
+    if (!seekTableWritten) {
+        lastStartOffset = outputStream.tellp();
+        makeSeekTable(outputStream, !m_vorbisComment, diag);
     }
 
     // write Vorbis comment
@@ -259,6 +586,19 @@ uint32 FlacStream::makeHeader(ostream &outputStream, Diagnostics &diag)
         const auto lastCoverStartOffset = outputStream.tellp();
 
         try {
+            // copy the block as-is if the picture has not been modified (preserves eg. the dimensions of the picture)
+            const VorbisCommentField &coverField = i->second;
+            if (const FlacPictureBlockLocation *const originalBlock = findUnmodifiedPictureBlock(originalStream, pictureBlocks, coverField)) {
+                header.setDataSize(originalBlock->second);
+                header.setLast(++i == coverFields.second);
+                header.makeHeader(outputStream);
+                originalStream.seekg(static_cast<streamoff>(originalBlock->first));
+                copy.copy(originalStream, outputStream, originalBlock->second);
+                lastStartOffset = lastCoverStartOffset;
+                lastActuallyWrittenHeader = header;
+                continue;
+            }
+
             // write the structure
             FlacMetaDataBlockPicture pictureBlock(i->second.value());
             pictureBlock.setPictureType(i->second.typeInfo());
@@ -286,12 +626,36 @@ uint32 FlacStream::makeHeader(ostream &outputStream, Diagnostics &diag)
         outputStream.seekp(lastStartOffset);
         lastActuallyWrittenHeader.setLast(true);
         lastActuallyWrittenHeader.makeHeader(outputStream);
-        outputStream.seekp(lastActuallyWrittenHeader.dataSize());
+        outputStream.seekp(lastActuallyWrittenHeader.dataSize(), ios_base::cur);
     }
 
     return static_cast<uint32>(lastStartOffset);
 }
 
+/*!
+ * \brief Writes the "METADATA_BLOCK_SEEKTABLE" for the seek points returned by seekTable() to the specified \a stream.
+ */
+void FlacStream::makeSeekTable(ostream &stream, bool isLast, Diagnostics &diag)
+{
+    VAR_UNUSED(diag)
+
+    // make header
+    FlacMetaDataBlockHeader header;
+    header.setType(FlacMetaDataBlockType::SeekTable);
+    header.setLast(isLast);
+    header.setDataSize(static_cast<uint32>(m_seekTable.size() * FlacSeekPoint::size));
+    header.makeHeader(stream);
+
+    // write seek points
+    char buffer[FlacSeekPoint::size];
+    for (const FlacSeekPoint &point : m_seekTable) {
+        BE::getBytes(point.sampleNumber, buffer);
+        BE::getBytes(point.offset, buffer + 8);
+        BE::getBytes(point.sampleCount, buffer + 16);
+        stream.write(buffer, FlacSeekPoint::size);
+    }
+}
+
 /*!
  * \brief Writes padding of the specified \a size to the specified \a stream.
  * \remarks Size must be at least 4 bytes.
@@ -308,9 +672,7 @@ void FlacStream::makePadding(ostream &stream, uint32 size, bool isLast, Diagnost
     header.makeHeader(stream);
 
     // write zeroes
-    for (; size; --size) {
-        stream.put(0);
-    }
+    PaddingHelper::writeZeroes(stream, size);
 }
 
 } // namespace TagParser
@@ -1,10 +1,13 @@
 #ifndef TAG_PARSER_FLACSTREAM_H
 #define TAG_PARSER_FLACSTREAM_H
 
+#include "./flacmetadata.h"
+
 #include "../abstracttrack.h"
 
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 namespace TagParser {
 
@@ -22,6 +25,9 @@ public:
     bool removeVorbisComment();
     uint32 paddingSize() const;
     uint32 streamOffset() const;
+    const std::vector<FlacSeekPoint> &seekTable() const;
+    std::vector<FlacSeekPoint> &seekTable();
+    void buildSeekTable(ChronoUtilities::TimeSpan spacing, Diagnostics &diag);
 
     uint32 makeHeader(std::ostream &stream, Diagnostics &diag);
     static void makePadding(std::ostream &stream, uint32 size, bool isLast, Diagnostics &diag);
@@ -30,10 +36,15 @@ protected:
     void internalParseHeader(Diagnostics &diag) override;
 
 private:
+    void makeSeekTable(std::ostream &stream, bool isLast, Diagnostics &diag);
+
     MediaFileInfo &m_mediaFileInfo;
     std::unique_ptr<VorbisComment> m_vorbisComment;
     uint32 m_paddingSize;
     uint32 m_streamOffset;
+    uint16 m_minBlockSize;
+    uint32 m_maxFrameSize;
+    std::vector<FlacSeekPoint> m_seekTable;
 };
 
 inline FlacStream::~FlacStream()
@@ -70,6 +81,25 @@ inline uint32 FlacStream::streamOffset() const
     return m_streamOffset;
 }
 
+/*!
+ * \brief Returns the seek points of the "METADATA_BLOCK_SEEKTABLE".
+ * \remarks Contains the seek points read when parsing the header or the ones determined via buildSeekTable().
+ */
+inline const std::vector<FlacSeekPoint> &FlacStream::seekTable() const
+{
+    return m_seekTable;
+}
+
+/*!
+ * \brief Returns the seek points of the "METADATA_BLOCK_SEEKTABLE".
+ * \remarks The seek points are written when making the header (see makeHeader()). Clear the seek points to remove the
+ *          "METADATA_BLOCK_SEEKTABLE".
+ */
+inline std::vector<FlacSeekPoint> &FlacStream::seekTable()
+{
+    return m_seekTable;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_FLACSTREAM_H
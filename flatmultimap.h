@@ -0,0 +1,292 @@
+#ifndef TAG_PARSER_FLATMULTIMAP_H
+#define TAG_PARSER_FLATMULTIMAP_H
+
+#include "./global.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace TagParser {
+
+/*!
+ * \class TagParser::FlatMultiMap
+ * \brief The FlatMultiMap class provides a sorted associative container which allows multiple elements with equivalent keys.
+ *
+ * The interface is a subset of the interface of std::multimap. As with std::multimap, elements with equivalent keys are
+ * kept in the order they have been inserted. However, the elements are stored contiguously within a std::vector sorted by
+ * key. This takes less memory, avoids an allocation per element and makes lookups and iterating faster. On the other hand
+ * inserting and erasing elements requires moving the elements behind and invalidates all iterators, pointers and references
+ * to the elements behind (or to all elements if the capacity needs to be increased).
+ *
+ * \remarks Unlike std::multimap, the key of value_type is not const because the elements need to be move-assignable. The
+ *          key of an element must not be modified via an iterator though.
+ */
+template <class Key, class Value, class Compare = std::less<Key>> class FlatMultiMap {
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<Key, Value> value_type;
+    typedef Compare key_compare;
+    typedef typename std::vector<value_type>::size_type size_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    FlatMultiMap();
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+    bool empty() const;
+    size_type size() const;
+    size_type capacity() const;
+    void reserve(size_type capacity);
+    void clear();
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const;
+    size_type count(const Key &key) const;
+    iterator lower_bound(const Key &key);
+    const_iterator lower_bound(const Key &key) const;
+    iterator upper_bound(const Key &key);
+    const_iterator upper_bound(const Key &key) const;
+    std::pair<iterator, iterator> equal_range(const Key &key);
+    std::pair<const_iterator, const_iterator> equal_range(const Key &key) const;
+
+    iterator insert(const value_type &value);
+    iterator insert(value_type &&value);
+    template <typename... Args> iterator emplace(Args &&... args);
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+    size_type erase(const Key &key);
+
+private:
+    /*!
+     * \brief The KeyComparer struct compares elements with keys using the compare function of the map.
+     */
+    struct KeyComparer {
+        bool operator()(const value_type &lhs, const Key &rhs) const
+        {
+            return Compare()(lhs.first, rhs);
+        }
+        bool operator()(const Key &lhs, const value_type &rhs) const
+        {
+            return Compare()(lhs, rhs.first);
+        }
+    };
+
+    std::vector<value_type> m_elements;
+};
+
+/*!
+ * \brief Constructs an empty map.
+ */
+template <class Key, class Value, class Compare> inline FlatMultiMap<Key, Value, Compare>::FlatMultiMap()
+{
+}
+
+/*!
+ * \brief Returns an iterator to the first element.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::begin() -> iterator
+{
+    return m_elements.begin();
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::begin() const -> const_iterator
+{
+    return m_elements.begin();
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::cbegin() const -> const_iterator
+{
+    return m_elements.cbegin();
+}
+
+/*!
+ * \brief Returns an iterator to the element following the last element.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::end() -> iterator
+{
+    return m_elements.end();
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::end() const -> const_iterator
+{
+    return m_elements.end();
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::cend() const -> const_iterator
+{
+    return m_elements.cend();
+}
+
+/*!
+ * \brief Returns whether the map is empty.
+ */
+template <class Key, class Value, class Compare> inline bool FlatMultiMap<Key, Value, Compare>::empty() const
+{
+    return m_elements.empty();
+}
+
+/*!
+ * \brief Returns the number of elements.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::size() const -> size_type
+{
+    return m_elements.size();
+}
+
+/*!
+ * \brief Returns the number of elements which can be held without allocating more memory.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::capacity() const -> size_type
+{
+    return m_elements.capacity();
+}
+
+/*!
+ * \brief Allocates memory for the specified number of elements in advance.
+ */
+template <class Key, class Value, class Compare> inline void FlatMultiMap<Key, Value, Compare>::reserve(size_type capacity)
+{
+    m_elements.reserve(capacity);
+}
+
+/*!
+ * \brief Removes all elements.
+ */
+template <class Key, class Value, class Compare> inline void FlatMultiMap<Key, Value, Compare>::clear()
+{
+    m_elements.clear();
+}
+
+/*!
+ * \brief Returns an iterator to the first element with the specified \a key or end() if there is no such element.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::find(const Key &key) -> iterator
+{
+    const auto i = lower_bound(key);
+    return i != end() && !Compare()(key, i->first) ? i : end();
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::find(const Key &key) const -> const_iterator
+{
+    const auto i = lower_bound(key);
+    return i != end() && !Compare()(key, i->first) ? i : end();
+}
+
+/*!
+ * \brief Returns the number of elements with the specified \a key.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::count(const Key &key) const -> size_type
+{
+    const auto range = equal_range(key);
+    return static_cast<size_type>(range.second - range.first);
+}
+
+/*!
+ * \brief Returns an iterator to the first element with a key not less than the specified \a key.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::lower_bound(const Key &key) -> iterator
+{
+    return std::lower_bound(m_elements.begin(), m_elements.end(), key, KeyComparer());
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::lower_bound(const Key &key) const -> const_iterator
+{
+    return std::lower_bound(m_elements.begin(), m_elements.end(), key, KeyComparer());
+}
+
+/*!
+ * \brief Returns an iterator to the first element with a key greater than the specified \a key.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::upper_bound(const Key &key) -> iterator
+{
+    return std::upper_bound(m_elements.begin(), m_elements.end(), key, KeyComparer());
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::upper_bound(const Key &key) const -> const_iterator
+{
+    return std::upper_bound(m_elements.begin(), m_elements.end(), key, KeyComparer());
+}
+
+/*!
+ * \brief Returns the range of elements with the specified \a key.
+ */
+template <class Key, class Value, class Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::equal_range(const Key &key) -> std::pair<iterator, iterator>
+{
+    return std::equal_range(m_elements.begin(), m_elements.end(), key, KeyComparer());
+}
+
+template <class Key, class Value, class Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::equal_range(const Key &key) const -> std::pair<const_iterator, const_iterator>
+{
+    return std::equal_range(m_elements.begin(), m_elements.end(), key, KeyComparer());
+}
+
+/*!
+ * \brief Inserts the specified \a value after the elements with an equivalent key.
+ * \returns Returns an iterator to the inserted element.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::insert(const value_type &value) -> iterator
+{
+    return m_elements.insert(upper_bound(value.first), value);
+}
+
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::insert(value_type &&value) -> iterator
+{
+    const auto position = upper_bound(value.first);
+    return m_elements.insert(position, std::move(value));
+}
+
+/*!
+ * \brief Inserts an element constructed from the specified \a args after the elements with an equivalent key.
+ * \returns Returns an iterator to the inserted element.
+ */
+template <class Key, class Value, class Compare>
+template <typename... Args>
+inline auto FlatMultiMap<Key, Value, Compare>::emplace(Args &&... args) -> iterator
+{
+    return insert(value_type(std::forward<Args>(args)...));
+}
+
+/*!
+ * \brief Removes the element at the specified \a position.
+ * \returns Returns an iterator to the element following the removed element.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::erase(const_iterator position) -> iterator
+{
+    return m_elements.erase(position);
+}
+
+/*!
+ * \brief Removes the elements within the specified range.
+ * \returns Returns an iterator to the element following the last removed element.
+ */
+template <class Key, class Value, class Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::erase(const_iterator first, const_iterator last) -> iterator
+{
+    return m_elements.erase(first, last);
+}
+
+/*!
+ * \brief Removes all elements with the specified \a key.
+ * \returns Returns the number of removed elements.
+ */
+template <class Key, class Value, class Compare> inline auto FlatMultiMap<Key, Value, Compare>::erase(const Key &key) -> size_type
+{
+    const auto range = equal_range(key);
+    const auto count = static_cast<size_type>(range.second - range.first);
+    m_elements.erase(range.first, range.second);
+    return count;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_FLATMULTIMAP_H
@@ -36,7 +36,12 @@ public:
 
     TagField();
     TagField(const IdentifierType &id, const TagValue &value);
+    TagField(const IdentifierType &id, TagValue &&value);
+    TagField(const TagField &other) = default;
+    TagField(TagField &&other) = default;
     ~TagField();
+    TagField &operator=(const TagField &other) = default;
+    TagField &operator=(TagField &&other) = default;
 
     const IdentifierType &id() const;
     std::string idToString() const;
@@ -46,6 +51,7 @@ public:
     TagValue &value();
     const TagValue &value() const;
     void setValue(const TagValue &value);
+    void setValue(TagValue &&value);
     void clearValue();
 
     const TypeInfoType &typeInfo() const;
@@ -56,6 +62,9 @@ public:
     bool isDefault() const;
     void setDefault(bool isDefault);
 
+    bool isDirty() const;
+    void setDirty(bool isDirty);
+
     void clear();
 
     bool isAdditionalTypeInfoUsed() const;
@@ -73,6 +82,7 @@ private:
     TypeInfoType m_typeInfo;
     bool m_typeInfoAssigned;
     bool m_default;
+    bool m_dirty;
     std::vector<ImplementationType> m_nestedFields;
 };
 
@@ -86,6 +96,7 @@ TagField<ImplementationType>::TagField()
     , m_typeInfo(TypeInfoType())
     , m_typeInfoAssigned(false)
     , m_default(false)
+    , m_dirty(true)
 {
 }
 
@@ -99,6 +110,21 @@ TagField<ImplementationType>::TagField(const IdentifierType &id, const TagValue
     , m_typeInfo(TypeInfoType())
     , m_typeInfoAssigned(false)
     , m_default(false)
+    , m_dirty(true)
+{
+}
+
+/*!
+ * \brief Constructs a new TagField with the specified \a id moving the specified \a value into the field.
+ */
+template <class ImplementationType>
+TagField<ImplementationType>::TagField(const IdentifierType &id, TagValue &&value)
+    : m_id(id)
+    , m_value(std::move(value))
+    , m_typeInfo(TypeInfoType())
+    , m_typeInfoAssigned(false)
+    , m_default(false)
+    , m_dirty(true)
 {
 }
 
@@ -128,6 +154,7 @@ template <class ImplementationType> inline std::string TagField<ImplementationTy
 template <class ImplementationType> inline void TagField<ImplementationType>::setId(const IdentifierType &id)
 {
     m_id = id;
+    m_dirty = true;
 }
 
 /*!
@@ -136,13 +163,16 @@ template <class ImplementationType> inline void TagField<ImplementationType>::se
 template <class ImplementationType> inline void TagField<ImplementationType>::clearId()
 {
     m_id = IdentifierType();
+    m_dirty = true;
 }
 
 /*!
  * \brief Returns the value of the current TagField.
+ * \remarks Marks the field as dirty because the value might be modified via the returned reference.
  */
 template <class ImplementationType> inline TagValue &TagField<ImplementationType>::value()
 {
+    m_dirty = true;
     return m_value;
 }
 
@@ -160,6 +190,16 @@ template <class ImplementationType> inline const TagValue &TagField<Implementati
 template <class ImplementationType> inline void TagField<ImplementationType>::setValue(const TagValue &value)
 {
     m_value = value;
+    m_dirty = true;
+}
+
+/*!
+ * \brief Sets the value of the current TagField moving the specified \a value into the field.
+ */
+template <class ImplementationType> inline void TagField<ImplementationType>::setValue(TagValue &&value)
+{
+    m_value = std::move(value);
+    m_dirty = true;
 }
 
 /*!
@@ -168,6 +208,7 @@ template <class ImplementationType> inline void TagField<ImplementationType>::se
 template <class ImplementationType> inline void TagField<ImplementationType>::clearValue()
 {
     m_value.clearDataAndMetadata();
+    m_dirty = true;
 }
 
 /*!
@@ -185,6 +226,7 @@ template <class ImplementationType> inline void TagField<ImplementationType>::se
 {
     m_typeInfo = typeInfo;
     m_typeInfoAssigned = true;
+    m_dirty = true;
 }
 
 /*!
@@ -194,6 +236,7 @@ template <class ImplementationType> inline void TagField<ImplementationType>::re
 {
     m_typeInfo = TypeInfoType();
     m_typeInfoAssigned = false;
+    m_dirty = true;
 }
 
 /*!
@@ -218,6 +261,31 @@ template <class ImplementationType> inline bool TagField<ImplementationType>::is
 template <class ImplementationType> inline void TagField<ImplementationType>::setDefault(bool isDefault)
 {
     m_default = isDefault;
+    m_dirty = true;
+}
+
+/*!
+ * \brief Returns whether the field is dirty.
+ *
+ * A field is dirty when it has been modified since it has been parsed or when it has not been parsed at all. All methods which
+ * might modify the field (including the non-const overloads of value() and nestedFields()) mark the field as dirty.
+ *
+ * Tag implementations might use this to copy fields which are not dirty as-is from the original file instead of making them
+ * from scratch.
+ */
+template <class ImplementationType> inline bool TagField<ImplementationType>::isDirty() const
+{
+    return m_dirty;
+}
+
+/*!
+ * \brief Sets whether the field is dirty.
+ * \remarks This is supposed to be called by tag implementations after parsing the field.
+ * \sa isDirty()
+ */
+template <class ImplementationType> inline void TagField<ImplementationType>::setDirty(bool isDirty)
+{
+    m_dirty = isDirty;
 }
 
 /*!
@@ -230,6 +298,7 @@ template <class ImplementationType> void TagField<ImplementationType>::clear()
     m_typeInfo = TypeInfoType();
     m_typeInfoAssigned = false;
     m_default = true;
+    m_dirty = true;
     static_cast<ImplementationType *>(this)->reset();
 }
 
@@ -259,6 +328,7 @@ template <class ImplementationType> const std::vector<ImplementationType> &TagFi
  */
 template <class ImplementationType> inline std::vector<ImplementationType> &TagField<ImplementationType>::nestedFields()
 {
+    m_dirty = true;
     return m_nestedFields;
 }
 
@@ -17,6 +17,7 @@ public:
     const char *typeName() const override;
     bool canEncodingBeUsed(TagTextEncoding encoding) const override;
     const TagValue &value(KnownField value) const override;
+    using Tag::setValue;
     bool setValue(KnownField field, const TagValue &value) override;
     bool setValueConsideringTypeInfo(KnownField field, const TagValue &value, const std::string &typeInfo);
     bool hasField(KnownField field) const override;
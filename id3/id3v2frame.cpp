@@ -4,6 +4,7 @@
 
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../textconversion.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
@@ -37,7 +38,8 @@ constexpr auto maxId3v2FrameDataSize(numeric_limits<uint32>::max() - 15);
  * \brief Constructs a new Id3v2Frame.
  */
 Id3v2Frame::Id3v2Frame()
-    : m_parsedVersion(0)
+    : m_startOffset(0)
+    , m_parsedVersion(0)
     , m_dataSize(0)
     , m_totalSize(0)
     , m_flag(0)
@@ -51,6 +53,22 @@ Id3v2Frame::Id3v2Frame()
  */
 Id3v2Frame::Id3v2Frame(const IdentifierType &id, const TagValue &value, byte group, uint16 flag)
     : TagField<Id3v2Frame>(id, value)
+    , m_startOffset(0)
+    , m_parsedVersion(0)
+    , m_dataSize(0)
+    , m_totalSize(0)
+    , m_flag(flag)
+    , m_group(group)
+    , m_padding(false)
+{
+}
+
+/*!
+ * \brief Constructs a new Id3v2Frame with the specified \a id, \a group and \a flag moving the specified \a value into the frame.
+ */
+Id3v2Frame::Id3v2Frame(const IdentifierType &id, TagValue &&value, byte group, uint16 flag)
+    : TagField<Id3v2Frame>(id, move(value))
+    , m_startOffset(0)
     , m_parsedVersion(0)
     , m_dataSize(0)
     , m_totalSize(0)
@@ -132,77 +150,9 @@ u16string wideStringFromSubstring(tuple<const char *, size_t, const char *> subs
  */
 void Id3v2Frame::parse(BinaryReader &reader, uint32 version, uint32 maximalSize, Diagnostics &diag)
 {
-    static const string defaultContext("parsing ID3v2 frame");
-    string context;
-
     // parse header
-    if (version < 3) {
-        // parse header for ID3v2.1 and ID3v2.2
-        // -> read ID
-        setId(reader.readUInt24BE());
-        if (id() & 0xFFFF0000u) {
-            m_padding = false;
-        } else {
-            // padding reached
-            m_padding = true;
-            diag.emplace_back(DiagLevel::Debug, "Frame ID starts with null-byte -> padding reached.", defaultContext);
-            throw NoDataFoundException();
-        }
-
-        // -> update context
-        context = "parsing " % frameIdString() + " frame";
-
-        // -> read size, check whether frame is truncated
-        m_dataSize = reader.readUInt24BE();
-        m_totalSize = m_dataSize + 6;
-        if (m_totalSize > maximalSize) {
-            diag.emplace_back(DiagLevel::Warning, "The frame is truncated and will be ignored.", context);
-            throw TruncatedDataException();
-        }
-
-        // -> no flags/group in ID3v2.2
-        m_flag = 0;
-        m_group = 0;
-
-    } else {
-        // parse header for ID3v2.3 and ID3v2.4
-        // -> read ID
-        setId(reader.readUInt32BE());
-        if (id() & 0xFF000000u) {
-            m_padding = false;
-        } else {
-            // padding reached
-            m_padding = true;
-            diag.emplace_back(DiagLevel::Debug, "Frame ID starts with null-byte -> padding reached.", defaultContext);
-            throw NoDataFoundException();
-        }
-
-        // -> update context
-        context = "parsing " % frameIdString() + " frame";
-
-        // -> read size, check whether frame is truncated
-        m_dataSize = version >= 4 ? reader.readSynchsafeUInt32BE() : reader.readUInt32BE();
-        m_totalSize = m_dataSize + 10;
-        if (m_totalSize > maximalSize) {
-            diag.emplace_back(DiagLevel::Warning, "The frame is truncated and will be ignored.", context);
-            throw TruncatedDataException();
-        }
-
-        // -> read flags and group
-        m_flag = reader.readUInt16BE();
-        m_group = hasGroupInformation() ? reader.readByte() : 0;
-        if (isEncrypted()) {
-            // encryption is not implemented
-            diag.emplace_back(DiagLevel::Critical, "Encrypted frames aren't supported.", context);
-            throw VersionNotSupportedException();
-        }
-    }
-
-    // frame size mustn't be 0
-    if (m_dataSize <= 0) {
-        diag.emplace_back(DiagLevel::Critical, "The frame size is 0.", context);
-        throw InvalidDataException();
-    }
+    parseHeader(reader, version, maximalSize, diag);
+    const string context("parsing " % frameIdString() + " frame");
 
     // parse the data
     unique_ptr<char[]> buffer;
@@ -295,10 +245,10 @@ void Id3v2Frame::parse(BinaryReader &reader, uint32 version, uint32 maximalSize,
                     const auto milliseconds = [&] {
                         if (dataEncoding == TagTextEncoding::Utf16BigEndian || dataEncoding == TagTextEncoding::Utf16LittleEndian) {
                             const auto parsedStringRef = parseSubstring(buffer.get() + 1, m_dataSize - 1, dataEncoding, false, diag);
-                            const auto convertedStringData = dataEncoding == TagTextEncoding::Utf16BigEndian
-                                ? convertUtf16BEToUtf8(get<0>(parsedStringRef), get<1>(parsedStringRef))
-                                : convertUtf16LEToUtf8(get<0>(parsedStringRef), get<1>(parsedStringRef));
-                            return string(convertedStringData.first.get(), convertedStringData.second);
+                            string convertedString;
+                            TextConversion::convertString(
+                                get<0>(parsedStringRef), get<1>(parsedStringRef), dataEncoding, TagTextEncoding::Utf8, convertedString);
+                            return convertedString;
                         } else { // Latin-1 or UTF-8
                             return stringFromSubstring(substr);
                         }
@@ -375,6 +325,96 @@ void Id3v2Frame::parse(BinaryReader &reader, uint32 version, uint32 maximalSize,
         // parse unknown/unsupported frame
         value().assignData(buffer.get(), m_dataSize, TagDataType::Undefined);
     }
+
+    // the frame has just been parsed so it is not dirty (although the value has been assigned via value())
+    setDirty(false);
+}
+
+/*!
+ * \brief Parses the header of a frame from the stream read using the specified \a reader.
+ *
+ * The position of the current character in the input stream is expected to be
+ * at the beginning of the frame. Afterwards it is at the beginning of the frame data
+ * (or the decompressed size if the frame is compressed). The data itself is not read.
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing
+ *         error occurs.
+ * \sa parse()
+ */
+void Id3v2Frame::parseHeader(BinaryReader &reader, uint32 version, uint32 maximalSize, Diagnostics &diag)
+{
+    static const string defaultContext("parsing ID3v2 frame");
+    string context;
+    m_startOffset = static_cast<uint64>(reader.stream()->tellg());
+
+    if (version < 3) {
+        // parse header for ID3v2.1 and ID3v2.2
+        // -> read ID
+        setId(reader.readUInt24BE());
+        if (id() & 0xFFFF0000u) {
+            m_padding = false;
+        } else {
+            // padding reached
+            m_padding = true;
+            diag.emplace_back(DiagLevel::Debug, "Frame ID starts with null-byte -> padding reached.", defaultContext);
+            throw NoDataFoundException();
+        }
+
+        // -> update context
+        context = "parsing " % frameIdString() + " frame";
+
+        // -> read size, check whether frame is truncated
+        m_dataSize = reader.readUInt24BE();
+        m_totalSize = m_dataSize + 6;
+        if (m_totalSize > maximalSize) {
+            diag.emplace_back(DiagLevel::Warning, "The frame is truncated and will be ignored.", context);
+            throw TruncatedDataException();
+        }
+
+        // -> no flags/group in ID3v2.2
+        m_flag = 0;
+        m_group = 0;
+
+    } else {
+        // parse header for ID3v2.3 and ID3v2.4
+        // -> read ID
+        setId(reader.readUInt32BE());
+        if (id() & 0xFF000000u) {
+            m_padding = false;
+        } else {
+            // padding reached
+            m_padding = true;
+            diag.emplace_back(DiagLevel::Debug, "Frame ID starts with null-byte -> padding reached.", defaultContext);
+            throw NoDataFoundException();
+        }
+
+        // -> update context
+        context = "parsing " % frameIdString() + " frame";
+
+        // -> read size, check whether frame is truncated
+        m_dataSize = version >= 4 ? reader.readSynchsafeUInt32BE() : reader.readUInt32BE();
+        m_totalSize = m_dataSize + 10;
+        if (m_totalSize > maximalSize) {
+            diag.emplace_back(DiagLevel::Warning, "The frame is truncated and will be ignored.", context);
+            throw TruncatedDataException();
+        }
+
+        // -> read flags and group
+        m_flag = reader.readUInt16BE();
+        m_group = hasGroupInformation() ? reader.readByte() : 0;
+        if (isEncrypted()) {
+            // encryption is not implemented
+            diag.emplace_back(DiagLevel::Critical, "Encrypted frames aren't supported.", context);
+            throw VersionNotSupportedException();
+        }
+    }
+
+    // frame size mustn't be 0
+    if (m_dataSize <= 0) {
+        diag.emplace_back(DiagLevel::Critical, "The frame size is 0.", context);
+        throw InvalidDataException();
+    }
 }
 
 /*!
@@ -410,6 +450,7 @@ void Id3v2Frame::make(BinaryWriter &writer, byte version, Diagnostics &diag)
  */
 void Id3v2Frame::reset()
 {
+    m_startOffset = 0;
     m_flag = 0;
     m_group = 0;
     m_parsedVersion = 0;
@@ -437,7 +478,7 @@ Id3v2FrameMaker::Id3v2FrameMaker(Id3v2Frame &frame, byte version, Diagnostics &d
     const string context("making " % m_frame.frameIdString() + " frame");
 
     // validate assigned data
-    const auto value(m_frame.value());
+    const TagValue &value(static_cast<const Id3v2Frame &>(m_frame).value());
     if (value.isEmpty()) {
         diag.emplace_back(DiagLevel::Critical, "Cannot make an empty frame.", context);
         throw InvalidDataException();
@@ -987,7 +1028,8 @@ void Id3v2Frame::makeLegacyPicture(unique_ptr<char[]> &buffer, uint32 &bufferSiz
     if (descriptionEncoding == TagTextEncoding::Utf8) {
         // UTF-8 is only supported by ID3v2.4, so convert back to UTF-16
         descriptionEncoding = TagTextEncoding::Utf16LittleEndian;
-        convertedDescription = convertUtf8ToUtf16LE(picture.description().data(), descriptionSize);
+        convertedDescription = TextConversion::convertString(
+            picture.description().data(), descriptionSize, TagTextEncoding::Utf8, TagTextEncoding::Utf16LittleEndian);
         descriptionSize = convertedDescription.second;
     }
     // calculate needed buffer size and create buffer
@@ -1051,7 +1093,8 @@ void Id3v2Frame::makePicture(std::unique_ptr<char[]> &buffer, uint32 &bufferSize
     if (version < 4 && descriptionEncoding == TagTextEncoding::Utf8) {
         // UTF-8 is only supported by ID3v2.4, so convert back to UTF-16
         descriptionEncoding = TagTextEncoding::Utf16LittleEndian;
-        convertedDescription = convertUtf8ToUtf16LE(picture.description().data(), descriptionSize);
+        convertedDescription = TextConversion::convertString(
+            picture.description().data(), descriptionSize, TagTextEncoding::Utf8, TagTextEncoding::Utf16LittleEndian);
         descriptionSize = convertedDescription.second;
     }
     // determine mime-type
@@ -1114,7 +1157,8 @@ void Id3v2Frame::makeComment(unique_ptr<char[]> &buffer, uint32 &bufferSize, con
     if (version < 4 && encoding == TagTextEncoding::Utf8) {
         // UTF-8 is only supported by ID3v2.4, so convert back to UTF-16
         encoding = TagTextEncoding::Utf16LittleEndian;
-        convertedDescription = convertUtf8ToUtf16LE(comment.description().data(), descriptionSize);
+        convertedDescription = TextConversion::convertString(
+            comment.description().data(), descriptionSize, TagTextEncoding::Utf8, TagTextEncoding::Utf16LittleEndian);
         descriptionSize = convertedDescription.second;
     }
     // calculate needed buffer size and create buffer
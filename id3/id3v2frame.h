@@ -87,9 +87,11 @@ class TAG_PARSER_EXPORT Id3v2Frame : public TagField<Id3v2Frame> {
 public:
     Id3v2Frame();
     Id3v2Frame(const IdentifierType &id, const TagValue &value, byte group = 0, uint16 flag = 0);
+    Id3v2Frame(const IdentifierType &id, TagValue &&value, byte group = 0, uint16 flag = 0);
 
     // parsing/making
     void parse(IoUtilities::BinaryReader &reader, uint32 version, uint32 maximalSize, Diagnostics &diag);
+    void parseHeader(IoUtilities::BinaryReader &reader, uint32 version, uint32 maximalSize, Diagnostics &diag);
     Id3v2FrameMaker prepareMaking(byte version, Diagnostics &diag);
     void make(IoUtilities::BinaryWriter &writer, byte version, Diagnostics &diag);
 
@@ -98,6 +100,7 @@ public:
     bool isValid() const;
     bool hasPaddingReached() const;
     std::string frameIdString() const;
+    uint64 startOffset() const;
     uint16 flag() const;
     void setFlag(uint16 value);
     uint32 totalSize() const;
@@ -140,6 +143,7 @@ public:
 
 private:
     void reset();
+    uint64 m_startOffset;
     uint32 m_parsedVersion;
     uint32 m_dataSize;
     uint32 m_totalSize;
@@ -181,6 +185,14 @@ inline std::string Id3v2Frame::frameIdString() const
     return idToString();
 }
 
+/*!
+ * \brief Returns the start offset of the frame in the stream it has been parsed from.
+ */
+inline uint64 Id3v2Frame::startOffset() const
+{
+    return m_startOffset;
+}
+
 /*!
  * \brief Returns the flags.
  */
@@ -195,6 +207,7 @@ inline uint16 Id3v2Frame::flag() const
 inline void Id3v2Frame::setFlag(uint16 value)
 {
     m_flag = value;
+    setDirty(true);
 }
 
 /*!
@@ -293,6 +306,7 @@ inline byte Id3v2Frame::group() const
 inline void Id3v2Frame::setGroup(byte value)
 {
     m_group = value;
+    setDirty(true);
 }
 
 /*!
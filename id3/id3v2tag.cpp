@@ -3,10 +3,14 @@
 
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../paddinghelper.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/catchiofailure.h>
+#include <c++utilities/io/copy.h>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -18,6 +22,9 @@ namespace TagParser {
 /*!
  * \class TagParser::Id3v2Tag
  * \brief Implementation of TagParser::Tag for ID3v2 tags.
+ *
+ * When making a parsed tag without changing its version, frames which have not been modified can be copied as-is
+ * from the stream the tag has been parsed from instead of making them from scratch. See prepareMaking() for details.
  */
 
 Id3v2Tag::IdentifierType Id3v2Tag::internallyGetFieldId(KnownField field) const
@@ -239,11 +246,28 @@ TagDataType Id3v2Tag::internallyGetProposedDataType(const uint32 &id) const
 /*!
  * \brief Parses tag information from the specified \a stream.
  *
+ * When \a parsingLazily is set, only the frame headers are read and the location of each frame is recorded (see
+ * pendingFrames()) instead of reading, decompressing and decoding its data. Frames are only decoded when explicitly
+ * requested via decodeFrames(). Frames which have not been decoded when making the tag are copied byte-for-byte from the
+ * \a stream, so the \a stream must stay open and unmodified until the tag has been made or all frames have been decoded.
+ *
+ * \remarks Frames which have not been decoded yet are not visible via the Tag API: They are not contained by fields(),
+ *          their values are not returned by value() and values() and they are not taken into account by hasField() and
+ *          fieldCount(). They are only kept to be made. Setting a value via setValue() or setValues() replaces the frames
+ *          with the same ID which have not been decoded yet and insertValues() does not overwrite them unless overwriting
+ *          is requested. MediaFileInfo decodes the frames before transferring values to other tags.
+ * \remarks When inserting fields from another tag (see insertFields() and insertValues()), frames of the other tag which
+ *          have not been decoded yet are only taken over if both tags have been parsed from the same stream and with the
+ *          same version. Otherwise they need to be decoded before.
+ * \remarks The tag only refers to the \a stream when parsing lazily. The reference is dropped when all frames have been
+ *          decoded (eg. via decodeFrames()) or removed.
+ * \sa MediaFileInfo::isParsingId3v2TagsLazily()
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void Id3v2Tag::parse(istream &stream, const uint64 maximalSize, Diagnostics &diag)
+void Id3v2Tag::parse(istream &stream, const uint64 maximalSize, Diagnostics &diag, bool parsingLazily)
 {
     // prepare parsing
     static const string context("parsing ID3v2 tag");
@@ -302,17 +326,34 @@ void Id3v2Tag::parse(istream &stream, const uint64 maximalSize, Diagnostics &dia
 
     // read frames
     auto pos = static_cast<uint64>(stream.tellg());
+    m_stream = parsingLazily ? &stream : nullptr;
+    m_parsedMajorVersion = majorVersion;
     while (bytesRemaining) {
         // seek to next frame
         stream.seekg(static_cast<streamoff>(pos));
-        // parse frame
+        // parse frame (only its header when parsing lazily)
         Id3v2Frame frame;
         try {
-            frame.parse(reader, majorVersion, bytesRemaining, diag);
-            if (Id3v2FrameIds::isTextFrame(frame.id()) && fields().count(frame.id()) == 1) {
-                diag.emplace_back(DiagLevel::Warning, "The text frame " % frame.frameIdString() + " exists more than once.", context);
+            if (parsingLazily) {
+                frame.parseHeader(reader, majorVersion, bytesRemaining, diag);
+                if (Id3v2FrameIds::isTextFrame(frame.id())
+                    && any_of(m_pendingFrames.cbegin(), m_pendingFrames.cend(),
+                           [&frame](const Id3v2FrameIndexEntry &entry) { return entry.id == frame.id(); })) {
+                    diag.emplace_back(DiagLevel::Warning, "The text frame " % frame.frameIdString() + " exists more than once.", context);
+                }
+                m_pendingFrames.emplace_back();
+                Id3v2FrameIndexEntry &entry = m_pendingFrames.back();
+                entry.offset = pos;
+                entry.id = frame.id();
+                entry.totalSize = frame.totalSize();
+                entry.flags = frame.flag();
+            } else {
+                frame.parse(reader, majorVersion, bytesRemaining, diag);
+                if (Id3v2FrameIds::isTextFrame(frame.id()) && fields().count(frame.id()) == 1) {
+                    diag.emplace_back(DiagLevel::Warning, "The text frame " % frame.frameIdString() + " exists more than once.", context);
+                }
+                fields().emplace(frame.id(), move(frame));
             }
-            fields().emplace(frame.id(), move(frame));
         } catch (const NoDataFoundException &) {
             if (frame.hasPaddingReached()) {
                 m_paddingSize = startOffset + m_size - pos;
@@ -349,19 +390,258 @@ void Id3v2Tag::parse(istream &stream, const uint64 maximalSize, Diagnostics &dia
     }
 }
 
+/*!
+ * \brief Decodes all frames which have not been decoded yet.
+ *
+ * Frames which can not be decoded are dropped and the reason is added to \a diag.
+ *
+ * Afterwards the tag does not refer to the stream it has been parsed from anymore so the stream might be closed
+ * or destroyed.
+ *
+ * \remarks Decoding frames adds them to fields() which invalidates references to fields and values.
+ * \sa parse()
+ */
+void Id3v2Tag::decodeFrames(Diagnostics &diag)
+{
+    for (const Id3v2FrameIndexEntry &entry : m_pendingFrames) {
+        decodeFrame(entry, diag);
+    }
+    m_pendingFrames.clear();
+    m_stream = nullptr;
+}
+
+/*!
+ * \brief Decodes the frames with the specified \a id which have not been decoded yet.
+ *
+ * This is useful to access only certain values without decoding the whole tag. Frames which can not be decoded are
+ * dropped and the reason is added to \a diag.
+ *
+ * \remarks Decoding frames adds them to fields() which invalidates references to fields and values.
+ * \sa decodeFrames(Diagnostics &), parse()
+ */
+void Id3v2Tag::decodeFrames(const IdentifierType &id, Diagnostics &diag)
+{
+    const FrameComparer compare;
+    for (auto i = m_pendingFrames.begin(); i != m_pendingFrames.end();) {
+        if (compare(i->id, id) || compare(id, i->id)) {
+            ++i;
+            continue;
+        }
+        decodeFrame(*i, diag);
+        i = m_pendingFrames.erase(i);
+    }
+    if (m_pendingFrames.empty()) {
+        m_stream = nullptr;
+    }
+}
+
+/*!
+ * \brief Decodes the pending frame at the specified \a entry and adds it to the fields.
+ * \remarks Does not remove the \a entry from the pending frames.
+ */
+void Id3v2Tag::decodeFrame(const Id3v2FrameIndexEntry &entry, Diagnostics &diag)
+{
+    static const string context("decoding ID3v2 frame");
+    Id3v2Frame frame;
+    try {
+        BinaryReader reader(m_stream);
+        m_stream->seekg(static_cast<streamoff>(entry.offset));
+        frame.parse(reader, m_parsedMajorVersion, entry.totalSize, diag);
+        fields().emplace(frame.id(), move(frame));
+    } catch (const Failure &) {
+    } catch (...) {
+        const char *const what = catchIoFailure();
+        diag.emplace_back(DiagLevel::Critical, argsToString("An IO error occured when decoding the frame at ", entry.offset, ": ", what), context);
+        m_stream->clear();
+    }
+}
+
+/*!
+ * \brief Returns the first frame with the specified \a id which has not been decoded yet.
+ */
+std::vector<Id3v2FrameIndexEntry>::const_iterator Id3v2Tag::findPendingFrame(const IdentifierType &id) const
+{
+    const FrameComparer compare;
+    return find_if(m_pendingFrames.cbegin(), m_pendingFrames.cend(),
+        [&compare, &id](const Id3v2FrameIndexEntry &entry) { return !compare(entry.id, id) && !compare(id, entry.id); });
+}
+
+/*!
+ * \brief Removes the frames (or only the first frame if \a onlyFirst is set) with the specified \a id which have not been
+ *        decoded yet.
+ * \returns Returns whether at least one frame has been removed.
+ */
+bool Id3v2Tag::removePendingFrames(const IdentifierType &id, bool onlyFirst)
+{
+    const FrameComparer compare;
+    const auto end = m_pendingFrames.end();
+    auto i = onlyFirst ? m_pendingFrames.begin() + (findPendingFrame(id) - m_pendingFrames.cbegin())
+                       : remove_if(m_pendingFrames.begin(), end,
+                             [&compare, &id](const Id3v2FrameIndexEntry &entry) { return !compare(entry.id, id) && !compare(id, entry.id); });
+    if (i == end) {
+        return false;
+    }
+    m_pendingFrames.erase(i, onlyFirst ? i + 1 : end);
+    return true;
+}
+
+bool Id3v2Tag::internallySetValue(const IdentifierType &id, const TagValue &value)
+{
+    // replace the first frame which has not been decoded yet unless there is already a decoded frame
+    if (fields().find(id) == fields().end() && removePendingFrames(id, true) && value.isEmpty()) {
+        return true;
+    }
+    return FieldMapBasedTag<Id3v2Tag>::internallySetValue(id, value);
+}
+
+bool Id3v2Tag::internallySetValue(const IdentifierType &id, TagValue &&value)
+{
+    // replace the first frame which has not been decoded yet unless there is already a decoded frame
+    if (fields().find(id) == fields().end() && removePendingFrames(id, true) && value.isEmpty()) {
+        return true;
+    }
+    return FieldMapBasedTag<Id3v2Tag>::internallySetValue(id, move(value));
+}
+
+bool Id3v2Tag::internallySetValues(const IdentifierType &id, const std::vector<TagValue> &values)
+{
+    // replace all frames which have not been decoded yet
+    removePendingFrames(id, false);
+    return FieldMapBasedTag<Id3v2Tag>::internallySetValues(id, values);
+}
+
+bool Id3v2Tag::internallySetValues(const IdentifierType &id, std::vector<TagValue> &&values)
+{
+    // replace all frames which have not been decoded yet
+    removePendingFrames(id, false);
+    return FieldMapBasedTag<Id3v2Tag>::internallySetValues(id, move(values));
+}
+
+void Id3v2Tag::removeAllFields()
+{
+    m_pendingFrames.clear();
+    m_stream = nullptr;
+    FieldMapBasedTag<Id3v2Tag>::removeAllFields();
+}
+
+/*!
+ * \brief Inserts all values \a from another tag.
+ * \remarks Frames which have not been decoded yet are considered to have a value. See insertFields() for how frames of
+ *          \a from which have not been decoded yet are handled.
+ * \sa Tag::insertValues()
+ */
+unsigned int Id3v2Tag::insertValues(const Tag &from, bool overwrite)
+{
+    if (from.type() == TagType::Id3v2Tag) {
+        return static_cast<unsigned int>(insertFields(static_cast<const Id3v2Tag &>(from), overwrite));
+    }
+    if (overwrite || m_pendingFrames.empty()) {
+        return FieldMapBasedTag<Id3v2Tag>::insertValues(from, overwrite);
+    }
+    unsigned int count = 0;
+    for (int i = static_cast<int>(KnownField::Invalid) + 1, last = static_cast<int>(KnownField::Description); i <= last; ++i) {
+        const auto field = static_cast<KnownField>(i);
+        if (!value(field).isEmpty() || findPendingFrame(fieldId(field)) != m_pendingFrames.cend()) {
+            continue;
+        }
+        const TagValue &otherValue = from.value(field);
+        if (!otherValue.isEmpty() && setValue(field, otherValue)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/*!
+ * \brief Inserts all fields \a from another ID3v2 tag.
+ *
+ * Frames which have not been decoded yet are considered to have a value. Frames of \a from which have not been decoded
+ * yet are taken over if both tags have been parsed from the same stream and with the same version. Otherwise they are
+ * not taken into account and need to be decoded before (see parse()).
+ *
+ * \sa FieldMapBasedTag::insertFields()
+ */
+int Id3v2Tag::insertFields(const Id3v2Tag &from, bool overwrite)
+{
+    if (&from == this) {
+        return 0;
+    }
+    int fieldsInserted = 0;
+    auto ownPendingFrameCount = m_pendingFrames.size();
+    for (const auto &pair : from.fields()) {
+        const Id3v2Frame &fromFrame = pair.second;
+        if (!fromFrame.value().isEmpty() && findPendingFrame(fromFrame.id()) != m_pendingFrames.cend()) {
+            if (!overwrite) {
+                continue;
+            }
+            removePendingFrames(fromFrame.id(), false);
+        }
+        fieldsInserted += insertField(fromFrame, overwrite);
+    }
+
+    // take over frames which have not been decoded yet if they can be copied from the same stream
+    if (from.m_pendingFrames.empty() || !from.m_stream || (m_stream && m_stream != from.m_stream)
+        || (m_parsedMajorVersion && m_parsedMajorVersion != from.m_parsedMajorVersion)) {
+        return fieldsInserted;
+    }
+    const FrameComparer compare;
+    for (const Id3v2FrameIndexEntry &entry : from.m_pendingFrames) {
+        const auto ownPendingFramesEnd = m_pendingFrames.cbegin() + static_cast<std::ptrdiff_t>(ownPendingFrameCount);
+        const bool present = fields().find(entry.id) != fields().end()
+            || find_if(m_pendingFrames.cbegin(), ownPendingFramesEnd,
+                   [&compare, &entry](const Id3v2FrameIndexEntry &own) { return !compare(own.id, entry.id) && !compare(entry.id, own.id); })
+                != ownPendingFramesEnd;
+        if (present) {
+            if (!overwrite) {
+                continue;
+            }
+            fields().erase(entry.id);
+            const auto sizeBefore = m_pendingFrames.size();
+            removePendingFrames(entry.id, false);
+            ownPendingFrameCount -= sizeBefore - m_pendingFrames.size();
+        }
+        m_pendingFrames.push_back(entry);
+        ++fieldsInserted;
+    }
+    m_stream = from.m_stream;
+    m_parsedMajorVersion = from.m_parsedMajorVersion;
+    return fieldsInserted;
+}
+
 /*!
  * \brief Prepares making.
  * \returns Returns a Id3v2TagMaker object which can be used to actually make the tag.
  * \remarks The tag must NOT be mutated after making is prepared when it is intended to actually
  *          make the tag using the make method of the returned object.
+ * \remarks Frames which have not been decoded yet (see parse()) are copied as-is from the
+ *          stream the tag has been parsed from. If the version has been changed they are decoded instead.
  * \throws Throws TagParser::Failure or a derived exception when a making error occurs.
+ * \throws Throws std::ios_base::failure when an IO error occurs when decoding frames which have
+ *         not been decoded yet.
  *
  * This method might be useful when it is necessary to know the size of the tag before making it.
  * \sa make()
  */
 Id3v2TagMaker Id3v2Tag::prepareMaking(Diagnostics &diag)
 {
-    return Id3v2TagMaker(*this, diag);
+    return Id3v2TagMaker(*this, m_stream, diag);
+}
+
+/*!
+ * \brief Prepares making; frames which have not been modified are copied as-is from the specified \a sourceStream.
+ * \returns Returns a Id3v2TagMaker object which can be used to actually make the tag.
+ *
+ * The \a sourceStream must be the stream the tag has been parsed from. Frames which are not dirty (see
+ * TagField::isDirty()) are copied from it instead of making them from scratch unless the version has been
+ * changed. Only the frame headers are read when preparing; the frames are read when actually making the tag
+ * so the source stream (see Id3v2TagMaker::setSourceStream()) must still be valid at this point.
+ *
+ * \remarks When making the tag within the source stream itself, see Id3v2TagMaker::bufferOverwrittenFrames().
+ * \sa prepareMaking()
+ */
+Id3v2TagMaker Id3v2Tag::prepareMaking(istream &sourceStream, Diagnostics &diag)
+{
+    return Id3v2TagMaker(*this, &sourceStream, diag);
 }
 
 /*!
@@ -459,9 +739,10 @@ bool FrameComparer::operator()(const uint32 &lhsRef, const uint32 &rhsRef) const
  * \brief Prepares making the specified \a tag.
  * \sa See Id3v2Tag::prepareMaking() for more information.
  */
-Id3v2TagMaker::Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag)
+Id3v2TagMaker::Id3v2TagMaker(Id3v2Tag &tag, istream *sourceStream, Diagnostics &diag)
     : m_tag(tag)
     , m_framesSize(0)
+    , m_sourceStream(sourceStream)
 {
     static const string context("making ID3v2 tag");
 
@@ -472,24 +753,103 @@ Id3v2TagMaker::Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag)
         throw VersionNotSupportedException();
     }
 
+    // decode pending frames if the version has been changed or there is no stream to copy them from
+    if (!tag.m_pendingFrames.empty() && (tag.m_parsedMajorVersion != tag.majorVersion() || !m_sourceStream)) {
+        tag.decodeFrames(diag);
+    }
+
     // prepare frames
+    // -> copy frames which have not been modified as-is if the version has not been changed
+    //    (only check whether the frame is still present, it is read when making the tag)
+    const bool copyingUnmodifiedFrames = m_sourceStream && tag.m_parsedMajorVersion == tag.majorVersion();
+    // -> copy frames which have not been decoded as-is at the position they would have when being decoded
+    vector<Id3v2FrameIndexEntry> pendingFrames(tag.m_pendingFrames);
+    const FrameComparer compare;
+    stable_sort(pendingFrames.begin(), pendingFrames.end(),
+        [&compare](const Id3v2FrameIndexEntry &lhs, const Id3v2FrameIndexEntry &rhs) { return compare(lhs.id, rhs.id); });
+    auto pendingFrame = pendingFrames.cbegin();
+    const auto copyPendingFrames = [this, &pendingFrame, &pendingFrames](const auto &goesBefore) {
+        for (; pendingFrame != pendingFrames.cend() && goesBefore(*pendingFrame); ++pendingFrame) {
+            m_copiedFrames.emplace_back(CopiedFrame{ *pendingFrame, m_maker.size(), nullptr });
+            m_framesSize += pendingFrame->totalSize;
+        }
+    };
+    BinaryReader reader(m_sourceStream);
     m_maker.reserve(tag.fields().size());
     for (auto &pair : tag.fields()) {
+        Id3v2Frame &frame = pair.second;
+        copyPendingFrames([&compare, &frame](const Id3v2FrameIndexEntry &entry) { return !compare(frame.id(), entry.id); });
+        if (copyingUnmodifiedFrames && !frame.isDirty()) {
+            try {
+                m_sourceStream->seekg(static_cast<streamoff>(frame.startOffset()));
+                if ((Id3v2FrameIds::isLongId(frame.id()) ? reader.readUInt32BE() : reader.readUInt24BE()) == frame.id()) {
+                    m_copiedFrames.emplace_back(
+                        CopiedFrame{ { frame.startOffset(), frame.id(), frame.totalSize(), frame.flag() }, m_maker.size(), nullptr });
+                    m_framesSize += frame.totalSize();
+                    continue;
+                }
+                diag.emplace_back(DiagLevel::Warning,
+                    "The " % frame.frameIdString() + " frame can not be copied from the original file. Making it from scratch instead.", context);
+            } catch (...) {
+                const char *const what = catchIoFailure();
+                diag.emplace_back(DiagLevel::Warning,
+                    argsToString("An IO error occured when copying the ", frame.frameIdString(), " frame from the original file: ", what,
+                        ". Making it from scratch instead."),
+                    context);
+                m_sourceStream->clear();
+            }
+        }
         try {
-            m_maker.emplace_back(pair.second.prepareMaking(tag.majorVersion(), diag));
+            m_maker.emplace_back(frame.prepareMaking(tag.majorVersion(), diag));
             m_framesSize += m_maker.back().requiredSize();
         } catch (const Failure &) {
         }
     }
 
+    copyPendingFrames([](const Id3v2FrameIndexEntry &) { return true; });
+
     // calculate required size
     // -> header + size of frames
     m_requiredSize = 10 + m_framesSize;
 }
 
+/*!
+ * \brief Buffers the frames which are copied as-is but would be overwritten before being copied.
+ *
+ * Frames which are copied as-is are read from the source stream when making the tag. When writing the tag to the
+ * source stream itself (eg. when updating a file in-place), frames located before their new position would be
+ * overwritten before being read. This method reads these frames so they are written from the buffer instead.
+ *
+ * \param targetOffset Specifies the offset the tag will be written to. All data before that offset is assumed to be
+ *                     overwritten as well.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void Id3v2TagMaker::bufferOverwrittenFrames(uint64 targetOffset)
+{
+    // determine the new offset of each frame (assuming the header has been written already)
+    uint64 offset = targetOffset + 10;
+    auto copiedFrame = m_copiedFrames.begin();
+    const auto copiedFramesEnd = m_copiedFrames.end();
+    for (size_t makerIndex = 0, makerCount = m_maker.size();; ++makerIndex) {
+        for (; copiedFrame != copiedFramesEnd && copiedFrame->makerIndex == makerIndex; ++copiedFrame) {
+            if (!copiedFrame->buffer && copiedFrame->location.offset < offset) {
+                copiedFrame->buffer = make_unique<char[]>(copiedFrame->location.totalSize);
+                m_sourceStream->seekg(static_cast<streamoff>(copiedFrame->location.offset));
+                m_sourceStream->read(copiedFrame->buffer.get(), copiedFrame->location.totalSize);
+            }
+            offset += copiedFrame->location.totalSize;
+        }
+        if (makerIndex == makerCount) {
+            break;
+        }
+        offset += m_maker[makerIndex].requiredSize();
+    }
+}
+
 /*!
  * \brief Saves the tag (specified when constructing the object) to the
  *        specified \a stream.
+ * \remarks Frames which are copied as-is are read from sourceStream().
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws Assumes the data is already validated and thus does NOT
  *                throw TagParser::Failure or a derived exception.
@@ -512,14 +872,28 @@ void Id3v2TagMaker::make(std::ostream &stream, uint32 padding, Diagnostics &diag
     writer.writeSynchsafeUInt32BE(m_framesSize + padding);
 
     // write frames
-    for (auto &maker : m_maker) {
-        maker.make(writer);
+    CopyHelper<0x2000> copyHelper;
+    auto copiedFrame = m_copiedFrames.cbegin();
+    const auto copiedFramesEnd = m_copiedFrames.cend();
+    for (size_t makerIndex = 0, makerCount = m_maker.size();; ++makerIndex) {
+        // -> frames which are copied as-is (from the buffer if they have been buffered)
+        for (; copiedFrame != copiedFramesEnd && copiedFrame->makerIndex == makerIndex; ++copiedFrame) {
+            if (copiedFrame->buffer) {
+                stream.write(copiedFrame->buffer.get(), copiedFrame->location.totalSize);
+            } else {
+                m_sourceStream->seekg(static_cast<streamoff>(copiedFrame->location.offset));
+                copyHelper.copy(*m_sourceStream, stream, copiedFrame->location.totalSize);
+            }
+        }
+        if (makerIndex == makerCount) {
+            break;
+        }
+        // -> frames which are made from scratch
+        m_maker[makerIndex].make(writer);
     }
 
     // write padding
-    for (; padding; --padding) {
-        stream.put(0);
-    }
+    PaddingHelper::writeZeroes(stream, padding);
 }
 
 } // namespace TagParser
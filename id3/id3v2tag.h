@@ -3,6 +3,7 @@
 
 #include "./id3v2frame.h"
 
+#include "../diagnostics.h"
 #include "../fieldbasedtag.h"
 
 #include <map>
@@ -11,6 +12,21 @@ namespace TagParser {
 
 class Id3v2Tag;
 
+/*!
+ * \brief The Id3v2FrameIndexEntry struct describes the location of a frame which has not been decoded yet.
+ * \sa Id3v2Tag::parse()
+ */
+struct TAG_PARSER_EXPORT Id3v2FrameIndexEntry {
+    /// \brief Specifies the start offset of the frame header.
+    uint64 offset = 0;
+    /// \brief Specifies the frame ID.
+    uint32 id = 0;
+    /// \brief Specifies the size of the frame including the header.
+    uint32 totalSize = 0;
+    /// \brief Specifies the flags of the frame.
+    uint16 flags = 0;
+};
+
 struct TAG_PARSER_EXPORT FrameComparer {
     bool operator()(const uint32 &lhs, const uint32 &rhs) const;
 };
@@ -22,14 +38,31 @@ public:
     void make(std::ostream &stream, uint32 padding, Diagnostics &diag);
     const Id3v2Tag &tag() const;
     uint64 requiredSize() const;
+    std::istream *sourceStream() const;
+    void setSourceStream(std::istream *sourceStream);
+    void bufferOverwrittenFrames(uint64 targetOffset);
 
 private:
-    Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag);
+    /*!
+     * \brief The CopiedFrame struct describes a frame which is copied as-is from the source stream.
+     */
+    struct CopiedFrame {
+        /// \brief Specifies the location of the frame within the source stream.
+        Id3v2FrameIndexEntry location;
+        /// \brief Specifies the number of frames (from m_maker) which are written before the frame.
+        std::size_t makerIndex;
+        /// \brief Holds the frame if it has been buffered via bufferOverwrittenFrames().
+        std::unique_ptr<char[]> buffer;
+    };
+
+    Id3v2TagMaker(Id3v2Tag &tag, std::istream *sourceStream, Diagnostics &diag);
 
     Id3v2Tag &m_tag;
     uint32 m_framesSize;
     uint32 m_requiredSize;
     std::vector<Id3v2FrameMaker> m_maker;
+    std::vector<CopiedFrame> m_copiedFrames;
+    std::istream *m_sourceStream;
 };
 
 /*!
@@ -49,6 +82,25 @@ inline uint64 Id3v2TagMaker::requiredSize() const
     return m_requiredSize;
 }
 
+/*!
+ * \brief Returns the stream frames which are copied as-is are read from.
+ */
+inline std::istream *Id3v2TagMaker::sourceStream() const
+{
+    return m_sourceStream;
+}
+
+/*!
+ * \brief Sets the stream frames which are copied as-is are read from.
+ *
+ * The stream must provide the same contents as the stream passed to Id3v2Tag::prepareMaking(). This is useful when
+ * the original file has been moved (eg. to create a backup) before actually making the tag.
+ */
+inline void Id3v2TagMaker::setSourceStream(std::istream *sourceStream)
+{
+    m_sourceStream = sourceStream;
+}
+
 /*!
  * \brief Defines traits for the TagField implementation of the Id3v2Tag class.
  */
@@ -60,6 +112,7 @@ public:
 
 class TAG_PARSER_EXPORT Id3v2Tag : public FieldMapBasedTag<Id3v2Tag> {
     friend class FieldMapBasedTag<Id3v2Tag>;
+    friend class Id3v2TagMaker;
 
 public:
     Id3v2Tag();
@@ -72,9 +125,17 @@ public:
     bool supportsDescription(KnownField field) const override;
     bool supportsMimeType(KnownField field) const override;
 
-    void parse(std::istream &sourceStream, const uint64 maximalSize, Diagnostics &diag);
+    void removeAllFields() override;
+    unsigned int insertValues(const Tag &from, bool overwrite) override;
+    int insertFields(const Id3v2Tag &from, bool overwrite);
+
+    void parse(std::istream &sourceStream, const uint64 maximalSize, Diagnostics &diag, bool parsingLazily = false);
     Id3v2TagMaker prepareMaking(Diagnostics &diag);
+    Id3v2TagMaker prepareMaking(std::istream &sourceStream, Diagnostics &diag);
     void make(std::ostream &targetStream, uint32 padding, Diagnostics &diag);
+    const std::vector<Id3v2FrameIndexEntry> &pendingFrames() const;
+    void decodeFrames(Diagnostics &diag);
+    void decodeFrames(const IdentifierType &id, Diagnostics &diag);
 
     byte majorVersion() const;
     byte revisionVersion() const;
@@ -92,14 +153,25 @@ protected:
     IdentifierType internallyGetFieldId(KnownField field) const;
     KnownField internallyGetKnownField(const IdentifierType &id) const;
     TagDataType internallyGetProposedDataType(const uint32 &id) const;
+    bool internallySetValue(const IdentifierType &id, const TagValue &value);
+    bool internallySetValue(const IdentifierType &id, TagValue &&value);
+    bool internallySetValues(const IdentifierType &id, const std::vector<TagValue> &values);
+    bool internallySetValues(const IdentifierType &id, std::vector<TagValue> &&values);
 
 private:
+    void decodeFrame(const Id3v2FrameIndexEntry &entry, Diagnostics &diag);
+    std::vector<Id3v2FrameIndexEntry>::const_iterator findPendingFrame(const IdentifierType &id) const;
+    bool removePendingFrames(const IdentifierType &id, bool onlyFirst);
+
     byte m_majorVersion;
     byte m_revisionVersion;
     byte m_flags;
     uint32 m_sizeExcludingHeader;
     uint32 m_extendedHeaderSize;
     uint32 m_paddingSize;
+    std::istream *m_stream;
+    byte m_parsedMajorVersion;
+    std::vector<Id3v2FrameIndexEntry> m_pendingFrames;
 };
 
 /*!
@@ -112,6 +184,8 @@ inline Id3v2Tag::Id3v2Tag()
     , m_sizeExcludingHeader(0)
     , m_extendedHeaderSize(0)
     , m_paddingSize(0)
+    , m_stream(nullptr)
+    , m_parsedMajorVersion(0)
 {
 }
 
@@ -220,6 +294,15 @@ inline uint32 Id3v2Tag::paddingSize() const
     return m_paddingSize;
 }
 
+/*!
+ * \brief Returns the frames which have not been decoded yet.
+ * \sa parse()
+ */
+inline const std::vector<Id3v2FrameIndexEntry> &Id3v2Tag::pendingFrames() const
+{
+    return m_pendingFrames;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_ID3V2TAG_H
@@ -11,6 +11,9 @@
 #include <c++utilities/io/binaryreader.h>
 #include <c++utilities/io/binarywriter.h>
 
+#include <zlib.h>
+
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <sstream>
@@ -70,11 +73,12 @@ string EbmlElement::parsingContext() const
 void EbmlElement::internalParse(Diagnostics &diag)
 {
     static const string context("parsing EBML element header");
+    const auto parsingContextFunction = [this] { return parsingContext(); };
 
     for (uint64 skipped = 0; skipped < bytesToBeSkipped; ++m_startOffset, --m_maxSize, ++skipped) {
         // check whether max size is valid
         if (maxTotalSize() < 2) {
-            diag.emplace_back(DiagLevel::Critical, argsToString("The EBML element at ", startOffset(), " is truncated or does not exist."), context);
+            diag.emplaceFormatted(DiagLevel::Critical, context, "The EBML element at ", startOffset(), " is truncated or does not exist.");
             throw TruncatedDataException();
         }
         stream().seekg(static_cast<streamoff>(startOffset()));
@@ -89,14 +93,13 @@ void EbmlElement::internalParse(Diagnostics &diag)
         }
         if (m_idLength > maximumIdLengthSupported()) {
             if (!skipped) {
-                diag.emplace_back(
-                    DiagLevel::Critical, argsToString("EBML ID length at ", startOffset(), " is not supported, trying to skip."), context);
+                diag.emplaceFormatted(DiagLevel::Critical, context, "EBML ID length at ", startOffset(), " is not supported, trying to skip.");
             }
             continue; // try again
         }
         if (m_idLength > container().maxIdLength()) {
             if (!skipped) {
-                diag.emplace_back(DiagLevel::Critical, argsToString("EBML ID length at ", startOffset(), " is invalid, trying to skip."), context);
+                diag.emplaceFormatted(DiagLevel::Critical, context, "EBML ID length at ", startOffset(), " is invalid, trying to skip.");
             }
             continue; // try again
         }
@@ -158,13 +161,13 @@ void EbmlElement::internalParse(Diagnostics &diag)
             }
             if (m_sizeLength > maximumSizeLengthSupported()) {
                 if (!skipped) {
-                    diag.emplace_back(DiagLevel::Critical, "EBML size length is not supported.", parsingContext());
+                    diag.emplaceFormatted(DiagLevel::Critical, parsingContextFunction, "EBML size length is not supported.");
                 }
                 continue; // try again
             }
             if (m_sizeLength > container().maxSizeLength()) {
                 if (!skipped) {
-                    diag.emplace_back(DiagLevel::Critical, "EBML size length is invalid.", parsingContext());
+                    diag.emplaceFormatted(DiagLevel::Critical, parsingContextFunction, "EBML size length is invalid.");
                 }
                 continue; // try again
             }
@@ -178,12 +181,12 @@ void EbmlElement::internalParse(Diagnostics &diag)
             if (totalSize() > maxTotalSize()) {
                 if (m_idLength + m_sizeLength > maxTotalSize()) { // header truncated
                     if (!skipped) {
-                        diag.emplace_back(DiagLevel::Critical, "EBML header seems to be truncated.", parsingContext());
+                        diag.emplaceFormatted(DiagLevel::Critical, parsingContextFunction, "EBML header seems to be truncated.");
                     }
                     continue; // try again
                 } else { // data truncated
-                    diag.emplace_back(DiagLevel::Warning, "Data of EBML element seems to be truncated; unable to parse siblings of that element.",
-                        parsingContext());
+                    diag.emplaceFormatted(DiagLevel::Warning, parsingContextFunction,
+                        "Data of EBML element seems to be truncated; unable to parse siblings of that element.");
                     m_dataSize = maxTotalSize() - m_idLength - m_sizeLength; // using max size instead
                 }
             }
@@ -211,7 +214,7 @@ void EbmlElement::internalParse(Diagnostics &diag)
         // no critical errors occured
         // -> add a warning if bytes have been skipped
         if (skipped) {
-            diag.emplace_back(DiagLevel::Warning, argsToString(skipped, " bytes have been skipped"), parsingContext());
+            diag.emplaceFormatted(DiagLevel::Warning, parsingContextFunction, skipped, " bytes have been skipped");
         }
         // -> don't need another try, return here
         return;
@@ -221,6 +224,97 @@ void EbmlElement::internalParse(Diagnostics &diag)
     throw InvalidDataException();
 }
 
+/*!
+ * \brief Reads the header of the EBML element at \a startOffset from \a stream.
+ *
+ * In contrast to parse() no EbmlElement objects are created and no bytes are skipped to recover from invalid data. So this
+ * method is meant to hop quickly over a large number of elements (eg. "Cluster"-elements) where only the ID and size matter.
+ *
+ * \param stream Specifies the stream to read from.
+ * \param startOffset Specifies the start offset of the element.
+ * \param maxTotalSize Specifies the available space, usually the remaining size of the parent.
+ * \param maxIdLength Specifies the max. ID length; see MatroskaContainer::maxIdLength().
+ * \param maxSizeLength Specifies the max. size length; see MatroskaContainer::maxSizeLength().
+ * \throws Throws TruncatedDataException if the element exceeds \a maxTotalSize and InvalidDataException if the ID or
+ *         size denotation is invalid.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+EbmlElementHeader EbmlElement::readHeader(istream &stream, uint64 startOffset, uint64 maxTotalSize, uint32 maxIdLength, uint32 maxSizeLength)
+{
+    if (maxTotalSize < 2) {
+        throw TruncatedDataException();
+    }
+    maxIdLength = min(maxIdLength, maximumIdLengthSupported());
+    maxSizeLength = min(maxSizeLength, maximumSizeLengthSupported());
+
+    // read ID and size denotation at once
+    char header[maximumIdLengthSupported() + maximumSizeLengthSupported()];
+    const auto bytesRead = static_cast<byte>(min<uint64>(maxTotalSize, sizeof(header)));
+    stream.seekg(static_cast<streamoff>(startOffset));
+    stream.read(header, bytesRead);
+
+    EbmlElementHeader res;
+    res.startOffset = startOffset;
+
+    // determine ID
+    byte beg = static_cast<byte>(header[0]), mask = 0x80;
+    for (res.idLength = 1; res.idLength <= maxIdLength && (beg & mask) == 0; ++res.idLength, mask >>= 1)
+        ;
+    if (res.idLength > maxIdLength || res.idLength >= bytesRead) {
+        throw InvalidDataException();
+    }
+    char buf[maximumSizeLengthSupported()] = { 0 };
+    memcpy(buf + (maximumIdLengthSupported() - res.idLength), header, res.idLength);
+    res.id = BE::toUInt32(buf);
+
+    // determine size
+    beg = static_cast<byte>(header[res.idLength]);
+    mask = 0x80;
+    if ((res.sizeUnknown = (beg == 0xFF))) {
+        res.sizeLength = 1;
+        res.dataSize = maxTotalSize - res.headerSize();
+        return res;
+    }
+    for (res.sizeLength = 1; res.sizeLength <= maxSizeLength && (beg & mask) == 0; ++res.sizeLength, mask >>= 1)
+        ;
+    if (res.sizeLength > maxSizeLength || res.headerSize() > bytesRead) {
+        throw InvalidDataException();
+    }
+    memset(buf, 0, sizeof(buf));
+    memcpy(buf + (maximumSizeLengthSupported() - res.sizeLength), header + res.idLength, res.sizeLength);
+    *(buf + (maximumSizeLengthSupported() - res.sizeLength)) ^= mask;
+    res.dataSize = BE::toUInt64(buf);
+    if (res.totalSize() > maxTotalSize) {
+        throw TruncatedDataException();
+    }
+    return res;
+}
+
+/*!
+ * \brief Computes the CRC-32 checksum of the data between \a startOffset and \a endOffset within the specified \a stream.
+ *
+ * The checksum is computed as specified for "CRC-32"-elements (ISO 3309). To compute the checksum of non-contiguous data, the
+ * checksum of the preceding data can be passed as \a crc.
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+uint32 EbmlElement::computeCrc32(std::istream &stream, uint64 startOffset, uint64 endOffset, uint32 crc)
+{
+    if (startOffset >= endOffset) {
+        return crc;
+    }
+    const auto bufferSize = static_cast<size_t>(min<uint64>(endOffset - startOffset, 0x100000));
+    const auto buffer = make_unique<char[]>(bufferSize);
+    stream.seekg(static_cast<streamoff>(startOffset));
+    for (uint64 bytesLeft = endOffset - startOffset; bytesLeft;) {
+        const auto bytesToProcess = static_cast<size_t>(min<uint64>(bytesLeft, bufferSize));
+        stream.read(buffer.get(), static_cast<streamsize>(bytesToProcess));
+        crc = static_cast<uint32>(::crc32(crc, reinterpret_cast<const Bytef *>(buffer.get()), static_cast<uInt>(bytesToProcess)));
+        bytesLeft -= bytesToProcess;
+    }
+    return crc;
+}
+
 /*!
  * \brief Reads the content of the element as string.
  */
@@ -18,6 +18,76 @@ namespace TagParser {
 class EbmlElement;
 class MatroskaContainer;
 
+/*!
+ * \brief The EbmlElementHeader struct holds the ID and size denotation of an EBML element.
+ * \remarks Obtained via EbmlElement::readHeader() which does not create an EbmlElement for it.
+ */
+struct TAG_PARSER_EXPORT EbmlElementHeader {
+    constexpr EbmlElementHeader();
+    constexpr uint64 headerSize() const;
+    constexpr uint64 dataOffset() const;
+    constexpr uint64 totalSize() const;
+    constexpr uint64 endOffset() const;
+
+    /// \brief The start offset of the element in the stream.
+    uint64 startOffset;
+    /// \brief The data size of the element.
+    uint64 dataSize;
+    /// \brief The ID of the element.
+    uint32 id;
+    /// \brief The length of the ID denotation in byte.
+    byte idLength;
+    /// \brief The length of the size denotation in byte.
+    byte sizeLength;
+    /// \brief Whether the size is unknown (dataSize is then assumed to take the remaining space).
+    bool sizeUnknown;
+};
+
+/*!
+ * \brief Constructs a new, empty EbmlElementHeader.
+ */
+constexpr EbmlElementHeader::EbmlElementHeader()
+    : startOffset(0)
+    , dataSize(0)
+    , id(0)
+    , idLength(0)
+    , sizeLength(0)
+    , sizeUnknown(false)
+{
+}
+
+/*!
+ * \brief Returns the size of the ID and size denotation.
+ */
+constexpr uint64 EbmlElementHeader::headerSize() const
+{
+    return static_cast<uint64>(idLength) + sizeLength;
+}
+
+/*!
+ * \brief Returns the offset of the element's data in the stream.
+ */
+constexpr uint64 EbmlElementHeader::dataOffset() const
+{
+    return startOffset + headerSize();
+}
+
+/*!
+ * \brief Returns the total size of the element (header and data).
+ */
+constexpr uint64 EbmlElementHeader::totalSize() const
+{
+    return headerSize() + dataSize;
+}
+
+/*!
+ * \brief Returns the offset of the first byte which doesn't belong to the element anymore.
+ */
+constexpr uint64 EbmlElementHeader::endOffset() const
+{
+    return startOffset + totalSize();
+}
+
 /*!
  * \brief Defines traits for the GenericFileElement implementation EbmlElement.
  */
@@ -36,6 +106,7 @@ public:
 
     std::string idToString() const;
     bool isParent() const;
+    static bool isParentId(IdentifierType id);
     bool isPadding() const;
     uint64 firstChildOffset() const;
     std::string readString();
@@ -53,6 +124,9 @@ public:
     static void makeSimpleElement(std::ostream &stream, IdentifierType id, uint64 content);
     static void makeSimpleElement(std::ostream &stream, IdentifierType id, const std::string &content);
     static void makeSimpleElement(std::ostream &stream, IdentifierType id, const char *data, std::size_t dataSize);
+    static EbmlElementHeader readHeader(
+        std::istream &stream, uint64 startOffset, uint64 maxTotalSize, uint32 maxIdLength = 4, uint32 maxSizeLength = 8);
+    static uint32 computeCrc32(std::istream &stream, uint64 startOffset, uint64 endOffset, uint32 crc = 0);
     static uint64 bytesToBeSkipped;
 
 protected:
@@ -86,10 +160,19 @@ inline std::string EbmlElement::idToString() const
  *          are considered as non-parents.
  */
 inline bool EbmlElement::isParent() const
+{
+    return isParentId(id());
+}
+
+/*!
+ * \brief Returns an indication whether elements with the specified \a id are parent elements.
+ * \sa isParent()
+ */
+inline bool EbmlElement::isParentId(IdentifierType id)
 {
     using namespace EbmlIds;
     using namespace MatroskaIds;
-    switch (id()) {
+    switch (id) {
     case Header:
     case SignatureSlot:
     case SignatureElements:
@@ -6,6 +6,7 @@
 #include <c++utilities/conversion/binaryconversion.h>
 #include <c++utilities/conversion/stringbuilder.h>
 
+#include <limits>
 #include <memory>
 
 using namespace std;
@@ -179,7 +180,16 @@ void MatroskaAttachmentMaker::make(ostream &stream, Diagnostics &diag) const
     }
 }
 
-void MatroskaAttachmentMaker::bufferCurrentAttachments(Diagnostics &diag)
+/*!
+ * \brief Buffers the data of the attachment which is currently stored in the file to be modified.
+ *
+ * This is required when modifying a file in-place because the data might be overwritten before it is copied. The
+ * \a targetOffset specifies the offset the "AttachedFile"-element will be written to. The data is not buffered if it
+ * is located at or after the offset it is moved to. Then it is copied within the file when calling make() because
+ * the file is written in ascending order. If the \a targetOffset is only estimated, it must not be smaller than the
+ * actual offset. The small child elements like "FileReferral" are always buffered.
+ */
+void MatroskaAttachmentMaker::bufferCurrentAttachments(Diagnostics &diag, uint64 targetOffset)
 {
     EbmlElement *child;
     if (attachment().attachedFileElement()) {
@@ -190,7 +200,12 @@ void MatroskaAttachmentMaker::bufferCurrentAttachments(Diagnostics &diag)
             }
         }
     }
-    if (attachment().data() && attachment().data()->size() && !attachment().isDataFromFile()) {
+    if (!attachment().data() || !attachment().data()->size() || attachment().isDataFromFile()) {
+        return;
+    }
+    const auto dataSize = static_cast<uint64>(attachment().data()->size());
+    if (targetOffset > numeric_limits<uint64>::max() - m_totalSize
+        || static_cast<uint64>(attachment().data()->startOffset()) < targetOffset + m_totalSize - dataSize) {
         attachment().data()->makeBuffer();
     }
 }
@@ -3,6 +3,8 @@
 
 #include "../abstractattachment.h"
 
+#include <limits>
+
 namespace TagParser {
 
 class EbmlElement;
@@ -15,7 +17,7 @@ public:
     void make(std::ostream &stream, Diagnostics &diag) const;
     const MatroskaAttachment &attachment() const;
     uint64 requiredSize() const;
-    void bufferCurrentAttachments(Diagnostics &diag);
+    void bufferCurrentAttachments(Diagnostics &diag, uint64 targetOffset = std::numeric_limits<uint64>::max());
 
 private:
     MatroskaAttachmentMaker(MatroskaAttachment &attachment, Diagnostics &diag);
@@ -0,0 +1,273 @@
+#include "./matroskaclusterscanner.h"
+#include "./matroskacontainer.h"
+#include "./matroskaid.h"
+
+#include "../exceptions.h"
+#include "../mediafileinfo.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/io/catchiofailure.h>
+#include <c++utilities/io/nativefilestream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace IoUtilities;
+using namespace ConversionUtilities;
+
+namespace TagParser {
+
+/// \brief The minimum number of bytes per MatroskaClusterRange (ranges are not split further to keep the overhead of dispatching small).
+constexpr uint64 minimumRangeSize = 0x100000;
+/// \brief The number of ranges per thread (more ranges than threads compensate for differences in processing time).
+constexpr uint64 rangesPerThread = 4;
+
+/*!
+ * \class TagParser::MatroskaClusterScanner
+ * \brief The MatroskaClusterScanner class allows processing the "Cluster"-elements of a MatroskaContainer concurrently.
+ *
+ * The "Cluster"-elements of each segment are split into ranges of roughly equal size (see determineRanges()). These
+ * ranges are then processed by a pool of threads (see scan()). Each thread reads from its own file handle so reading
+ * and seeking within one range does not interfere with other ranges. Since diagnostic messages are gathered per
+ * range and merged in the order of the ranges the resulting Diagnostics do not depend on the number of threads.
+ */
+
+/*!
+ * \brief Constructs a new scanner for the specified \a container.
+ * \remarks The header of the \a container must have been parsed before using the scanner.
+ */
+MatroskaClusterScanner::MatroskaClusterScanner(MatroskaContainer &container)
+    : m_container(container)
+    , m_threadCount(max(thread::hardware_concurrency(), 1u))
+{
+}
+
+/*!
+ * \brief Sets the number of threads used by scan().
+ * \remarks Setting 0 will reset to the number of concurrent threads supported by the hardware.
+ */
+void MatroskaClusterScanner::setThreadCount(unsigned int threadCount)
+{
+    m_threadCount = threadCount ? threadCount : max(thread::hardware_concurrency(), 1u);
+}
+
+/*!
+ * \brief Returns whether a "Cluster"-element starts at the specified \a offset.
+ * \remarks Only "Cluster"-elements found by determineRanges() are taken into account.
+ */
+bool MatroskaClusterScanner::isCluster(uint64 offset) const
+{
+    return binary_search(m_clusterOffsets.cbegin(), m_clusterOffsets.cend(), offset);
+}
+
+/*!
+ * \brief Returns the actual end offset of the "Cluster"-element with the specified \a clusterHeader whose size is unknown.
+ *
+ * The headers of the children are read until an element is encountered which is not supposed to be a child of a
+ * "Cluster"-element (usually the next "Cluster"-element).
+ *
+ * \throws Throws TagParser::Failure or a derived exception when a header can not be read and std::ios_base::failure
+ *         when an IO error occurs.
+ */
+uint64 MatroskaClusterScanner::determineClusterEndOffset(
+    istream &stream, const EbmlElementHeader &clusterHeader, uint32 maxIdLength, uint32 maxSizeLength)
+{
+    uint64 offset = clusterHeader.dataOffset();
+    for (const uint64 endOffset = clusterHeader.endOffset(); offset < endOffset;) {
+        const EbmlElementHeader header = EbmlElement::readHeader(stream, offset, endOffset - offset, maxIdLength, maxSizeLength);
+        const MatroskaElementLevel level = matroskaIdLevel(header.id);
+        if (level != MatroskaElementLevel::Global && level != MatroskaElementLevel::Unknown
+            && !(level > matroskaIdLevel(MatroskaIds::Cluster))) {
+            break;
+        }
+        offset = header.endOffset();
+    }
+    return offset;
+}
+
+/*!
+ * \brief Determines the ranges to be processed when calling scan().
+ *
+ * Only the headers of the top-level elements are parsed as EbmlElement. The children of the "Segment"-elements are located
+ * by only reading their headers (see EbmlElement::readHeader()) so no EbmlElement objects are created for the
+ * "Cluster"-elements. Hence this takes much less time than parsing the children of the "Cluster"-elements. The headers of
+ * the other children are returned by segmentChildren().
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void MatroskaClusterScanner::determineRanges(Diagnostics &diag)
+{
+    static const string context("determining Matroska cluster ranges");
+    m_ranges.clear();
+    m_clusterOffsets.clear();
+    m_segmentChildren.clear();
+
+    // gather all "Cluster"-elements
+    struct ClusterInfo {
+        uint64 startOffset;
+        uint64 totalSize;
+        uint64 segmentDataOffset;
+        uint64 segmentOffset;
+    };
+    vector<ClusterInfo> clusters;
+    uint64 totalClusterSize = 0, segmentOffset = 0;
+    istream &stream = m_container.stream();
+    const auto maxIdLength = static_cast<uint32>(m_container.maxIdLength()), maxSizeLength = static_cast<uint32>(m_container.maxSizeLength());
+    for (EbmlElement *topLevelElement = m_container.firstElement(); topLevelElement; topLevelElement = topLevelElement->nextSibling()) {
+        try {
+            topLevelElement->parse(diag);
+        } catch (const Failure &) {
+            diag.emplace_back(
+                DiagLevel::Critical, argsToString("Unable to parse top-level element at ", topLevelElement->startOffset(), '.'), context);
+            break;
+        }
+        if (topLevelElement->id() != MatroskaIds::Segment) {
+            continue;
+        }
+        const uint64 segmentDataOffset = topLevelElement->dataOffset(), segmentEndOffset = topLevelElement->endOffset();
+        try {
+            for (uint64 offset = segmentDataOffset; offset < segmentEndOffset;) {
+                const EbmlElementHeader header = EbmlElement::readHeader(stream, offset, segmentEndOffset - offset, maxIdLength, maxSizeLength);
+                if (header.id != MatroskaIds::Cluster) {
+                    m_segmentChildren.emplace_back(header);
+                    offset = header.endOffset();
+                    continue;
+                }
+                const uint64 clusterEndOffset
+                    = header.sizeUnknown ? determineClusterEndOffset(stream, header, maxIdLength, maxSizeLength) : header.endOffset();
+                clusters.emplace_back(ClusterInfo{ offset, clusterEndOffset - offset, segmentDataOffset, segmentOffset });
+                totalClusterSize += clusterEndOffset - offset;
+                offset = clusterEndOffset;
+            }
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical, "Unable to parse all childs of \"Segment\"-element.", context);
+        }
+        segmentOffset += topLevelElement->totalSize();
+    }
+
+    // split "Cluster"-elements into ranges of roughly equal size without crossing segment boundaries
+    const uint64 targetRangeSize = max<uint64>(totalClusterSize / (static_cast<uint64>(m_threadCount) * rangesPerThread), minimumRangeSize);
+    m_clusterOffsets.reserve(clusters.size());
+    uint64 previousClusterSize = 0;
+    for (const ClusterInfo &cluster : clusters) {
+        m_clusterOffsets.emplace_back(cluster.startOffset);
+        if (m_ranges.empty() || m_ranges.back().segmentDataOffset != cluster.segmentDataOffset
+            || m_ranges.back().endOffset - m_ranges.back().startOffset >= targetRangeSize) {
+            if (!m_ranges.empty() && m_ranges.back().segmentDataOffset != cluster.segmentDataOffset) {
+                previousClusterSize = 0;
+            }
+            m_ranges.emplace_back();
+            MatroskaClusterRange &range = m_ranges.back();
+            range.index = m_ranges.size() - 1;
+            range.startOffset = cluster.startOffset;
+            range.segmentDataOffset = cluster.segmentDataOffset;
+            range.segmentOffset = cluster.segmentOffset;
+            range.previousClusterSize = previousClusterSize;
+        }
+        m_ranges.back().endOffset = cluster.startOffset + cluster.totalSize;
+        previousClusterSize = cluster.totalSize;
+    }
+    sort(m_clusterOffsets.begin(), m_clusterOffsets.end());
+}
+
+/*!
+ * \brief Invokes the specified \a handler for each range determined by determineRanges().
+ *
+ * The \a handler is invoked concurrently from up to threadCount() threads. It is passed a stream to read from, the range
+ * to process and the Diagnostics to add messages to. The stream must only be used within the invocation and the handler must
+ * not access the element tree of the container. If it needs to store results, it should store them per range (eg. in a vector
+ * indexed by MatroskaClusterRange::index) to avoid synchronization.
+ *
+ * After all ranges have been processed, the messages of all ranges are appended to \a diag in the order of the ranges.
+ *
+ * \throws Throws any exceptions thrown by the \a handler except Failure and std::ios_base::failure which are turned into
+ *         critical messages of the range.
+ */
+void MatroskaClusterScanner::scan(const RangeHandler &handler, Diagnostics &diag)
+{
+    static const string context("scanning Matroska clusters");
+    if (m_ranges.empty()) {
+        return;
+    }
+
+    vector<Diagnostics> rangeDiag(m_ranges.size());
+    for (Diagnostics &messages : rangeDiag) {
+        messages.adoptSettings(diag);
+    }
+    atomic<size_t> nextRange(0);
+    mutex exceptionMutex;
+    exception_ptr exception;
+    const auto keepException = [&exceptionMutex, &exception] {
+        lock_guard<mutex> lock(exceptionMutex);
+        if (!exception) {
+            exception = current_exception();
+        }
+    };
+    const auto processRanges = [&](istream &stream) {
+        for (size_t index; (index = nextRange++) < m_ranges.size();) {
+            try {
+                handler(stream, m_ranges[index], rangeDiag[index]);
+            } catch (const Failure &) {
+                rangeDiag[index].emplace_back(DiagLevel::Critical,
+                    argsToString("Unable to process \"Cluster\"-elements between ", m_ranges[index].startOffset, " and ",
+                        m_ranges[index].endOffset, '.'),
+                    context);
+            } catch (...) {
+                try {
+                    const char *const what = catchIoFailure();
+                    rangeDiag[index].emplace_back(DiagLevel::Critical,
+                        argsToString("An IO error occured when reading \"Cluster\"-elements between ", m_ranges[index].startOffset, " and ",
+                            m_ranges[index].endOffset, ": ", what),
+                        context);
+                    stream.clear();
+                } catch (...) {
+                    keepException();
+                    return;
+                }
+            }
+        }
+    };
+
+    // spawn additional threads reading from their own file handle; the current thread uses the stream of the container
+    const size_t threadCount = min<size_t>(m_threadCount, m_ranges.size());
+    const string &path = m_container.fileInfo().path();
+    vector<thread> threads;
+    if (!path.empty() && threadCount > 1) {
+        threads.reserve(threadCount - 1);
+        for (size_t i = 1; i < threadCount; ++i) {
+            threads.emplace_back([&path, &processRanges, &keepException] {
+                try {
+                    NativeFileStream stream;
+                    stream.exceptions(ios_base::badbit | ios_base::failbit);
+                    stream.open(path, ios_base::in | ios_base::binary);
+                    processRanges(stream);
+                } catch (...) {
+                    // remaining ranges are processed by the other threads when opening the file fails
+                    try {
+                        catchIoFailure();
+                    } catch (...) {
+                        keepException();
+                    }
+                }
+            });
+        }
+    }
+    processRanges(m_container.stream());
+    for (thread &worker : threads) {
+        worker.join();
+    }
+    if (exception) {
+        rethrow_exception(exception);
+    }
+
+    // merge messages in the order of the ranges
+    for (Diagnostics &messages : rangeDiag) {
+        diag.append(move(messages));
+    }
+}
+
+} // namespace TagParser
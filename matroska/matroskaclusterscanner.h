@@ -0,0 +1,97 @@
+#ifndef TAG_PARSER_MATROSKACLUSTERSCANNER_H
+#define TAG_PARSER_MATROSKACLUSTERSCANNER_H
+
+#include "./ebmlelement.h"
+
+#include "../diagnostics.h"
+
+#include <c++utilities/conversion/types.h>
+
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace TagParser {
+
+class MatroskaContainer;
+
+/*!
+ * \brief The MatroskaClusterRange struct describes a range of consecutive "Cluster"-elements within a "Segment"-element.
+ * \remarks The range might contain other top-level elements as well (which are located between the "Cluster"-elements).
+ */
+struct TAG_PARSER_EXPORT MatroskaClusterRange {
+    /// \brief Specifies the index of the range within MatroskaClusterScanner::ranges().
+    std::size_t index = 0;
+    /// \brief Specifies the start offset of the first "Cluster"-element within the range.
+    uint64 startOffset = 0;
+    /// \brief Specifies the end offset of the last "Cluster"-element within the range.
+    uint64 endOffset = 0;
+    /// \brief Specifies the data offset of the "Segment"-element containing the range.
+    uint64 segmentDataOffset = 0;
+    /// \brief Specifies the accumulated size of the "Segment"-elements preceding the "Segment"-element containing the range.
+    uint64 segmentOffset = 0;
+    /// \brief Specifies the total size of the "Cluster"-element preceding the range or 0 if the range starts with the first "Cluster"-element.
+    uint64 previousClusterSize = 0;
+};
+
+class TAG_PARSER_EXPORT MatroskaClusterScanner {
+public:
+    using RangeHandler = std::function<void(std::istream &stream, const MatroskaClusterRange &range, Diagnostics &diag)>;
+
+    explicit MatroskaClusterScanner(MatroskaContainer &container);
+
+    unsigned int threadCount() const;
+    void setThreadCount(unsigned int threadCount);
+    const std::vector<MatroskaClusterRange> &ranges() const;
+    const std::vector<uint64> &clusterOffsets() const;
+    const std::vector<EbmlElementHeader> &segmentChildren() const;
+    bool isCluster(uint64 offset) const;
+    void determineRanges(Diagnostics &diag);
+    void scan(const RangeHandler &handler, Diagnostics &diag);
+    static uint64 determineClusterEndOffset(std::istream &stream, const EbmlElementHeader &clusterHeader, uint32 maxIdLength, uint32 maxSizeLength);
+
+private:
+    MatroskaContainer &m_container;
+    unsigned int m_threadCount;
+    std::vector<MatroskaClusterRange> m_ranges;
+    std::vector<uint64> m_clusterOffsets;
+    std::vector<EbmlElementHeader> m_segmentChildren;
+};
+
+/*!
+ * \brief Returns the number of threads used by scan().
+ * \remarks Defaults to the number of concurrent threads supported by the hardware.
+ */
+inline unsigned int MatroskaClusterScanner::threadCount() const
+{
+    return m_threadCount;
+}
+
+/*!
+ * \brief Returns the ranges determined by determineRanges().
+ */
+inline const std::vector<MatroskaClusterRange> &MatroskaClusterScanner::ranges() const
+{
+    return m_ranges;
+}
+
+/*!
+ * \brief Returns the start offsets of all "Cluster"-elements found by determineRanges() in ascending order.
+ */
+inline const std::vector<uint64> &MatroskaClusterScanner::clusterOffsets() const
+{
+    return m_clusterOffsets;
+}
+
+/*!
+ * \brief Returns the headers of the children of all "Segment"-elements found by determineRanges() except "Cluster"-elements.
+ * \remarks The headers are ordered by their offset. So all children of a "Segment"-element are adjacent.
+ */
+inline const std::vector<EbmlElementHeader> &MatroskaClusterScanner::segmentChildren() const
+{
+    return m_segmentChildren;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_MATROSKACLUSTERSCANNER_H
@@ -1,5 +1,6 @@
 #include "./matroskacontainer.h"
 #include "./ebmlid.h"
+#include "./matroskaclusterscanner.h"
 #include "./matroskacues.h"
 #include "./matroskaeditionentry.h"
 #include "./matroskaid.h"
@@ -8,21 +9,26 @@
 #include "../backuphelper.h"
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
+#include "../paddinghelper.h"
 
 #include "resources/config.h"
 
+#include <c++utilities/conversion/binaryconversion.h>
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/catchiofailure.h>
 
 #include <unistd.h>
+#include <zlib.h>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <initializer_list>
 #include <limits>
 #include <memory>
 #include <random>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace std;
@@ -90,9 +96,6 @@ void MatroskaContainer::validateIndex(Diagnostics &diag)
     static const string context("validating Matroska file index (cues)");
     bool cuesElementsFound = false;
     if (m_firstElement) {
-        unordered_set<EbmlElement::IdentifierType> ids;
-        bool cueTimeFound = false, cueTrackPositionsFound = false;
-        unique_ptr<EbmlElement> clusterElement;
         uint64 pos, prevClusterSize = 0, currentOffset = 0;
         // iterate throught all segments
         for (EbmlElement *segmentElement = m_firstElement->siblingById(MatroskaIds::Segment, diag); segmentElement;
@@ -108,149 +111,7 @@ void MatroskaContainer::validateIndex(Diagnostics &diag)
                     break;
                 case MatroskaIds::Cues:
                     cuesElementsFound = true;
-                    // parse childs of "Cues"-element ("CuePoint"-elements)
-                    for (EbmlElement *cuePointElement = segmentChildElement->firstChild(); cuePointElement;
-                         cuePointElement = cuePointElement->nextSibling()) {
-                        cuePointElement->parse(diag);
-                        cueTimeFound = cueTrackPositionsFound = false; // to validate quantity of these elements
-                        switch (cuePointElement->id()) {
-                        case EbmlIds::Void:
-                        case EbmlIds::Crc32:
-                            break;
-                        case MatroskaIds::CuePoint:
-                            // parse childs of "CuePoint"-element
-                            for (EbmlElement *cuePointChildElement = cuePointElement->firstChild(); cuePointChildElement;
-                                 cuePointChildElement = cuePointChildElement->nextSibling()) {
-                                cuePointChildElement->parse(diag);
-                                switch (cuePointChildElement->id()) {
-                                case MatroskaIds::CueTime:
-                                    // validate uniqueness
-                                    if (cueTimeFound) {
-                                        diag.emplace_back(
-                                            DiagLevel::Warning, "\"CuePoint\"-element contains multiple \"CueTime\" elements.", context);
-                                    } else {
-                                        cueTimeFound = true;
-                                    }
-                                    break;
-                                case MatroskaIds::CueTrackPositions:
-                                    cueTrackPositionsFound = true;
-                                    ids.clear();
-                                    clusterElement.reset();
-                                    for (EbmlElement *subElement = cuePointChildElement->firstChild(); subElement;
-                                         subElement = subElement->nextSibling()) {
-                                        subElement->parse(diag);
-                                        switch (subElement->id()) {
-                                        case MatroskaIds::CueTrack:
-                                        case MatroskaIds::CueClusterPosition:
-                                        case MatroskaIds::CueRelativePosition:
-                                        case MatroskaIds::CueDuration:
-                                        case MatroskaIds::CueBlockNumber:
-                                        case MatroskaIds::CueCodecState:
-                                            // validate uniqueness
-                                            if (ids.count(subElement->id())) {
-                                                diag.emplace_back(DiagLevel::Warning,
-                                                    "\"CueTrackPositions\"-element contains multiple \"" % subElement->idToString() + "\" elements.",
-                                                    context);
-                                            } else {
-                                                ids.insert(subElement->id());
-                                            }
-                                            break;
-                                        case EbmlIds::Crc32:
-                                        case EbmlIds::Void:
-                                        case MatroskaIds::CueReference:
-                                            break;
-                                        default:
-                                            diag.emplace_back(DiagLevel::Warning,
-                                                "\"CueTrackPositions\"-element contains unknown element \"" % subElement->idToString() + "\".",
-                                                context);
-                                        }
-                                        switch (subElement->id()) {
-                                        case EbmlIds::Void:
-                                        case EbmlIds::Crc32:
-                                        case MatroskaIds::CueTrack:
-                                            break;
-                                        case MatroskaIds::CueClusterPosition:
-                                            // validate "Cluster" position denoted by "CueClusterPosition"-element
-                                            clusterElement = make_unique<EbmlElement>(
-                                                *this, segmentElement->dataOffset() + subElement->readUInteger() - currentOffset);
-                                            try {
-                                                clusterElement->parse(diag);
-                                                if (clusterElement->id() != MatroskaIds::Cluster) {
-                                                    diag.emplace_back(DiagLevel::Critical,
-                                                        "\"CueClusterPosition\" element at " % numberToString(subElement->startOffset())
-                                                            + " does not point to \"Cluster\"-element (points to "
-                                                            + numberToString(clusterElement->startOffset()) + ").",
-                                                        context);
-                                                }
-                                            } catch (const Failure &) {
-                                            }
-                                            break;
-                                        case MatroskaIds::CueRelativePosition:
-                                            // read "Block" position denoted by "CueRelativePosition"-element (validate later since the "Cluster"-element is needed to validate)
-                                            pos = subElement->readUInteger();
-                                            break;
-                                        case MatroskaIds::CueDuration:
-                                            break;
-                                        case MatroskaIds::CueBlockNumber:
-                                            break;
-                                        case MatroskaIds::CueCodecState:
-                                            break;
-                                        case MatroskaIds::CueReference:
-                                            break;
-                                        default:;
-                                        }
-                                    }
-                                    // validate existence of mandatory elements
-                                    if (!ids.count(MatroskaIds::CueTrack)) {
-                                        diag.emplace_back(DiagLevel::Warning,
-                                            "\"CueTrackPositions\"-element does not contain mandatory element \"CueTrack\".", context);
-                                    }
-                                    if (!clusterElement) {
-                                        diag.emplace_back(DiagLevel::Warning,
-                                            "\"CueTrackPositions\"-element does not contain mandatory element \"CueClusterPosition\".", context);
-                                    } else if (ids.count(MatroskaIds::CueRelativePosition)) {
-                                        // validate "Block" position denoted by "CueRelativePosition"-element
-                                        EbmlElement referenceElement(*this, clusterElement->dataOffset() + pos);
-                                        try {
-                                            referenceElement.parse(diag);
-                                            switch (referenceElement.id()) {
-                                            case MatroskaIds::SimpleBlock:
-                                            case MatroskaIds::Block:
-                                            case MatroskaIds::BlockGroup:
-                                                break;
-                                            default:
-                                                diag.emplace_back(DiagLevel::Critical,
-                                                    "\"CueRelativePosition\" element does not point to \"Block\"-, \"BlockGroup\", or "
-                                                    "\"SimpleBlock\"-element (points to "
-                                                            % numberToString(referenceElement.startOffset())
-                                                        + ").",
-                                                    context);
-                                            }
-                                        } catch (const Failure &) {
-                                        }
-                                    }
-                                    break;
-                                case EbmlIds::Crc32:
-                                case EbmlIds::Void:
-                                    break;
-                                default:
-                                    diag.emplace_back(DiagLevel::Warning,
-                                        "\"CuePoint\"-element contains unknown element \"" % cuePointElement->idToString() + "\".", context);
-                                }
-                            }
-                            // validate existence of mandatory elements
-                            if (!cueTimeFound) {
-                                diag.emplace_back(
-                                    DiagLevel::Warning, "\"CuePoint\"-element does not contain mandatory element \"CueTime\".", context);
-                            }
-                            if (!cueTrackPositionsFound) {
-                                diag.emplace_back(
-                                    DiagLevel::Warning, "\"CuePoint\"-element does not contain mandatory element \"CueClusterPosition\".", context);
-                            }
-                            break;
-                        default:;
-                        }
-                    }
+                    validateCuesElement(*segmentElement, *segmentChildElement, currentOffset, diag);
                     break;
                 case MatroskaIds::Cluster:
                     // parse childs of "Cluster"-element
@@ -297,6 +158,885 @@ void MatroskaContainer::validateIndex(Diagnostics &diag)
     }
 }
 
+/*!
+ * \brief The MatroskaCueReference struct holds the position of a "Cluster"- and "Block"-element denoted by a "CueTrackPositions"-element.
+ * \remarks Used by MatroskaContainer::validateConcurrently() to validate the index without seeking to each referenced element.
+ */
+struct MatroskaCueReference {
+    /// \brief Specifies the start offset of the "CueClusterPosition"-element.
+    uint64 clusterPositionOffset;
+    /// \brief Specifies the start offset of the referenced "Cluster"-element.
+    uint64 clusterOffset;
+    /// \brief Specifies the position of the referenced "Block"-element relative to the data of the "Cluster"-element (max if not present).
+    uint64 relativePosition;
+};
+
+/*!
+ * \brief Validates the specified \a cuesElement which is a child of the specified \a segmentElement.
+ * \remarks
+ * - This is a helper for validateIndex() and validateConcurrently().
+ * - If \a deferredReferences is specified, the "Cluster"- and "Block"-positions are not validated but added to
+ *   \a deferredReferences so they can be validated without seeking to each of them.
+ */
+void MatroskaContainer::validateCuesElement(
+    EbmlElement &segmentElement, EbmlElement &cuesElement, uint64 currentOffset, Diagnostics &diag, vector<MatroskaCueReference> *deferredReferences)
+{
+    static const string context("validating Matroska file index (cues)");
+    unordered_set<EbmlElement::IdentifierType> ids;
+    bool cueTimeFound = false, cueTrackPositionsFound = false;
+    unique_ptr<EbmlElement> clusterElement;
+    uint64 pos = 0, clusterPositionOffset = 0, clusterOffset = 0;
+    // parse childs of "Cues"-element ("CuePoint"-elements)
+    for (EbmlElement *cuePointElement = cuesElement.firstChild(); cuePointElement;
+         cuePointElement = cuePointElement->nextSibling()) {
+        cuePointElement->parse(diag);
+        cueTimeFound = cueTrackPositionsFound = false; // to validate quantity of these elements
+        switch (cuePointElement->id()) {
+        case EbmlIds::Void:
+        case EbmlIds::Crc32:
+            break;
+        case MatroskaIds::CuePoint:
+            // parse childs of "CuePoint"-element
+            for (EbmlElement *cuePointChildElement = cuePointElement->firstChild(); cuePointChildElement;
+                 cuePointChildElement = cuePointChildElement->nextSibling()) {
+                cuePointChildElement->parse(diag);
+                switch (cuePointChildElement->id()) {
+                case MatroskaIds::CueTime:
+                    // validate uniqueness
+                    if (cueTimeFound) {
+                        diag.emplace_back(
+                            DiagLevel::Warning, "\"CuePoint\"-element contains multiple \"CueTime\" elements.", context);
+                    } else {
+                        cueTimeFound = true;
+                    }
+                    break;
+                case MatroskaIds::CueTrackPositions:
+                    cueTrackPositionsFound = true;
+                    ids.clear();
+                    clusterElement.reset();
+                    clusterPositionOffset = 0;
+                    for (EbmlElement *subElement = cuePointChildElement->firstChild(); subElement;
+                         subElement = subElement->nextSibling()) {
+                        subElement->parse(diag);
+                        switch (subElement->id()) {
+                        case MatroskaIds::CueTrack:
+                        case MatroskaIds::CueClusterPosition:
+                        case MatroskaIds::CueRelativePosition:
+                        case MatroskaIds::CueDuration:
+                        case MatroskaIds::CueBlockNumber:
+                        case MatroskaIds::CueCodecState:
+                            // validate uniqueness
+                            if (ids.count(subElement->id())) {
+                                diag.emplace_back(DiagLevel::Warning,
+                                    "\"CueTrackPositions\"-element contains multiple \"" % subElement->idToString() + "\" elements.",
+                                    context);
+                            } else {
+                                ids.insert(subElement->id());
+                            }
+                            break;
+                        case EbmlIds::Crc32:
+                        case EbmlIds::Void:
+                        case MatroskaIds::CueReference:
+                            break;
+                        default:
+                            diag.emplace_back(DiagLevel::Warning,
+                                "\"CueTrackPositions\"-element contains unknown element \"" % subElement->idToString() + "\".",
+                                context);
+                        }
+                        switch (subElement->id()) {
+                        case EbmlIds::Void:
+                        case EbmlIds::Crc32:
+                        case MatroskaIds::CueTrack:
+                            break;
+                        case MatroskaIds::CueClusterPosition:
+                            clusterPositionOffset = subElement->startOffset();
+                            clusterOffset = segmentElement.dataOffset() + subElement->readUInteger() - currentOffset;
+                            if (deferredReferences) {
+                                // validate "Cluster" position later (see validateConcurrently())
+                                break;
+                            }
+                            // validate "Cluster" position denoted by "CueClusterPosition"-element
+                            clusterElement = make_unique<EbmlElement>(*this, clusterOffset);
+                            try {
+                                clusterElement->parse(diag);
+                                if (clusterElement->id() != MatroskaIds::Cluster) {
+                                    diag.emplace_back(DiagLevel::Critical,
+                                        "\"CueClusterPosition\" element at " % numberToString(subElement->startOffset())
+                                            + " does not point to \"Cluster\"-element (points to "
+                                            + numberToString(clusterElement->startOffset()) + ").",
+                                        context);
+                                }
+                            } catch (const Failure &) {
+                            }
+                            break;
+                        case MatroskaIds::CueRelativePosition:
+                            // read "Block" position denoted by "CueRelativePosition"-element (validate later since the "Cluster"-element is needed to validate)
+                            pos = subElement->readUInteger();
+                            break;
+                        case MatroskaIds::CueDuration:
+                            break;
+                        case MatroskaIds::CueBlockNumber:
+                            break;
+                        case MatroskaIds::CueCodecState:
+                            break;
+                        case MatroskaIds::CueReference:
+                            break;
+                        default:;
+                        }
+                    }
+                    // validate existence of mandatory elements
+                    if (!ids.count(MatroskaIds::CueTrack)) {
+                        diag.emplace_back(DiagLevel::Warning,
+                            "\"CueTrackPositions\"-element does not contain mandatory element \"CueTrack\".", context);
+                    }
+                    if (!clusterPositionOffset) {
+                        diag.emplace_back(DiagLevel::Warning,
+                            "\"CueTrackPositions\"-element does not contain mandatory element \"CueClusterPosition\".", context);
+                    } else if (deferredReferences) {
+                        // validate "Cluster" and "Block" position later (see validateConcurrently())
+                        deferredReferences->emplace_back(MatroskaCueReference{ clusterPositionOffset, clusterOffset,
+                            ids.count(MatroskaIds::CueRelativePosition) ? pos : numeric_limits<uint64>::max() });
+                    } else if (ids.count(MatroskaIds::CueRelativePosition)) {
+                        // validate "Block" position denoted by "CueRelativePosition"-element
+                        EbmlElement referenceElement(*this, clusterElement->dataOffset() + pos);
+                        try {
+                            referenceElement.parse(diag);
+                            switch (referenceElement.id()) {
+                            case MatroskaIds::SimpleBlock:
+                            case MatroskaIds::Block:
+                            case MatroskaIds::BlockGroup:
+                                break;
+                            default:
+                                diag.emplace_back(DiagLevel::Critical,
+                                    "\"CueRelativePosition\" element does not point to \"Block\"-, \"BlockGroup\", or "
+                                    "\"SimpleBlock\"-element (points to "
+                                            % numberToString(referenceElement.startOffset())
+                                        + ").",
+                                    context);
+                            }
+                        } catch (const Failure &) {
+                        }
+                    }
+                    break;
+                case EbmlIds::Crc32:
+                case EbmlIds::Void:
+                    break;
+                default:
+                    diag.emplace_back(DiagLevel::Warning,
+                        "\"CuePoint\"-element contains unknown element \"" % cuePointElement->idToString() + "\".", context);
+                }
+            }
+            // validate existence of mandatory elements
+            if (!cueTimeFound) {
+                diag.emplace_back(
+                    DiagLevel::Warning, "\"CuePoint\"-element does not contain mandatory element \"CueTime\".", context);
+            }
+            if (!cueTrackPositionsFound) {
+                diag.emplace_back(
+                    DiagLevel::Warning, "\"CuePoint\"-element does not contain mandatory element \"CueClusterPosition\".", context);
+            }
+            break;
+        default:;
+        }
+    }
+}
+
+/*!
+ * \brief Validates the specified \a element and its children.
+ * \remarks This is a helper for MatroskaContainer::validateConcurrently() which does the same as
+ *          GenericFileElement::validateSubsequentElementStructure() but without validating the siblings.
+ */
+void validateElementAndChildren(EbmlElement &element, Diagnostics &diag, uint64 *paddingSize)
+{
+    element.parse(diag);
+    if (element.firstChild()) {
+        try {
+            element.firstChild()->validateSubsequentElementStructure(diag, paddingSize);
+        } catch (const Failure &) {
+            // ignore critical errors in child structure to continue validating siblings
+        }
+    } else if (paddingSize && element.isPadding()) {
+        *paddingSize += element.totalSize();
+    }
+}
+
+/*!
+ * \brief Reads the unsigned integer stored in the element with the specified \a header.
+ */
+uint64 readUInteger(istream &stream, const EbmlElementHeader &header)
+{
+    char buff[sizeof(uint64)] = { 0 };
+    const auto bytesToRead = static_cast<streamsize>(min<uint64>(header.dataSize, sizeof(uint64)));
+    stream.seekg(static_cast<streamoff>(header.dataOffset()));
+    stream.read(buff + (sizeof(uint64) - static_cast<size_t>(bytesToRead)), bytesToRead);
+    return BE::toUInt64(buff);
+}
+
+/*!
+ * \brief Validates the children of the element with the specified \a parentHeader by only reading their headers.
+ * \remarks This is a helper for MatroskaContainer::validateConcurrently().
+ * \returns Returns the end offset of the parent. It is less than parentHeader.endOffset() if the size of the parent is
+ *          unknown and a sibling of the parent has been encountered.
+ */
+uint64 validateChildren(istream &stream, const EbmlElementHeader &parentHeader, uint32 maxIdLength, uint32 maxSizeLength,
+    vector<EbmlElementHeader> *children, uint64 &paddingSize, Diagnostics &diag)
+{
+    static const string context("validating Matroska clusters");
+    const uint64 endOffset = parentHeader.endOffset();
+    for (uint64 offset = parentHeader.dataOffset(); offset < endOffset;) {
+        EbmlElementHeader header;
+        try {
+            header = EbmlElement::readHeader(stream, offset, endOffset - offset, maxIdLength, maxSizeLength);
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical,
+                argsToString("Unable to parse EBML element at ", offset, "; skipping remaining children of the element at ", parentHeader.startOffset,
+                    '.'),
+                context);
+            return endOffset;
+        }
+        // check whether the element is actually a sibling of the parent
+        if (parentHeader.sizeUnknown && !(matroskaIdLevel(header.id) > matroskaIdLevel(parentHeader.id))) {
+            return offset;
+        }
+        if (children) {
+            children->emplace_back(header);
+        }
+        if (EbmlElement::isParentId(header.id)) {
+            offset = validateChildren(stream, header, maxIdLength, maxSizeLength, nullptr, paddingSize, diag);
+        } else {
+            if (header.id == EbmlIds::Void) {
+                paddingSize += header.totalSize();
+            }
+            offset = header.endOffset();
+        }
+    }
+    return endOffset;
+}
+
+/*!
+ * \brief Validates the "Cluster"-elements within the specified \a range.
+ * \remarks
+ * - This is a helper for MatroskaContainer::validateConcurrently() which is invoked concurrently for different ranges
+ *   so it must not access the element tree.
+ * - The specified \a cueReferences must be sorted by the "Cluster"-offset and only contain references to existing "Cluster"-elements
+ *   with a "Block"-position.
+ */
+void validateClusterRange(istream &stream, const MatroskaClusterRange &range, uint32 maxIdLength, uint32 maxSizeLength,
+    const vector<MatroskaCueReference> &cueReferences, uint64 &paddingSize, Diagnostics &diag)
+{
+    static const string context("validating Matroska clusters");
+    static const string indexContext("validating Matroska file index (cues)");
+    auto cueReference = lower_bound(cueReferences.cbegin(), cueReferences.cend(), range.startOffset,
+        [](const MatroskaCueReference &reference, uint64 offset) { return reference.clusterOffset < offset; });
+    vector<EbmlElementHeader> clusterChildren;
+    uint64 prevClusterSize = range.previousClusterSize, pos;
+    for (uint64 offset = range.startOffset; offset < range.endOffset;) {
+        const EbmlElementHeader clusterHeader = EbmlElement::readHeader(stream, offset, range.endOffset - offset, maxIdLength, maxSizeLength);
+        if (clusterHeader.id != MatroskaIds::Cluster) {
+            // other elements between the "Cluster"-elements are validated sequentially
+            offset = clusterHeader.endOffset();
+            continue;
+        }
+
+        // validate children
+        clusterChildren.clear();
+        const uint64 clusterEndOffset = validateChildren(stream, clusterHeader, maxIdLength, maxSizeLength, &clusterChildren, paddingSize, diag);
+        for (const EbmlElementHeader &childHeader : clusterChildren) {
+            switch (childHeader.id) {
+            case MatroskaIds::Position:
+                // validate position
+                if ((pos = readUInteger(stream, childHeader)) > 0
+                    && (clusterHeader.startOffset - range.segmentDataOffset + range.segmentOffset) != pos) {
+                    diag.emplace_back(DiagLevel::Critical,
+                        argsToString("\"Position\"-element at ", childHeader.startOffset, " points to ", pos,
+                            " which is not the offset of the containing \"Cluster\"-element."),
+                        context);
+                }
+                break;
+            case MatroskaIds::PrevSize:
+                // validate prev size
+                if ((pos = readUInteger(stream, childHeader)) != prevClusterSize) {
+                    diag.emplace_back(DiagLevel::Critical,
+                        argsToString("\"PrevSize\"-element at ", childHeader.startOffset, " should be ", prevClusterSize, " but is ", pos, "."),
+                        context);
+                }
+                break;
+            default:;
+            }
+        }
+
+        // validate "Block" positions denoted by "CueRelativePosition"-elements referring to this "Cluster"-element
+        for (; cueReference != cueReferences.cend() && cueReference->clusterOffset == clusterHeader.startOffset; ++cueReference) {
+            const uint64 blockOffset = clusterHeader.dataOffset() + cueReference->relativePosition;
+            const auto child = lower_bound(clusterChildren.cbegin(), clusterChildren.cend(), blockOffset,
+                [](const EbmlElementHeader &header, uint64 offset) { return header.startOffset < offset; });
+            if (child != clusterChildren.cend() && child->startOffset == blockOffset) {
+                switch (child->id) {
+                case MatroskaIds::SimpleBlock:
+                case MatroskaIds::Block:
+                case MatroskaIds::BlockGroup:
+                    continue;
+                default:;
+                }
+            }
+            diag.emplace_back(DiagLevel::Critical,
+                "\"CueRelativePosition\" element does not point to \"Block\"-, \"BlockGroup\", or \"SimpleBlock\"-element (points to "
+                        % numberToString(blockOffset)
+                    + ").",
+                indexContext);
+        }
+
+        prevClusterSize = clusterEndOffset - clusterHeader.startOffset;
+        offset = clusterEndOffset;
+    }
+}
+
+/*!
+ * \brief Validates the element structure and the file index (cues) like validateElementStructure() and validateIndex() do
+ *        but processes the "Cluster"-elements concurrently.
+ *
+ * The segments are split at "Cluster"-boundaries into ranges which are validated by up to \a threadCount threads, each
+ * reading from its own file handle (see MatroskaClusterScanner). If \a threadCount is 0, the number of concurrent threads
+ * supported by the hardware is used. The children of "Cluster"-elements are validated by only reading their headers so no
+ * EbmlElement objects are created for them. The references of the "Cues"-elements are checked against the "Cluster"-elements
+ * found while splitting the segments and while scanning the ranges instead of seeking to each of them.
+ *
+ * The resulting messages do not depend on \a threadCount. Messages about the "Cluster"-elements are added in the order the
+ * elements appear in the file, after messages about other elements and before messages about the index.
+ *
+ * The size of padding/void elements will be accumulated and stored in at \a paddingSize if it is not a null pointer.
+ *
+ * \throws Throws Failure or a derived class when a parsing error occurs.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void MatroskaContainer::validateConcurrently(Diagnostics &diag, uint64 *paddingSize, unsigned int threadCount)
+{
+    static const string context("validating Matroska file index (cues)");
+    parseHeader(diag);
+    if (!m_firstElement) {
+        return;
+    }
+
+    // split the segments into ranges of "Cluster"-elements
+    MatroskaClusterScanner scanner(*this);
+    scanner.setThreadCount(threadCount);
+    scanner.determineRanges(diag);
+
+    // validate all elements besides "Cluster"-elements and gather references of "Cues"-elements
+    // note: EbmlElement objects are only created for the children of the segments which are not "Cluster"-elements.
+    Diagnostics indexDiag;
+    indexDiag.adoptSettings(diag);
+    vector<MatroskaCueReference> cueReferences;
+    bool cuesElementsFound = false;
+    uint64 currentOffset = 0;
+    for (EbmlElement *topLevelElement = m_firstElement.get(); topLevelElement; topLevelElement = topLevelElement->nextSibling()) {
+        topLevelElement->parse(diag);
+        if (topLevelElement->id() != MatroskaIds::Segment) {
+            validateElementAndChildren(*topLevelElement, diag, paddingSize);
+            continue;
+        }
+        const uint64 segmentDataOffset = topLevelElement->dataOffset(), segmentEndOffset = topLevelElement->endOffset();
+        for (const EbmlElementHeader &childHeader : scanner.segmentChildren()) {
+            if (childHeader.startOffset < segmentDataOffset || childHeader.startOffset >= segmentEndOffset) {
+                continue;
+            }
+            EbmlElement segmentChildElement(*this, childHeader.startOffset);
+            try {
+                segmentChildElement.parse(diag);
+                validateElementAndChildren(segmentChildElement, diag, paddingSize);
+                if (segmentChildElement.id() == MatroskaIds::Cues) {
+                    cuesElementsFound = true;
+                    validateCuesElement(*topLevelElement, segmentChildElement, currentOffset, indexDiag, &cueReferences);
+                }
+            } catch (const Failure &) {
+                // ignore critical errors in child structure to continue validating siblings
+            }
+        }
+        currentOffset += topLevelElement->totalSize();
+    }
+
+    // validate "Cluster" positions denoted by "CueClusterPosition"-elements
+    for (MatroskaCueReference &reference : cueReferences) {
+        if (!scanner.isCluster(reference.clusterOffset)) {
+            indexDiag.emplace_back(DiagLevel::Critical,
+                "\"CueClusterPosition\" element at " % numberToString(reference.clusterPositionOffset)
+                    + " does not point to \"Cluster\"-element (points to " + numberToString(reference.clusterOffset) + ").",
+                context);
+            reference.relativePosition = numeric_limits<uint64>::max();
+        }
+    }
+    // -> "Block" positions are validated when scanning the "Cluster"-elements
+    cueReferences.erase(remove_if(cueReferences.begin(), cueReferences.end(),
+                            [](const MatroskaCueReference &reference) { return reference.relativePosition == numeric_limits<uint64>::max(); }),
+        cueReferences.end());
+    stable_sort(cueReferences.begin(), cueReferences.end(),
+        [](const MatroskaCueReference &lhs, const MatroskaCueReference &rhs) { return lhs.clusterOffset < rhs.clusterOffset; });
+
+    // validate "Cluster"-elements concurrently
+    vector<uint64> rangePaddingSizes(scanner.ranges().size());
+    const auto maxIdLength = static_cast<uint32>(m_maxIdLength), maxSizeLength = static_cast<uint32>(m_maxSizeLength);
+    scanner.scan(
+        [&](istream &stream, const MatroskaClusterRange &range, Diagnostics &rangeDiag) {
+            validateClusterRange(stream, range, maxIdLength, maxSizeLength, cueReferences, rangePaddingSizes[range.index], rangeDiag);
+        },
+        diag);
+    if (paddingSize) {
+        for (const uint64 rangePaddingSize : rangePaddingSizes) {
+            *paddingSize += rangePaddingSize;
+        }
+    }
+
+    // add messages about the index
+    diag.append(move(indexDiag));
+    if (!cuesElementsFound) {
+        diag.emplace_back(DiagLevel::Information, "No \"Cues\"-elements (index) found.", context);
+    }
+}
+
+/*!
+ * \brief Verifies the CRC-32 checksum of the element with the specified \a header and the checksums of its children.
+ * \remarks
+ * - This is a helper for MatroskaContainer::validateChecksums() which is invoked concurrently for different "Cluster"-elements
+ *   so it must not access the element tree.
+ * - Only the headers of the children are read. The data is only read to compute checksums.
+ * - If \a totalCrc is not a null pointer, the checksum of the whole element is computed as well and stored at \a totalCrc. This
+ *   is required to verify the checksum of the parent without reading the data twice.
+ * \returns Returns the end offset of the element. It is less than header.endOffset() if the size of the element is unknown and
+ *          a sibling of the element has been encountered.
+ */
+uint64 verifyCrc32Checksums(istream &stream, const EbmlElementHeader &header, uint32 maxIdLength, uint32 maxSizeLength, uint32 *totalCrc,
+    Diagnostics &diag)
+{
+    static const string context("validating Matroska CRC-32 checksums");
+    uint64 endOffset = header.endOffset();
+    if (!EbmlElement::isParentId(header.id)) {
+        if (totalCrc) {
+            *totalCrc = EbmlElement::computeCrc32(stream, header.startOffset, endOffset);
+        }
+        return endOffset;
+    }
+
+    // verify checksums of children (only parents might have a "CRC-32"-element)
+    EbmlElementHeader crcHeader;
+    for (uint64 offset = header.dataOffset(); offset < endOffset;) {
+        EbmlElementHeader childHeader;
+        try {
+            childHeader = EbmlElement::readHeader(stream, offset, endOffset - offset, maxIdLength, maxSizeLength);
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical,
+                argsToString("Unable to parse EBML element at ", offset, "; checksums of subsequent children of the element at ", header.startOffset,
+                    " can not be verified."),
+                context);
+            break;
+        }
+        if (header.sizeUnknown && !(matroskaIdLevel(childHeader.id) > matroskaIdLevel(header.id))) {
+            // element is actually a sibling
+            endOffset = offset;
+            break;
+        }
+        if (offset == header.dataOffset() && childHeader.id == EbmlIds::Crc32) {
+            // the "CRC-32"-element must be the first child
+            crcHeader = childHeader;
+        }
+        offset = EbmlElement::isParentId(childHeader.id)
+            ? verifyCrc32Checksums(stream, childHeader, maxIdLength, maxSizeLength, nullptr, diag)
+            : childHeader.endOffset();
+    }
+
+    // verify own checksum
+    if (crcHeader.id != EbmlIds::Crc32) {
+        if (totalCrc) {
+            *totalCrc = EbmlElement::computeCrc32(stream, header.startOffset, endOffset);
+        }
+        return endOffset;
+    }
+    uint32 headerCrc = 0;
+    if (totalCrc) {
+        headerCrc = EbmlElement::computeCrc32(stream, header.startOffset, crcHeader.endOffset());
+    }
+    const uint32 actualCrc = EbmlElement::computeCrc32(stream, crcHeader.endOffset(), endOffset);
+    if (crcHeader.dataSize != 4) {
+        diag.emplace_back(DiagLevel::Warning,
+            argsToString("\"CRC-32\"-element at ", crcHeader.startOffset, " has an invalid size of ", crcHeader.dataSize, " bytes."), context);
+    } else {
+        char buff[4];
+        stream.seekg(static_cast<streamoff>(crcHeader.dataOffset()));
+        stream.read(buff, sizeof(buff));
+        const uint32 expectedCrc = LE::toUInt32(buff);
+        if (actualCrc != expectedCrc) {
+            diag.emplace_back(DiagLevel::Critical,
+                argsToString("CRC-32 checksum of element \"", matroskaIdName(header.id), "\" at ", header.startOffset, " is 0x",
+                    numberToString(actualCrc, 16), " but should be 0x", numberToString(expectedCrc, 16), " (as denoted by the \"CRC-32\"-element at ",
+                    crcHeader.startOffset, ")."),
+                context);
+        }
+    }
+    if (totalCrc) {
+        *totalCrc = static_cast<uint32>(crc32_combine(headerCrc, actualCrc, static_cast<z_off_t>(endOffset - crcHeader.endOffset())));
+    }
+    return endOffset;
+}
+
+/*!
+ * \brief Verifies the CRC-32 checksums of all elements and their children (including "Cluster"-elements).
+ *
+ * Checksums are denoted by "CRC-32"-elements which might be present as first child of any master element. The
+ * "Cluster"-elements are processed concurrently by up to \a threadCount threads (see MatroskaClusterScanner). If
+ * \a threadCount is 0, the number of concurrent threads supported by the hardware is used. Checksums of whole segments
+ * are assembled from the checksums of their children so the data is only read once.
+ *
+ * Mismatches are reported as critical messages containing the offset of the affected element.
+ *
+ * \throws Throws Failure or a derived class when a parsing error occurs.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void MatroskaContainer::validateChecksums(Diagnostics &diag, unsigned int threadCount)
+{
+    static const string context("validating Matroska CRC-32 checksums");
+    parseHeader(diag);
+    if (!m_firstElement) {
+        return;
+    }
+
+    // split the segments into ranges of "Cluster"-elements
+    MatroskaClusterScanner scanner(*this);
+    scanner.setThreadCount(threadCount);
+    scanner.determineRanges(diag);
+    const auto &ranges = scanner.ranges();
+
+    // verify checksums of all elements besides "Cluster"-elements
+    struct SegmentChecksum {
+        EbmlElementHeader segmentHeader;
+        EbmlElementHeader crcHeader;
+        vector<tuple<uint64, uint64, uint32>> childCrcs; // start offset, end offset, checksum
+    };
+    vector<SegmentChecksum> segmentChecksums;
+    const auto maxIdLength = static_cast<uint32>(m_maxIdLength), maxSizeLength = static_cast<uint32>(m_maxSizeLength);
+    const uint64 fileEndOffset = fileInfo().size();
+    for (EbmlElement *topLevelElement = m_firstElement.get(); topLevelElement; topLevelElement = topLevelElement->nextSibling()) {
+        topLevelElement->parse(diag);
+        const EbmlElementHeader header = EbmlElement::readHeader(
+            stream(), topLevelElement->startOffset(), fileEndOffset - topLevelElement->startOffset(), maxIdLength, maxSizeLength);
+        if (topLevelElement->id() != MatroskaIds::Segment) {
+            verifyCrc32Checksums(stream(), header, maxIdLength, maxSizeLength, nullptr, diag);
+            continue;
+        }
+
+        // verify checksums of children
+        SegmentChecksum segmentChecksum;
+        segmentChecksum.segmentHeader = header;
+        // note: "Cluster"-elements are not contained by segmentChildren() because they are verified concurrently.
+        try {
+            for (const EbmlElementHeader &childHeader : scanner.segmentChildren()) {
+                const uint64 childStartOffset = childHeader.startOffset;
+                if (childStartOffset < header.dataOffset() || childStartOffset >= header.endOffset()) {
+                    continue;
+                }
+                if (childHeader.id == EbmlIds::Crc32 && childStartOffset == header.dataOffset()) {
+                    segmentChecksum.crcHeader = childHeader;
+                    continue;
+                }
+                // skip elements within ranges of "Cluster"-elements (also verified concurrently)
+                if (find_if(ranges.cbegin(), ranges.cend(),
+                        [childStartOffset](const MatroskaClusterRange &range) {
+                            return range.startOffset <= childStartOffset && childStartOffset < range.endOffset;
+                        })
+                    != ranges.cend()) {
+                    continue;
+                }
+                uint32 childCrc = 0;
+                const uint64 childEndOffset = verifyCrc32Checksums(stream(), childHeader, maxIdLength, maxSizeLength,
+                    segmentChecksum.crcHeader.id == EbmlIds::Crc32 ? &childCrc : nullptr, diag);
+                segmentChecksum.childCrcs.emplace_back(childStartOffset, childEndOffset, childCrc);
+            }
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical, "Unable to parse all childs of \"Segment\"-element.", context);
+        }
+        if (segmentChecksum.crcHeader.id == EbmlIds::Crc32) {
+            segmentChecksums.emplace_back(move(segmentChecksum));
+        }
+    }
+
+    // verify checksums of "Cluster"-elements concurrently
+    // note: Checksums of whole ranges are only required if the segment has a checksum.
+    vector<uint32> rangeCrcs(ranges.size());
+    scanner.scan(
+        [&](istream &stream, const MatroskaClusterRange &range, Diagnostics &rangeDiag) {
+            const bool computeRangeCrc = find_if(segmentChecksums.cbegin(), segmentChecksums.cend(), [&range](const SegmentChecksum &checksum) {
+                return checksum.segmentHeader.dataOffset() == range.segmentDataOffset;
+            }) != segmentChecksums.cend();
+            uint32 rangeCrc = 0;
+            for (uint64 offset = range.startOffset; offset < range.endOffset;) {
+                const EbmlElementHeader header = EbmlElement::readHeader(stream, offset, range.endOffset - offset, maxIdLength, maxSizeLength);
+                uint32 elementCrc = 0;
+                uint64 endOffset;
+                if (header.id == MatroskaIds::Cluster) {
+                    endOffset = verifyCrc32Checksums(stream, header, maxIdLength, maxSizeLength, computeRangeCrc ? &elementCrc : nullptr, rangeDiag);
+                } else {
+                    // other elements between the "Cluster"-elements are only relevant for the checksum of the segment
+                    endOffset = header.endOffset();
+                    if (computeRangeCrc) {
+                        elementCrc = EbmlElement::computeCrc32(stream, offset, endOffset);
+                    }
+                }
+                rangeCrc = static_cast<uint32>(crc32_combine(rangeCrc, elementCrc, static_cast<z_off_t>(endOffset - offset)));
+                offset = endOffset;
+            }
+            rangeCrcs[range.index] = rangeCrc;
+        },
+        diag);
+
+    // verify checksums of segments by combining the checksums of their children
+    for (SegmentChecksum &segmentChecksum : segmentChecksums) {
+        const uint64 segmentDataOffset = segmentChecksum.segmentHeader.dataOffset();
+        for (const MatroskaClusterRange &range : ranges) {
+            if (range.segmentDataOffset == segmentDataOffset) {
+                segmentChecksum.childCrcs.emplace_back(range.startOffset, range.endOffset, rangeCrcs[range.index]);
+            }
+        }
+        sort(segmentChecksum.childCrcs.begin(), segmentChecksum.childCrcs.end());
+        uint32 actualCrc = 0;
+        uint64 offset = segmentChecksum.crcHeader.endOffset();
+        for (const auto &childCrc : segmentChecksum.childCrcs) {
+            if (get<0>(childCrc) != offset) {
+                // compute checksum of data not covered by any child (eg. when parsing children failed)
+                actualCrc = EbmlElement::computeCrc32(stream(), offset, get<0>(childCrc), actualCrc);
+            }
+            actualCrc = static_cast<uint32>(crc32_combine(actualCrc, get<2>(childCrc), static_cast<z_off_t>(get<1>(childCrc) - get<0>(childCrc))));
+            offset = get<1>(childCrc);
+        }
+        actualCrc = EbmlElement::computeCrc32(stream(), offset, segmentChecksum.segmentHeader.endOffset(), actualCrc);
+        if (segmentChecksum.crcHeader.dataSize != 4) {
+            diag.emplace_back(DiagLevel::Warning,
+                argsToString("\"CRC-32\"-element at ", segmentChecksum.crcHeader.startOffset, " has an invalid size of ",
+                    segmentChecksum.crcHeader.dataSize, " bytes."),
+                context);
+            continue;
+        }
+        stream().seekg(static_cast<streamoff>(segmentChecksum.crcHeader.dataOffset()));
+        const uint32 expectedCrc = reader().readUInt32LE();
+        if (actualCrc != expectedCrc) {
+            diag.emplace_back(DiagLevel::Critical,
+                argsToString("CRC-32 checksum of element \"Segment\" at ", segmentChecksum.segmentHeader.startOffset, " is 0x",
+                    numberToString(actualCrc, 16), " but should be 0x", numberToString(expectedCrc, 16),
+                    " (as denoted by the \"CRC-32\"-element at ", segmentChecksum.crcHeader.startOffset, ")."),
+                context);
+        }
+    }
+}
+
+/*!
+ * \brief Adds the block with the specified \a blockHeader to the specified \a statistics.
+ * \remarks This is a helper for MatroskaContainer::readTrackStatisticsFromBlocks().
+ * \param clusterTimecode Specifies the timecode of the "Cluster"-element containing the block.
+ * \param timeScale Specifies the timecode scale of the segment containing the block.
+ * \param blockDuration Specifies the duration of the block (denoted by "BlockDuration"-element) or 0 if unknown.
+ * \param keyframe Specifies whether the block is a keyframe; ignored for "SimpleBlock"-elements since they denote it themselves.
+ * \param defaultDurations Specifies the default duration of a frame in nanoseconds for each track number. It is used if
+ *        \a blockDuration is unknown (always the case for "SimpleBlock"-elements).
+ */
+void addBlockToStatistics(istream &stream, const EbmlElementHeader &blockHeader, uint64 clusterTimecode, uint64 timeScale, uint64 blockDuration,
+    bool keyframe, const unordered_map<uint64, uint64> &defaultDurations, unordered_map<uint64, MatroskaBlockStatistics> &statistics)
+{
+    // read block header: track number (variable size integer), relative timecode (16-bit), flags, number of frames (if laced)
+    byte buff[8 + 2 + 1 + 1] = { 0 };
+    const auto bytesToRead = static_cast<streamsize>(min<uint64>(blockHeader.dataSize, sizeof(buff)));
+    stream.seekg(static_cast<streamoff>(blockHeader.dataOffset()));
+    stream.read(reinterpret_cast<char *>(buff), bytesToRead);
+    byte trackNumberLength = 1;
+    for (byte mask = 0x80; trackNumberLength <= 8 && !(buff[0] & mask); ++trackNumberLength, mask >>= 1)
+        ;
+    const uint64 headerLength = trackNumberLength + 2u + 1u;
+    if (trackNumberLength > 8 || headerLength > static_cast<uint64>(bytesToRead)) {
+        throw InvalidDataException();
+    }
+    uint64 trackNumber = buff[0] & (0xFF >> trackNumberLength);
+    for (byte i = 1; i < trackNumberLength; ++i) {
+        trackNumber = (trackNumber << 8) | buff[i];
+    }
+    const auto relativeTimecode = static_cast<int16>((buff[trackNumberLength] << 8) | buff[trackNumberLength + 1]);
+    const byte flags = buff[trackNumberLength + 2];
+    uint64 frameCount = 1;
+    if (flags & 0x06) {
+        if (headerLength + 1 > static_cast<uint64>(bytesToRead)) {
+            throw InvalidDataException();
+        }
+        frameCount += buff[headerLength];
+    }
+
+    // update statistics
+    MatroskaBlockStatistics &trackStatistics = statistics[trackNumber];
+    const int64 timestamp = (static_cast<int64>(clusterTimecode) + relativeTimecode) * static_cast<int64>(timeScale);
+    const uint64 byteCount = blockHeader.dataSize - headerLength;
+    uint64 duration = blockDuration * timeScale;
+    if (!duration) {
+        const auto defaultDuration = defaultDurations.find(trackNumber);
+        if (defaultDuration != defaultDurations.cend()) {
+            duration = frameCount * defaultDuration->second;
+        }
+    }
+    trackStatistics.trackNumber = trackNumber;
+    trackStatistics.byteCount += byteCount;
+    trackStatistics.frameCount += frameCount;
+    if (blockHeader.id == MatroskaIds::SimpleBlock ? (flags & 0x80) : keyframe) {
+        ++trackStatistics.keyframeCount;
+    }
+    trackStatistics.firstTimestamp = min(trackStatistics.firstTimestamp, timestamp);
+    trackStatistics.lastTimestamp = max(trackStatistics.lastTimestamp, timestamp + static_cast<int64>(duration));
+    trackStatistics.bytesPerSecond[timestamp / 1000000000] += byteCount;
+}
+
+/*!
+ * \brief Gathers statistics about the blocks of the "Cluster"-elements within the specified \a range.
+ * \remarks
+ * - This is a helper for MatroskaContainer::readTrackStatisticsFromBlocks() which is invoked concurrently for different ranges
+ *   so it must not access the element tree.
+ * - Only the headers of the elements and blocks are read.
+ */
+void gatherBlockStatistics(istream &stream, const MatroskaClusterRange &range, uint32 maxIdLength, uint32 maxSizeLength, uint64 timeScale,
+    const unordered_map<uint64, uint64> &defaultDurations, unordered_map<uint64, MatroskaBlockStatistics> &statistics, Diagnostics &diag)
+{
+    static const string context("gathering Matroska block statistics");
+    for (uint64 offset = range.startOffset; offset < range.endOffset;) {
+        const EbmlElementHeader clusterHeader = EbmlElement::readHeader(stream, offset, range.endOffset - offset, maxIdLength, maxSizeLength);
+        if (clusterHeader.id != MatroskaIds::Cluster) {
+            offset = clusterHeader.endOffset();
+            continue;
+        }
+        uint64 clusterTimecode = 0, clusterEndOffset = clusterHeader.endOffset();
+        for (offset = clusterHeader.dataOffset(); offset < clusterEndOffset;) {
+            EbmlElementHeader childHeader;
+            try {
+                childHeader = EbmlElement::readHeader(stream, offset, clusterEndOffset - offset, maxIdLength, maxSizeLength);
+                if (clusterHeader.sizeUnknown && !(matroskaIdLevel(childHeader.id) > MatroskaElementLevel::Level1)) {
+                    // element is actually a sibling of the "Cluster"-element
+                    clusterEndOffset = offset;
+                    break;
+                }
+                switch (childHeader.id) {
+                case MatroskaIds::Timecode:
+                    clusterTimecode = readUInteger(stream, childHeader);
+                    break;
+                case MatroskaIds::SimpleBlock:
+                    addBlockToStatistics(stream, childHeader, clusterTimecode, timeScale, 0, false, defaultDurations, statistics);
+                    break;
+                case MatroskaIds::BlockGroup: {
+                    EbmlElementHeader blockHeader;
+                    uint64 blockDuration = 0;
+                    bool keyframe = true;
+                    for (uint64 groupChildOffset = childHeader.dataOffset(); groupChildOffset < childHeader.endOffset();) {
+                        const EbmlElementHeader groupChildHeader = EbmlElement::readHeader(
+                            stream, groupChildOffset, childHeader.endOffset() - groupChildOffset, maxIdLength, maxSizeLength);
+                        switch (groupChildHeader.id) {
+                        case MatroskaIds::Block:
+                            blockHeader = groupChildHeader;
+                            break;
+                        case MatroskaIds::BlockDuration:
+                            blockDuration = readUInteger(stream, groupChildHeader);
+                            break;
+                        case MatroskaIds::ReferenceBlock:
+                            keyframe = false;
+                            break;
+                        default:;
+                        }
+                        groupChildOffset = groupChildHeader.endOffset();
+                    }
+                    if (blockHeader.id == MatroskaIds::Block) {
+                        addBlockToStatistics(stream, blockHeader, clusterTimecode, timeScale, blockDuration, keyframe, defaultDurations, statistics);
+                    }
+                    break;
+                }
+                default:;
+                }
+            } catch (const Failure &) {
+                diag.emplace_back(DiagLevel::Warning,
+                    argsToString("Unable to parse block at ", offset, "; skipping remaining blocks of the \"Cluster\"-element at ",
+                        clusterHeader.startOffset, '.'),
+                    context);
+                break;
+            }
+            offset = childHeader.endOffset();
+        }
+        offset = clusterEndOffset;
+    }
+}
+
+/*!
+ * \brief Determines track statistics by scanning the blocks of all "Cluster"-elements.
+ *
+ * Unlike readTrackStatisticsFromTags() this works for files produced by any muxer. Only the headers of the elements and the
+ * blocks are read so no EbmlElement objects are created for the "Cluster"-elements and their children. The "Cluster"-elements
+ * are processed concurrently by up to \a threadCount threads (see MatroskaClusterScanner). If \a threadCount is 0, the number of
+ * concurrent threads supported by the hardware is used.
+ *
+ * The duration, the number of frames and keyframes, the size and the average and maximum bitrate of the tracks are updated
+ * accordingly. The maximum bitrate is determined over intervals of one second. The duration includes the duration of the last
+ * frame if it is known (see MatroskaBlockStatistics::lastTimestamp).
+ *
+ * \returns Returns the gathered statistics for each track in the order of tracks().
+ * \throws Throws Failure or a derived class when a parsing error occurs.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+vector<MatroskaBlockStatistics> MatroskaContainer::readTrackStatisticsFromBlocks(Diagnostics &diag, unsigned int threadCount)
+{
+    parseTracks(diag);
+
+    // determine the timecode scale of each segment
+    vector<pair<uint64, uint64>> timeScales; // segment data offset, timecode scale
+    for (EbmlElement *segmentElement = m_firstElement ? m_firstElement->siblingById(MatroskaIds::Segment, diag) : nullptr; segmentElement;
+         segmentElement = segmentElement->siblingById(MatroskaIds::Segment, diag)) {
+        uint64 timeScale = 1000000;
+        for (EbmlElement *segmentInfoElement : m_segmentInfoElements) {
+            if (segmentInfoElement->startOffset() < segmentElement->startOffset() || segmentInfoElement->startOffset() >= segmentElement->endOffset()) {
+                continue;
+            }
+            if (EbmlElement *timeScaleElement = segmentInfoElement->childById(MatroskaIds::TimeCodeScale, diag)) {
+                timeScale = timeScaleElement->readUInteger();
+            }
+            break;
+        }
+        timeScales.emplace_back(segmentElement->dataOffset(), timeScale);
+    }
+
+    // determine the default duration of each track
+    unordered_map<uint64, uint64> defaultDurations;
+    for (const auto &track : m_tracks) {
+        if (track->defaultDuration()) {
+            defaultDurations[track->trackNumber()] = track->defaultDuration();
+        }
+    }
+
+    // gather statistics concurrently
+    MatroskaClusterScanner scanner(*this);
+    scanner.setThreadCount(threadCount);
+    scanner.determineRanges(diag);
+    vector<unordered_map<uint64, MatroskaBlockStatistics>> rangeStatistics(scanner.ranges().size());
+    const auto maxIdLength = static_cast<uint32>(m_maxIdLength), maxSizeLength = static_cast<uint32>(m_maxSizeLength);
+    scanner.scan(
+        [&](istream &stream, const MatroskaClusterRange &range, Diagnostics &rangeDiag) {
+            const auto timeScale = find_if(timeScales.cbegin(), timeScales.cend(),
+                [&range](const pair<uint64, uint64> &timeScale) { return timeScale.first == range.segmentDataOffset; });
+            gatherBlockStatistics(stream, range, maxIdLength, maxSizeLength, timeScale != timeScales.cend() ? timeScale->second : 1000000,
+                defaultDurations, rangeStatistics[range.index], rangeDiag);
+        },
+        diag);
+
+    // merge statistics and apply them to the tracks
+    vector<MatroskaBlockStatistics> statistics(m_tracks.size());
+    for (size_t index = 0; index != m_tracks.size(); ++index) {
+        MatroskaBlockStatistics &trackStatistics = statistics[index];
+        trackStatistics.trackNumber = m_tracks[index]->trackNumber();
+        for (const auto &statisticsOfRange : rangeStatistics) {
+            const auto i = statisticsOfRange.find(trackStatistics.trackNumber);
+            if (i != statisticsOfRange.cend()) {
+                trackStatistics.add(i->second);
+            }
+        }
+        m_tracks[index]->readStatisticsFromBlocks(trackStatistics);
+    }
+    return statistics;
+}
+
 /*!
  * \brief Returns an indication whether \a offset equals the start offset of \a element.
  */
@@ -467,8 +1207,9 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag)
                     }
                 }
                 break;
-            case MatroskaIds::Segment:
+            case MatroskaIds::Segment: {
                 ++m_segmentCount;
+                bool seekHeadFound = false;
                 for (EbmlElement *subElement = topLevelElement->firstChild(); subElement; subElement = subElement->nextSibling()) {
                     try {
                         subElement->parse(diag);
@@ -476,6 +1217,7 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag)
                         case MatroskaIds::SeekHead:
                             m_seekInfos.emplace_back(make_unique<MatroskaSeekInfo>());
                             m_seekInfos.back()->parse(subElement, diag);
+                            seekHeadFound = true;
                             break;
                         case MatroskaIds::Tracks:
                             if (excludesOffset(m_tracksElements, subElement->startOffset())) {
@@ -562,6 +1304,13 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag)
                                     }
                                 }
                             }
+                            if (fileInfo().isParsingSegmentsLazily()) {
+                                // rely on the "SeekHead"-element if present; otherwise hop over the remaining elements
+                                if (!seekHeadFound || m_segmentInfoElements.empty() || m_tracksElements.empty()) {
+                                    skipScanSegment(*topLevelElement, subElement->startOffset(), diag);
+                                }
+                                goto nextTopLevelElement;
+                            }
                             // not checking if m_tagsElements is empty avoids long parsing times when loading big files
                             // but also has the disadvantage that the parser relies on the presence of a SeekHead element
                             // (which is not mandatory) to detect tags at the end of the segment
@@ -576,8 +1325,10 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag)
                         break;
                     }
                 }
+            nextTopLevelElement:
                 currentOffset += topLevelElement->totalSize();
                 break;
+            }
             default:;
             }
         } catch (const Failure &) {
@@ -644,6 +1395,80 @@ void MatroskaContainer::parseSegmentInfo(Diagnostics &diag)
     }
 }
 
+/*!
+ * \brief Gathers the relevant elements of the specified \a segmentElement starting at \a startOffset.
+ *
+ * This private method is called when parsing the header lazily and no "SeekHead"-element is present. Only the header of
+ * each element is read (see EbmlElement::readHeader()) so no EbmlElement objects are created for the "Cluster"-elements
+ * and their children. The end of "Cluster"-elements with unknown size is determined by reading only the headers of their
+ * children (see MatroskaClusterScanner::determineClusterEndOffset()). The scan stops at the end of the segment, at any other
+ * element with unknown size or at invalid data.
+ */
+void MatroskaContainer::skipScanSegment(const EbmlElement &segmentElement, uint64 startOffset, Diagnostics &diag)
+{
+    static const string context("scanning Matroska segment");
+    const uint64 segmentEndOffset = segmentElement.endOffset();
+    for (uint64 offset = startOffset; offset < segmentEndOffset;) {
+        EbmlElementHeader header;
+        try {
+            header = EbmlElement::readHeader(stream(), offset, segmentEndOffset - offset, static_cast<uint32>(m_maxIdLength),
+                static_cast<uint32>(m_maxSizeLength));
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Warning,
+                argsToString("Unable to read header of EBML element at ", offset, "; subsequent elements of the segment are not considered."),
+                context);
+            return;
+        }
+
+        // gather relevant elements
+        vector<EbmlElement *> *elements;
+        switch (header.id) {
+        case MatroskaIds::SegmentInfo:
+            elements = &m_segmentInfoElements;
+            break;
+        case MatroskaIds::Tracks:
+            elements = &m_tracksElements;
+            break;
+        case MatroskaIds::Tags:
+            elements = &m_tagsElements;
+            break;
+        case MatroskaIds::Chapters:
+            elements = &m_chaptersElements;
+            break;
+        case MatroskaIds::Attachments:
+            elements = &m_attachmentsElements;
+            break;
+        default:
+            elements = nullptr;
+        }
+        if (elements && excludesOffset(*elements, offset)) {
+            m_additionalElements.emplace_back(make_unique<EbmlElement>(*this, offset));
+            elements->emplace_back(m_additionalElements.back().get());
+        }
+
+        // hop to the next element
+        if (!header.sizeUnknown) {
+            offset = header.endOffset();
+            continue;
+        }
+        if (header.id != MatroskaIds::Cluster) {
+            diag.emplace_back(DiagLevel::Information,
+                argsToString("Size of EBML element at ", offset, " is unknown; subsequent elements of the segment are not considered."), context);
+            return;
+        }
+        try {
+            offset = MatroskaClusterScanner::determineClusterEndOffset(
+                stream(), header, static_cast<uint32>(m_maxIdLength), static_cast<uint32>(m_maxSizeLength));
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Warning,
+                argsToString("Unable to determine the end of the \"Cluster\"-element at ", offset,
+                    "; subsequent elements of the segment are not considered."),
+                context);
+            return;
+        }
+    }
+}
+
 /*!
  * \brief Reads track-specific statistics from tags.
  * \remarks Tags and tracks must have been parsed before calling this method.
@@ -1247,9 +2072,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                 // check whether aborted (because this loop might take some seconds to process)
                                 progress.stopIfAborted();
                                 // update the progress percentage (using offset / file size should be accurate enough)
-                                if (index % 50 == 0) {
-                                    progress.updateStepPercentage(static_cast<byte>(level1Element->dataOffset() * 100 / fileInfo().size()));
-                                }
+                                progress.updateBytesProcessed(level1Element->dataOffset(), fileInfo().size());
                             }
                             if (cuesInvalidated) {
                                 segment.totalDataSize = offset;
@@ -1391,9 +2214,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                         // check whether aborted (because this loop might take some seconds to process)
                         progress.stopIfAborted();
                         // update the progress percentage (using offset / file size should be accurate enough)
-                        if ((index % 50 == 0) && fileInfo().size()) {
-                            progress.updateStepPercentage(static_cast<byte>(level1Element->dataOffset() * 100 / fileInfo().size()));
-                        }
+                        progress.updateBytesProcessed(level1Element->dataOffset(), fileInfo().size());
                         // TODO: reduce code duplication for aborting and progress updates
                     }
                     // check whether the total size of the "Cues"-element has been invalidated and recompute cluster if required
@@ -1525,9 +2346,23 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
         // TODO: reduce code duplication
 
     } else { // !rewriteRequired
-        // buffer currently assigned attachments
+        // buffer currently assigned attachments unless they are located after the offset they are moved to
+        // -> only possible to tell for a single segment because the "Attachments"-element is written for each segment
+        // -> assume the maximum size denotation length for the "Segment"- and "Attachments"-element to be on the safe side
+        uint64 attachedFileOffset = numeric_limits<uint64>::max();
+        if (segmentData.size() == 1) {
+            for (const auto &info : segmentData.front().seekInfo.info()) {
+                if (info.first == MatroskaIds::Attachments) {
+                    attachedFileOffset = segmentData.front().startOffset + 4 + 8 + info.second + 4 + 8;
+                    break;
+                }
+            }
+        }
         for (auto &maker : attachmentMaker) {
-            maker.bufferCurrentAttachments(diag);
+            maker.bufferCurrentAttachments(diag, attachedFileOffset);
+            if (attachedFileOffset != numeric_limits<uint64>::max()) {
+                attachedFileOffset += maker.requiredSize();
+            }
         }
 
         // reopen original file to ensure it is opened for writing
@@ -1686,9 +2521,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                     outputWriter.writeByte(EbmlIds::Void);
                     outputStream.write(buff, sizeLength);
                     // write zeroes
-                    for (; voidLength; --voidLength) {
-                        outputStream.put(0);
-                    }
+                    PaddingHelper::writeZeroes(outputStream, voidLength);
                 }
 
                 // write media data / "Cluster"-elements
@@ -1699,8 +2532,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                         "Writing cluster ...", static_cast<byte>((static_cast<uint64>(outputStream.tellp()) - offset) * 100 / segment.totalDataSize));
                     // write "Cluster"-element
                     auto clusterSizesIterator = segment.clusterSizes.cbegin();
-                    unsigned int index = 0;
-                    for (; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag), ++clusterSizesIterator, ++index) {
+                    for (; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag), ++clusterSizesIterator) {
                         // calculate position of cluster in segment
                         clusterSize = currentPosition + (static_cast<uint64>(outputStream.tellp()) - offset);
                         // write header; checking whether clusterSizesIterator is valid shouldn't be necessary
@@ -1720,19 +2552,19 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                 level2Element->copyEntirely(outputStream, diag, nullptr);
                             }
                         }
-                        // update percentage, check whether the operation has been aborted
+                        // update percentage (callbacks are throttled via callbackInterval()), check whether the operation has been aborted
                         progress.stopIfAborted();
-                        if (index % 50 == 0) {
-                            progress.updateStepPercentage(
-                                static_cast<byte>((static_cast<uint64>(outputStream.tellp()) - offset) * 100 / segment.totalDataSize));
-                        }
+                        progress.updateBytesProcessed(static_cast<uint64>(outputStream.tellp()) - offset, segment.totalDataSize);
                     }
                 } else {
                     // can't just skip existing "Cluster"-elements: "Position"-elements must be updated
                     progress.nextStepOrStop("Updateing cluster ...",
                         static_cast<byte>((static_cast<uint64>(outputStream.tellp()) - offset) * 100 / segment.totalDataSize));
-                    for (; level1Element; level1Element = level1Element->nextSibling()) {
-                        for (level2Element = level1Element->firstChild(); level2Element; level2Element = level2Element->nextSibling()) {
+                    for (; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag)) {
+                        EbmlElement *const firstChild = level1Element->firstChild();
+                        for (level2Element = firstChild; level2Element; level2Element = level2Element->nextSibling()) {
+                            // the children have not been parsed yet when no rewrite has been considered when calculating the sizes
+                            level2Element->parse(diag);
                             switch (level2Element->id()) {
                             case MatroskaIds::Position:
                                 // calculate new position
@@ -1748,6 +2580,10 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                     outputStream.seekp(static_cast<streamoff>(level2Element->dataOffset()));
                                     outputStream.write(buff, sizeLength);
                                 }
+                                // update the CRC-32 checksum of the "Cluster"-element (if present) after all data has been written
+                                if (firstChild->id() == EbmlIds::Crc32 && firstChild->totalSize() == 6) {
+                                    crc32Offsets.emplace_back(firstChild->startOffset(), level1Element->endOffset() - firstChild->startOffset());
+                                }
                                 break;
                             default:;
                             }
@@ -1846,10 +2682,12 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
         // update CRC-32 checksums
         if (!crc32Offsets.empty()) {
             progress.updateStep("Updating CRC-32 checksums ...");
-            for (const auto &crc32Offset : crc32Offsets) {
-                outputStream.seekg(static_cast<streamoff>(get<0>(crc32Offset) + 6));
+            // note: Checksums of nested elements have been added after the checksums of their parents so they need to be updated first.
+            for (auto i = crc32Offsets.crbegin(), end = crc32Offsets.crend(); i != end; ++i) {
+                const auto &crc32Offset = *i;
+                const uint32 crc = EbmlElement::computeCrc32(outputStream, get<0>(crc32Offset) + 6, get<0>(crc32Offset) + get<1>(crc32Offset));
                 outputStream.seekp(static_cast<streamoff>(get<0>(crc32Offset) + 2));
-                writer().writeUInt32LE(reader().readCrc32(get<1>(crc32Offset) - 6));
+                writer().writeUInt32LE(crc);
             }
         }
 
@@ -19,6 +19,7 @@ namespace TagParser {
 
 class MatroskaSeekInfo;
 class MatroskaEditionEntry;
+struct MatroskaCueReference;
 
 class MediaFileInfo;
 
@@ -28,6 +29,9 @@ public:
     ~MatroskaContainer() override;
 
     void validateIndex(Diagnostics &diag);
+    void validateConcurrently(Diagnostics &diag, uint64 *paddingSize = nullptr, unsigned int threadCount = 0);
+    void validateChecksums(Diagnostics &diag, unsigned int threadCount = 0);
+    std::vector<MatroskaBlockStatistics> readTrackStatisticsFromBlocks(Diagnostics &diag, unsigned int threadCount = 0);
     uint64 maxIdLength() const;
     uint64 maxSizeLength() const;
     const std::vector<std::unique_ptr<MatroskaSeekInfo>> &seekInfos() const;
@@ -58,7 +62,10 @@ protected:
     void internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress) override;
 
 private:
+    void validateCuesElement(EbmlElement &segmentElement, EbmlElement &cuesElement, uint64 currentOffset, Diagnostics &diag,
+        std::vector<MatroskaCueReference> *deferredReferences = nullptr);
     void parseSegmentInfo(Diagnostics &diag);
+    void skipScanSegment(const EbmlElement &segmentElement, uint64 startOffset, Diagnostics &diag);
     void readTrackStatisticsFromTags(Diagnostics &diag);
 
     uint64 m_maxIdLength;
@@ -111,7 +118,8 @@ inline const std::vector<std::unique_ptr<MatroskaSeekInfo>> &MatroskaContainer::
  *
  * The default value is 50 MiB.
  *
- * \sa setMaxFullParseSize()
+ * \remarks This limit is not taken into account when parsing lazily.
+ * \sa setMaxFullParseSize(), MediaFileInfo::isParsingSegmentsLazily()
  */
 inline uint64 MatroskaContainer::maxFullParseSize()
 {
@@ -2,9 +2,9 @@
 #include "./ebmlelement.h"
 
 #include "../diagnostics.h"
+#include "../namehashtable.h"
 
 #include <initializer_list>
-#include <map>
 #include <stdexcept>
 
 using namespace std;
@@ -73,13 +73,14 @@ MatroskaTag::IdentifierType MatroskaTag::internallyGetFieldId(KnownField field)
 KnownField MatroskaTag::internallyGetKnownField(const IdentifierType &id) const
 {
     using namespace MatroskaTagIds;
-    static const map<string, KnownField> fieldMap({
+    static constexpr NameHashTableEntry<KnownField> fieldNames[] = {
         { artist(), KnownField::Artist },
         { album(), KnownField::Album },
         { comment(), KnownField::Comment },
         { dateRecorded(), KnownField::RecordDate },
         { dateRelease(), KnownField::Year },
         { title(), KnownField::Title },
+        { genre(), KnownField::Genre },
         { partNumber(), KnownField::PartNumber },
         { totalParts(), KnownField::TotalParts },
         { encoder(), KnownField::Encoder },
@@ -95,9 +96,10 @@ KnownField MatroskaTag::internallyGetKnownField(const IdentifierType &id) const
         { composer(), KnownField::Composer },
         { duration(), KnownField::Length },
         { language(), KnownField::Language },
-    });
-    const auto knownField(fieldMap.find(id));
-    return knownField != fieldMap.cend() ? knownField->second : KnownField::Invalid;
+    };
+    static constexpr auto fieldTable = makeNameHashTable<false>(fieldNames);
+    const KnownField *const knownField = fieldTable.find(id);
+    return knownField ? *knownField : KnownField::Invalid;
 }
 
 /*!
@@ -34,6 +34,14 @@ MatroskaTagField::MatroskaTagField(const string &id, const TagValue &value)
 {
 }
 
+/*!
+ * \brief Constructs a new MatroskaTagField with the specified \a id moving the specified \a value into the field.
+ */
+MatroskaTagField::MatroskaTagField(const string &id, TagValue &&value)
+    : TagField<MatroskaTagField>(id, move(value))
+{
+}
+
 /*!
  * \brief Parses field information from the specified EbmlElement.
  *
@@ -253,7 +261,7 @@ void MatroskaTagFieldMaker::make(ostream &stream) const
         writer.writeUInt16BE(MatroskaIds::TagBinary);
         sizeDenotationLen = EbmlElement::makeSizeDenotation(m_field.value().dataSize(), buff);
         stream.write(buff, sizeDenotationLen);
-        stream.write(m_field.value().dataPointer(), m_field.value().dataSize());
+        m_field.value().copyDataTo(stream);
     } else {
         writer.writeUInt16BE(MatroskaIds::TagString);
         sizeDenotationLen = EbmlElement::makeSizeDenotation(m_stringValue.size(), buff);
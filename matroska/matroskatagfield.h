@@ -68,6 +68,7 @@ class TAG_PARSER_EXPORT MatroskaTagField : public TagField<MatroskaTagField> {
 public:
     MatroskaTagField();
     MatroskaTagField(const std::string &id, const TagValue &value);
+    MatroskaTagField(const std::string &id, TagValue &&value);
 
     void reparse(EbmlElement &simpleTagElement, Diagnostics &diag, bool parseNestedFields = true);
     MatroskaTagFieldMaker prepareMaking(Diagnostics &diag);
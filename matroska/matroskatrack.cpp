@@ -15,9 +15,12 @@
 
 #include "../exceptions.h"
 #include "../mediaformat.h"
+#include "../namehashtable.h"
 
 #include <c++utilities/conversion/stringconversion.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace ConversionUtilities;
 
@@ -37,6 +40,8 @@ namespace TagParser {
 MatroskaTrack::MatroskaTrack(EbmlElement &trackElement)
     : AbstractTrack(trackElement.stream(), trackElement.startOffset())
     , m_trackElement(&trackElement)
+    , m_defaultDuration(0)
+    , m_keyframeCount(0)
 {
 }
 
@@ -57,151 +62,88 @@ TrackType MatroskaTrack::type() const
  */
 MediaFormat MatroskaTrack::codecIdToMediaFormat(const string &codecId)
 {
-    auto parts = splitString<vector<string>>(codecId, "/", EmptyPartsTreat::Keep, 3);
-    parts.resize(3);
-    const auto &part1 = parts[0], &part2 = parts[1], &part3 = parts[2];
-    MediaFormat fmt;
-    if (part1 == "V_MS" && part2 == "VFW" && part3 == "FOURCC") {
-        fmt.general = GeneralMediaFormat::MicrosoftVideoCodecManager;
-    } else if (part1 == "V_UNCOMPRESSED") {
-        fmt.general = GeneralMediaFormat::UncompressedVideoFrames;
-    } else if (part1 == "V_MPEG4") {
-        fmt.general = GeneralMediaFormat::Mpeg4Video;
-        if (part2 == "ISO") {
-            if (part3 == "SP") {
-                fmt.sub = SubFormats::Mpeg4SimpleProfile1;
-            } else if (part3 == "ASP") {
-                fmt.sub = SubFormats::Mpeg4AdvancedSimpleProfile1;
-            } else if (part3 == "AVC") {
-                fmt.general = GeneralMediaFormat::Avc;
-            }
-        } else if (part2 == "MS" && part3 == "V3") {
-            fmt.sub = SubFormats::Mpeg4SimpleProfile1;
-        }
-    } else if (part1 == "V_MPEG1") {
-        fmt.general = GeneralMediaFormat::Mpeg1Video;
-    } else if (part1 == "V_MPEG2") {
-        fmt.general = GeneralMediaFormat::Mpeg2Video;
-    } else if (part1 == "V_REAL") {
-        fmt.general = GeneralMediaFormat::RealVideo;
-    } else if (part1 == "V_QUICKTIME") {
-        fmt.general = GeneralMediaFormat::QuicktimeVideo;
-    } else if (part1 == "V_THEORA") {
-        fmt.general = GeneralMediaFormat::Theora;
-    } else if (part1 == "V_PRORES") {
-        fmt.general = GeneralMediaFormat::ProRes;
-    } else if (part1 == "V_VP8") {
-        fmt.general = GeneralMediaFormat::Vp8;
-    } else if (part1 == "V_VP9") {
-        fmt.general = GeneralMediaFormat::Vp9;
-    } else if (part1 == "A_MPEG") {
-        fmt.general = GeneralMediaFormat::Mpeg1Audio;
-        if (part2 == "L1") {
-            fmt.sub = SubFormats::Mpeg1Layer1;
-        } else if (part2 == "L2") {
-            fmt.sub = SubFormats::Mpeg1Layer2;
-        } else if (part2 == "L3") {
-            fmt.sub = SubFormats::Mpeg1Layer3;
-        }
-    } else if (part1 == "V_MPEGH" && part2 == "ISO" && part3 == "HEVC") {
-        fmt.general = GeneralMediaFormat::Hevc;
-    } else if (part1 == "A_PCM") {
-        fmt.general = GeneralMediaFormat::Pcm;
-        if (part2 == "INT") {
-            if (part3 == "BIG") {
-                fmt.sub = SubFormats::PcmIntBe;
-            } else if (part3 == "LIT") {
-                fmt.sub = SubFormats::PcmIntLe;
-            }
-        } else if (part2 == "FLOAT" && part3 == "IEEE") {
-            fmt.sub = SubFormats::PcmFloatIeee;
-        }
-    } else if (part1 == "A_MPC") {
-        fmt.general = GeneralMediaFormat::Mpc;
-    } else if (part1 == "A_AC3") {
-        fmt.general = GeneralMediaFormat::Ac3;
-    } else if (part1 == "A_ALAC") {
-        fmt.general = GeneralMediaFormat::Alac;
-    } else if (part1 == "A_DTS") {
-        fmt.general = GeneralMediaFormat::Dts;
-        if (part2 == "EXPRESS") {
-            fmt.sub = SubFormats::DtsExpress;
-        } else if (part2 == "LOSSLESS") {
-            fmt.sub = SubFormats::DtsLossless;
-        }
-    } else if (part1 == "A_VORBIS") {
-        fmt.general = GeneralMediaFormat::Vorbis;
-    } else if (part1 == "A_FLAC") {
-        fmt.general = GeneralMediaFormat::Flac;
-    } else if (part1 == "A_OPUS") {
-        fmt.general = GeneralMediaFormat::Opus;
-    } else if (part1 == "A_REAL") {
-        fmt.general = GeneralMediaFormat::RealAudio;
-    } else if (part1 == "A_MS" && part2 == "ACM") {
-        fmt.general = GeneralMediaFormat::MicrosoftAudioCodecManager;
-    } else if (part1 == "A_AAC") {
-        fmt.general = GeneralMediaFormat::Aac;
-        if (part2 == "MPEG2") {
-            if (part3 == "MAIN") {
-                fmt.sub = SubFormats::AacMpeg2MainProfile;
-            } else if (part3 == "LC") {
-                fmt.sub = SubFormats::AacMpeg2LowComplexityProfile;
-            } else if (part3 == "SBR") {
-                fmt.sub = SubFormats::AacMpeg2LowComplexityProfile;
-                fmt.extension = ExtensionFormats::SpectralBandReplication;
-            } else if (part3 == "SSR") {
-                fmt.sub = SubFormats::AacMpeg2ScalableSamplingRateProfile;
-            }
-        } else if (part2 == "MPEG4") {
-            if (part3 == "MAIN") {
-                fmt.sub = SubFormats::AacMpeg4MainProfile;
-            } else if (part3 == "LC") {
-                fmt.sub = SubFormats::AacMpeg4LowComplexityProfile;
-            } else if (part3 == "SBR") {
-                fmt.sub = SubFormats::AacMpeg4LowComplexityProfile;
-                fmt.extension = ExtensionFormats::SpectralBandReplication;
-            } else if (part3 == "SSR") {
-                fmt.sub = SubFormats::AacMpeg4ScalableSamplingRateProfile;
-            } else if (part3 == "LTP") {
-                fmt.sub = SubFormats::AacMpeg4LongTermPrediction;
-            }
-        }
-    } else if (part1 == "A_QUICKTIME") {
-        fmt.general = GeneralMediaFormat::QuicktimeAudio;
-    } else if (part1 == "A_TTA1") {
-        fmt.general = GeneralMediaFormat::Tta;
-    } else if (part1 == "A_WAVPACK4") {
-        fmt.general = GeneralMediaFormat::WavPack;
-    } else if (part1 == "S_TEXT") {
-        fmt.general = GeneralMediaFormat::TextSubtitle;
-        if (part2 == "UTF8") {
-            fmt.sub = SubFormats::PlainUtf8Subtitle;
-        } else if (part2 == "SSA") {
-            fmt.sub = SubFormats::SubStationAlpha;
-        } else if (part2 == "ASS") {
-            fmt.sub = SubFormats::AdvancedSubStationAlpha;
-        } else if (part2 == "USF") {
-            fmt.sub = SubFormats::UniversalSubtitleFormat;
-        } else if (part2 == "WEBVTT") {
-            fmt.sub = SubFormats::WebVideoTextTracksFormat;
-        }
-    } else if (part1 == "S_IMAGE") {
-        fmt.general = GeneralMediaFormat::ImageSubtitle;
-        if (part2 == "BMP") {
-            fmt.sub = SubFormats::ImgSubBmp;
-        }
-    } else if (part1 == "S_VOBSUB") {
-        fmt.general = GeneralMediaFormat::VobSub;
-    } else if (part1 == "S_KATE") {
-        fmt.general = GeneralMediaFormat::OggKate;
-    } else if (part1 == "B_VOBBTN") {
-        fmt.general = GeneralMediaFormat::VobBtn;
-    } else if (part1 == "S_DVBSUB") {
-        fmt.general = GeneralMediaFormat::DvbSub;
-    } else if (part1 == "V_MSWMV") {
-        fmt.general = GeneralMediaFormat::Vc1;
+    using namespace SubFormats;
+    using namespace ExtensionFormats;
+    static constexpr NameHashTableEntry<MediaFormat> codecIds[] = {
+        { "V_MS/VFW/FOURCC", GeneralMediaFormat::MicrosoftVideoCodecManager },
+        { "V_UNCOMPRESSED", GeneralMediaFormat::UncompressedVideoFrames },
+        { "V_MPEG4", GeneralMediaFormat::Mpeg4Video },
+        { "V_MPEG4/ISO/SP", { GeneralMediaFormat::Mpeg4Video, Mpeg4SimpleProfile1 } },
+        { "V_MPEG4/ISO/ASP", { GeneralMediaFormat::Mpeg4Video, Mpeg4AdvancedSimpleProfile1 } },
+        { "V_MPEG4/ISO/AVC", GeneralMediaFormat::Avc },
+        { "V_MPEG4/MS/V3", { GeneralMediaFormat::Mpeg4Video, Mpeg4SimpleProfile1 } },
+        { "V_MPEG1", GeneralMediaFormat::Mpeg1Video },
+        { "V_MPEG2", GeneralMediaFormat::Mpeg2Video },
+        { "V_REAL", GeneralMediaFormat::RealVideo },
+        { "V_QUICKTIME", GeneralMediaFormat::QuicktimeVideo },
+        { "V_THEORA", GeneralMediaFormat::Theora },
+        { "V_PRORES", GeneralMediaFormat::ProRes },
+        { "V_VP8", GeneralMediaFormat::Vp8 },
+        { "V_VP9", GeneralMediaFormat::Vp9 },
+        { "A_MPEG", GeneralMediaFormat::Mpeg1Audio },
+        { "A_MPEG/L1", { GeneralMediaFormat::Mpeg1Audio, Mpeg1Layer1 } },
+        { "A_MPEG/L2", { GeneralMediaFormat::Mpeg1Audio, Mpeg1Layer2 } },
+        { "A_MPEG/L3", { GeneralMediaFormat::Mpeg1Audio, Mpeg1Layer3 } },
+        { "V_MPEGH/ISO/HEVC", GeneralMediaFormat::Hevc },
+        { "A_PCM", GeneralMediaFormat::Pcm },
+        { "A_PCM/INT/BIG", { GeneralMediaFormat::Pcm, PcmIntBe } },
+        { "A_PCM/INT/LIT", { GeneralMediaFormat::Pcm, PcmIntLe } },
+        { "A_PCM/FLOAT/IEEE", { GeneralMediaFormat::Pcm, PcmFloatIeee } },
+        { "A_MPC", GeneralMediaFormat::Mpc },
+        { "A_AC3", GeneralMediaFormat::Ac3 },
+        { "A_ALAC", GeneralMediaFormat::Alac },
+        { "A_DTS", GeneralMediaFormat::Dts },
+        { "A_DTS/EXPRESS", { GeneralMediaFormat::Dts, DtsExpress } },
+        { "A_DTS/LOSSLESS", { GeneralMediaFormat::Dts, DtsLossless } },
+        { "A_VORBIS", GeneralMediaFormat::Vorbis },
+        { "A_FLAC", GeneralMediaFormat::Flac },
+        { "A_OPUS", GeneralMediaFormat::Opus },
+        { "A_REAL", GeneralMediaFormat::RealAudio },
+        { "A_MS/ACM", GeneralMediaFormat::MicrosoftAudioCodecManager },
+        { "A_AAC", GeneralMediaFormat::Aac },
+        { "A_AAC/MPEG2/MAIN", { GeneralMediaFormat::Aac, AacMpeg2MainProfile } },
+        { "A_AAC/MPEG2/LC", { GeneralMediaFormat::Aac, AacMpeg2LowComplexityProfile } },
+        { "A_AAC/MPEG2/SBR", { GeneralMediaFormat::Aac, AacMpeg2LowComplexityProfile, SpectralBandReplication } },
+        { "A_AAC/MPEG2/SSR", { GeneralMediaFormat::Aac, AacMpeg2ScalableSamplingRateProfile } },
+        { "A_AAC/MPEG4/MAIN", { GeneralMediaFormat::Aac, AacMpeg4MainProfile } },
+        { "A_AAC/MPEG4/LC", { GeneralMediaFormat::Aac, AacMpeg4LowComplexityProfile } },
+        { "A_AAC/MPEG4/SBR", { GeneralMediaFormat::Aac, AacMpeg4LowComplexityProfile, SpectralBandReplication } },
+        { "A_AAC/MPEG4/SSR", { GeneralMediaFormat::Aac, AacMpeg4ScalableSamplingRateProfile } },
+        { "A_AAC/MPEG4/LTP", { GeneralMediaFormat::Aac, AacMpeg4LongTermPrediction } },
+        { "A_QUICKTIME", GeneralMediaFormat::QuicktimeAudio },
+        { "A_TTA1", GeneralMediaFormat::Tta },
+        { "A_WAVPACK4", GeneralMediaFormat::WavPack },
+        { "S_TEXT", GeneralMediaFormat::TextSubtitle },
+        { "S_TEXT/UTF8", { GeneralMediaFormat::TextSubtitle, PlainUtf8Subtitle } },
+        { "S_TEXT/SSA", { GeneralMediaFormat::TextSubtitle, SubStationAlpha } },
+        { "S_TEXT/ASS", { GeneralMediaFormat::TextSubtitle, AdvancedSubStationAlpha } },
+        { "S_TEXT/USF", { GeneralMediaFormat::TextSubtitle, UniversalSubtitleFormat } },
+        { "S_TEXT/WEBVTT", { GeneralMediaFormat::TextSubtitle, WebVideoTextTracksFormat } },
+        { "S_IMAGE", GeneralMediaFormat::ImageSubtitle },
+        { "S_IMAGE/BMP", { GeneralMediaFormat::ImageSubtitle, ImgSubBmp } },
+        { "S_VOBSUB", GeneralMediaFormat::VobSub },
+        { "S_KATE", GeneralMediaFormat::OggKate },
+        { "B_VOBBTN", GeneralMediaFormat::VobBtn },
+        { "S_DVBSUB", GeneralMediaFormat::DvbSub },
+        { "V_MSWMV", GeneralMediaFormat::Vc1 },
+    };
+    static constexpr auto codecIdTable = makeNameHashTable<false>(codecIds);
+
+    // look up the whole codec ID (if it has not more than 3 parts) and fall back to its first two parts and its first part
+    // so unknown profiles still map to the general format, eg. "A_AAC/MPEG4/FOO" to GeneralMediaFormat::Aac
+    const auto firstSlash = codecId.find('/');
+    const auto secondSlash = firstSlash != string::npos ? codecId.find('/', firstSlash + 1) : string::npos;
+    const MediaFormat *format = nullptr;
+    if (secondSlash == string::npos || codecId.find('/', secondSlash + 1) == string::npos) {
+        format = codecIdTable.find(codecId);
+    }
+    if (!format && secondSlash != string::npos) {
+        format = codecIdTable.find(codecId.data(), secondSlash);
+    }
+    if (!format && firstSlash != string::npos) {
+        format = codecIdTable.find(codecId.data(), firstSlash);
     }
-    return fmt;
+    return format ? *format : MediaFormat();
 }
 
 /// \cond
@@ -278,6 +220,44 @@ void MatroskaTrack::readStatisticsFromTags(const std::vector<std::unique_ptr<Mat
     }
 }
 
+/*!
+ * \brief Adds the statistics of \a other (which must refer to the same track) to these statistics.
+ */
+void MatroskaBlockStatistics::add(const MatroskaBlockStatistics &other)
+{
+    byteCount += other.byteCount;
+    frameCount += other.frameCount;
+    keyframeCount += other.keyframeCount;
+    firstTimestamp = min(firstTimestamp, other.firstTimestamp);
+    lastTimestamp = max(lastTimestamp, other.lastTimestamp);
+    for (const auto &bytes : other.bytesPerSecond) {
+        bytesPerSecond[bytes.first] += bytes.second;
+    }
+}
+
+/*!
+ * \brief Reads track-specific statistics from the specified block \a statistics.
+ * \remarks The statistics are usually gathered via MatroskaContainer::readTrackStatisticsFromBlocks().
+ */
+void MatroskaTrack::readStatisticsFromBlocks(const MatroskaBlockStatistics &statistics)
+{
+    if (!statistics.frameCount) {
+        return;
+    }
+    m_size = statistics.byteCount;
+    m_sampleCount = statistics.frameCount;
+    m_keyframeCount = statistics.keyframeCount;
+    if (statistics.lastTimestamp > statistics.firstTimestamp) {
+        const double seconds = static_cast<double>(statistics.lastTimestamp - statistics.firstTimestamp) / 1000000000.0;
+        m_duration = ChronoUtilities::TimeSpan::fromSeconds(seconds);
+        m_bitrate = static_cast<double>(statistics.byteCount) * 0.008 / seconds;
+    }
+    m_maxBitrate = 0.0;
+    for (const auto &bytes : statistics.bytesPerSecond) {
+        m_maxBitrate = max(m_maxBitrate, static_cast<double>(bytes.second) * 0.008);
+    }
+}
+
 void MatroskaTrack::internalParseHeader(Diagnostics &diag)
 {
     static const string context("parsing header of Matroska track");
@@ -427,7 +407,7 @@ void MatroskaTrack::internalParseHeader(Diagnostics &diag)
             m_lacing = trackInfoElement->readUInteger();
             break;
         case MatroskaIds::DefaultDuration:
-            defaultDuration = trackInfoElement->readUInteger();
+            m_defaultDuration = defaultDuration = trackInfoElement->readUInteger();
             break;
         default:;
         }
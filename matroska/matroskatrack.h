@@ -3,6 +3,9 @@
 
 #include "../abstracttrack.h"
 
+#include <limits>
+#include <map>
+
 namespace TagParser {
 
 class EbmlElement;
@@ -43,6 +46,30 @@ inline uint64 MatroskaTrackHeaderMaker::requiredSize() const
     return m_requiredSize;
 }
 
+/*!
+ * \brief The MatroskaBlockStatistics struct holds statistics about the blocks of a track.
+ * \sa MatroskaContainer::readTrackStatisticsFromBlocks()
+ */
+struct TAG_PARSER_EXPORT MatroskaBlockStatistics {
+    void add(const MatroskaBlockStatistics &other);
+
+    /// \brief Specifies the number of the track the statistics refer to.
+    uint64 trackNumber = 0;
+    /// \brief Specifies the number of bytes of all blocks (excluding block headers).
+    uint64 byteCount = 0;
+    /// \brief Specifies the number of frames (laced frames are counted individually).
+    uint64 frameCount = 0;
+    /// \brief Specifies the number of keyframes.
+    uint64 keyframeCount = 0;
+    /// \brief Specifies the timestamp of the first frame in nanoseconds.
+    int64 firstTimestamp = std::numeric_limits<int64>::max();
+    /// \brief Specifies the timestamp of the end of the last frame in nanoseconds.
+    /// \remarks The duration of a block is taken from its "BlockDuration"-element or from the "DefaultDuration"-element of the track.
+    int64 lastTimestamp = std::numeric_limits<int64>::min();
+    /// \brief Specifies the number of bytes for each second (used to determine the maximum bitrate).
+    std::map<int64, uint64> bytesPerSecond;
+};
+
 class TAG_PARSER_EXPORT MatroskaTrack : public AbstractTrack {
     friend class MatroskaContainer;
     friend class MatroskaTrackHeaderMaker;
@@ -52,9 +79,12 @@ public:
     ~MatroskaTrack() override;
 
     TrackType type() const override;
+    uint64 defaultDuration() const;
+    uint64 keyframeCount() const;
 
     static MediaFormat codecIdToMediaFormat(const std::string &codecId);
     void readStatisticsFromTags(const std::vector<std::unique_ptr<MatroskaTag>> &tags, Diagnostics &diag);
+    void readStatisticsFromBlocks(const MatroskaBlockStatistics &statistics);
     MatroskaTrackHeaderMaker prepareMakingHeader(Diagnostics &diag) const;
     void makeHeader(std::ostream &stream, Diagnostics &diag) const;
 
@@ -67,8 +97,27 @@ private:
         const ConversionFunction &conversionFunction, Diagnostics &diag);
 
     EbmlElement *m_trackElement;
+    uint64 m_defaultDuration;
+    uint64 m_keyframeCount;
 };
 
+/*!
+ * \brief Returns the default duration of a frame in nanoseconds (denoted by the "DefaultDuration"-element) or 0 if not present.
+ */
+inline uint64 MatroskaTrack::defaultDuration() const
+{
+    return m_defaultDuration;
+}
+
+/*!
+ * \brief Returns the number of keyframes.
+ * \remarks Only determined when calling readStatisticsFromBlocks(); otherwise 0.
+ */
+inline uint64 MatroskaTrack::keyframeCount() const
+{
+    return m_keyframeCount;
+}
+
 /*!
  * \brief Prepares making header.
  * \returns Returns a MatroskaTrackHeaderMaker object which can be used to actually make the track
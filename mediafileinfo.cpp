@@ -3,6 +3,7 @@
 #include "./backuphelper.h"
 #include "./diagnostics.h"
 #include "./exceptions.h"
+#include "./paddinghelper.h"
 #include "./progressfeedback.h"
 #include "./signature.h"
 #include "./tag.h"
@@ -96,6 +97,9 @@ MediaFileInfo::MediaFileInfo()
     , m_forceRewrite(true)
     , m_forceTagPosition(true)
     , m_forceIndexPosition(true)
+    , m_referencingPictureData(false)
+    , m_parsingSegmentsLazily(false)
+    , m_parsingId3v2TagsLazily(false)
 {
 }
 
@@ -123,6 +127,9 @@ MediaFileInfo::MediaFileInfo(const string &path)
     , m_forceRewrite(true)
     , m_forceTagPosition(true)
     , m_forceIndexPosition(true)
+    , m_referencingPictureData(false)
+    , m_parsingSegmentsLazily(false)
+    , m_parsingId3v2TagsLazily(false)
 {
 }
 
@@ -239,8 +246,8 @@ startParsingSignature:
                 if (m_forceFullParse) {
                     // validating the element structure of Matroska files takes too long when
                     // parsing big files so do this only when explicitely desired
-                    container->validateElementStructure(diag, &m_paddingSize);
-                    container->validateIndex(diag);
+                    // (the "Cluster"-elements are validated concurrently to speed this up)
+                    container->validateConcurrently(diag, &m_paddingSize);
                 }
             } catch (const Failure &) {
                 m_containerParsingStatus = ParsingStatus::CriticalFailure;
@@ -318,6 +325,7 @@ void MediaFileInfo::parseTracks(Diagnostics &diag)
             break;
         case ContainerFormat::MpegAudioFrames:
             m_singleTrack = make_unique<MpegAudioFrameStream>(stream(), m_containerOffset);
+            static_cast<MpegAudioFrameStream *>(m_singleTrack.get())->setScanningFrames(m_forceFullParse);
             break;
         case ContainerFormat::RiffWave:
             m_singleTrack = make_unique<WaveAudioStream>(stream(), m_containerOffset);
@@ -389,7 +397,7 @@ void MediaFileInfo::parseTags(Diagnostics &diag)
         auto id3v2Tag = make_unique<Id3v2Tag>();
         stream().seekg(offset, ios_base::beg);
         try {
-            id3v2Tag->parse(stream(), size() - static_cast<uint64>(offset), diag);
+            id3v2Tag->parse(stream(), size() - static_cast<uint64>(offset), diag, m_parsingId3v2TagsLazily);
             m_paddingSize += id3v2Tag->paddingSize();
         } catch (const NoDataFoundException &) {
             continue;
@@ -526,6 +534,9 @@ void MediaFileInfo::parseEverything(Diagnostics &diag)
  *  - The method might do nothing if present tag(s) already match the given specifications.
  *  - This is only a convenience method. The task could be done by manually using the methods createId3v1Tag(), createId3v2Tag(), removeId3v1Tag() ... as well.
  *  - Some tag information might be discarded. For example when an ID3v2 tag needs to be removed (TagSettings::id3v2usage is set to TagUsage::Never) and an ID3v1 tag will be created instead not all fields can be transfered.
+ *  - When ID3v2 tags have been parsed lazily, frames which have not been decoded yet are decoded before transferring
+ *    values from ID3v2 tags. Frames which can not be decoded are dropped. Use Id3v2Tag::decodeFrames() before to obtain
+ *    the reason.
  */
 bool MediaFileInfo::createAppropriateTags(const TagCreationSettings &settings)
 {
@@ -587,6 +598,7 @@ bool MediaFileInfo::createAppropriateTags(const TagCreationSettings &settings)
         if (settings.id3v1usage == TagUsage::Always && !id3v1Tag()) {
             auto *const id3v1Tag = createId3v1Tag();
             if (flags & TagCreationFlags::Id3InitOnCreate) {
+                decodePendingId3v2Frames();
                 for (const auto &id3v2Tag : id3v2Tags()) {
                     // overwrite existing values to ensure default ID3v1 genre "Blues" is updated as well
                     id3v1Tag->insertValues(*id3v2Tag, true);
@@ -619,6 +631,7 @@ bool MediaFileInfo::createAppropriateTags(const TagCreationSettings &settings)
     if (settings.id3v2usage == TagUsage::Never) {
         if ((flags & TagCreationFlags::Id3TransferValuesOnRemoval) && hasId3v1Tag()) {
             // transfer tags to ID3v1 tag before removing
+            decodePendingId3v2Frames();
             for (const auto &tag : id3v2Tags()) {
                 id3v1Tag()->insertValues(*tag, false);
             }
@@ -1300,6 +1313,8 @@ void MediaFileInfo::clearParsingResults()
  * This method does nothing the tags of the current file haven't been parsed using
  * the parseTags() method.
  *
+ * \remarks Frames of the additional tags which have not been decoded yet (see isParsingId3v2TagsLazily()) are
+ *          decoded before. Frames which can not be decoded are dropped.
  * \sa id3v2Tags()
  */
 void MediaFileInfo::mergeId3v2Tags()
@@ -1313,12 +1328,27 @@ void MediaFileInfo::mergeId3v2Tags()
     if (isecond == end) {
         return;
     }
+    Diagnostics diag;
     for (auto i = isecond; i != end; ++i) {
+        (*i)->decodeFrames(diag);
         first.insertFields(**i, false);
     }
     m_id3v2Tags.erase(isecond, end - 1);
 }
 
+/*!
+ * \brief Decodes the frames of all ID3v2 tags which have not been decoded yet.
+ * \remarks Frames which can not be decoded are dropped (as when parsing the tags eagerly). The reason is discarded.
+ * \sa isParsingId3v2TagsLazily()
+ */
+void MediaFileInfo::decodePendingId3v2Frames()
+{
+    Diagnostics diag;
+    for (const auto &tag : m_id3v2Tags) {
+        tag->decodeFrames(diag);
+    }
+}
+
 /*!
  * \brief Converts an existing ID3v1 tag into an ID3v2 tag.
  *
@@ -1535,12 +1565,13 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
     progress.updateStep(flacStream ? "Updating FLAC tags ..." : "Updating ID3v2 tags ...");
 
     // prepare ID3v2 tags
+    // -> frames which have not been modified are copied as-is from the current file
     vector<Id3v2TagMaker> makers;
     makers.reserve(m_id3v2Tags.size());
     uint32 tagsSize = 0;
     for (auto &tag : m_id3v2Tags) {
         try {
-            makers.emplace_back(tag->prepareMaking(diag));
+            makers.emplace_back(tag->prepareMaking(stream(), diag));
             tagsSize += makers.back().requiredSize();
         } catch (const Failure &) {
         }
@@ -1635,6 +1666,12 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
         try {
             close();
             outputStream.open(path(), ios_base::in | ios_base::out | ios_base::binary);
+            // open the file a second time to read ID3v2 frames which are copied as-is from it
+            // note: the output stream can not be used for this because reading from it would alter the write position
+            if (!makers.empty()) {
+                backupStream.exceptions(ios_base::badbit | ios_base::failbit);
+                backupStream.open(path(), ios_base::in | ios_base::binary);
+            }
         } catch (...) {
             const char *const what = catchIoFailure();
             diag.emplace_back(DiagLevel::Critical, "Opening the file with write permissions failed.", context);
@@ -1652,6 +1689,19 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
         }
 
         if (!makers.empty()) {
+            // read ID3v2 frames which are copied as-is from the original file
+            for (auto &maker : makers) {
+                maker.setSourceStream(&backupStream);
+            }
+            // -> buffer frames which would be overwritten before being copied when updating the file in-place
+            if (!rewriteRequired) {
+                uint64 tagOffset = 0;
+                for (auto &maker : makers) {
+                    maker.bufferOverwrittenFrames(tagOffset);
+                    tagOffset += maker.requiredSize();
+                }
+            }
+
             // write ID3v2 tags
             progress.updateStep("Writing ID3v2 tag ...");
             for (auto i = makers.begin(), end = makers.end() - 1; i != end; ++i) {
@@ -1681,9 +1731,7 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
 
         if (makers.empty() && !flacStream) {
             // just write padding (however, padding should be set to 0 in this case?)
-            for (; padding; --padding) {
-                outputStream.put(0);
-            }
+            PaddingHelper::writeZeroes(outputStream, padding);
         }
 
         // copy / skip actual stream data
@@ -143,6 +143,12 @@ public:
     void setIndexPosition(ElementPosition indexPosition);
     bool forceIndexPosition() const;
     void setForceIndexPosition(bool forceTagPosition);
+    bool isReferencingPictureData() const;
+    void setReferencingPictureData(bool referencingPictureData);
+    bool isParsingSegmentsLazily() const;
+    void setParsingSegmentsLazily(bool parsingSegmentsLazily);
+    bool isParsingId3v2TagsLazily() const;
+    void setParsingId3v2TagsLazily(bool parsingId3v2TagsLazily);
 
 protected:
     void invalidated() override;
@@ -152,6 +158,7 @@ private:
     // currently only the makeMp3File() methods is present; corresponding methods for
     // other formats are outsourced to container classes
     void makeMp3File(Diagnostics &diag, AbortableProgressFeedback &progress);
+    void decodePendingId3v2Frames();
 
     // fields related to the container
     ParsingStatus m_containerParsingStatus;
@@ -187,6 +194,9 @@ private:
     bool m_forceRewrite;
     bool m_forceTagPosition;
     bool m_forceIndexPosition;
+    bool m_referencingPictureData;
+    bool m_parsingSegmentsLazily;
+    bool m_parsingId3v2TagsLazily;
 };
 
 /*!
@@ -610,6 +620,94 @@ inline void MediaFileInfo::setForceIndexPosition(bool forceIndexPosition)
     m_forceIndexPosition = forceIndexPosition;
 }
 
+/*!
+ * \brief Returns whether the data of pictures is referenced instead of being read when parsing tags.
+ *
+ * If enabled, cover art of FLAC streams ("METADATA_BLOCK_PICTURE") and MP4 tags ("covr") is not read into memory when
+ * parsing tags. The tag values refer to the location of the data within the file instead (see TagValue::dataBlock()).
+ * The data is read on the first access and is copied directly from the file when making the tag. Hence the file must
+ * stay open and unmodified as long as the tags are used.
+ *
+ * Copies of such tag values share the reference (see TagValue). They must not outlive the next call of applyChanges(),
+ * clearParsingResults() or close() because the referenced location is invalidated then. Call TagValue::dataPointer()
+ * on a copy to read the data into memory before if it is supposed to be kept.
+ *
+ * FLAC "METADATA_BLOCK_PICTURE"s whose data has not been read and whose type, MIME type and description have not been
+ * changed are copied as-is from the original file when making the FLAC header.
+ *
+ * This is disabled by default.
+ *
+ * \sa setReferencingPictureData()
+ */
+inline bool MediaFileInfo::isReferencingPictureData() const
+{
+    return m_referencingPictureData;
+}
+
+/*!
+ * \brief Sets whether the data of pictures is referenced instead of being read when parsing tags.
+ * \remarks The setting is applied next time parsing. The current parsing results are not mutated.
+ * \sa isReferencingPictureData()
+ */
+inline void MediaFileInfo::setReferencingPictureData(bool referencingPictureData)
+{
+    m_referencingPictureData = referencingPictureData;
+}
+
+/*!
+ * \brief Returns whether Matroska segments are parsed lazily.
+ *
+ * When parsing lazily the parser stops walking through the segment when reaching the first "Cluster"-element. Top-level elements
+ * located after that (usually "Tags", "Cues" and sometimes "Attachments") are fetched via the "SeekHead"-element if present.
+ * Otherwise the remaining elements are found by hopping over the "Cluster"-elements using only their size denotation so
+ * no child elements are parsed. This way the time required to parse the header depends only on the number of top-level
+ * elements and not on the file size. The MatroskaContainer::maxFullParseSize() is not taken into account.
+ *
+ * This is disabled by default.
+ *
+ * \sa setParsingSegmentsLazily()
+ */
+inline bool MediaFileInfo::isParsingSegmentsLazily() const
+{
+    return m_parsingSegmentsLazily;
+}
+
+/*!
+ * \brief Sets whether Matroska segments are parsed lazily.
+ * \remarks The setting is applied next time parsing. The current parsing results are not mutated.
+ * \sa isParsingSegmentsLazily()
+ */
+inline void MediaFileInfo::setParsingSegmentsLazily(bool parsingSegmentsLazily)
+{
+    m_parsingSegmentsLazily = parsingSegmentsLazily;
+}
+
+/*!
+ * \brief Returns whether ID3v2 tags are parsed lazily.
+ *
+ * When parsing lazily only the frame headers are read when parsing tags. The frames are decoded when requested via
+ * Id3v2Tag::decodeFrames() and copied as-is from the file when making the tag otherwise (see Id3v2Tag::parse() for
+ * details). Hence the file must stay open and unmodified as long as the tags are used.
+ *
+ * This is disabled by default.
+ *
+ * \sa setParsingId3v2TagsLazily()
+ */
+inline bool MediaFileInfo::isParsingId3v2TagsLazily() const
+{
+    return m_parsingId3v2TagsLazily;
+}
+
+/*!
+ * \brief Sets whether ID3v2 tags are parsed lazily.
+ * \remarks The setting is applied next time parsing. The current parsing results are not mutated.
+ * \sa isParsingId3v2TagsLazily()
+ */
+inline void MediaFileInfo::setParsingId3v2TagsLazily(bool parsingId3v2TagsLazily)
+{
+    m_parsingId3v2TagsLazily = parsingId3v2TagsLazily;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_MEDIAINFO_H
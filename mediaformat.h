@@ -242,7 +242,7 @@ enum AudioFormatExtensions : unsigned char { SpectralBandReplication = 1, Parame
 
 class TAG_PARSER_EXPORT MediaFormat {
 public:
-    MediaFormat(GeneralMediaFormat general = GeneralMediaFormat::Unknown, unsigned char sub = 0, unsigned char extension = 0);
+    constexpr MediaFormat(GeneralMediaFormat general = GeneralMediaFormat::Unknown, unsigned char sub = 0, unsigned char extension = 0);
 
     const char *name() const;
     const char *abbreviation() const;
@@ -261,7 +261,7 @@ public:
 /*!
  * \brief Constructs a new media format.
  */
-inline MediaFormat::MediaFormat(GeneralMediaFormat general, unsigned char sub, unsigned char extension)
+constexpr MediaFormat::MediaFormat(GeneralMediaFormat general, unsigned char sub, unsigned char extension)
     : general(general)
     , sub(sub)
     , extension(extension)
@@ -4,6 +4,7 @@
 #include "../backuphelper.h"
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
+#include "../paddinghelper.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/binaryreader.h>
@@ -549,6 +550,10 @@ calculatePadding:
         for (const auto &track : tracks()) {
             track->bufferTrackAtoms(diag);
         }
+        // -> data referenced by tag fields (eg. covers) is otherwise copied from the original file when making the tags
+        for (auto &maker : tagMaker) {
+            maker.bufferReferencedData();
+        }
 
         // reopen original file to ensure it is opened for writing
         try {
@@ -656,9 +661,7 @@ calculatePadding:
                     }
 
                     // write zeroes
-                    for (; newPadding; --newPadding) {
-                        outputStream.put(0);
-                    }
+                    PaddingHelper::writeZeroes(outputStream, newPadding);
                 }
 
                 // write media data
@@ -695,7 +698,6 @@ calculatePadding:
                         // read chunk offset and chunk size table from the old file which are required to get chunks
                         progress.updateStep("Reading chunk offsets and sizes from the original file ...");
                         trackInfos.reserve(trackCount);
-                        uint64 totalChunkCount = 0;
                         uint64 totalMediaDataSize = 0;
                         for (auto &track : tracks()) {
                             progress.stopIfAborted();
@@ -712,19 +714,19 @@ calculatePadding:
                                     "Chunks of track " % numberToString<uint64, string>(track->id()) + " could not be parsed correctly.", context);
                             }
 
-                            // increase total chunk count and size
-                            totalChunkCount += track->chunkCount();
+                            // increase total size
                             totalMediaDataSize += accumulate(chunkSizesTable.cbegin(), chunkSizesTable.cend(), 0ul);
                         }
 
                         // write media data chunk-by-chunk
                         // -> write header of media data atom
+                        const uint64 totalChunkSize = totalMediaDataSize;
                         Mp4Atom::addHeaderSize(totalMediaDataSize);
                         Mp4Atom::makeHeader(totalMediaDataSize, Mp4AtomIds::MediaData, outputWriter);
 
                         // -> copy chunks
                         CopyHelper<0x2000> copyHelper;
-                        uint64 chunkIndexWithinTrack = 0, totalChunksCopied = 0;
+                        uint64 chunkIndexWithinTrack = 0, totalBytesCopied = 0;
                         bool anyChunksCopied;
                         do {
                             progress.stopIfAborted();
@@ -747,14 +749,13 @@ calculatePadding:
 
                                     // update counter / status
                                     anyChunksCopied = true;
-                                    ++totalChunksCopied;
+                                    totalBytesCopied += chunkSizesTable[chunkIndexWithinTrack];
+                                    progress.updateBytesProcessed(totalBytesCopied, totalChunkSize);
                                 }
                             }
 
-                            // incrase chunk index within track, update progress percentage
-                            if (!(++chunkIndexWithinTrack % 10)) {
-                                progress.updateStepPercentage(static_cast<byte>(totalChunksCopied * 100 / totalChunkCount));
-                            }
+                            // incrase chunk index within track
+                            ++chunkIndexWithinTrack;
 
                         } while (anyChunksCopied);
                     }
@@ -241,6 +241,31 @@ bool Mp4Tag::setValue(KnownField field, const TagValue &value)
     }
 }
 
+bool Mp4Tag::setValue(KnownField field, TagValue &&value)
+{
+    switch (field) {
+    case KnownField::Genre:
+        switch (value.type()) {
+        case TagDataType::StandardGenreIndex:
+            fields().erase(Mp4TagAtomIds::Genre);
+            return FieldMapBasedTag<Mp4Tag>::setValue(Mp4TagAtomIds::PreDefinedGenre, move(value));
+        default:
+            fields().erase(Mp4TagAtomIds::PreDefinedGenre);
+            return FieldMapBasedTag<Mp4Tag>::setValue(Mp4TagAtomIds::Genre, move(value));
+        }
+    case KnownField::EncoderSettings:
+        return setValue(Mp4TagExtendedMeanIds::iTunes, Mp4TagExtendedNameIds::cdec, move(value));
+    case KnownField::RecordLabel:
+        if (!this->value(Mp4TagExtendedMeanIds::iTunes, Mp4TagExtendedNameIds::label).isEmpty()) {
+            // the copy shares the data with the moved value
+            setValue(Mp4TagExtendedMeanIds::iTunes, Mp4TagExtendedNameIds::label, static_cast<const TagValue &>(value));
+        }
+        FALLTHROUGH;
+    default:
+        return FieldMapBasedTag<Mp4Tag>::setValue(field, move(value));
+    }
+}
+
 bool Mp4Tag::setValues(KnownField field, const std::vector<TagValue> &values)
 {
     const Mp4ExtendedFieldId extendedId(field);
@@ -258,19 +283,29 @@ bool Mp4Tag::setValues(KnownField field, const std::vector<TagValue> &values)
                 ++valuesIterator;
             }
         }
+        for (; range.first != range.second; ++range.first) {
+            range.first->second.setValue(TagValue());
+        }
+        // note: inserting invalidates range so it must be done last
         for (; valuesIterator != values.cend(); ++valuesIterator) {
             Mp4TagField tagField(Mp4TagAtomIds::Extended, *valuesIterator);
             tagField.setMean(extendedId.mean);
             tagField.setName(extendedId.name);
             fields().insert(std::make_pair(Mp4TagAtomIds::Extended, move(tagField)));
         }
-        for (; range.first != range.second; ++range.first) {
-            range.first->second.setValue(TagValue());
-        }
     }
     return FieldMapBasedTag<Mp4Tag>::setValues(field, values);
 }
 
+bool Mp4Tag::setValues(KnownField field, std::vector<TagValue> &&values)
+{
+    // the values are used twice for extended fields so they can not be moved in this case
+    if (Mp4ExtendedFieldId(field)) {
+        return setValues(field, static_cast<const std::vector<TagValue> &>(values));
+    }
+    return FieldMapBasedTag<Mp4Tag>::setValues(field, move(values));
+}
+
 /*!
  * \brief Assigns the given \a value to the field with the specified \a mean and \a name attributes.
  * \remarks
@@ -291,6 +326,23 @@ bool Mp4Tag::setValue(const char *mean, const char *name, const TagValue &value)
     return true;
 }
 
+/*!
+ * \brief Moves the given \a value into the field with the specified \a mean and \a name attributes.
+ * \sa setValue(const char *, const char *, const TagValue &)
+ */
+bool Mp4Tag::setValue(const char *mean, const char *name, TagValue &&value)
+{
+    auto range = fields().equal_range(Mp4TagAtomIds::Extended);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second.mean() == mean && i->second.name() == name) {
+            i->second.setValue(move(value));
+            return true;
+        }
+    }
+    fields().emplace(Mp4TagAtomIds::Extended, FieldType(mean, name, move(value)));
+    return true;
+}
+
 /*!
  * \brief Assigns the given \a value to the field with the specified \a mean and \a name attributes.
  */
@@ -440,6 +492,18 @@ Mp4TagMaker::Mp4TagMaker(Mp4Tag &tag, Diagnostics &diag)
     }
 }
 
+/*!
+ * \brief Buffers the data referenced by the fields of the tag (see Mp4TagFieldMaker::bufferReferencedData()).
+ * \remarks Must be called before the referenced data is modified (eg. when the file is modified in-place).
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void Mp4TagMaker::bufferReferencedData()
+{
+    for (auto &maker : m_maker) {
+        maker.bufferReferencedData();
+    }
+}
+
 /*!
  * \brief Saves the tag (specified when constructing the object) to the
  *        specified \a stream.
@@ -56,6 +56,7 @@ class TAG_PARSER_EXPORT Mp4TagMaker {
 
 public:
     void make(std::ostream &stream, Diagnostics &diag);
+    void bufferReferencedData();
     const Mp4Tag &tag() const;
     uint64 requiredSize() const;
 
@@ -117,13 +118,17 @@ public:
     const TagValue &value(const char *mean, const char *name) const;
     using FieldMapBasedTag<Mp4Tag>::setValue;
     bool setValue(KnownField field, const TagValue &value) override;
+    bool setValue(KnownField field, TagValue &&value) override;
     using FieldMapBasedTag<Mp4Tag>::setValues;
     bool setValues(KnownField field, const std::vector<TagValue> &values) override;
+    bool setValues(KnownField field, std::vector<TagValue> &&values) override;
 #ifdef LEGACY_API
     bool setValue(const std::string mean, const std::string name, const TagValue &value);
 #endif
     bool setValue(const std::string &mean, const std::string &name, const TagValue &value);
     bool setValue(const char *mean, const char *name, const TagValue &value);
+    bool setValue(const std::string &mean, const std::string &name, TagValue &&value);
+    bool setValue(const char *mean, const char *name, TagValue &&value);
     using FieldMapBasedTag<Mp4Tag>::hasField;
     bool hasField(KnownField value) const override;
 
@@ -169,6 +174,14 @@ inline bool Mp4Tag::setValue(const std::string &mean, const std::string &name, c
     return setValue(mean.data(), name.data(), value);
 }
 
+/*!
+ * \brief Moves the given \a value into the field with the specified \a mean and \a name attributes.
+ */
+inline bool Mp4Tag::setValue(const std::string &mean, const std::string &name, TagValue &&value)
+{
+    return setValue(mean.data(), name.data(), std::move(value));
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_MP4TAG_H
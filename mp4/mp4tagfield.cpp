@@ -3,7 +3,9 @@
 #include "./mp4container.h"
 #include "./mp4ids.h"
 
+#include "../abstractattachment.h"
 #include "../exceptions.h"
+#include "../mediafileinfo.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/binaryreader.h>
@@ -45,6 +47,17 @@ Mp4TagField::Mp4TagField(IdentifierType id, const TagValue &value)
 {
 }
 
+/*!
+ * \brief Constructs a new Mp4TagField with the specified \a id moving the specified \a value into the field.
+ */
+Mp4TagField::Mp4TagField(IdentifierType id, TagValue &&value)
+    : TagField<Mp4TagField>(id, move(value))
+    , m_parsedRawDataType(RawDataType::Reserved)
+    , m_countryIndicator(0)
+    , m_langIndicator(0)
+{
+}
+
 /*!
  * \brief Constructs a new Mp4TagField with the specified \a mean, \a name and \a value.
  *
@@ -61,6 +74,17 @@ Mp4TagField::Mp4TagField(const string &mean, const string &name, const TagValue
     m_mean = mean;
 }
 
+/*!
+ * \brief Constructs a new Mp4TagField with the specified \a mean and \a name moving the specified \a value into the field.
+ * \sa Mp4TagField(const std::string &, const std::string &, const TagValue &)
+ */
+Mp4TagField::Mp4TagField(const string &mean, const string &name, TagValue &&value)
+    : Mp4TagField(Mp4TagAtomIds::Extended, move(value))
+{
+    m_name = name;
+    m_mean = mean;
+}
+
 /*!
  * \brief Parses field information from the specified Mp4Atom.
  *
@@ -140,6 +164,20 @@ void Mp4TagField::reparse(Mp4Atom &ilstChild, Diagnostics &diag)
                         break;
                     default:;
                     }
+                    MediaFileInfo &fileInfo = ilstChild.container().fileInfo();
+                    if (fileInfo.isReferencingPictureData()) {
+                        // refer to the cover within the file instead of reading it
+                        // note: Not capturing the atom or the container because the data block might outlive them. The container's
+                        //       stream is still used while it exists because it refers to the original file when rewriting.
+                        const auto sourceStream = [&fileInfo]() -> istream & {
+                            return fileInfo.container() ? fileInfo.container()->stream() : static_cast<istream &>(fileInfo.stream());
+                        };
+                        value().assignData(make_shared<StreamDataBlock>(sourceStream,
+                                               static_cast<streamoff>(dataAtom->dataOffset() + 8), ios_base::beg,
+                                               static_cast<streamoff>(dataAtom->endOffset()), ios_base::beg),
+                            TagDataType::Picture);
+                        break;
+                    }
                     const auto coverSize = static_cast<streamoff>(dataAtom->dataSize() - 8);
                     auto coverData = make_unique<char[]>(static_cast<size_t>(coverSize));
                     stream.read(coverData.get(), coverSize);
@@ -559,6 +597,20 @@ Mp4TagFieldMaker::Mp4TagFieldMaker(Mp4TagField &field, Diagnostics &diag)
     }
 }
 
+/*!
+ * \brief Buffers the data the value of the field refers to (see TagValue::dataBlock()) if not buffered yet.
+ * \remarks Referenced data (eg. a cover referring to the original file) is copied directly from the stream when calling
+ *          make(). This must be called before the referenced data is modified (eg. when the file is modified in-place).
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void Mp4TagFieldMaker::bufferReferencedData()
+{
+    const StreamDataBlock *const dataBlock = m_field.value().dataBlock();
+    if (dataBlock && !dataBlock->buffer()) {
+        dataBlock->makeBuffer();
+    }
+}
+
 /*!
  * \brief Saves the field (specified when constructing the object) to the
  *        specified \a stream.
@@ -599,7 +651,7 @@ void Mp4TagFieldMaker::make(ostream &stream)
             stream << m_convertedData.rdbuf();
         } else {
             // no conversion was needed, write data directly from tag value
-            stream.write(m_field.value().dataPointer(), static_cast<streamoff>(m_field.value().dataSize()));
+            m_field.value().copyDataTo(stream);
         }
     }
 }
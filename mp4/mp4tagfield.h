@@ -64,6 +64,7 @@ class TAG_PARSER_EXPORT Mp4TagFieldMaker {
 
 public:
     void make(std::ostream &stream);
+    void bufferReferencedData();
     const Mp4TagField &field() const;
     uint64 requiredSize() const;
 
@@ -100,7 +101,9 @@ class TAG_PARSER_EXPORT Mp4TagField : public TagField<Mp4TagField> {
 public:
     Mp4TagField();
     Mp4TagField(IdentifierType id, const TagValue &value);
+    Mp4TagField(IdentifierType id, TagValue &&value);
     Mp4TagField(const std::string &mean, const std::string &name, const TagValue &value);
+    Mp4TagField(const std::string &mean, const std::string &name, TagValue &&value);
 
     void reparse(Mp4Atom &ilstChild, Diagnostics &diag);
     Mp4TagFieldMaker prepareMaking(Diagnostics &diag);
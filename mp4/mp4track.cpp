@@ -4,6 +4,8 @@
 #include "./mp4ids.h"
 #include "./mpeg4descriptor.h"
 
+#include "../aac/aacframe.h"
+
 #include "../avc/avcconfiguration.h"
 
 #include "../mpegaudio/mpegaudioframe.h"
@@ -2005,6 +2007,69 @@ void Mp4Track::internalParseHeader(Diagnostics &diag)
     // read stsc atom (only number of entries)
     m_istream->seekg(m_stscAtom->dataOffset() + 4);
     m_sampleToChunkEntryCount = reader.readUInt32BE();
+
+    // check for implicitly signaled SBR/PS
+    probeSbr(diag);
+}
+
+/*!
+ * \brief Parses the first samples of AAC tracks to detect implicitly signaled SBR and PS (HE-AAC).
+ *
+ * Without explicit signaling in the audio specific config the sampling frequency of HE-AAC tracks would be reported as half
+ * of the actual output sampling frequency. Only samples of the first chunk are parsed. At most aacSbrProbingBlockCount samples
+ * and aacSbrProbingByteBudget bytes are parsed.
+ */
+void Mp4Track::probeSbr(Diagnostics &diag)
+{
+    static const string context("probing MP4 track for SBR");
+    if (m_format.general != GeneralMediaFormat::Aac || !m_esInfo || !m_esInfo->audioSpecificConfig || m_sampleSizes.empty()
+        || !m_chunkCount || !m_sampleToChunkEntryCount) {
+        return;
+    }
+    const Mpeg4AudioSpecificConfig &audioConfig = *m_esInfo->audioSpecificConfig;
+    if (audioConfig.audioObjectType != Mpeg4AudioObjectIds::AacLc || audioConfig.sbrPresent
+        || audioConfig.extensionSampleFrequencyIndex < sizeof(mpeg4SamplingFrequencyTable) / sizeof(*mpeg4SamplingFrequencyTable)) {
+        return;
+    }
+    // pass an invalid extension sampling frequency index so SBR is assumed to run at twice the sampling frequency
+    AacFrameElementParser parser(audioConfig.audioObjectType, audioConfig.sampleFrequencyIndex, 0xFF, audioConfig.channelConfiguration,
+        audioConfig.frameLengthFlag ? 960 : 1024);
+    try {
+        // determine the offset of the first chunk and the number of samples it contains
+        m_istream->seekg(static_cast<streamoff>(m_stcoAtom->dataOffset() + 8));
+        uint64 offset = m_chunkOffsetSize == 8 ? m_reader.readUInt64BE() : m_reader.readUInt32BE();
+        m_istream->seekg(static_cast<streamoff>(m_stscAtom->dataOffset() + 12));
+        const uint32 samplesInFirstChunk = m_reader.readUInt32BE();
+
+        // parse the samples
+        auto buffer = make_unique<char[]>(aacSbrProbingByteBudget);
+        uint64 remainingBytes = aacSbrProbingByteBudget;
+        for (uint32 sampleIndex = 0;
+             sampleIndex != samplesInFirstChunk && sampleIndex != aacSbrProbingBlockCount && !parser.isSbrPresent(); ++sampleIndex) {
+            const uint64 sampleSize = m_sampleSizes[m_sampleSizes.size() > 1 ? min<size_t>(sampleIndex, m_sampleSizes.size() - 1) : 0];
+            if (!sampleSize || sampleSize > remainingBytes) {
+                break;
+            }
+            m_istream->seekg(static_cast<streamoff>(offset));
+            m_istream->read(buffer.get(), static_cast<streamsize>(sampleSize));
+            parser.parse(buffer.get(), sampleSize);
+            remainingBytes -= sampleSize;
+            offset += sampleSize;
+        }
+    } catch (const Failure &) {
+        diag.emplace_back(DiagLevel::Information, "Unable to parse raw data block; SBR/PS might not be detected.", context);
+    } catch (...) {
+        catchIoFailure();
+        m_istream->clear();
+        diag.emplace_back(DiagLevel::Information, "Raw data block is truncated; SBR/PS might not be detected.", context);
+    }
+    if (parser.isSbrPresent()) {
+        m_format = Mpeg4AudioObjectIds::idToMediaFormat(audioConfig.audioObjectType, true, parser.isPsPresent());
+        m_extensionSamplingFrequency = m_samplingFrequency * 2;
+        if (parser.isPsPresent()) {
+            m_extensionChannelConfig = Mpeg4ChannelConfigs::FrontLeftFrontRight;
+        }
+    }
 }
 
 } // namespace TagParser
@@ -165,6 +165,7 @@ private:
     // private helper methods
     uint64 accumulateSampleSizes(size_t &sampleIndex, size_t count, Diagnostics &diag);
     void addChunkSizeEntries(std::vector<uint64> &chunkSizeTable, size_t count, size_t &sampleIndex, uint32 sampleCount, Diagnostics &diag);
+    void probeSbr(Diagnostics &diag);
     TrackHeaderInfo verifyPresentTrackHeader() const;
 
     Mp4Atom *m_trakAtom;
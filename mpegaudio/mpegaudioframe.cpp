@@ -41,8 +41,13 @@ const int MpegAudioFrame::m_bitrateTable[0x2][0x3][0xF] = { { { 0, 32, 64, 96, 1
     { { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 }, { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
         { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } } };
 
+const uint32 MpegAudioFrame::m_samplingFrequencyTable[0x4][0x3]
+    = { { 11025, 12000, 8000 }, { 0, 0, 0 }, { 22050, 24000, 16000 }, { 44100, 48000, 32000 } };
+
 const uint32 MpegAudioFrame::m_sync = 0xFFE00000u;
 
+const uint32 MpegAudioFrame::m_compatibilityMask = 0xFFFE0C00u;
+
 /*!
  * \brief Parses the header read using the specified \a reader.
  * \throws Throws InvalidDataException if the data read from the stream is
@@ -65,7 +70,7 @@ void MpegAudioFrame::parseHeader(BinaryReader &reader)
             m_xingBytesfield = reader.readUInt32BE();
         }
         if (isXingTocFieldPresent()) {
-            reader.stream()->seekg(64, ios_base::cur);
+            reader.stream()->seekg(100, ios_base::cur);
         }
         if (isXingQualityIndicatorFieldPresent()) {
             m_xingQualityIndicator = reader.readUInt32BE();
@@ -195,22 +200,45 @@ uint32 MpegAudioFrame::sampleCount() const
 
 /*!
  * \brief Returns the size if known; otherwise retruns 0.
+ * \remarks The size of frames using the "free format" (bitrate index 0) is not known.
  */
 uint32 MpegAudioFrame::size() const
 {
-    switch (m_header & 0x60000u) {
-    case 0x60000u:
-        return static_cast<uint32>(
-            ((static_cast<double>(bitrate()) * 1024.0 / 8.0) / static_cast<double>(samplingFrequency())) * static_cast<double>(sampleCount())
-            + static_cast<double>(paddingSize()));
-    case 0x40000u:
-    case 0x20000u:
-        return static_cast<uint32>(
-            ((static_cast<double>(bitrate()) * 1024.0 / 8.0) / static_cast<double>(samplingFrequency())) * static_cast<double>(sampleCount())
-            + static_cast<double>(paddingSize()));
-    default:
+    return sizeFromHeader(m_header);
+}
+
+/*!
+ * \brief Returns the size of the frame with the specified \a header (including the header itself).
+ *
+ * Only table lookups and integer arithmetic are used so this is suitable to check headers of all frames
+ * within a stream.
+ *
+ * \returns Returns 0 if the \a header is not valid or if the size is not known (eg. "free format").
+ */
+uint32 MpegAudioFrame::sizeFromHeader(uint32 header)
+{
+    const uint32 versionIndex = (header >> 19) & 0x3u;
+    const uint32 layerIndex = (header >> 17) & 0x3u;
+    const uint32 bitrateIndex = (header >> 12) & 0xFu;
+    const uint32 samplingFrequencyIndex = (header >> 10) & 0x3u;
+    if ((header & m_sync) != m_sync || versionIndex == 0x1u || !layerIndex || !bitrateIndex || bitrateIndex == 0xFu
+        || samplingFrequencyIndex == 0x3u) {
         return 0;
     }
+    const uint32 bitrate = static_cast<uint32>(m_bitrateTable[versionIndex == 0x3u ? 0 : 1][0x3u - layerIndex][bitrateIndex]) * 1000u;
+    const uint32 samplingFrequency = m_samplingFrequencyTable[versionIndex][samplingFrequencyIndex];
+    const uint32 padding = (header >> 9) & 0x1u;
+    switch (layerIndex) {
+    case 0x3u: // layer I: 384 samples, slots of 4 byte
+        return (12u * bitrate / samplingFrequency + padding) * 4u;
+    case 0x1u: // layer III: 1152 samples for MPEG-1, 576 samples for MPEG-2/2.5
+        if (versionIndex != 0x3u) {
+            return 72u * bitrate / samplingFrequency + padding;
+        }
+        FALLTHROUGH;
+    default: // layer II: 1152 samples
+        return 144u * bitrate / samplingFrequency + padding;
+    }
 }
 
 } // namespace TagParser
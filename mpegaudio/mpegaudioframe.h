@@ -37,8 +37,11 @@ enum class XingHeaderFlags {
 class TAG_PARSER_EXPORT MpegAudioFrame {
 public:
     MpegAudioFrame();
+    explicit MpegAudioFrame(uint32 header);
 
     void parseHeader(IoUtilities::BinaryReader &reader);
+    static uint32 sizeFromHeader(uint32 header);
+    static bool isCompatibleHeader(uint32 header, uint32 referenceHeader);
 
     bool isValid() const;
     double mpegVersion() const;
@@ -61,11 +64,15 @@ public:
     uint32 xingFrameCount() const;
     uint32 xingBytesfield() const;
     uint32 xingQualityIndicator() const;
+    bool isVbriHeaderAvailable() const;
+    static uint64 xingHeaderOffset();
 
 private:
     static const uint64 m_xingHeaderOffset;
     static const int m_bitrateTable[0x2][0x3][0xF];
+    static const uint32 m_samplingFrequencyTable[0x4][0x3];
     static const uint32 m_sync;
+    static const uint32 m_compatibilityMask;
     uint32 m_header;
     uint64 m_xingHeader;
     XingHeaderFlags m_xingHeaderFlags;
@@ -87,6 +94,31 @@ inline MpegAudioFrame::MpegAudioFrame()
 {
 }
 
+/*!
+ * \brief Constructs a new frame from the specified \a header without reading further data.
+ * \remarks The Xing header is not available for frames constructed this way.
+ */
+inline MpegAudioFrame::MpegAudioFrame(uint32 header)
+    : m_header(header)
+    , m_xingHeader(0)
+    , m_xingHeaderFlags(XingHeaderFlags::None)
+    , m_xingFramefield(0)
+    , m_xingBytesfield(0)
+    , m_xingQualityIndicator(0)
+{
+}
+
+/*!
+ * \brief Returns whether the frame with the specified \a header belongs to the same stream as the frame
+ *        with the specified \a referenceHeader.
+ *
+ * That is the case if the MPEG version, the layer and the sampling frequency are equal.
+ */
+inline bool MpegAudioFrame::isCompatibleHeader(uint32 header, uint32 referenceHeader)
+{
+    return (header & m_compatibilityMask) == (referenceHeader & m_compatibilityMask);
+}
+
 /*!
  * \brief Returns an indication whether the frame is valid.
  */
@@ -119,8 +151,8 @@ inline uint32 MpegAudioFrame::bitrate() const
  */
 inline uint32 MpegAudioFrame::paddingSize() const
 {
-    if (isValid()) {
-        return (m_header & 0x60000u) == 0x60000u ? 4u : 1u * (m_header & 0x200u);
+    if (isValid() && (m_header & 0x200u)) {
+        return (m_header & 0x60000u) == 0x60000u ? 4u : 1u;
     } else {
         return 0;
     }
@@ -181,7 +213,7 @@ inline bool MpegAudioFrame::isXingFramefieldPresent() const
  */
 inline bool MpegAudioFrame::isXingBytesfieldPresent() const
 {
-    return (isXingHeaderAvailable()) ? ((m_xingHeaderFlags & XingHeaderFlags::HasFramesField) == XingHeaderFlags::HasFramesField) : false;
+    return (isXingHeaderAvailable()) ? ((m_xingHeaderFlags & XingHeaderFlags::HasBytesField) == XingHeaderFlags::HasBytesField) : false;
 }
 
 /*!
@@ -224,6 +256,22 @@ inline uint32 MpegAudioFrame::xingQualityIndicator() const
     return m_xingQualityIndicator;
 }
 
+/*!
+ * \brief Returns an indication whether a VBRI header is present.
+ */
+inline bool MpegAudioFrame::isVbriHeaderAvailable() const
+{
+    return (m_xingHeader >> 32) == 0x56425249u;
+}
+
+/*!
+ * \brief Returns the offset of the Xing/Info/VBRI header relative to the start of the frame.
+ */
+inline uint64 MpegAudioFrame::xingHeaderOffset()
+{
+    return m_xingHeaderOffset;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_MP3FRAMEAUDIOSTREAM_H
@@ -1,8 +1,14 @@
 #include "./mpegaudioframestream.h"
 
+#include "../bufferedsyncscanner.h"
 #include "../exceptions.h"
 #include "../mediaformat.h"
 
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/conversion/stringbuilder.h>
+
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 using namespace std;
@@ -42,6 +48,7 @@ void MpegAudioFrameStream::internalParseHeader(Diagnostics &diag)
     } else {
         m_size = static_cast<uint64>(m_istream->tellg()) + 125u - m_startOffset;
     }
+    const uint64 endOffset = m_startOffset + m_size;
     m_istream->seekg(static_cast<streamoff>(m_startOffset), ios_base::beg);
     // parse frame header
     m_frames.emplace_back();
@@ -61,6 +68,223 @@ void MpegAudioFrameStream::internalParseHeader(Diagnostics &diag)
               / (static_cast<double>(frame.xingFrameCount() * frame.sampleCount()) / static_cast<double>(frame.samplingFrequency())) / 1024.0)
         : frame.bitrate();
     m_duration = TimeSpan::fromSeconds(static_cast<double>(m_size) / (m_bytesPerSecond = static_cast<uint32>(m_bitrate * 125)));
+    if (m_scanningFrames) {
+        m_size = endOffset - m_startOffset;
+        scanFrames(diag);
+    }
+}
+
+/*!
+ * \brief Reads the headers of all frames to determine the exact sample count, duration and bitrates.
+ *
+ * The stream is read sequentially in large chunks. Frames are located by hopping from header to header. Only
+ * if a header is invalid, the next sync word is searched (see BufferedSyncScanner).
+ * Then the subsequent header must be valid as well to avoid locking onto a sync word within the audio data.
+ */
+void MpegAudioFrameStream::scanFrames(Diagnostics &diag)
+{
+    static const string context("scanning MPEG audio frames");
+    const uint64 endOffset = m_startOffset + m_size;
+    BufferedSyncScanner scanner(*m_istream, endOffset);
+    const MpegAudioFrame &firstFrame = m_frames.front();
+    const bool skipFirstFrame = firstFrame.isXingHeaderAvailable() || firstFrame.isVbriHeaderAvailable();
+    uint64 offset = m_startOffset, sampleCount = 0, audioSize = 0, skippedSize = 0;
+    uint32 referenceHeader = 0, maxBitrate = 0;
+    bool synchronized = false, recordingOffsets = true;
+    m_frameOffsets.clear();
+    m_frameOffsets.reserve(m_size / max<uint32>(firstFrame.size(), 0x60));
+    for (const char *bytes; (bytes = scanner.bytesAt(offset, 4));) {
+        const uint32 header = BE::toUInt32(bytes);
+        const uint32 frameSize = MpegAudioFrame::sizeFromHeader(header);
+        bool valid = frameSize && (!referenceHeader || MpegAudioFrame::isCompatibleHeader(header, referenceHeader));
+        if (valid && !synchronized && offset + frameSize < endOffset) {
+            const char *const nextBytes = scanner.bytesAt(offset + frameSize, 4);
+            const uint32 nextHeader = nextBytes ? BE::toUInt32(nextBytes) : 0;
+            valid = MpegAudioFrame::sizeFromHeader(nextHeader) && MpegAudioFrame::isCompatibleHeader(nextHeader, header);
+        }
+        if (!valid) {
+            const uint64 syncOffset = scanner.findSync(offset + 1, 0xE0, 0xE0, 4);
+            skippedSize += syncOffset - offset;
+            offset = syncOffset;
+            synchronized = false;
+            continue;
+        }
+        if (offset + frameSize > endOffset) {
+            diag.emplace_back(DiagLevel::Warning, argsToString("The last frame at ", offset, " is truncated and will be ignored."), context);
+            skippedSize += endOffset - offset;
+            break;
+        }
+        synchronized = true;
+        if (!referenceHeader) {
+            referenceHeader = header;
+        }
+
+        // take the frame into account unless it is the first frame containing the Xing/Info/VBRI header (which contains no audio data)
+        if (offset != m_startOffset || !skipFirstFrame) {
+            const MpegAudioFrame frame(header);
+            sampleCount += frame.sampleCount();
+            audioSize += frameSize;
+            maxBitrate = max(maxBitrate, frame.bitrate());
+            // stop recording offsets at the first one exceeding 32-bit so the index still corresponds to the frame number
+            if (recordingOffsets && offset - m_startOffset > numeric_limits<uint32>::max()) {
+                recordingOffsets = false;
+                diag.emplace_back(DiagLevel::Information,
+                    argsToString("The frame at ", offset,
+                        " is more than 4 GiB behind the start of the stream; the frame offsets and the seek index only cover the frames before."),
+                    context);
+            }
+            if (recordingOffsets) {
+                m_frameOffsets.emplace_back(static_cast<uint32>(offset - m_startOffset));
+            }
+        }
+        offset += frameSize;
+    }
+
+    if (skippedSize) {
+        diag.emplace_back(
+            DiagLevel::Warning, argsToString(skippedSize, " bytes between the frames could not be assigned to a valid frame."), context);
+    }
+    if (!sampleCount) {
+        diag.emplace_back(DiagLevel::Warning, "No valid frames found; the duration and bitrate are only estimated.", context);
+        return;
+    }
+    const uint32 samplingFrequency = MpegAudioFrame(referenceHeader).samplingFrequency();
+    const double seconds = static_cast<double>(sampleCount) / static_cast<double>(samplingFrequency);
+    m_sampleCount = sampleCount;
+    m_duration = TimeSpan::fromSeconds(seconds);
+    m_bitrate = static_cast<double>(audioSize) * 8.0 / seconds / 1000.0;
+    m_maxBitrate = maxBitrate;
+    m_bytesPerSecond = static_cast<uint32>(static_cast<double>(audioSize) / seconds);
+}
+
+/*!
+ * \brief Builds the seek index which is returned by seekIndex() and used by seekOffset().
+ *
+ * The TOC of the Xing or VBRI header is used if present. Otherwise the frames are scanned once (unless that has
+ * already been done when parsing the header, see setScanningFrames()) and a seek point is added for roughly every
+ * second. Either way the index is small enough to be cached per file.
+ *
+ * \throws Throws InvalidDataException if the header has not been parsed successfully.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void MpegAudioFrameStream::buildSeekIndex(Diagnostics &diag)
+{
+    static const string context("building MPEG audio seek index");
+    if (!isHeaderValid() || m_frames.empty()) {
+        diag.emplace_back(DiagLevel::Critical, "The header has not been parsed yet.", context);
+        throw InvalidDataException();
+    }
+    m_seekIndex.clear();
+    if (readXingToc() || readVbriToc()) {
+        return;
+    }
+
+    // build sparse index from frame offsets
+    if (m_frameOffsets.empty()) {
+        scanFrames(diag);
+    }
+    const MpegAudioFrame &frame = m_frames.front();
+    const uint32 samplingFrequency = frame.samplingFrequency(), samplesPerFrame = frame.sampleCount();
+    if (!samplingFrequency || !samplesPerFrame) {
+        return;
+    }
+    const size_t framesPerSeekPoint = max<size_t>(samplingFrequency / samplesPerFrame, 1);
+    m_seekIndex.reserve(m_frameOffsets.size() / framesPerSeekPoint + 1);
+    for (size_t index = 0; index < m_frameOffsets.size(); index += framesPerSeekPoint) {
+        m_seekIndex.emplace_back(SeekPoint{
+            TimeSpan::fromSeconds(static_cast<double>(index) * samplesPerFrame / samplingFrequency), m_startOffset + m_frameOffsets[index] });
+    }
+}
+
+/*!
+ * \brief Returns the absolute offset of the frame to start decoding at for seeking to the specified \a time.
+ * \remarks Performs a binary search within seekIndex(). Returns startOffset() if the index has not been built.
+ */
+uint64 MpegAudioFrameStream::seekOffset(TimeSpan time) const
+{
+    const auto seekPoint = upper_bound(m_seekIndex.cbegin(), m_seekIndex.cend(), time,
+        [](TimeSpan time, const SeekPoint &seekPoint) { return time < seekPoint.time; });
+    return seekPoint == m_seekIndex.cbegin() ? m_startOffset : (seekPoint - 1)->offset;
+}
+
+/*!
+ * \brief Populates the seek index from the TOC of the Xing header.
+ * \returns Returns whether a Xing header with TOC is present.
+ */
+bool MpegAudioFrameStream::readXingToc()
+{
+    const MpegAudioFrame &frame = m_frames.front();
+    const uint32 samplingFrequency = frame.samplingFrequency();
+    if (!frame.isXingTocFieldPresent() || !samplingFrequency) {
+        return false;
+    }
+    const uint64 totalSize = frame.isXingBytesfieldPresent() && frame.xingBytesfield() ? frame.xingBytesfield() : m_size;
+    const double duration = frame.isXingFramefieldPresent()
+        ? static_cast<double>(frame.xingFrameCount()) * frame.sampleCount() / samplingFrequency
+        : m_duration.totalSeconds();
+
+    // the TOC consists of 100 entries specifying the offset at each percent of the duration in 1/256 of the total size
+    byte toc[100];
+    m_istream->seekg(static_cast<streamoff>(m_startOffset + MpegAudioFrame::xingHeaderOffset() + 8 + (frame.isXingFramefieldPresent() ? 4 : 0)
+        + (frame.isXingBytesfieldPresent() ? 4 : 0)));
+    m_istream->read(reinterpret_cast<char *>(toc), sizeof(toc));
+    m_seekIndex.reserve(sizeof(toc));
+    for (size_t index = 0; index != sizeof(toc); ++index) {
+        uint64 offset = m_startOffset + totalSize * toc[index] / 256;
+        if (!m_seekIndex.empty() && offset < m_seekIndex.back().offset) {
+            // ensure offsets are monotonic even if the TOC is not
+            offset = m_seekIndex.back().offset;
+        }
+        m_seekIndex.emplace_back(SeekPoint{ TimeSpan::fromSeconds(duration * static_cast<double>(index) / 100.0), offset });
+    }
+    return true;
+}
+
+/*!
+ * \brief Populates the seek index from the TOC of the VBRI header.
+ * \returns Returns whether a VBRI header with TOC is present.
+ */
+bool MpegAudioFrameStream::readVbriToc()
+{
+    const MpegAudioFrame &frame = m_frames.front();
+    const uint32 samplingFrequency = frame.samplingFrequency();
+    if (!frame.isVbriHeaderAvailable() || !samplingFrequency) {
+        return false;
+    }
+    // skip ID, version, delay, quality, byte count and frame count
+    m_istream->seekg(static_cast<streamoff>(m_startOffset + MpegAudioFrame::xingHeaderOffset() + 18));
+    const uint16 entryCount = m_reader.readUInt16BE();
+    const uint16 scale = m_reader.readUInt16BE();
+    const uint16 entrySize = m_reader.readUInt16BE();
+    const uint16 framesPerEntry = m_reader.readUInt16BE();
+    if (!entryCount || !entrySize || entrySize > 4 || !framesPerEntry) {
+        return false;
+    }
+
+    // each entry specifies the size of the frames covered by the entry (divided by the scale)
+    const double secondsPerEntry = static_cast<double>(framesPerEntry) * frame.sampleCount() / samplingFrequency;
+    uint64 offset = m_startOffset;
+    m_seekIndex.reserve(entryCount + 1u);
+    m_seekIndex.emplace_back(SeekPoint{ TimeSpan(), offset });
+    for (uint16 index = 1; index <= entryCount; ++index) {
+        uint32 entry;
+        switch (entrySize) {
+        case 1:
+            entry = m_reader.readByte();
+            break;
+        case 2:
+            entry = m_reader.readUInt16BE();
+            break;
+        case 3:
+            entry = m_reader.readUInt24BE();
+            break;
+        default:
+            entry = m_reader.readUInt32BE();
+        }
+        offset += static_cast<uint64>(entry) * scale;
+        m_seekIndex.emplace_back(SeekPoint{ TimeSpan::fromSeconds(secondsPerEntry * index), offset });
+    }
+    return true;
 }
 
 } // namespace TagParser
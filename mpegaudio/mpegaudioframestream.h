@@ -4,8 +4,10 @@
 #include "./mpegaudioframe.h"
 
 #include "../abstracttrack.h"
+#include "../seekpoint.h"
 
 #include <list>
+#include <vector>
 
 namespace TagParser {
 
@@ -15,6 +17,12 @@ public:
     ~MpegAudioFrameStream() override;
 
     TrackType type() const override;
+    bool isScanningFrames() const;
+    void setScanningFrames(bool scanningFrames);
+    const std::vector<uint32> &frameOffsets() const;
+    const std::vector<SeekPoint> &seekIndex() const;
+    void buildSeekIndex(Diagnostics &diag);
+    uint64 seekOffset(ChronoUtilities::TimeSpan time) const;
 
     static void addInfo(const MpegAudioFrame &frame, AbstractTrack &track);
 
@@ -22,7 +30,14 @@ protected:
     void internalParseHeader(Diagnostics &diag) override;
 
 private:
+    void scanFrames(Diagnostics &diag);
+    bool readXingToc();
+    bool readVbriToc();
+
     std::list<MpegAudioFrame> m_frames;
+    std::vector<uint32> m_frameOffsets;
+    std::vector<SeekPoint> m_seekIndex;
+    bool m_scanningFrames;
 };
 
 /*!
@@ -30,6 +45,7 @@ private:
  */
 inline MpegAudioFrameStream::MpegAudioFrameStream(std::iostream &stream, uint64 startOffset)
     : AbstractTrack(stream, startOffset)
+    , m_scanningFrames(false)
 {
     m_mediaType = MediaType::Audio;
 }
@@ -43,6 +59,50 @@ inline TrackType MpegAudioFrameStream::type() const
     return TrackType::MpegAudioFrameStream;
 }
 
+/*!
+ * \brief Returns whether all frames are scanned when parsing the header.
+ * \sa setScanningFrames()
+ */
+inline bool MpegAudioFrameStream::isScanningFrames() const
+{
+    return m_scanningFrames;
+}
+
+/*!
+ * \brief Sets whether all frames are scanned when parsing the header.
+ *
+ * By default, only the first frame is parsed and the duration and bitrate are estimated from it (or taken from
+ * the Xing header if present). That is fast but wrong for VBR streams without Xing header. When enabled, the
+ * headers of all frames are read to determine the exact sample count, duration, average bitrate and maximum
+ * bitrate. Besides, frameOffsets() is populated.
+ *
+ * \remarks Must be set before parseHeader() is called to take effect.
+ */
+inline void MpegAudioFrameStream::setScanningFrames(bool scanningFrames)
+{
+    m_scanningFrames = scanningFrames;
+}
+
+/*!
+ * \brief Returns the offsets of the frames relative to startOffset().
+ * \remarks Only populated when all frames have been scanned. See setScanningFrames().
+ * \remarks The offsets are stored as 32-bit integers. Hence only the frames within the first 4 GiB are recorded so the
+ *          index within the returned vector still corresponds to the frame number.
+ */
+inline const std::vector<uint32> &MpegAudioFrameStream::frameOffsets() const
+{
+    return m_frameOffsets;
+}
+
+/*!
+ * \brief Returns the seek index built via buildSeekIndex().
+ * \remarks The seek points are sorted by time (and offset).
+ */
+inline const std::vector<SeekPoint> &MpegAudioFrameStream::seekIndex() const
+{
+    return m_seekIndex;
+}
+
 } // namespace TagParser
 
 #endif // MPEGAUDIOFRAMESTREAM_H
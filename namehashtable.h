@@ -0,0 +1,226 @@
+#ifndef TAG_PARSER_NAMEHASHTABLE_H
+#define TAG_PARSER_NAMEHASHTABLE_H
+
+#include "./caseinsensitivecomparer.h"
+
+#include <c++utilities/conversion/types.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace TagParser {
+
+/*!
+ * \brief The NameHashTableEntry struct maps a name to a value.
+ */
+template <typename Value> struct NameHashTableEntry {
+    const char *name;
+    Value value;
+};
+
+/*!
+ * \brief Returns the binary logarithm of the number of slots for a NameHashTable with the specified \a entryCount.
+ * \remarks The number of slots is the smallest power of two which is at least twice the number of entries.
+ */
+constexpr unsigned int nameHashTableSlotBits(std::size_t entryCount)
+{
+    unsigned int bits = 1;
+    while ((static_cast<std::size_t>(1) << bits) < entryCount * 2) {
+        ++bits;
+    }
+    return bits;
+}
+
+/*!
+ * \class TagParser::NameHashTable
+ * \brief The NameHashTable class provides a perfect hash table mapping names (eg. field names or codec IDs) to values.
+ *
+ * The table is supposed to be computed at compile-time via makeNameHashTable(). It uses the "hash and displace" scheme:
+ * The FNV-1a hash of a name selects a bucket. Each bucket has a seed which is mixed into the hash to select the slot.
+ * The seeds are chosen when constructing the table so that no slot is taken twice. So looking up a name only requires
+ * hashing it once and comparing it to at most one entry.
+ *
+ * \tparam Value Specifies the type of the values; must be a literal type.
+ * \tparam entryCount Specifies the number of names.
+ * \tparam caseInsensitive Specifies whether names are compared case-insensitively (only ASCII letters are folded).
+ */
+template <typename Value, std::size_t entryCount, bool caseInsensitive> class NameHashTable {
+public:
+    typedef NameHashTableEntry<Value> Entry;
+
+    constexpr NameHashTable(const Entry (&entries)[entryCount]);
+
+    const Value *find(const char *name, std::size_t size) const;
+    const Value *find(const std::string &name) const;
+
+private:
+    /*!
+     * \brief The Slot struct holds an entry of the table; empty slots have no name.
+     */
+    struct Slot {
+        const char *name;
+        std::size_t size;
+        Value value;
+    };
+
+    static constexpr unsigned char fold(char c);
+    static constexpr std::size_t length(const char *name);
+    static constexpr uint32 hash(const char *name, std::size_t size);
+    static constexpr std::size_t bucketIndex(uint32 hash);
+    static constexpr std::size_t slotIndex(uint32 hash, uint32 seed);
+
+    static constexpr unsigned int slotBits = nameHashTableSlotBits(entryCount);
+    static constexpr std::size_t slotCount = static_cast<std::size_t>(1) << slotBits;
+    static constexpr std::size_t bucketCount = slotCount / 4 ? slotCount / 4 : 1;
+    /// \brief The maximum number of seeds to try per bucket before giving up.
+    static constexpr uint32 maxSeed = 0x10000;
+
+    uint32 m_seeds[bucketCount];
+    Slot m_slots[slotCount];
+};
+
+/*!
+ * \brief Constructs the table for the specified \a entries.
+ * \throws Throws std::logic_error if no collision-free seed could be found for a bucket (which leads to a compile-time
+ *         error when constructing the table at compile-time). This happens when \a entries contains duplicates.
+ */
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+constexpr NameHashTable<Value, entryCount, caseInsensitive>::NameHashTable(const Entry (&entries)[entryCount])
+    : m_seeds{}
+    , m_slots{}
+{
+    uint32 hashes[entryCount]{};
+    std::size_t bucketSizes[bucketCount]{};
+    std::size_t maxBucketSize = 0;
+    for (std::size_t i = 0; i != entryCount; ++i) {
+        hashes[i] = hash(entries[i].name, length(entries[i].name));
+        const std::size_t bucketSize = ++bucketSizes[bucketIndex(hashes[i])];
+        if (bucketSize > maxBucketSize) {
+            maxBucketSize = bucketSize;
+        }
+    }
+
+    // place the entries of the biggest buckets first as it is harder to find a seed for them
+    bool used[slotCount]{};
+    for (std::size_t bucketSize = maxBucketSize; bucketSize; --bucketSize) {
+        for (std::size_t b = 0; b != bucketCount; ++b) {
+            if (bucketSizes[b] != bucketSize) {
+                continue;
+            }
+            for (uint32 seed = 0;; ++seed) {
+                if (seed == maxSeed) {
+                    throw std::logic_error("no collision-free seed found");
+                }
+                std::size_t i = 0;
+                for (; i != entryCount; ++i) {
+                    if (bucketIndex(hashes[i]) != b) {
+                        continue;
+                    }
+                    bool &slotUsed = used[slotIndex(hashes[i], seed)];
+                    if (slotUsed) {
+                        break;
+                    }
+                    slotUsed = true;
+                }
+                if (i == entryCount) {
+                    m_seeds[b] = seed;
+                    break;
+                }
+                // release the slots taken by this bucket before trying the next seed
+                while (i--) {
+                    if (bucketIndex(hashes[i]) == b) {
+                        used[slotIndex(hashes[i], seed)] = false;
+                    }
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i != entryCount; ++i) {
+        Slot &slot = m_slots[slotIndex(hashes[i], m_seeds[bucketIndex(hashes[i])])];
+        slot.name = entries[i].name;
+        slot.size = length(entries[i].name);
+        slot.value = entries[i].value;
+    }
+}
+
+/*!
+ * \brief Returns the value for the name with the specified \a size or nullptr if the name is unknown.
+ */
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+const Value *NameHashTable<Value, entryCount, caseInsensitive>::find(const char *name, std::size_t size) const
+{
+    const uint32 nameHash = hash(name, size);
+    const Slot &slot = m_slots[slotIndex(nameHash, m_seeds[bucketIndex(nameHash)])];
+    if (!slot.name || slot.size != size) {
+        return nullptr;
+    }
+    for (std::size_t i = 0; i != size; ++i) {
+        if (fold(name[i]) != fold(slot.name[i])) {
+            return nullptr;
+        }
+    }
+    return &slot.value;
+}
+
+/*!
+ * \brief Returns the value for the specified \a name or nullptr if the name is unknown.
+ */
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+inline const Value *NameHashTable<Value, entryCount, caseInsensitive>::find(const std::string &name) const
+{
+    return find(name.data(), name.size());
+}
+
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+constexpr unsigned char NameHashTable<Value, entryCount, caseInsensitive>::fold(char c)
+{
+    return caseInsensitive ? CaseInsensitiveCharComparer::toLower(static_cast<unsigned char>(c)) : static_cast<unsigned char>(c);
+}
+
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+constexpr std::size_t NameHashTable<Value, entryCount, caseInsensitive>::length(const char *name)
+{
+    std::size_t size = 0;
+    while (name[size]) {
+        ++size;
+    }
+    return size;
+}
+
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+constexpr uint32 NameHashTable<Value, entryCount, caseInsensitive>::hash(const char *name, std::size_t size)
+{
+    uint32 value = 2166136261u;
+    for (std::size_t i = 0; i != size; ++i) {
+        value ^= fold(name[i]);
+        value *= 16777619u;
+    }
+    return value;
+}
+
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+constexpr std::size_t NameHashTable<Value, entryCount, caseInsensitive>::bucketIndex(uint32 hash)
+{
+    return hash & (bucketCount - 1);
+}
+
+template <typename Value, std::size_t entryCount, bool caseInsensitive>
+constexpr std::size_t NameHashTable<Value, entryCount, caseInsensitive>::slotIndex(uint32 hash, uint32 seed)
+{
+    return static_cast<uint32>((hash ^ (seed * 0x85EBCA6Bu)) * 0x9E3779B1u) >> (32 - slotBits);
+}
+
+/*!
+ * \brief Returns a NameHashTable for the specified \a entries.
+ * \remarks Use this function to initialize a constexpr variable so the table is computed at compile-time.
+ */
+template <bool caseInsensitive, typename Value, std::size_t entryCount>
+constexpr NameHashTable<Value, entryCount, caseInsensitive> makeNameHashTable(const NameHashTableEntry<Value> (&entries)[entryCount])
+{
+    return NameHashTable<Value, entryCount, caseInsensitive>(entries);
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_NAMEHASHTABLE_H
@@ -196,10 +196,8 @@ void OggContainer::internalParseHeader(Diagnostics &diag)
         for (m_iterator.removeFilter(), m_iterator.reset(); m_iterator; m_iterator.nextPage()) {
             const OggPage &page = m_iterator.currentPage();
             if (m_validateChecksums && page.checksum() != OggPage::computeChecksum(stream(), page.startOffset())) {
-                diag.emplace_back(DiagLevel::Warning,
-                    argsToString(
-                        "The denoted checksum of the OGG page at ", m_iterator.currentSegmentOffset(), " does not match the computed checksum."),
-                    context);
+                diag.emplaceFormatted(DiagLevel::Warning, context, "The denoted checksum of the OGG page at ", m_iterator.currentSegmentOffset(),
+                    " does not match the computed checksum.");
             }
             OggStream *stream;
             uint64 lastNewStreamOffset = 0;
@@ -0,0 +1,44 @@
+#include "./paddinghelper.h"
+
+#include <algorithm>
+#include <ostream>
+
+using namespace std;
+
+namespace TagParser {
+
+/*!
+ * \namespace TagParser::PaddingHelper
+ * \brief Helps to write padding when making tags and files.
+ *
+ * Methods in this namespace are internally used eg. in implementations of AbstractContainer::internalMakeFile().
+ */
+
+namespace PaddingHelper {
+
+/// \brief The size of the block of zeroes which is written at once by writeZeroes().
+constexpr std::size_t zeroBlockSize = 0x10000;
+
+/// \brief A block of zeroes to write padding from (zero-initialized because it has static storage duration).
+static const char zeroBlock[zeroBlockSize] = {};
+
+/*!
+ * \brief Writes the specified number of zero-bytes to the specified \a stream.
+ *
+ * The zeroes are written in blocks of zeroBlockSize bytes so writing several MiB of padding
+ * takes only a few calls of std::ostream::write() instead of one std::ostream::put() call per byte.
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void writeZeroes(ostream &stream, uint64 count)
+{
+    while (count) {
+        const auto blockSize = static_cast<streamsize>(min<uint64>(count, zeroBlockSize));
+        stream.write(zeroBlock, blockSize);
+        count -= static_cast<uint64>(blockSize);
+    }
+}
+
+} // namespace PaddingHelper
+
+} // namespace TagParser
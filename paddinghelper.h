@@ -0,0 +1,20 @@
+#ifndef TAG_PARSER_PADDINGHELPER_H
+#define TAG_PARSER_PADDINGHELPER_H
+
+#include "./global.h"
+
+#include <c++utilities/conversion/types.h>
+
+#include <iosfwd>
+
+namespace TagParser {
+
+namespace PaddingHelper {
+
+TAG_PARSER_EXPORT void writeZeroes(std::ostream &stream, uint64 count);
+
+} // namespace PaddingHelper
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_PADDINGHELPER_H
@@ -5,36 +5,94 @@
 
 #include <c++utilities/conversion/types.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <forward_list>
 #include <functional>
 #include <string>
 
 namespace TagParser {
 
+/*!
+ * \brief The ProgressSnapshot struct holds the state of a BasicProgressFeedback at a certain point of time.
+ * \sa BasicProgressFeedback::snapshot()
+ */
+struct TAG_PARSER_EXPORT ProgressSnapshot {
+    /// \brief The name of the current step.
+    std::string step;
+    /// \brief The percentage of the current step.
+    byte stepPercentage = 0;
+    /// \brief The overall percentage.
+    byte overallPercentage = 0;
+    /// \brief The number of bytes processed within the current step (if the operation reports it).
+    uint64 bytesProcessed = 0;
+    /// \brief The total number of bytes to be processed within the current step (if the operation reports it).
+    uint64 bytesTotal = 0;
+};
+
 template <typename ActualProgressFeedback> class BasicProgressFeedback {
 public:
     using Callback = std::function<void(ActualProgressFeedback &feedback)>;
 
+    BasicProgressFeedback();
     BasicProgressFeedback(const Callback &callback, const Callback &percentageOnlyCallback = Callback());
     BasicProgressFeedback(Callback &&callback, Callback &&percentageOnlyCallback = Callback());
 
     const std::string &step() const;
     byte stepPercentage() const;
     byte overallPercentage() const;
+    uint64 bytesProcessed() const;
+    uint64 bytesTotal() const;
+    ProgressSnapshot snapshot() const;
+    std::chrono::steady_clock::duration callbackInterval() const;
+    void setCallbackInterval(std::chrono::steady_clock::duration callbackInterval);
     void updateStep(const std::string &step, byte stepPercentage = 0);
     void updateStep(std::string &&step, byte stepPercentage = 0);
     void updateStepPercentage(byte stepPercentage);
     void updateStepPercentageFromFraction(double stepPercentage);
     void updateOverallPercentage(byte overallPercentage);
+    void updateBytesProcessed(uint64 bytesProcessed, uint64 bytesTotal);
 
 private:
+    const std::string *internStep(const std::string &step);
+    const std::string *internStep(std::string &&step);
+    void enterStep(const std::string *step, byte stepPercentage);
+    void invokeStepCallback();
+    void invokePercentageCallback();
+
     Callback m_callback;
     Callback m_percentageOnlyCallback;
-    std::string m_step;
-    byte m_stepPercentage;
-    byte m_overallPercentage;
+    std::forward_list<std::string> m_steps;
+    std::atomic<const std::string *> m_step;
+    std::atomic<byte> m_stepPercentage;
+    std::atomic<byte> m_overallPercentage;
+    std::atomic<uint64> m_bytesProcessed;
+    std::atomic<uint64> m_bytesTotal;
+    std::chrono::steady_clock::duration m_callbackInterval;
+    std::chrono::steady_clock::time_point m_lastPercentageCallback;
+    bool m_percentageCallbackPending;
 };
 
+/*!
+ * \brief Constructs a new BasicProgressFeedback without callbacks.
+ *
+ * The progress is supposed to be polled via snapshot() (eg. by a GUI timer) in this case. Updating the progress only stores
+ * the new values then.
+ */
+template <typename ActualProgressFeedback>
+inline BasicProgressFeedback<ActualProgressFeedback>::BasicProgressFeedback()
+    : m_steps(1)
+    , m_step(&m_steps.front())
+    , m_stepPercentage(0)
+    , m_overallPercentage(0)
+    , m_bytesProcessed(0)
+    , m_bytesTotal(0)
+    , m_callbackInterval(std::chrono::steady_clock::duration::zero())
+    , m_percentageCallbackPending(false)
+{
+}
+
 /*!
  * \brief Constructs a new BasicProgressFeedback.
  *
@@ -44,8 +102,14 @@ template <typename ActualProgressFeedback>
 inline BasicProgressFeedback<ActualProgressFeedback>::BasicProgressFeedback(const Callback &callback, const Callback &percentageOnlyCallback)
     : m_callback(callback)
     , m_percentageOnlyCallback(percentageOnlyCallback)
+    , m_steps(1)
+    , m_step(&m_steps.front())
     , m_stepPercentage(0)
     , m_overallPercentage(0)
+    , m_bytesProcessed(0)
+    , m_bytesTotal(0)
+    , m_callbackInterval(std::chrono::steady_clock::duration::zero())
+    , m_percentageCallbackPending(false)
 {
 }
 
@@ -56,19 +120,27 @@ inline BasicProgressFeedback<ActualProgressFeedback>::BasicProgressFeedback(cons
  */
 template <typename ActualProgressFeedback>
 inline BasicProgressFeedback<ActualProgressFeedback>::BasicProgressFeedback(Callback &&callback, Callback &&percentageOnlyCallback)
-    : m_callback(callback)
-    , m_percentageOnlyCallback(percentageOnlyCallback)
+    : m_callback(std::move(callback))
+    , m_percentageOnlyCallback(std::move(percentageOnlyCallback))
+    , m_steps(1)
+    , m_step(&m_steps.front())
     , m_stepPercentage(0)
     , m_overallPercentage(0)
+    , m_bytesProcessed(0)
+    , m_bytesTotal(0)
+    , m_callbackInterval(std::chrono::steady_clock::duration::zero())
+    , m_percentageCallbackPending(false)
 {
 }
 
 /*!
  * \brief Returns the name of the current step (initially empty).
+ * \remarks May be called from any thread. The returned reference stays valid until the feedback is destroyed (even when
+ *          entering the next step).
  */
 template <typename ActualProgressFeedback> inline const std::string &BasicProgressFeedback<ActualProgressFeedback>::step() const
 {
-    return m_step;
+    return *m_step.load(std::memory_order_relaxed);
 }
 
 /*!
@@ -77,7 +149,7 @@ template <typename ActualProgressFeedback> inline const std::string &BasicProgre
  */
 template <typename ActualProgressFeedback> inline byte BasicProgressFeedback<ActualProgressFeedback>::stepPercentage() const
 {
-    return m_stepPercentage;
+    return m_stepPercentage.load(std::memory_order_relaxed);
 }
 
 /*!
@@ -86,7 +158,71 @@ template <typename ActualProgressFeedback> inline byte BasicProgressFeedback<Act
  */
 template <typename ActualProgressFeedback> inline byte BasicProgressFeedback<ActualProgressFeedback>::overallPercentage() const
 {
-    return m_overallPercentage;
+    return m_overallPercentage.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Returns the number of bytes processed within the current step.
+ * \remarks Only set by operations reporting their progress via updateBytesProcessed(); reset to 0 on the next step.
+ */
+template <typename ActualProgressFeedback> inline uint64 BasicProgressFeedback<ActualProgressFeedback>::bytesProcessed() const
+{
+    return m_bytesProcessed.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Returns the total number of bytes to be processed within the current step (0 if unknown).
+ * \remarks Only set by operations reporting their progress via updateBytesProcessed(); reset to 0 on the next step.
+ */
+template <typename ActualProgressFeedback> inline uint64 BasicProgressFeedback<ActualProgressFeedback>::bytesTotal() const
+{
+    return m_bytesTotal.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Returns the current state of the progress.
+ * \remarks
+ * - May be called from any thread while the operation is ongoing. No locking is involved: The names of the steps are
+ *   immutable once set and only a pointer to the current one is exchanged atomically when entering the next step.
+ * - The values are not guaranteed to be consistent among each other (eg. the step percentage might already belong to
+ *   the next step).
+ */
+template <typename ActualProgressFeedback> inline ProgressSnapshot BasicProgressFeedback<ActualProgressFeedback>::snapshot() const
+{
+    ProgressSnapshot snapshot;
+    snapshot.step = *m_step.load(std::memory_order_acquire);
+    snapshot.stepPercentage = stepPercentage();
+    snapshot.overallPercentage = overallPercentage();
+    snapshot.bytesProcessed = bytesProcessed();
+    snapshot.bytesTotal = bytesTotal();
+    return snapshot;
+}
+
+/*!
+ * \brief Returns the minimum interval between two invocations of the callbacks due to a percentage change.
+ *
+ * Operations might update the percentage very often. Setting an interval avoids invoking the callbacks more often than
+ * needed (eg. more often than the screen is refreshed). Percentage changes within the interval are still stored and
+ * visible via snapshot() or the next invocation. Reaching 100 % always invokes the callbacks. When entering the next step
+ * while a percentage change is still pending, the second callback is invoked for it before the first callback is invoked
+ * for the new step. So the last percentage of a step is never lost.
+ *
+ * The interval is zero by default (callbacks are invoked on every change).
+ */
+template <typename ActualProgressFeedback>
+inline std::chrono::steady_clock::duration BasicProgressFeedback<ActualProgressFeedback>::callbackInterval() const
+{
+    return m_callbackInterval;
+}
+
+/*!
+ * \brief Sets the minimum interval between two invocations of the callbacks due to a percentage change.
+ * \sa callbackInterval()
+ */
+template <typename ActualProgressFeedback>
+inline void BasicProgressFeedback<ActualProgressFeedback>::setCallbackInterval(std::chrono::steady_clock::duration callbackInterval)
+{
+    m_callbackInterval = callbackInterval;
 }
 
 /*!
@@ -96,11 +232,7 @@ template <typename ActualProgressFeedback> inline byte BasicProgressFeedback<Act
 template <typename ActualProgressFeedback>
 inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(const std::string &step, byte stepPercentage)
 {
-    m_step = step;
-    m_stepPercentage = stepPercentage;
-    if (m_callback) {
-        m_callback(*static_cast<ActualProgressFeedback *>(this));
-    }
+    enterStep(internStep(step), stepPercentage);
 }
 
 /*!
@@ -110,25 +242,18 @@ inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(const std:
 template <typename ActualProgressFeedback>
 inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(std::string &&step, byte stepPercentage)
 {
-    m_step = step;
-    m_stepPercentage = stepPercentage;
-    if (m_callback) {
-        m_callback(*static_cast<ActualProgressFeedback *>(this));
-    }
+    enterStep(internStep(std::move(step)), stepPercentage);
 }
 
 /*!
  * \brief Updates the current step percentage and invokes the second callback specified on construction (or the first if only one has been specified).
  * \remarks Supposed to be called only by the operation itself.
+ * \sa callbackInterval()
  */
 template <typename ActualProgressFeedback> inline void BasicProgressFeedback<ActualProgressFeedback>::updateStepPercentage(byte stepPercentage)
 {
-    m_stepPercentage = stepPercentage;
-    if (m_percentageOnlyCallback) {
-        m_percentageOnlyCallback(*static_cast<ActualProgressFeedback *>(this));
-    } else if (m_callback) {
-        m_callback(*static_cast<ActualProgressFeedback *>(this));
-    }
+    m_stepPercentage.store(stepPercentage, std::memory_order_relaxed);
+    invokePercentageCallback();
 }
 
 /*!
@@ -145,23 +270,133 @@ inline void BasicProgressFeedback<ActualProgressFeedback>::updateStepPercentageF
 /*!
  * \brief Updates the overall percentage and invokes the second callback specified on construction (or the first if only one has been specified).
  * \remarks Supposed to be called only by the operation itself.
+ * \sa callbackInterval()
  */
 template <typename ActualProgressFeedback> inline void BasicProgressFeedback<ActualProgressFeedback>::updateOverallPercentage(byte overallPercentage)
 {
-    m_overallPercentage = overallPercentage;
-    if (m_percentageOnlyCallback) {
-        m_percentageOnlyCallback(*static_cast<ActualProgressFeedback *>(this));
-    } else if (m_callback) {
+    m_overallPercentage.store(overallPercentage, std::memory_order_relaxed);
+    invokePercentageCallback();
+}
+
+/*!
+ * \brief Updates the number of bytes processed within the current step and the step percentage accordingly and invokes the
+ *        second callback specified on construction (or the first if only one has been specified).
+ * \remarks
+ * - Supposed to be called only by the operation itself.
+ * - \a bytesProcessed is clamped to \a bytesTotal (unless \a bytesTotal is 0 which means unknown).
+ * \sa callbackInterval()
+ */
+template <typename ActualProgressFeedback>
+inline void BasicProgressFeedback<ActualProgressFeedback>::updateBytesProcessed(uint64 bytesProcessed, uint64 bytesTotal)
+{
+    if (bytesTotal) {
+        bytesProcessed = std::min(bytesProcessed, bytesTotal);
+    }
+    m_bytesProcessed.store(bytesProcessed, std::memory_order_relaxed);
+    m_bytesTotal.store(bytesTotal, std::memory_order_relaxed);
+    if (bytesTotal) {
+        m_stepPercentage.store(static_cast<byte>(bytesProcessed * 100 / bytesTotal), std::memory_order_relaxed);
+    }
+    invokePercentageCallback();
+}
+
+/*!
+ * \brief Returns a pointer to the stored step name equal to \a step; stores \a step first if not stored yet.
+ * \remarks Stored names are never modified or removed until the feedback is destroyed so snapshot() can read them without
+ *          locking. Operations only use a small set of step names so the storage does not grow significantly.
+ */
+template <typename ActualProgressFeedback>
+inline const std::string *BasicProgressFeedback<ActualProgressFeedback>::internStep(const std::string &step)
+{
+    const auto existingStep = std::find(m_steps.cbegin(), m_steps.cend(), step);
+    if (existingStep != m_steps.cend()) {
+        return &*existingStep;
+    }
+    m_steps.emplace_front(step);
+    return &m_steps.front();
+}
+
+/*!
+ * \brief Returns a pointer to the stored step name equal to \a step; stores \a step first if not stored yet.
+ * \remarks Moves \a step into the storage if not stored yet.
+ */
+template <typename ActualProgressFeedback> inline const std::string *BasicProgressFeedback<ActualProgressFeedback>::internStep(std::string &&step)
+{
+    const auto existingStep = std::find(m_steps.cbegin(), m_steps.cend(), step);
+    if (existingStep != m_steps.cend()) {
+        return &*existingStep;
+    }
+    m_steps.emplace_front(std::move(step));
+    return &m_steps.front();
+}
+
+/*!
+ * \brief Makes the specified \a step the current step and invokes the first callback specified on construction.
+ * \remarks Invokes the second callback first if a percentage change of the previous step is still pending.
+ */
+template <typename ActualProgressFeedback>
+inline void BasicProgressFeedback<ActualProgressFeedback>::enterStep(const std::string *step, byte stepPercentage)
+{
+    if (m_percentageCallbackPending) {
+        m_percentageCallbackPending = false;
+        const Callback &callback = m_percentageOnlyCallback ? m_percentageOnlyCallback : m_callback;
+        callback(*static_cast<ActualProgressFeedback *>(this));
+    }
+    m_step.store(step, std::memory_order_release);
+    m_stepPercentage.store(stepPercentage, std::memory_order_relaxed);
+    m_bytesProcessed.store(0, std::memory_order_relaxed);
+    m_bytesTotal.store(0, std::memory_order_relaxed);
+    invokeStepCallback();
+}
+
+/*!
+ * \brief Invokes the first callback specified on construction.
+ */
+template <typename ActualProgressFeedback> inline void BasicProgressFeedback<ActualProgressFeedback>::invokeStepCallback()
+{
+    if (m_callback) {
         m_callback(*static_cast<ActualProgressFeedback *>(this));
     }
 }
 
+/*!
+ * \brief Invokes the second callback specified on construction (or the first if only one has been specified) unless the
+ *        last invocation is less than callbackInterval() ago and 100 % has not been reached yet.
+ */
+template <typename ActualProgressFeedback> inline void BasicProgressFeedback<ActualProgressFeedback>::invokePercentageCallback()
+{
+    const Callback &callback = m_percentageOnlyCallback ? m_percentageOnlyCallback : m_callback;
+    if (!callback) {
+        return;
+    }
+    if (m_callbackInterval != std::chrono::steady_clock::duration::zero()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - m_lastPercentageCallback < m_callbackInterval && stepPercentage() < 100 && overallPercentage() < 100) {
+            m_percentageCallbackPending = true;
+            return;
+        }
+        m_lastPercentageCallback = now;
+    }
+    m_percentageCallbackPending = false;
+    callback(*static_cast<ActualProgressFeedback *>(this));
+}
+
 class ProgressFeedback : public BasicProgressFeedback<ProgressFeedback> {
 public:
+    ProgressFeedback();
     ProgressFeedback(const Callback &callback, const Callback &percentageOnlyCallback = Callback());
     ProgressFeedback(Callback &&callback, Callback &&percentageOnlyCallback = Callback());
 };
 
+/*!
+ * \brief Constructs a new ProgressFeedback without callbacks.
+ *
+ * The progress is supposed to be polled via snapshot() in this case.
+ */
+inline ProgressFeedback::ProgressFeedback()
+{
+}
+
 /*!
  * \brief Constructs a new ProgressFeedback.
  *
@@ -178,12 +413,13 @@ inline ProgressFeedback::ProgressFeedback(const Callback &callback, const Callba
  * It will call \a callback on the next step and \a percentageOnlyCallback when only the percentage changes.
  */
 inline ProgressFeedback::ProgressFeedback(Callback &&callback, Callback &&percentageOnlyCallback)
-    : BasicProgressFeedback<ProgressFeedback>(callback, percentageOnlyCallback)
+    : BasicProgressFeedback<ProgressFeedback>(std::move(callback), std::move(percentageOnlyCallback))
 {
 }
 
 class AbortableProgressFeedback : public BasicProgressFeedback<AbortableProgressFeedback> {
 public:
+    AbortableProgressFeedback();
     AbortableProgressFeedback(const Callback &callback, const Callback &percentageOnlyCallback = Callback());
     AbortableProgressFeedback(Callback &&callback, Callback &&percentageOnlyCallback = Callback());
 
@@ -197,6 +433,16 @@ private:
     std::atomic_bool m_aborted;
 };
 
+/*!
+ * \brief Constructs a new AbortableProgressFeedback without callbacks.
+ *
+ * The progress is supposed to be polled via snapshot() in this case.
+ */
+inline AbortableProgressFeedback::AbortableProgressFeedback()
+    : m_aborted(false)
+{
+}
+
 /*!
  * \brief Constructs a new AbortableProgressFeedback.
  *
@@ -214,17 +460,18 @@ inline AbortableProgressFeedback::AbortableProgressFeedback(const Callback &call
  * It will call \a callback on the next step and \a percentageOnlyCallback when only the percentage changes.
  */
 inline AbortableProgressFeedback::AbortableProgressFeedback(Callback &&callback, Callback &&percentageOnlyCallback)
-    : BasicProgressFeedback<AbortableProgressFeedback>(callback, percentageOnlyCallback)
+    : BasicProgressFeedback<AbortableProgressFeedback>(std::move(callback), std::move(percentageOnlyCallback))
     , m_aborted(false)
 {
 }
 
 /*!
  * \brief Returns whether the operation has been aborted via tryToAbort().
+ * \remarks This is only a relaxed atomic load so it is fine to call this very frequently.
  */
 inline bool AbortableProgressFeedback::isAborted() const
 {
-    return m_aborted.load();
+    return m_aborted.load(std::memory_order_relaxed);
 }
 
 /*!
@@ -234,7 +481,7 @@ inline bool AbortableProgressFeedback::isAborted() const
  */
 inline void AbortableProgressFeedback::tryToAbort()
 {
-    return m_aborted.store(true);
+    return m_aborted.store(true, std::memory_order_relaxed);
 }
 
 /*!
@@ -269,7 +516,7 @@ inline void AbortableProgressFeedback::nextStepOrStop(std::string &&status, byte
     if (isAborted()) {
         throw OperationAbortedException();
     }
-    updateStep(status, percentage);
+    updateStep(std::move(status), percentage);
 }
 
 } // namespace TagParser
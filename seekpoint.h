@@ -0,0 +1,23 @@
+#ifndef TAG_PARSER_SEEKPOINT_H
+#define TAG_PARSER_SEEKPOINT_H
+
+#include "./global.h"
+
+#include <c++utilities/chrono/timespan.h>
+#include <c++utilities/conversion/types.h>
+
+namespace TagParser {
+
+/*!
+ * \brief The SeekPoint struct specifies the absolute \a offset of the frame to start decoding at for seeking to the
+ *        specified \a time.
+ * \remarks Used for the seek indexes of raw audio streams (see MpegAudioFrameStream::seekIndex() and AdtsStream::seekIndex()).
+ */
+struct TAG_PARSER_EXPORT SeekPoint {
+    ChronoUtilities::TimeSpan time;
+    uint64 offset = 0;
+};
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_SEEKPOINT_H
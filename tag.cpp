@@ -75,6 +75,31 @@ bool Tag::setValues(KnownField field, const std::vector<TagValue> &values)
     return setValue(field, values.size() ? *values.begin() : TagValue());
 }
 
+/*!
+ * \brief Moves the given \a values into the specified \a field.
+ * \remarks
+ * - The default implementation just calls setValues(KnownField, const std::vector<TagValue> &). Reimplement to avoid
+ *   copying the values.
+ * - This virtual method has been added in version 8 which changes the vtable of Tag and therefore breaks ABI
+ *   compatibility (hence the major version and with it the SOVERSION has been bumped to 8).
+ */
+bool Tag::setValues(KnownField field, std::vector<TagValue> &&values)
+{
+    return setValues(field, static_cast<const std::vector<TagValue> &>(values));
+}
+
+/*!
+ * \brief Moves the given \a value into the specified \a field.
+ * \remarks
+ * - The default implementation just calls setValue(KnownField, const TagValue &). Reimplement to avoid copying the value.
+ * - This virtual method has been added in version 8 which changes the vtable of Tag and therefore breaks ABI
+ *   compatibility (hence the major version and with it the SOVERSION has been bumped to 8).
+ */
+bool Tag::setValue(KnownField field, TagValue &&value)
+{
+    return setValue(field, static_cast<const TagValue &>(value));
+}
+
 /*!
  * \fn Tag::value()
  * \brief Returns the value of the specified \a field.
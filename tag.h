@@ -104,7 +104,9 @@ public:
     virtual const TagValue &value(KnownField field) const = 0;
     virtual std::vector<const TagValue *> values(KnownField field) const;
     virtual bool setValue(KnownField field, const TagValue &value) = 0;
+    virtual bool setValue(KnownField field, TagValue &&value);
     virtual bool setValues(KnownField field, const std::vector<TagValue> &values);
+    virtual bool setValues(KnownField field, std::vector<TagValue> &&values);
     virtual bool hasField(KnownField field) const = 0;
     virtual void removeAllFields() = 0;
     const std::string &version() const;
@@ -1,5 +1,7 @@
 #include "./tagvalue.h"
+#include "./abstractattachment.h"
 #include "./tag.h"
+#include "./textconversion.h"
 
 #include "./id3/id3genres.h"
 
@@ -9,6 +11,7 @@
 #include <c++utilities/conversion/stringconversion.h>
 
 #include <algorithm>
+#include <functional>
 #include <cstring>
 #include <utility>
 
@@ -55,25 +58,27 @@ const char *tagDataTypeString(TagDataType dataType)
 /*!
  * \brief Constructs a new TagValue holding a copy of the given TagValue instance.
  * \param other Specifies another TagValue instance.
+ * \remarks The data is not actually copied but shared until one of the values is modified. Only small data which is
+ *          stored within the value itself is copied.
  */
 TagValue::TagValue(const TagValue &other)
-    : m_size(other.m_size)
-    , m_desc(other.m_desc)
-    , m_mimeType(other.m_mimeType)
-    , m_language(other.m_language)
+    : m_ptr(other.m_ptr)
+    , m_dataBlock(other.m_dataBlock)
+    , m_metadata(other.m_metadata)
+    , m_size(other.m_size)
     , m_type(other.m_type)
     , m_encoding(other.m_encoding)
-    , m_descEncoding(other.m_descEncoding)
     , m_labeledAsReadonly(other.m_labeledAsReadonly)
 {
-    if (!other.isEmpty()) {
-        m_ptr = make_unique<char[]>(m_size);
-        std::copy(other.m_ptr.get(), other.m_ptr.get() + other.m_size, m_ptr.get());
+    if (!m_ptr && !m_dataBlock) {
+        std::copy(other.m_inlineData, other.m_inlineData + m_size, m_inlineData);
     }
 }
 
 /*!
  * \brief Assigns the value of another TagValue to the current instance.
+ * \remarks The data is not actually copied but shared until one of the values is modified. Only small data which is
+ *          stored within the value itself is copied.
  */
 TagValue &TagValue::operator=(const TagValue &other)
 {
@@ -82,18 +87,56 @@ TagValue &TagValue::operator=(const TagValue &other)
     }
     m_size = other.m_size;
     m_type = other.m_type;
-    m_desc = other.m_desc;
-    m_mimeType = other.m_mimeType;
-    m_language = other.m_language;
+    m_metadata = other.m_metadata;
     m_labeledAsReadonly = other.m_labeledAsReadonly;
     m_encoding = other.m_encoding;
-    m_descEncoding = other.m_descEncoding;
-    if (other.isEmpty()) {
-        m_ptr.reset();
-    } else {
-        m_ptr = make_unique<char[]>(m_size);
-        std::copy(other.m_ptr.get(), other.m_ptr.get() + other.m_size, m_ptr.get());
+    m_ptr = other.m_ptr;
+    m_dataBlock = other.m_dataBlock;
+    if (!m_ptr && !m_dataBlock) {
+        std::copy(other.m_inlineData, other.m_inlineData + m_size, m_inlineData);
+    }
+    return *this;
+}
+
+/*!
+ * \brief Constructs a new TagValue taking over the data and meta data of the given TagValue instance.
+ * \remarks The \a other value is left empty.
+ */
+TagValue::TagValue(TagValue &&other) noexcept
+    : m_ptr(move(other.m_ptr))
+    , m_dataBlock(move(other.m_dataBlock))
+    , m_metadata(move(other.m_metadata))
+    , m_size(other.m_size)
+    , m_type(other.m_type)
+    , m_encoding(other.m_encoding)
+    , m_labeledAsReadonly(other.m_labeledAsReadonly)
+{
+    if (!m_ptr && !m_dataBlock) {
+        std::copy(other.m_inlineData, other.m_inlineData + m_size, m_inlineData);
+    }
+    other.m_size = 0;
+}
+
+/*!
+ * \brief Assigns the data and meta data of another TagValue to the current instance.
+ * \remarks The \a other value is left empty.
+ */
+TagValue &TagValue::operator=(TagValue &&other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+    m_size = other.m_size;
+    m_type = other.m_type;
+    m_metadata = move(other.m_metadata);
+    m_labeledAsReadonly = other.m_labeledAsReadonly;
+    m_encoding = other.m_encoding;
+    m_ptr = move(other.m_ptr);
+    m_dataBlock = move(other.m_dataBlock);
+    if (!m_ptr && !m_dataBlock) {
+        std::copy(other.m_inlineData, other.m_inlineData + m_size, m_inlineData);
     }
+    other.m_size = 0;
     return *this;
 }
 
@@ -108,8 +151,12 @@ TagValue &TagValue::operator=(const TagValue &other)
 bool TagValue::operator==(const TagValue &other) const
 {
     // check whether meta-data is equal
-    if (m_desc != other.m_desc || (!m_desc.empty() && m_descEncoding != other.m_descEncoding) || m_mimeType != other.m_mimeType
-        || m_language != other.m_language || m_labeledAsReadonly != other.m_labeledAsReadonly) {
+    if (m_labeledAsReadonly != other.m_labeledAsReadonly) {
+        return false;
+    }
+    if (m_metadata != other.m_metadata
+        && (description() != other.description() || (!description().empty() && descriptionEncoding() != other.descriptionEncoding())
+               || mimeType() != other.mimeType() || language() != other.language())) {
         return false;
     }
 
@@ -121,7 +168,7 @@ bool TagValue::operator==(const TagValue &other) const
                 // don't consider differently encoded text values equal
                 return false;
             }
-            return strncmp(m_ptr.get(), other.m_ptr.get(), m_size) == 0;
+            return strncmp(dataPointer(), other.dataPointer(), m_size) == 0;
         case TagDataType::PositionInSet:
             return toPositionInSet() == other.toPositionInSet();
         case TagDataType::Integer:
@@ -138,7 +185,7 @@ bool TagValue::operator==(const TagValue &other) const
             if (m_size != other.m_size) {
                 return false;
             }
-            return strncmp(m_ptr.get(), other.m_ptr.get(), m_size) == 0;
+            return strncmp(dataPointer(), other.dataPointer(), m_size) == 0;
         }
         return false;
     }
@@ -160,12 +207,9 @@ bool TagValue::operator==(const TagValue &other) const
  */
 void TagValue::clearMetadata()
 {
-    m_desc.clear();
-    m_mimeType.clear();
-    m_language.clear();
+    m_metadata.reset();
     m_labeledAsReadonly = false;
     m_encoding = TagTextEncoding::Latin1;
-    m_descEncoding = TagTextEncoding::Latin1;
     m_type = TagDataType::Undefined;
 }
 
@@ -185,10 +229,10 @@ int32 TagValue::toInteger() const
         case TagTextEncoding::Unspecified:
         case TagTextEncoding::Latin1:
         case TagTextEncoding::Utf8:
-            return ConversionUtilities::bufferToNumber<int32>(m_ptr.get(), m_size);
+            return ConversionUtilities::bufferToNumber<int32>(dataPointer(), m_size);
         case TagTextEncoding::Utf16LittleEndian:
         case TagTextEncoding::Utf16BigEndian:
-            u16string u16str(reinterpret_cast<char16_t *>(m_ptr.get()), m_size / 2);
+            u16string u16str(reinterpret_cast<const char16_t *>(dataPointer()), m_size / 2);
             ensureHostByteOrder(u16str, m_encoding);
             return ConversionUtilities::stringToNumber<int32>(u16str);
         }
@@ -196,7 +240,7 @@ int32 TagValue::toInteger() const
     case TagDataType::PositionInSet:
     case TagDataType::StandardGenreIndex:
         if (m_size == sizeof(int32)) {
-            return *reinterpret_cast<int32 *>(m_ptr.get());
+            return *reinterpret_cast<const int32 *>(dataPointer());
         }
         throw ConversionException("Can not convert assigned data to integer because the data size is not appropriate.");
     default:
@@ -234,7 +278,7 @@ int TagValue::toStandardGenreIndex() const
         if (m_size != sizeof(int32)) {
             throw ConversionException("The assigned index/integer is of unappropriate size.");
         }
-        index = static_cast<int>(*reinterpret_cast<int32 *>(m_ptr.get()));
+        index = static_cast<int>(*reinterpret_cast<const int32 *>(dataPointer()));
         break;
     default:
         throw ConversionException(argsToString("Can not convert ", tagDataTypeString(m_type), " to genre index."));
@@ -261,10 +305,10 @@ PositionInSet TagValue::toPositionInSet() const
         case TagTextEncoding::Unspecified:
         case TagTextEncoding::Latin1:
         case TagTextEncoding::Utf8:
-            return PositionInSet(string(m_ptr.get(), m_size));
+            return PositionInSet(string(dataPointer(), m_size));
         case TagTextEncoding::Utf16LittleEndian:
         case TagTextEncoding::Utf16BigEndian:
-            u16string u16str(reinterpret_cast<char16_t *>(m_ptr.get()), m_size / 2);
+            u16string u16str(reinterpret_cast<const char16_t *>(dataPointer()), m_size / 2);
             ensureHostByteOrder(u16str, m_encoding);
             return PositionInSet(u16str);
         }
@@ -272,9 +316,10 @@ PositionInSet TagValue::toPositionInSet() const
     case TagDataType::PositionInSet:
         switch (m_size) {
         case sizeof(int32):
-            return PositionInSet(*(reinterpret_cast<int32 *>(m_ptr.get())));
+            return PositionInSet(*(reinterpret_cast<const int32 *>(dataPointer())));
         case 2 * sizeof(int32):
-            return PositionInSet(*(reinterpret_cast<int32 *>(m_ptr.get())), *(reinterpret_cast<int32 *>(m_ptr.get() + sizeof(int32))));
+            return PositionInSet(
+                *(reinterpret_cast<const int32 *>(dataPointer())), *(reinterpret_cast<const int32 *>(dataPointer() + sizeof(int32))));
         default:
             throw ConversionException("The size of the assigned data is not appropriate.");
         }
@@ -300,9 +345,9 @@ TimeSpan TagValue::toTimeSpan() const
     case TagDataType::TimeSpan:
         switch (m_size) {
         case sizeof(int32):
-            return TimeSpan(*(reinterpret_cast<int32 *>(m_ptr.get())));
+            return TimeSpan(*(reinterpret_cast<const int32 *>(dataPointer())));
         case sizeof(int64):
-            return TimeSpan(*(reinterpret_cast<int64 *>(m_ptr.get())));
+            return TimeSpan(*(reinterpret_cast<const int64 *>(dataPointer())));
         default:
             throw ConversionException("The size of the assigned integer is not appropriate for conversion to time span.");
         }
@@ -327,9 +372,9 @@ DateTime TagValue::toDateTime() const
     case TagDataType::Integer:
     case TagDataType::DateTime:
         if (m_size == sizeof(int32)) {
-            return DateTime(*(reinterpret_cast<uint32 *>(m_ptr.get())));
+            return DateTime(*(reinterpret_cast<const uint32 *>(dataPointer())));
         } else if (m_size == sizeof(int64)) {
-            return DateTime(*(reinterpret_cast<uint64 *>(m_ptr.get())));
+            return DateTime(*(reinterpret_cast<const uint64 *>(dataPointer())));
         } else {
             throw ConversionException("The size of the assigned integer is not appropriate for conversion to date time.");
         }
@@ -338,25 +383,6 @@ DateTime TagValue::toDateTime() const
     }
 }
 
-/*!
- * \brief Returns the encoding parameter (name of the character set and bytes per character) for the specified \a tagTextEncoding.
- */
-pair<const char *, float> encodingParameter(TagTextEncoding tagTextEncoding)
-{
-    switch (tagTextEncoding) {
-    case TagTextEncoding::Latin1:
-        return make_pair("ISO-8859-1", 1.0f);
-    case TagTextEncoding::Utf8:
-        return make_pair("UTF-8", 1.0f);
-    case TagTextEncoding::Utf16LittleEndian:
-        return make_pair("UTF-16LE", 2.0f);
-    case TagTextEncoding::Utf16BigEndian:
-        return make_pair("UTF-16BE", 2.0f);
-    default:
-        return make_pair(nullptr, 0.0f);
-    }
-}
-
 /*!
  * \brief Converts the currently assigned text value to the specified \a encoding.
  * \throws Throws ConversionUtilities::ConversionException() if the conversion fails.
@@ -372,34 +398,24 @@ void TagValue::convertDataEncoding(TagTextEncoding encoding)
         return;
     }
     if (type() == TagDataType::Text) {
-        StringData encodedData;
-        switch (encoding) {
-        case TagTextEncoding::Utf8:
-            // use pre-defined methods when encoding to UTF-8
-            switch (dataEncoding()) {
-            case TagTextEncoding::Latin1:
-                encodedData = convertLatin1ToUtf8(m_ptr.get(), m_size);
-                break;
-            case TagTextEncoding::Utf16LittleEndian:
-                encodedData = convertUtf16LEToUtf8(m_ptr.get(), m_size);
-                break;
-            case TagTextEncoding::Utf16BigEndian:
-                encodedData = convertUtf16BEToUtf8(m_ptr.get(), m_size);
-                break;
-            default:;
+        // read via the const overload to avoid copying shared data which is replaced anyways
+        const char *data = static_cast<const TagValue &>(*this).dataPointer();
+        const auto size = TextConversion::convertedSize(data, m_size, m_encoding, encoding);
+        if (size != TextConversion::invalidSize) {
+            // keep the current data until the conversion is done because the buffer is going to be replaced
+            const auto currentData = m_ptr;
+            const auto currentSize = m_size;
+            char inlineData[inlineDataCapacity];
+            if (!currentData) {
+                std::copy(m_inlineData, m_inlineData + currentSize, inlineData);
+                data = inlineData;
             }
-            break;
-        default: {
-            // otherwise, determine input and output parameter to use general covertString method
-            const auto inputParameter = encodingParameter(dataEncoding());
-            const auto outputParameter = encodingParameter(encoding);
-            encodedData
-                = convertString(inputParameter.first, outputParameter.first, m_ptr.get(), m_size, outputParameter.second / inputParameter.second);
-        }
+            TextConversion::convert(data, currentSize, m_encoding, encoding, allocateData(size));
+        } else {
+            // fall back to iconv which also takes care of raising the error if the conversion is not possible
+            const auto encodedData = TextConversion::convertString(data, m_size, m_encoding, encoding);
+            copy(encodedData.first.get(), encodedData.first.get() + encodedData.second, allocateData(encodedData.second));
         }
-        // can't just move the encoded data because it needs to be deleted with free
-        m_ptr = make_unique<char[]>(m_size = encodedData.second);
-        copy(encodedData.first.get(), encodedData.first.get() + encodedData.second, m_ptr.get());
     }
     m_encoding = encoding;
 }
@@ -434,34 +450,9 @@ void TagValue::toString(string &result, TagTextEncoding encoding) const
     switch (m_type) {
     case TagDataType::Text:
         if (encoding == TagTextEncoding::Unspecified || dataEncoding() == TagTextEncoding::Unspecified || encoding == dataEncoding()) {
-            result.assign(m_ptr.get(), m_size);
+            result.assign(dataPointer(), m_size);
         } else {
-            StringData encodedData;
-            switch (encoding) {
-            case TagTextEncoding::Utf8:
-                // use pre-defined methods when encoding to UTF-8
-                switch (dataEncoding()) {
-                case TagTextEncoding::Latin1:
-                    encodedData = convertLatin1ToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16LittleEndian:
-                    encodedData = convertUtf16LEToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16BigEndian:
-                    encodedData = convertUtf16BEToUtf8(m_ptr.get(), m_size);
-                    break;
-                default:;
-                }
-                break;
-            default: {
-                // otherwise, determine input and output parameter to use general covertString method
-                const auto inputParameter = encodingParameter(dataEncoding());
-                const auto outputParameter = encodingParameter(encoding);
-                encodedData
-                    = convertString(inputParameter.first, outputParameter.first, m_ptr.get(), m_size, outputParameter.second / inputParameter.second);
-            }
-            }
-            result.assign(encodedData.first.get(), encodedData.second);
+            TextConversion::convertString(dataPointer(), m_size, dataEncoding(), encoding, result);
         }
         return;
     case TagDataType::Integer:
@@ -487,9 +478,9 @@ void TagValue::toString(string &result, TagTextEncoding encoding) const
         throw ConversionException(argsToString("Can not convert ", tagDataTypeString(m_type), " to string."));
     }
     if (encoding == TagTextEncoding::Utf16LittleEndian || encoding == TagTextEncoding::Utf16BigEndian) {
-        auto encodedData = encoding == TagTextEncoding::Utf16LittleEndian ? convertUtf8ToUtf16LE(result.data(), result.size())
-                                                                          : convertUtf8ToUtf16BE(result.data(), result.size());
-        result.assign(encodedData.first.get(), encodedData.second);
+        string utf8;
+        utf8.swap(result);
+        TextConversion::convertString(utf8.data(), utf8.size(), TagTextEncoding::Utf8, encoding, result);
     }
 }
 
@@ -511,34 +502,9 @@ void TagValue::toWString(std::u16string &result, TagTextEncoding encoding) const
     switch (m_type) {
     case TagDataType::Text:
         if (encoding == TagTextEncoding::Unspecified || encoding == dataEncoding()) {
-            result.assign(reinterpret_cast<const char16_t *>(m_ptr.get()), m_size / sizeof(char16_t));
+            result.assign(reinterpret_cast<const char16_t *>(dataPointer()), m_size / sizeof(char16_t));
         } else {
-            StringData encodedData;
-            switch (encoding) {
-            case TagTextEncoding::Utf8:
-                // use pre-defined methods when encoding to UTF-8
-                switch (dataEncoding()) {
-                case TagTextEncoding::Latin1:
-                    encodedData = convertLatin1ToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16LittleEndian:
-                    encodedData = convertUtf16LEToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16BigEndian:
-                    encodedData = convertUtf16BEToUtf8(m_ptr.get(), m_size);
-                    break;
-                default:;
-                }
-                break;
-            default: {
-                // otherwise, determine input and output parameter to use general covertString method
-                const auto inputParameter = encodingParameter(dataEncoding());
-                const auto outputParameter = encodingParameter(encoding);
-                encodedData
-                    = convertString(inputParameter.first, outputParameter.first, m_ptr.get(), m_size, outputParameter.second / inputParameter.second);
-            }
-            }
-            result.assign(reinterpret_cast<const char16_t *>(encodedData.first.get()), encodedData.second / sizeof(char16_t));
+            TextConversion::convertString(dataPointer(), m_size, dataEncoding(), encoding, result);
         }
         return;
     case TagDataType::Integer:
@@ -560,9 +526,7 @@ void TagValue::toWString(std::u16string &result, TagTextEncoding encoding) const
         throw ConversionException(argsToString("Can not convert ", tagDataTypeString(m_type), " to string."));
     }
     if (encoding == TagTextEncoding::Utf16LittleEndian || encoding == TagTextEncoding::Utf16BigEndian) {
-        auto encodedData = encoding == TagTextEncoding::Utf16LittleEndian ? convertUtf8ToUtf16LE(regularStrRes.data(), result.size())
-                                                                          : convertUtf8ToUtf16BE(regularStrRes.data(), result.size());
-        result.assign(reinterpret_cast<const char16_t *>(encodedData.first.get()), encodedData.second / sizeof(const char16_t));
+        TextConversion::convertString(regularStrRes.data(), regularStrRes.size(), TagTextEncoding::Utf8, encoding, result);
     }
 }
 
@@ -580,6 +544,7 @@ void TagValue::assignText(const char *text, std::size_t textSize, TagTextEncodin
 {
     m_type = TagDataType::Text;
     m_encoding = convertTo == TagTextEncoding::Unspecified ? textEncoding : convertTo;
+    m_dataBlock.reset();
 
     stripBom(text, textSize, textEncoding);
     if (!textSize) {
@@ -589,38 +554,20 @@ void TagValue::assignText(const char *text, std::size_t textSize, TagTextEncodin
     }
 
     if (convertTo == TagTextEncoding::Unspecified || textEncoding == convertTo) {
-        m_ptr = make_unique<char[]>(m_size = textSize);
-        copy(text, text + textSize, m_ptr.get());
+        copy(text, text + textSize, allocateData(textSize));
         return;
     }
 
-    StringData encodedData;
-    switch (textEncoding) {
-    case TagTextEncoding::Utf8:
-        // use pre-defined methods when encoding to UTF-8
-        switch (convertTo) {
-        case TagTextEncoding::Latin1:
-            encodedData = convertUtf8ToLatin1(text, textSize);
-            break;
-        case TagTextEncoding::Utf16LittleEndian:
-            encodedData = convertUtf8ToUtf16LE(text, textSize);
-            break;
-        case TagTextEncoding::Utf16BigEndian:
-            encodedData = convertUtf8ToUtf16BE(text, textSize);
-            break;
-        default:;
-        }
-        break;
-    default: {
-        // otherwise, determine input and output parameter to use general covertString method
-        const auto inputParameter = encodingParameter(textEncoding);
-        const auto outputParameter = encodingParameter(convertTo);
-        encodedData = convertString(inputParameter.first, outputParameter.first, text, textSize, outputParameter.second / inputParameter.second);
-    }
+    const auto size = TextConversion::convertedSize(text, textSize, textEncoding, convertTo);
+    if (size != TextConversion::invalidSize) {
+        TextConversion::convert(text, textSize, textEncoding, convertTo, allocateData(size));
+        return;
     }
+
+    // fall back to iconv which also takes care of raising the error if the conversion is not possible
+    const auto encodedData = TextConversion::convertString(text, textSize, textEncoding, convertTo);
     // can't just move the encoded data because it needs to be deleted with free
-    m_ptr = make_unique<char[]>(m_size = encodedData.second);
-    copy(encodedData.first.get(), encodedData.first.get() + encodedData.second, m_ptr.get());
+    copy(encodedData.first.get(), encodedData.first.get() + encodedData.second, allocateData(encodedData.second));
 }
 
 /*!
@@ -629,9 +576,7 @@ void TagValue::assignText(const char *text, std::size_t textSize, TagTextEncodin
  */
 void TagValue::assignInteger(int value)
 {
-    m_size = sizeof(value);
-    m_ptr = make_unique<char[]>(m_size);
-    std::copy(reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value) + m_size, m_ptr.get());
+    std::copy(reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value) + sizeof(value), allocateData(sizeof(value)));
     m_type = TagDataType::Integer;
     m_encoding = TagTextEncoding::Latin1;
 }
@@ -643,21 +588,37 @@ void TagValue::assignInteger(int value)
  * \param type Specifies the type of the data as TagDataType.
  * \param encoding Specifies the encoding of the data as TagTextEncoding. The
  *                 encoding will only be considered if a text is assigned.
+ * \remarks The specified \a data might point to the data currently assigned (eg. dataPointer()).
  */
 void TagValue::assignData(const char *data, size_t length, TagDataType type, TagTextEncoding encoding)
 {
     if (type == TagDataType::Text) {
         stripBom(data, length, encoding);
     }
-    if (length > m_size) {
-        m_ptr = make_unique<char[]>(length);
-    }
-    if (length) {
+    // check whether the specified data is (part of) the data currently assigned (eg. when assigning a part of the current data)
+    const char *const currentData = m_ptr ? m_ptr.get() : m_inlineData;
+    const bool aliasing = m_size && !m_dataBlock && !less<const char *>()(data, currentData) && less<const char *>()(data, currentData + m_size);
+    if (length <= inlineDataCapacity) {
+        if (aliasing) {
+            // copy the data first because it is going to be overwritten or released when allocating the new buffer
+            char inlineData[inlineDataCapacity];
+            std::copy(data, data + length, inlineData);
+            std::copy(inlineData, inlineData + length, allocateData(length));
+        } else {
+            std::copy(data, data + length, allocateData(length));
+        }
+    } else if (!aliasing && length <= m_size && m_ptr && m_ptr.use_count() == 1) {
+        // re-use the current buffer if it is big enough and not shared with other values
+        m_size = length;
         std::copy(data, data + length, m_ptr.get());
     } else {
-        m_ptr.reset();
+        // copy the data into the new buffer before replacing the current one which might hold the data
+        auto buffer = makeData(length);
+        std::copy(data, data + length, buffer.get());
+        m_ptr = move(buffer);
+        m_size = length;
+        m_dataBlock.reset();
     }
-    m_size = length;
     m_type = type;
     m_encoding = encoding;
 }
@@ -676,10 +637,96 @@ void TagValue::assignData(const char *data, size_t length, TagDataType type, Tag
  */
 void TagValue::assignData(unique_ptr<char[]> &&data, size_t length, TagDataType type, TagTextEncoding encoding)
 {
-    m_size = length;
+    m_ptr = makeData(move(data));
+    m_size = m_ptr ? length : 0;
     m_type = type;
     m_encoding = encoding;
-    m_ptr = move(data);
+    m_dataBlock.reset();
+}
+
+/*!
+ * \brief Assigns the data of the specified \a dataBlock without reading it.
+ *
+ * The data is read from the stream of the \a dataBlock on the first access via dataPointer() or any of the conversion
+ * functions. As long as the data has not been read, copies of the value share the reference to the \a dataBlock and
+ * copyDataTo() copies the data directly from the stream of the \a dataBlock. So the stream must stay valid and the
+ * referenced data must not be modified until the value is not used anymore.
+ *
+ * \param dataBlock Specifies the data block to be referenced.
+ * \param type Specifies the type of the data as TagDataType.
+ */
+void TagValue::assignData(const std::shared_ptr<const StreamDataBlock> &dataBlock, TagDataType type)
+{
+    m_size = dataBlock ? static_cast<size_t>(static_cast<streamoff>(dataBlock->size())) : 0;
+    m_type = type;
+    m_encoding = TagTextEncoding::Latin1;
+    m_ptr.reset();
+    m_dataBlock = m_size ? dataBlock : nullptr;
+}
+
+/*!
+ * \brief Reads the assigned data block into memory and releases the reference to it.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void TagValue::readDataBlock() const
+{
+    istream &stream = m_dataBlock->stream();
+    stream.seekg(m_dataBlock->startOffset());
+    if (m_size <= inlineDataCapacity) {
+        stream.read(m_inlineData, static_cast<streamsize>(m_size));
+    } else {
+        auto data = make_unique<char[]>(m_size);
+        stream.read(data.get(), static_cast<streamsize>(m_size));
+        m_ptr = makeData(move(data));
+    }
+    m_dataBlock.reset();
+}
+
+/*!
+ * \brief Replaces the data shared with other values by a copy of it.
+ */
+void TagValue::detachData()
+{
+    const auto sharedData = move(m_ptr);
+    std::copy(sharedData.get(), sharedData.get() + m_size, allocateData(m_size));
+}
+
+/*!
+ * \brief Returns the meta data for modification.
+ * \remarks Allocates the meta data if not present yet or creates a copy of it if it is currently shared with other values.
+ */
+TagValue::Metadata &TagValue::metadata()
+{
+    if (!m_metadata) {
+        m_metadata = make_shared<Metadata>();
+    } else if (m_metadata.use_count() > 1) {
+        m_metadata = make_shared<Metadata>(*m_metadata);
+    }
+    return *m_metadata;
+}
+
+/*!
+ * \brief Returns an empty string which is returned by the meta data accessors if no meta data is present.
+ */
+const string &TagValue::emptyString()
+{
+    static const string emptyString;
+    return emptyString;
+}
+
+/*!
+ * \brief Writes the assigned data to the specified \a stream.
+ * \remarks If a data block is assigned and has not been read yet, the data is copied in chunks directly from the
+ *          stream of the data block so it is never held in memory as a whole.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void TagValue::copyDataTo(ostream &stream) const
+{
+    if (m_dataBlock) {
+        m_dataBlock->copyTo(stream);
+    } else if (m_size) {
+        stream.write(dataPointer(), static_cast<streamsize>(m_size));
+    }
 }
 
 /*!
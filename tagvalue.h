@@ -17,6 +17,7 @@ namespace TagParser {
 
 class Tag;
 class Id3v2Frame;
+class StreamDataBlock;
 
 /*!
  * \brief Specifies the text encoding.
@@ -75,14 +76,15 @@ public:
     TagValue(const char *data, std::size_t length, TagDataType type = TagDataType::Undefined, TagTextEncoding encoding = TagTextEncoding::Latin1);
     TagValue(std::unique_ptr<char[]> &&data, std::size_t length, TagDataType type = TagDataType::Binary,
         TagTextEncoding encoding = TagTextEncoding::Latin1);
+    TagValue(const std::shared_ptr<const StreamDataBlock> &dataBlock, TagDataType type = TagDataType::Binary);
     TagValue(const PositionInSet &value);
     TagValue(const TagValue &other);
-    TagValue(TagValue &&other) = default;
+    TagValue(TagValue &&other) noexcept;
     ~TagValue();
 
     // operators
     TagValue &operator=(const TagValue &other);
-    TagValue &operator=(TagValue &&other) = default;
+    TagValue &operator=(TagValue &&other) noexcept;
     bool operator==(const TagValue &other) const;
     bool operator!=(const TagValue &other) const;
 
@@ -104,6 +106,8 @@ public:
     std::size_t dataSize() const;
     char *dataPointer();
     const char *dataPointer() const;
+    const StreamDataBlock *dataBlock() const;
+    void copyDataTo(std::ostream &stream) const;
     const std::string &description() const;
     void setDescription(const std::string &value, TagTextEncoding encoding = TagTextEncoding::Latin1);
     const std::string &mimeType() const;
@@ -127,6 +131,7 @@ public:
     void assignData(const char *data, std::size_t length, TagDataType type = TagDataType::Binary, TagTextEncoding encoding = TagTextEncoding::Latin1);
     void assignData(std::unique_ptr<char[]> &&data, std::size_t length, TagDataType type = TagDataType::Binary,
         TagTextEncoding encoding = TagTextEncoding::Latin1);
+    void assignData(const std::shared_ptr<const StreamDataBlock> &dataBlock, TagDataType type = TagDataType::Binary);
     void assignPosition(PositionInSet value);
     void assignTimeSpan(ChronoUtilities::TimeSpan value);
     void assignDateTime(ChronoUtilities::DateTime value);
@@ -140,15 +145,35 @@ public:
     static std::vector<std::string> toStrings(const ContainerType &values, TagTextEncoding encoding = TagTextEncoding::Utf8);
 
 private:
-    std::unique_ptr<char[]> m_ptr;
+    /// \brief The maximum size of data which is stored within the value itself instead of being allocated separately.
+    static constexpr std::size_t inlineDataCapacity = 32;
+
+    /*!
+     * \brief The Metadata struct holds the meta data of a value which is only allocated if present.
+     */
+    struct Metadata {
+        std::string description;
+        std::string mimeType;
+        std::string language;
+        TagTextEncoding descriptionEncoding = TagTextEncoding::Latin1;
+    };
+
+    static std::shared_ptr<char> makeData(std::size_t size);
+    static std::shared_ptr<char> makeData(std::unique_ptr<char[]> &&data);
+    static const std::string &emptyString();
+    char *allocateData(std::size_t size);
+    void readDataBlock() const;
+    void detachData();
+    Metadata &metadata();
+
+    mutable std::shared_ptr<char> m_ptr;
+    mutable std::shared_ptr<const StreamDataBlock> m_dataBlock;
+    std::shared_ptr<Metadata> m_metadata;
     std::size_t m_size;
-    std::string m_desc;
-    std::string m_mimeType;
-    std::string m_language;
     TagDataType m_type;
     TagTextEncoding m_encoding;
-    TagTextEncoding m_descEncoding;
     bool m_labeledAsReadonly;
+    mutable char m_inlineData[inlineDataCapacity];
 };
 
 /*!
@@ -158,7 +183,6 @@ inline TagValue::TagValue()
     : m_size(0)
     , m_type(TagDataType::Undefined)
     , m_encoding(TagTextEncoding::Latin1)
-    , m_descEncoding(TagTextEncoding::Latin1)
     , m_labeledAsReadonly(false)
 {
 }
@@ -170,6 +194,37 @@ inline TagValue::~TagValue()
 {
 }
 
+/*!
+ * \brief Allocates a buffer of the specified \a size which can be shared between values.
+ */
+inline std::shared_ptr<char> TagValue::makeData(std::size_t size)
+{
+    return std::shared_ptr<char>(new char[size](), std::default_delete<char[]>());
+}
+
+/*!
+ * \brief Takes ownership of the specified \a data so it can be shared between values.
+ */
+inline std::shared_ptr<char> TagValue::makeData(std::unique_ptr<char[]> &&data)
+{
+    return std::shared_ptr<char>(data.release(), std::default_delete<char[]>());
+}
+
+/*!
+ * \brief Sets the data size to the specified \a size and returns a buffer of that size to write the data to.
+ * \remarks Data up to inlineDataCapacity bytes is stored within the value itself so no allocation is required.
+ */
+inline char *TagValue::allocateData(std::size_t size)
+{
+    m_dataBlock.reset();
+    if ((m_size = size) <= inlineDataCapacity) {
+        m_ptr.reset();
+        return m_inlineData;
+    }
+    m_ptr = makeData(size);
+    return m_ptr.get();
+}
+
 /*!
  * \brief Constructs a new TagValue holding a copy of the given \a text.
  * \param text Specifies the text to be assigned.
@@ -181,8 +236,7 @@ inline TagValue::~TagValue()
  * \remarks Strips the BOM of the specified \a text.
  */
 inline TagValue::TagValue(const char *text, std::size_t textSize, TagTextEncoding textEncoding, TagTextEncoding convertTo)
-    : m_descEncoding(TagTextEncoding::Latin1)
-    , m_labeledAsReadonly(false)
+    : m_labeledAsReadonly(false)
 {
     assignText(text, textSize, textEncoding, convertTo);
 }
@@ -197,6 +251,7 @@ inline TagValue::TagValue(const char *text, std::size_t textSize, TagTextEncodin
  * \remarks Strips the BOM of the specified \a text.
  */
 inline TagValue::TagValue(const char *text, TagTextEncoding textEncoding, TagTextEncoding convertTo)
+    : m_labeledAsReadonly(false)
 {
     assignText(text, std::strlen(text), textEncoding, convertTo);
 }
@@ -211,8 +266,7 @@ inline TagValue::TagValue(const char *text, TagTextEncoding textEncoding, TagTex
  * \remarks Strips the BOM of the specified \a text.
  */
 inline TagValue::TagValue(const std::string &text, TagTextEncoding textEncoding, TagTextEncoding convertTo)
-    : m_descEncoding(TagTextEncoding::Latin1)
-    , m_labeledAsReadonly(false)
+    : m_labeledAsReadonly(false)
 {
     assignText(text, textEncoding, convertTo);
 }
@@ -236,19 +290,14 @@ inline TagValue::TagValue(int value)
  * \remarks Strips the BOM of the specified \a data if \a type is TagDataType::Text.
  */
 inline TagValue::TagValue(const char *data, std::size_t length, TagDataType type, TagTextEncoding encoding)
-    : m_size(length)
-    , m_type(type)
+    : m_type(type)
     , m_encoding(encoding)
-    , m_descEncoding(TagTextEncoding::Latin1)
     , m_labeledAsReadonly(false)
 {
-    if (length) {
-        if (type == TagDataType::Text) {
-            stripBom(data, m_size, encoding);
-        }
-        m_ptr = std::make_unique<char[]>(m_size);
-        std::copy(data, data + m_size, m_ptr.get());
+    if (type == TagDataType::Text) {
+        stripBom(data, length, encoding);
     }
+    std::copy(data, data + length, allocateData(length));
 }
 
 /*!
@@ -264,17 +313,28 @@ inline TagValue::TagValue(const char *data, std::size_t length, TagDataType type
  * \remarks Does not strip the BOM so for consistency the caller must ensure there is no BOM present.
  */
 inline TagValue::TagValue(std::unique_ptr<char[]> &&data, std::size_t length, TagDataType type, TagTextEncoding encoding)
-    : m_size(length)
+    : m_size(data ? length : 0)
     , m_type(type)
     , m_encoding(encoding)
-    , m_descEncoding(TagTextEncoding::Latin1)
     , m_labeledAsReadonly(false)
 {
-    if (length) {
-        m_ptr = move(data);
+    if (m_size) {
+        m_ptr = makeData(move(data));
     }
 }
 
+/*!
+ * \brief Constructs a new TagValue referring to the specified \a dataBlock.
+ * \sa assignData(const std::shared_ptr<const StreamDataBlock> &, TagDataType)
+ */
+inline TagValue::TagValue(const std::shared_ptr<const StreamDataBlock> &dataBlock, TagDataType type)
+    : m_size(0)
+    , m_encoding(TagTextEncoding::Latin1)
+    , m_labeledAsReadonly(false)
+{
+    assignData(dataBlock, type);
+}
+
 /*!
  * \brief Constructs a new TagValue holding a copy of the given PositionInSet \a value.
  * \param value Specifies the PositionInSet.
@@ -389,7 +449,7 @@ inline std::u16string TagValue::toWString(TagTextEncoding encoding) const
  */
 inline bool TagValue::isEmpty() const
 {
-    return m_ptr == nullptr || m_size == 0;
+    return m_size == 0;
 }
 
 /*!
@@ -402,6 +462,7 @@ inline void TagValue::clearData()
 {
     m_size = 0;
     m_ptr.reset();
+    m_dataBlock.reset();
 }
 
 /*!
@@ -429,15 +490,41 @@ inline std::size_t TagValue::dataSize() const
  * \remarks The instance keeps ownership over the data which will be invalidated when the
  *          TagValue gets destroyed or another value is assigned.
  * \remarks The raw data is not null terminated. See dataSize().
+ * \remarks If a data block is assigned, it is read into memory first (see dataBlock()).
+ * \remarks The data is shared between copies of the value. The non-const overload creates a copy of the data
+ *          before returning if the data is currently shared so modifications do not affect other values.
+ * \remarks Small data is stored within the value itself (and hence not shared between copies). So the returned pointer
+ *          is also invalidated when the value is moved, eg. when fields are inserted into or removed from a tag which
+ *          stores its fields in a FlatMultiMap (see FieldMapBasedTag::fields()).
+ * \throws Throws std::ios_base::failure when an IO error occurs when reading the assigned data block.
  */
 inline char *TagValue::dataPointer()
 {
-    return m_ptr.get();
+    if (m_dataBlock) {
+        readDataBlock();
+    } else if (m_ptr.use_count() > 1) {
+        detachData();
+    }
+    return m_ptr ? m_ptr.get() : (m_size ? m_inlineData : nullptr);
 }
 
 inline const char *TagValue::dataPointer() const
 {
-    return m_ptr.get();
+    if (m_dataBlock) {
+        readDataBlock();
+    }
+    return m_ptr ? m_ptr.get() : (m_size ? m_inlineData : nullptr);
+}
+
+/*!
+ * \brief Returns the data block the data is read from or nullptr if the data is held in memory.
+ *
+ * A data block is assigned via assignData(const std::shared_ptr<const StreamDataBlock> &, TagDataType). It is read
+ * into memory on the first call of dataPointer() or any of the conversion functions and released afterwards.
+ */
+inline const StreamDataBlock *TagValue::dataBlock() const
+{
+    return m_dataBlock.get();
 }
 
 /*!
@@ -448,7 +535,7 @@ inline const char *TagValue::dataPointer() const
  */
 inline const std::string &TagValue::description() const
 {
-    return m_desc;
+    return m_metadata ? m_metadata->description : emptyString();
 }
 
 /*!
@@ -461,8 +548,9 @@ inline const std::string &TagValue::description() const
  */
 inline void TagValue::setDescription(const std::string &value, TagTextEncoding encoding)
 {
-    m_desc = value;
-    m_descEncoding = encoding;
+    Metadata &metadata = this->metadata();
+    metadata.description = value;
+    metadata.descriptionEncoding = encoding;
 }
 
 /*!
@@ -472,7 +560,7 @@ inline void TagValue::setDescription(const std::string &value, TagTextEncoding e
  */
 inline const std::string &TagValue::mimeType() const
 {
-    return m_mimeType;
+    return m_metadata ? m_metadata->mimeType : emptyString();
 }
 
 /*!
@@ -483,7 +571,7 @@ inline const std::string &TagValue::mimeType() const
  */
 inline void TagValue::setMimeType(const std::string &mimeType)
 {
-    m_mimeType = mimeType;
+    metadata().mimeType = mimeType;
 }
 
 /*!
@@ -493,7 +581,7 @@ inline void TagValue::setMimeType(const std::string &mimeType)
  */
 inline const std::string &TagValue::language() const
 {
-    return m_language;
+    return m_metadata ? m_metadata->language : emptyString();
 }
 
 /*!
@@ -504,7 +592,7 @@ inline const std::string &TagValue::language() const
  */
 inline void TagValue::setLanguage(const std::string &language)
 {
-    m_language = language;
+    metadata().language = language;
 }
 
 /*!
@@ -550,7 +638,7 @@ inline TagTextEncoding TagValue::dataEncoding() const
  */
 inline TagTextEncoding TagValue::descriptionEncoding() const
 {
-    return m_descEncoding;
+    return m_metadata ? m_metadata->descriptionEncoding : TagTextEncoding::Latin1;
 }
 
 /*!
@@ -0,0 +1,200 @@
+#include "./helper.h"
+
+#include "../aac/aaccodebook.h"
+#include "../aac/aacframe.h"
+#include "../exceptions.h"
+#include "../mp4/mp4ids.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The AacTests class tests decoding Huffman codes when parsing raw data blocks of AAC streams.
+ * \remarks The AAC parser is still WIP. So only the parts of it which are used to detect SBR are tested.
+ */
+class AacTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(AacTests);
+    CPPUNIT_TEST(testDecodingHuffmanCodes);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testDecodingHuffmanCodes();
+};
+
+/// \cond
+
+namespace AacTestHelper {
+
+/*!
+ * \brief The HuffmanCode struct holds a code of a spectral Huffman codebook and the number of non-zero values it denotes.
+ */
+struct HuffmanCode {
+    string bits;
+    unsigned int nonZeroValueCount;
+};
+
+/*!
+ * \brief Returns the codes and leafs of the Huffman tree described by \a isLeaf and \a next by walking the tree from the
+ *        specified \a node.
+ */
+void collectHuffmanCodes(
+    int node, const string &bits, const function<bool(int)> &isLeaf, const function<int(int, int)> &next, vector<pair<string, int>> &codes)
+{
+    if (isLeaf(node)) {
+        codes.emplace_back(bits, node);
+        return;
+    }
+    collectHuffmanCodes(next(node, 0), bits + '0', isLeaf, next, codes);
+    collectHuffmanCodes(next(node, 1), bits + '1', isLeaf, next, codes);
+}
+
+/*!
+ * \brief Returns all codes of the Huffman tree for scale factors ordered by the scale factor difference they denote.
+ */
+vector<string> scaleFactorCodes()
+{
+    vector<pair<string, int>> codes;
+    collectHuffmanCodes(
+        0, string(), [](int node) { return !aacHcbSf[node][1]; }, [](int node, int bit) { return node + aacHcbSf[node][bit]; }, codes);
+    vector<string> sortedCodes(codes.size());
+    for (const auto &code : codes) {
+        sortedCodes.at(aacHcbSf[code.second][0]) = code.first;
+    }
+    return sortedCodes;
+}
+
+/*!
+ * \brief Returns all codes of the binary Huffman tree for the specified spectral codebook \a cb.
+ */
+vector<HuffmanCode> spectralCodes(byte cb)
+{
+    vector<pair<string, int>> codes;
+    vector<HuffmanCode> spectralCodes;
+    if (cb == 3) {
+        collectHuffmanCodes(
+            0, string(), [](int node) { return aacHcb3[node].isLeaf; }, [](int node, int bit) { return node + aacHcb3[node].data[bit]; }, codes);
+        for (const auto &code : codes) {
+            const sbyte *const values = aacHcb3[code.second].data;
+            spectralCodes.emplace_back(
+                HuffmanCode{ code.first, static_cast<unsigned int>((values[0] != 0) + (values[1] != 0) + (values[2] != 0) + (values[3] != 0)) });
+        }
+    } else {
+        const AacHcbBinPair *const table = aacHcbBinTable[cb];
+        collectHuffmanCodes(
+            0, string(), [table](int node) { return table[node].isLeaf; }, [table](int node, int bit) { return node + table[node].data[bit]; },
+            codes);
+        for (const auto &code : codes) {
+            const sbyte *const values = table[code.second].data;
+            spectralCodes.emplace_back(HuffmanCode{ code.first, static_cast<unsigned int>((values[0] != 0) + (values[1] != 0)) });
+        }
+    }
+    return spectralCodes;
+}
+
+/*!
+ * \brief Returns a raw data block consisting of a "single channel element" followed by the "ID_END" element.
+ *
+ * The only scale factor band uses the specified spectral codebook \a cb and is denoted by the specified \a scaleFactorCode
+ * and \a spectralCodes. Sign bits are added for codebooks which require them.
+ */
+string makeRawDataBlock(byte cb, const string &scaleFactorCode, const vector<const HuffmanCode *> &spectralCodes)
+{
+    string bits;
+    const auto appendBits = [&bits](unsigned int value, unsigned int bitCount) {
+        while (bitCount) {
+            bits += (value >> --bitCount) & 0x1 ? '1' : '0';
+        }
+    };
+    appendBits(0, 3); // ID_SCE
+    appendBits(0, 4); // element instance tag
+    appendBits(100, 8); // global gain
+    appendBits(0, 4); // ics info: reserved bit, only long sequence, window shape
+    appendBits(1, 6); // max SFB
+    appendBits(0, 1); // no predictor data
+    appendBits(cb, 4); // section data: codebook
+    appendBits(1, 5); // section data: section length
+    bits += scaleFactorCode;
+    appendBits(0, 3); // no pulse data, TNS data and gain control data
+    for (const HuffmanCode *const code : spectralCodes) {
+        bits += code->bits;
+        if (cb != 5) {
+            appendBits(0, code->nonZeroValueCount); // sign bits (only codebook 5 is signed)
+        }
+    }
+    appendBits(7, 3); // ID_END
+    bits.append((8 - bits.size() % 8) % 8, '0');
+
+    string block;
+    for (size_t i = 0; i < bits.size(); i += 8) {
+        block += static_cast<char>(stoul(bits.substr(i, 8), nullptr, 2));
+    }
+    return block;
+}
+
+} // namespace AacTestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AacTests);
+
+void AacTests::setUp()
+{
+}
+
+void AacTests::tearDown()
+{
+}
+
+/*!
+ * \brief Tests decoding every code of the scale factor codebook and the binary spectral codebooks 3, 5, 7 and 9.
+ * \remarks
+ * - The codes are taken from the Huffman trees so this checks whether decoding via lookup tables yields the same as walking
+ *   the trees bit by bit.
+ * - Each raw data block ends with the "ID_END" element so wrongly decoded codes lead to an exception or to further elements
+ *   being parsed.
+ * - The first scale factor band is 4 spectral lines wide so it is denoted by one quadruple or two pairs.
+ */
+void AacTests::testDecodingHuffmanCodes()
+{
+    using namespace AacTestHelper;
+    const auto sfCodes = scaleFactorCodes();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(121), sfCodes.size());
+    AacFrameElementParser parser(Mpeg4AudioObjectIds::AacLc, 4, 0xFF, 1);
+    for (const byte cb : { 3, 5, 7, 9 }) {
+        const auto codes = spectralCodes(cb);
+        CPPUNIT_ASSERT(!codes.empty());
+        for (size_t i = 0; i != max(codes.size(), sfCodes.size()); ++i) {
+            vector<const HuffmanCode *> blockCodes{ &codes[i % codes.size()] };
+            if (cb != 3) {
+                blockCodes.emplace_back(&codes[(i * 7 + 3) % codes.size()]);
+            }
+            const string block = makeRawDataBlock(cb, sfCodes[i % sfCodes.size()], blockCodes);
+            try {
+                parser.parse(block.data(), block.size());
+            } catch (const Failure &) {
+                CPPUNIT_FAIL(argsToString("unable to parse block ", i, " using codebook ", static_cast<unsigned int>(cb)));
+            } catch (const ios_base::failure &) {
+                CPPUNIT_FAIL(argsToString("block ", i, " using codebook ", static_cast<unsigned int>(cb), " is considered truncated"));
+            }
+        }
+    }
+    CPPUNIT_ASSERT(!parser.isSbrPresent());
+}
@@ -0,0 +1,189 @@
+#include "./helper.h"
+
+#include "../adts/adtsstream.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+using namespace ChronoUtilities;
+using namespace TestUtilities::Literals;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The AdtsTests class tests walking through the frames of generated ADTS streams.
+ */
+class AdtsTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(AdtsTests);
+    CPPUNIT_TEST(testWalkingFrames);
+    CPPUNIT_TEST(testProbingSbr);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testWalkingFrames();
+    void testProbingSbr();
+};
+
+/// \cond
+
+namespace AdtsTestHelper {
+
+/// \brief The size of the frames created via makeFrame().
+constexpr std::size_t frameSize = 200;
+
+/*!
+ * \brief Returns an ADTS frame of an AAC-LC stereo stream with 44.1 kHz without CRC.
+ * \remarks The raw data block consists only of the "ID_END" element.
+ */
+string makeFrame()
+{
+    string frame("\xFF\xF1\x50\x80\x00\x1F\xFC\xE0", 8);
+    frame[3] = static_cast<char>(frame[3] | ((frameSize >> 11) & 0x03));
+    frame[4] = static_cast<char>((frameSize >> 3) & 0xFF);
+    frame[5] = static_cast<char>(frame[5] | ((frameSize & 0x07) << 5));
+    return frame.append(frameSize - frame.size(), '\0');
+}
+
+/*!
+ * \brief Returns an ADTS frame of an AAC-LC mono stream with 22.05 kHz without CRC.
+ * \remarks
+ * - The raw data block consists of a "single channel element" without spectral data followed by the "ID_END" element.
+ * - If \a withSbr is true, the "single channel element" is followed by a "fill element" containing an SBR header. The
+ *   remaining SBR data is not valid and hence supposed to be skipped.
+ */
+string makeSbrFrame(bool withSbr)
+{
+    string bits;
+    const auto appendBits = [&bits](unsigned int value, unsigned int bitCount) {
+        while (bitCount) {
+            bits += (value >> --bitCount) & 0x1 ? '1' : '0';
+        }
+    };
+    appendBits(0, 3); // ID_SCE
+    appendBits(0, 4); // element instance tag
+    appendBits(100, 8); // global gain
+    appendBits(0, 11); // ics info: reserved bit, only long sequence, window shape, max SFB of 0, no predictor data
+    appendBits(0, 3); // no pulse data, TNS data and gain control data
+    if (withSbr) {
+        appendBits(6, 3); // ID_FIL
+        appendBits(4, 4); // count
+        appendBits(13, 4); // extension type EXT_SBR_DATA
+        appendBits(1, 1); // header flag
+        appendBits(0x5A, 15); // start/stop frequency, crossover band, reserved bits, no extra headers
+        appendBits(0xFFF, 12); // remaining data
+    }
+    appendBits(7, 3); // ID_END
+    bits.append((8 - bits.size() % 8) % 8, '0');
+
+    string frame("\xFF\xF1\x5C\x40\x00\x1F\xFC", 7);
+    for (size_t i = 0; i < bits.size(); i += 8) {
+        frame += static_cast<char>(stoul(bits.substr(i, 8), nullptr, 2));
+    }
+    frame[3] = static_cast<char>(frame[3] | ((frame.size() >> 11) & 0x03));
+    frame[4] = static_cast<char>((frame.size() >> 3) & 0xFF);
+    frame[5] = static_cast<char>(frame[5] | ((frame.size() & 0x07) << 5));
+    return frame;
+}
+
+} // namespace AdtsTestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AdtsTests);
+
+void AdtsTests::setUp()
+{
+}
+
+void AdtsTests::tearDown()
+{
+}
+
+/*!
+ * \brief Tests walking through the frames of a stream with garbage between the frames and a trailing ID3v1 tag.
+ */
+void AdtsTests::testWalkingFrames()
+{
+    using namespace AdtsTestHelper;
+    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+    for (auto i = 0; i != 50; ++i) {
+        stream << makeFrame();
+    }
+    // write garbage containing a valid frame header which is not followed by another frame header
+    const string garbage = "garbage..."s + makeFrame().substr(0, 7) + string(33, 'x');
+    stream << garbage;
+    for (auto i = 0; i != 50; ++i) {
+        stream << makeFrame();
+    }
+    // write ID3v1 tag which happens to contain a frame header
+    stream << "TAG"s << makeFrame().substr(0, 7) << string(118, '\0');
+
+    Diagnostics diag;
+    AdtsStream track(stream, 0);
+    track.setRecordingSeekIndex(true);
+    track.parseHeader(diag);
+    CPPUNIT_ASSERT_EQUAL(44100u, track.samplingFrequency());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint16>(2), track.channelCount());
+    for (const auto &message : diag) {
+        if (message.level() >= DiagLevel::Warning) {
+            CPPUNIT_ASSERT_EQUAL(argsToString(garbage.size(), " bytes between the frames could not be assigned to a valid frame."), message.message());
+        }
+    }
+
+    // check sample count and seek index (with a seek point for the frames containing the first sample of every second)
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(100 * 1024), track.sampleCount());
+    const auto &seekIndex = track.seekIndex();
+    CPPUNIT_ASSERT_EQUAL(3_st, seekIndex.size());
+    const std::size_t frameIndexes[] = { 0, 44, 87 };
+    for (std::size_t index = 0; index != 3; ++index) {
+        const auto frameIndex = frameIndexes[index];
+        CPPUNIT_ASSERT_EQUAL(TimeSpan::fromSeconds(static_cast<double>(frameIndex * 1024) / 44100), seekIndex[index].time);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(frameIndex * frameSize + (frameIndex >= 50 ? garbage.size() : 0)), seekIndex[index].offset);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(0), track.seekOffset(TimeSpan::fromSeconds(0.5)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(44 * frameSize), track.seekOffset(TimeSpan::fromSeconds(1.5)));
+}
+
+/*!
+ * \brief Tests detecting implicitly signaled SBR by parsing the first raw data blocks.
+ */
+void AdtsTests::testProbingSbr()
+{
+    using namespace AdtsTestHelper;
+    for (const bool withSbr : { false, true }) {
+        stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+        for (auto i = 0; i != 50; ++i) {
+            stream << makeSbrFrame(withSbr);
+        }
+
+        Diagnostics diag;
+        AdtsStream track(stream, 0);
+        track.parseHeader(diag);
+        for (const auto &message : diag) {
+            CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Information);
+        }
+        CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Aac, track.format().general);
+        CPPUNIT_ASSERT_EQUAL(22050u, track.samplingFrequency());
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint16>(1), track.channelCount());
+        if (withSbr) {
+            CPPUNIT_ASSERT_EQUAL(
+                static_cast<unsigned int>(ExtensionFormats::SpectralBandReplication), static_cast<unsigned int>(track.format().extension));
+            CPPUNIT_ASSERT_EQUAL(44100u, track.extensionSamplingFrequency());
+        } else {
+            CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(track.format().extension));
+            CPPUNIT_ASSERT_EQUAL(0u, track.extensionSamplingFrequency());
+        }
+    }
+}
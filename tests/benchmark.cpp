@@ -0,0 +1,160 @@
+#include "./helper.h"
+
+#include "../mediafileinfo.h"
+#include "../tag.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+
+using namespace CPPUNIT_NS;
+
+/// \cond
+
+namespace BenchmarkTestHelper {
+
+/// \brief Counts the invocations of the global operator new (see replacement below).
+atomic<size_t> allocationCount(0);
+
+} // namespace BenchmarkTestHelper
+
+/// \endcond
+
+void *operator new(size_t size)
+{
+    ++BenchmarkTestHelper::allocationCount;
+    if (void *const ptr = malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+/*!
+ * \brief The BenchmarkTests class measures parsing tags of the reference files.
+ * \remarks
+ * - The benchmark is only run if the environment variable TAG_PARSER_BENCHMARK is set because it takes considerably
+ *   longer than the other tests and its results depend on the system.
+ * - The results are only printed. Run the benchmark before and after a change to compare them.
+ */
+class BenchmarkTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(BenchmarkTests);
+    CPPUNIT_TEST(testParsingTags);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testParsingTags();
+};
+
+/// \cond
+
+namespace BenchmarkTestHelper {
+
+/*!
+ * \brief Returns a MP3 file with an ID3v2.3 tag containing 40 short "TXXX"-frames and some MPEG-1 layer 3 frames.
+ */
+string makeMp3FileWith40Fields()
+{
+    string frames;
+    char size[4];
+    for (unsigned int i = 0; i != 40; ++i) {
+        const string data = '\0' + ("field " + to_string(i)) + '\0' + ("value " + to_string(i));
+        BE::getBytes(static_cast<uint32>(data.size()), size);
+        frames += "TXXX" + string(size, sizeof(size)) + string(2, '\0') + data;
+    }
+    const auto tagSize = static_cast<uint32>(frames.size());
+    BE::getBytes(static_cast<uint32>((tagSize & 0x7F) | ((tagSize << 1) & 0x7F00) | ((tagSize << 2) & 0x7F0000)), size);
+    string file = string("ID3\x03\x00\x00", 6) + string(size, sizeof(size)) + frames;
+    for (unsigned int i = 0; i != 5; ++i) {
+        file += string("\xFF\xFB\x90\x00", 4) + string(413, '\0');
+    }
+    return file;
+}
+
+} // namespace BenchmarkTestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BenchmarkTests);
+
+void BenchmarkTests::setUp()
+{
+}
+
+void BenchmarkTests::tearDown()
+{
+}
+
+/*!
+ * \brief Parses the tags of the reference files (and of a generated file with 40 text fields) repeatedly and prints the
+ *        average time and number of allocations per file.
+ * \remarks Reference files which are not present are skipped.
+ */
+void BenchmarkTests::testParsingTags()
+{
+    using namespace BenchmarkTestHelper;
+    if (!getenv("TAG_PARSER_BENCHMARK")) {
+        return;
+    }
+
+    const string generatedPath = workingCopyPathMode("benchmark-40-fields.mp3", WorkingCopyMode::NoCopy);
+    ofstream(generatedPath, ios_base::out | ios_base::trunc | ios_base::binary) << makeMp3FileWith40Fields();
+    const string paths[] = {
+        generatedPath,
+        testFilePath("misc/multiple_id3v2_4_values.mp3"),
+        testFilePath("mtx-test-data/mp3/id3-tag-and-xing-header.mp3"),
+        testFilePath("flac/test.flac"),
+        testFilePath("mtx-test-data/mkv/tags.mkv"),
+        testFilePath("mtx-test-data/alac/othertest-itunes.m4a"),
+        testFilePath("mtx-test-data/mp4/10-DanseMacabreOp.40.m4a"),
+        testFilePath("mtx-test-data/ogg/qt4dance_medium.ogg"),
+    };
+    constexpr unsigned int iterations = 200;
+    cerr << "\n - parsing tags " << iterations << " times per file:" << endl;
+    for (const string &path : paths) {
+        if (!ifstream(path)) {
+            cerr << "   " << path << ": skipped (not present)" << endl;
+            continue;
+        }
+        size_t fieldCount = 0;
+        const size_t allocationsBefore = allocationCount;
+        const auto start = chrono::steady_clock::now();
+        for (unsigned int i = 0; i != iterations; ++i) {
+            Diagnostics diag;
+            MediaFileInfo file(path);
+            file.open(true);
+            file.parseContainerFormat(diag);
+            file.parseTags(diag);
+            fieldCount = 0;
+            for (const Tag *const tag : file.tags()) {
+                fieldCount += tag->fieldCount();
+            }
+        }
+        const auto duration = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        CPPUNIT_ASSERT(fieldCount);
+        cerr << "   " << path << ": " << fieldCount << " fields, " << duration / iterations << " us, "
+             << (allocationCount - allocationsBefore) / iterations << " allocations" << endl;
+    }
+    remove(generatedPath.data());
+}
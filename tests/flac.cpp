@@ -0,0 +1,444 @@
+#include "./helper.h"
+
+#include "../abstractattachment.h"
+#include "../flac/flacstream.h"
+#include "../mediafileinfo.h"
+#include "../progressfeedback.h"
+#include "../vorbis/vorbiscomment.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+using namespace ChronoUtilities;
+using namespace TestUtilities::Literals;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The FlacTests class tests specific features of the FLAC implementation with generated FLAC files.
+ * \remarks Parsing and making FLAC files in general is tested in OverallTests.
+ */
+class FlacTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(FlacTests);
+    CPPUNIT_TEST(testCopyingUnmodifiedPictures);
+    CPPUNIT_TEST(testMakingModifiedPictures);
+    CPPUNIT_TEST(testBuildingSeekTable);
+    CPPUNIT_TEST(testBuildingSeekTableWithGaps);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testCopyingUnmodifiedPictures();
+    void testMakingModifiedPictures();
+    void testBuildingSeekTable();
+    void testBuildingSeekTableWithGaps();
+};
+
+/// \cond
+
+namespace FlacTestHelper {
+
+/*!
+ * \brief Returns a "METADATA_BLOCK_HEADER" followed by the specified \a data.
+ */
+string makeBlock(byte type, const string &data, bool isLast = false)
+{
+    char header[4];
+    BE::getBytes(static_cast<uint32>(data.size()), header);
+    header[0] = static_cast<char>(type | (isLast ? 0x80 : 0x00));
+    return string(header, sizeof(header)) + data;
+}
+
+/*!
+ * \brief Returns a "METADATA_BLOCK_STREAMINFO" for a 44.1 kHz stereo stream with 16 bit per sample.
+ */
+string makeStreamInfo(uint16 blockSize, uint32 maxFrameSize, uint64 sampleCount)
+{
+    char data[0x22] = {};
+    BE::getBytes(blockSize, data);
+    BE::getBytes(blockSize, data + 2);
+    BE::getBytes(maxFrameSize & 0xFFFFFF, data + 6); // the minimum frame size (preceding the maximum frame size) is left zero
+    BE::getBytes(static_cast<uint64>(44100) << 44 | static_cast<uint64>(1) << 41 | static_cast<uint64>(15) << 36 | sampleCount, data + 10);
+    return makeBlock(0, string(data, sizeof(data)));
+}
+
+/*!
+ * \brief Returns a "METADATA_BLOCK_VORBIS_COMMENT" containing only a title.
+ */
+string makeVorbisComment(const string &title)
+{
+    char size[4];
+    string data;
+    LE::getBytes(static_cast<uint32>(6), size);
+    data.append(size, sizeof(size)).append("vendor");
+    LE::getBytes(static_cast<uint32>(1), size);
+    data.append(size, sizeof(size));
+    LE::getBytes(static_cast<uint32>(6 + title.size()), size);
+    data.append(size, sizeof(size)).append("TITLE=").append(title);
+    return makeBlock(4, data);
+}
+
+/*!
+ * \brief Returns the data of a "METADATA_BLOCK_PICTURE" with the specified dimensions.
+ */
+string makePictureData(const string &description, uint32 width, uint32 height, uint32 colorDepth, const string &picture)
+{
+    char value[4];
+    string data;
+    const auto append = [&data, &value](uint32 number) {
+        BE::getBytes(number, value);
+        data.append(value, sizeof(value));
+    };
+    append(3);
+    append(9);
+    data.append("image/png");
+    append(static_cast<uint32>(description.size()));
+    data.append(description);
+    append(width);
+    append(height);
+    append(colorDepth);
+    append(0);
+    append(static_cast<uint32>(picture.size()));
+    data.append(picture);
+    return data;
+}
+
+/*!
+ * \brief Returns the CRC-8 (polynomial x^8 + x^2 + x^1 + x^0) of the specified \a data.
+ */
+byte crc8(const string &data)
+{
+    byte crc = 0;
+    for (const char c : data) {
+        crc ^= static_cast<byte>(c);
+        for (byte bit = 0; bit != 8; ++bit) {
+            crc = static_cast<byte>(crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Returns the CRC-16 (polynomial x^16 + x^15 + x^2 + x^0) of the specified \a data.
+ */
+uint16 crc16(const string &data)
+{
+    uint16 crc = 0;
+    for (const char c : data) {
+        crc ^= static_cast<uint16>(static_cast<byte>(c) << 8);
+        for (byte bit = 0; bit != 8; ++bit) {
+            crc = static_cast<uint16>(crc & 0x8000 ? (crc << 1) ^ 0x8005 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Returns a FLAC frame of a 44.1 kHz stereo stream with 16 bit per sample and a fixed block size.
+ *
+ * Both channels are encoded as "SUBFRAME_CONSTANT" with the specified \a value. The default value contains a sync code so
+ * the frame data contains a sync code as well.
+ */
+string makeFrame(uint32 frameNumber, uint32 blockSize, uint16 value = 0xFFF8)
+{
+    string frame("\xFF\xF8", 2);
+    frame += static_cast<char>((blockSize == 4096 ? 0xC0 : 0x70) | 0x09);
+    frame += static_cast<char>(0x18);
+    // encode frame number like UTF-8
+    if (frameNumber < 0x80) {
+        frame += static_cast<char>(frameNumber);
+    } else {
+        CPPUNIT_ASSERT(frameNumber < 0x800);
+        frame += static_cast<char>(0xC0 | (frameNumber >> 6));
+        frame += static_cast<char>(0x80 | (frameNumber & 0x3F));
+    }
+    char buffer[2];
+    if (blockSize != 4096) {
+        BE::getBytes(static_cast<uint16>(blockSize - 1), buffer);
+        frame.append(buffer, sizeof(buffer));
+    }
+    frame += static_cast<char>(crc8(frame));
+    BE::getBytes(value, buffer);
+    for (auto channel = 0; channel != 2; ++channel) {
+        frame += '\0';
+        frame.append(buffer, sizeof(buffer));
+    }
+    BE::getBytes(crc16(frame), buffer);
+    return frame.append(buffer, sizeof(buffer));
+}
+
+/*!
+ * \brief Returns the signature, "METADATA_BLOCK_STREAMINFO" and "METADATA_BLOCK_PADDING" of a FLAC file with
+ *        the frames created via makeFrame().
+ */
+string makeHeaderForFrames(uint32 maxFrameSize)
+{
+    return "fLaC"s + makeStreamInfo(4096, maxFrameSize, 0) + makeBlock(1, string(1024, '\0'), true);
+}
+
+/*!
+ * \brief Returns a FLAC file with two pictures of the specified \a pictureData followed by some bytes representing the
+ *        actual stream.
+ */
+string makeFileWithPictures(const string &pictureData1, const string &pictureData2)
+{
+    return "fLaC"s + makeStreamInfo(4096, 0, 0) + makeVorbisComment("Title") + makeBlock(6, pictureData1) + makeBlock(6, pictureData2)
+        + makeBlock(1, string(16, '\0'), true) + "\xFF\xF8"s + string(64, '\0');
+}
+
+/*!
+ * \brief Returns whether \a fileData contains a "METADATA_BLOCK_PICTURE" with the specified \a pictureData.
+ * \remarks The "last metadata block" flag is not taken into account.
+ */
+bool containsPictureBlock(const string &fileData, const string &pictureData)
+{
+    const auto pos = fileData.find(makeBlock(6, pictureData).substr(1));
+    return pos != string::npos && pos && (fileData[pos - 1] & 0x7F) == 6;
+}
+
+/*!
+ * \brief Returns the contents of the file at the specified \a path.
+ */
+string readFile(const string &path)
+{
+    stringstream buffer;
+    buffer << ifstream(path, ios_base::in | ios_base::binary).rdbuf();
+    return buffer.str();
+}
+
+} // namespace FlacTestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FlacTests);
+
+void FlacTests::setUp()
+{
+}
+
+void FlacTests::tearDown()
+{
+}
+
+/*!
+ * \brief Tests whether pictures which have not been modified are copied as-is (preserving eg. their dimensions) when the
+ *        picture data is referenced.
+ */
+void FlacTests::testCopyingUnmodifiedPictures()
+{
+    using namespace FlacTestHelper;
+    const string path = workingCopyPathMode("flac-unmodified-pictures.flac", WorkingCopyMode::NoCopy);
+    const string pictureData1 = makePictureData("front", 640, 480, 24, string(1000, 'a'));
+    const string pictureData2 = makePictureData("back", 320, 240, 24, string(2000, 'b'));
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeFileWithPictures(pictureData1, pictureData2);
+
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(path);
+    file.setReferencingPictureData(true);
+    file.open();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Flac, file.containerFormat());
+    VorbisComment *const vorbisComment = static_cast<FlacStream *>(file.tracks().front())->vorbisComment();
+    CPPUNIT_ASSERT(vorbisComment);
+    const auto covers = vorbisComment->values(KnownField::Cover);
+    CPPUNIT_ASSERT_EQUAL(2_st, covers.size());
+    CPPUNIT_ASSERT_MESSAGE("picture data referenced", covers.front()->dataBlock() && covers.back()->dataBlock());
+    CPPUNIT_ASSERT_EQUAL("front"s, covers.front()->description());
+    CPPUNIT_ASSERT_EQUAL(1000_st, covers.front()->dataSize());
+
+    // modify only the title so the pictures are copied
+    vorbisComment->setValue(KnownField::Title, TagValue("New title"s));
+    file.applyChanges(diag, progress);
+    const string newData = readFile(path);
+    CPPUNIT_ASSERT_MESSAGE("first picture copied as-is", containsPictureBlock(newData, pictureData1));
+    CPPUNIT_ASSERT_MESSAGE("second picture copied as-is", containsPictureBlock(newData, pictureData2));
+    CPPUNIT_ASSERT_EQUAL("\xFF\xF8"s + string(64, '\0'), newData.substr(newData.size() - 66));
+
+    // check whether the file can be parsed again (this time reading the pictures)
+    file.setReferencingPictureData(false);
+    diag.clear();
+    file.parseEverything(diag);
+    VorbisComment *const newVorbisComment = static_cast<FlacStream *>(file.tracks().front())->vorbisComment();
+    CPPUNIT_ASSERT(newVorbisComment);
+    CPPUNIT_ASSERT_EQUAL("New title"s, newVorbisComment->value(KnownField::Title).toString());
+    const auto newCovers = newVorbisComment->values(KnownField::Cover);
+    CPPUNIT_ASSERT_EQUAL(2_st, newCovers.size());
+    CPPUNIT_ASSERT(!newCovers.front()->dataBlock());
+    CPPUNIT_ASSERT_EQUAL(string(1000, 'a'), string(newCovers.front()->dataPointer(), newCovers.front()->dataSize()));
+    CPPUNIT_ASSERT_EQUAL(string(2000, 'b'), string(newCovers.back()->dataPointer(), newCovers.back()->dataSize()));
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Critical);
+    }
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests whether pictures which have been modified are made from scratch.
+ */
+void FlacTests::testMakingModifiedPictures()
+{
+    using namespace FlacTestHelper;
+    const string path = workingCopyPathMode("flac-modified-pictures.flac", WorkingCopyMode::NoCopy);
+    const string pictureData1 = makePictureData("front", 640, 480, 24, string(1000, 'a'));
+    const string pictureData2 = makePictureData("back", 320, 240, 24, string(2000, 'b'));
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeFileWithPictures(pictureData1, pictureData2);
+
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(path);
+    file.setReferencingPictureData(true);
+    file.open();
+    file.parseEverything(diag);
+    VorbisComment *const vorbisComment = static_cast<FlacStream *>(file.tracks().front())->vorbisComment();
+    CPPUNIT_ASSERT(vorbisComment);
+
+    // modify the description of the first picture and the data of the second picture
+    auto &fields = vorbisComment->fields();
+    auto covers = fields.equal_range(vorbisComment->fieldId(KnownField::Cover));
+    CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(covers.second - covers.first));
+    covers.first->second.value().setDescription("modified");
+    (covers.first + 1)->second.value().assignData("new picture", 11, TagDataType::Picture);
+    (covers.first + 1)->second.value().setMimeType("image/png");
+    file.applyChanges(diag, progress);
+
+    // the modified pictures have been made from scratch (which does not preserve the dimensions)
+    const string newData = readFile(path);
+    CPPUNIT_ASSERT(!containsPictureBlock(newData, pictureData1));
+    CPPUNIT_ASSERT(!containsPictureBlock(newData, pictureData2));
+    CPPUNIT_ASSERT(containsPictureBlock(newData, makePictureData("modified", 0, 0, 0, string(1000, 'a'))));
+    CPPUNIT_ASSERT(containsPictureBlock(newData, makePictureData("back", 0, 0, 0, "new picture")));
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Critical);
+    }
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests building the seek table of a FLAC file by scanning its frames.
+ */
+void FlacTests::testBuildingSeekTable()
+{
+    using namespace FlacTestHelper;
+    const string path = workingCopyPathMode("flac-seek-table.flac", WorkingCopyMode::NoCopy);
+    const string header = makeHeaderForFrames(0);
+    string fileData = header;
+    for (uint32 frameNumber = 0; frameNumber != 10; ++frameNumber) {
+        fileData += makeFrame(frameNumber, 4096);
+    }
+    fileData += makeFrame(10, 1000);
+    // append frame with a block size of 65536 which is not allowed (and would wrap when stored within the seek point)
+    fileData += makeFrame(11, 65536);
+    // append ID3v1 tag which happens to contain a valid frame header
+    const string id3v1Tag = "TAG"s + makeFrame(12, 4096);
+    fileData += id3v1Tag + string(128 - id3v1Tag.size(), '\0');
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << fileData;
+
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(path);
+    file.open();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Flac, file.containerFormat());
+    auto *flacStream = static_cast<FlacStream *>(file.tracks().front());
+    CPPUNIT_ASSERT(flacStream->seekTable().empty());
+    flacStream->buildSeekTable(TimeSpan::fromSeconds(0.05), diag);
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Warning);
+    }
+
+    // check whether there is one seek point per frame (as the spacing is smaller than the block size)
+    const auto checkSeekTable = [](const vector<FlacSeekPoint> &seekTable) {
+        CPPUNIT_ASSERT_EQUAL(11_st, seekTable.size());
+        for (uint32 frameNumber = 0; frameNumber != 11; ++frameNumber) {
+            const auto &seekPoint = seekTable[frameNumber];
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(frameNumber * 4096), seekPoint.sampleNumber);
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(frameNumber * makeFrame(0, 4096).size()), seekPoint.offset);
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint16>(frameNumber != 10 ? 4096 : 1000), seekPoint.sampleCount);
+        }
+    };
+    checkSeekTable(flacStream->seekTable());
+
+    // check whether the seek table has been written into the padding
+    file.setForceRewrite(false);
+    file.setMaxPadding(1024);
+    file.applyChanges(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(fileData.size()), file.size());
+    diag.clear();
+    file.parseEverything(diag);
+    flacStream = static_cast<FlacStream *>(file.tracks().front());
+    checkSeekTable(flacStream->seekTable());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32>(4 + 1024 - (4 + 11 * FlacSeekPoint::size)), flacStream->paddingSize());
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Critical);
+    }
+    file.close();
+    const auto framesSize = fileData.size() - header.size() - 128;
+    CPPUNIT_ASSERT_EQUAL(fileData.substr(header.size(), framesSize), readFile(path).substr(header.size(), framesSize));
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests building the seek table of a FLAC file with missing frames and a first frame not starting at sample zero.
+ */
+void FlacTests::testBuildingSeekTableWithGaps()
+{
+    using namespace FlacTestHelper;
+    const string path = workingCopyPathMode("flac-seek-table-with-gaps.flac", WorkingCopyMode::NoCopy);
+    const auto frameSize = static_cast<uint32>(makeFrame(0, 4096).size());
+    // run the test with and without the maximum frame size being known
+    for (const uint32 maxFrameSize : { 0u, frameSize }) {
+        string fileData = makeHeaderForFrames(maxFrameSize);
+        for (uint32 frameNumber = 5; frameNumber != 10; ++frameNumber) {
+            fileData += makeFrame(frameNumber, 4096);
+        }
+        // replace frames 10 to 12 with garbage containing sync codes
+        for (auto i = 0; i != 10; ++i) {
+            fileData += "\xFF\xF8\x00\x12\x34\x56\x78\x9A\xBC\xDE"s;
+        }
+        for (uint32 frameNumber = 13; frameNumber != 20; ++frameNumber) {
+            fileData += makeFrame(frameNumber, 4096);
+        }
+        ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << fileData;
+
+        Diagnostics diag;
+        MediaFileInfo file(path);
+        file.open();
+        file.parseEverything(diag);
+        auto *const flacStream = static_cast<FlacStream *>(file.tracks().front());
+        diag.clear();
+        flacStream->buildSeekTable(TimeSpan::fromSeconds(0.05), diag);
+        CPPUNIT_ASSERT_EQUAL(1_st, diag.size());
+        CPPUNIT_ASSERT_EQUAL(DiagLevel::Warning, diag.front().level());
+        CPPUNIT_ASSERT_EQUAL("Frames are missing or corrupted at 1 locations."s, diag.front().message());
+
+        const auto &seekTable = flacStream->seekTable();
+        CPPUNIT_ASSERT_EQUAL(12_st, seekTable.size());
+        for (uint32 frameNumber = 5, index = 0; frameNumber != 20; ++frameNumber) {
+            if (frameNumber >= 10 && frameNumber <= 12) {
+                continue;
+            }
+            const auto &seekPoint = seekTable[index++];
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(frameNumber * 4096), seekPoint.sampleNumber);
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint64>((frameNumber - 5) * frameSize - (frameNumber > 12 ? 3 * frameSize - 100 : 0)),
+                seekPoint.offset);
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint16>(4096), seekPoint.sampleCount);
+        }
+        file.close();
+    }
+    remove(path.data());
+}
@@ -0,0 +1,326 @@
+#include "./helper.h"
+
+#include "../id3/id3v1tag.h"
+#include "../id3/id3v2frameids.h"
+#include "../id3/id3v2tag.h"
+#include "../mediafileinfo.h"
+#include "../progressfeedback.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+using namespace TestUtilities::Literals;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The Id3Tests class tests making ID3v2 tags whose frames are copied as-is from the original file.
+ * \remarks Parsing and making ID3 tags in general is tested in OverallTests.
+ */
+class Id3Tests : public TestFixture {
+    CPPUNIT_TEST_SUITE(Id3Tests);
+    CPPUNIT_TEST(testCopyingUnmodifiedFramesInPlace);
+    CPPUNIT_TEST(testCopyingUnmodifiedFramesWhenRewriting);
+    CPPUNIT_TEST(testCopyingPendingFramesInPlace);
+    CPPUNIT_TEST(testCopyingPendingFramesWhenRewriting);
+    CPPUNIT_TEST(testDecodingPendingFrames);
+    CPPUNIT_TEST(testOrderOfPendingFrames);
+    CPPUNIT_TEST(testTransferringPendingFrames);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testCopyingUnmodifiedFramesInPlace();
+    void testCopyingUnmodifiedFramesWhenRewriting();
+    void testCopyingPendingFramesInPlace();
+    void testCopyingPendingFramesWhenRewriting();
+    void testDecodingPendingFrames();
+    void testOrderOfPendingFrames();
+    void testTransferringPendingFrames();
+
+private:
+    void testRoundTrip(const char *fileName, bool parsingLazily, bool forcingRewrite);
+};
+
+/// \cond
+
+namespace Id3TestHelper {
+
+/*!
+ * \brief Returns an ID3v2.4 frame with the specified \a id and \a data.
+ */
+string makeFrame(const char *id, const string &data)
+{
+    char size[4];
+    BE::getBytes(static_cast<uint32>((data.size() & 0x7F) | ((data.size() << 1) & 0x7F00) | ((data.size() << 2) & 0x7F0000)), size);
+    return string(id, 4) + string(size, sizeof(size)) + string(2, '\0') + data;
+}
+
+/*!
+ * \brief Returns frames in the order they are made (the artist would not be made the same way due to its terminator).
+ */
+const string &unmodifiedFrames()
+{
+    static const string frames = makeFrame("TALB", "\x03"
+                                                   "Album"s)
+        + makeFrame("TPE1", "\x03"
+                            "Artist\0"s)
+        + makeFrame("PRIV", "owner\0private data"s);
+    return frames;
+}
+
+/*!
+ * \brief Returns a MP3 file with an ID3v2.4 tag (the title frame being the last frame followed by 32 KiB padding) and some
+ *        MPEG-1 layer 3 frames.
+ */
+string makeMp3File()
+{
+    const string frames = unmodifiedFrames() + makeFrame("TIT2", "\x03Title");
+    const auto tagSize = static_cast<uint32>(frames.size() + 0x8000);
+    char size[4];
+    BE::getBytes(static_cast<uint32>((tagSize & 0x7F) | ((tagSize << 1) & 0x7F00) | ((tagSize << 2) & 0x7F0000)), size);
+    string file = "ID3\x04\x00\x00"s + string(size, sizeof(size)) + frames + string(0x8000, '\0');
+    for (unsigned int i = 0; i != 5; ++i) {
+        file += "\xFF\xFB\x90\x00"s + string(413, '\0');
+    }
+    return file;
+}
+
+} // namespace Id3TestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(Id3Tests);
+
+void Id3Tests::setUp()
+{
+}
+
+void Id3Tests::tearDown()
+{
+}
+
+/*!
+ * \brief Changes the title of a generated MP3 file and checks whether the other frames have been copied as-is.
+ */
+void Id3Tests::testRoundTrip(const char *fileName, bool parsingLazily, bool forcingRewrite)
+{
+    using namespace Id3TestHelper;
+    const string path = workingCopyPathMode(fileName, WorkingCopyMode::NoCopy);
+    const string originalData = makeMp3File();
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << originalData;
+
+    // change the title to a much longer one, so the other frames are moved behind their original location and their
+    // original location has already been overwritten when updating the file in-place
+    const string newTitle(0x4000, 'x');
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(path);
+    file.setParsingId3v2TagsLazily(parsingLazily);
+    file.open();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(1_st, file.id3v2Tags().size());
+    Id3v2Tag &tag = *file.id3v2Tags().front();
+    CPPUNIT_ASSERT_EQUAL(parsingLazily ? 4_st : 0_st, tag.pendingFrames().size());
+    CPPUNIT_ASSERT_EQUAL(parsingLazily ? 0u : 4u, tag.fieldCount());
+    CPPUNIT_ASSERT_EQUAL(parsingLazily ? ""s : "Title"s, tag.value(KnownField::Title).toString());
+    tag.setValue(KnownField::Title, TagValue(newTitle));
+    CPPUNIT_ASSERT_EQUAL(parsingLazily ? 3_st : 0_st, tag.pendingFrames().size());
+    file.setForceRewrite(forcingRewrite);
+    file.setMaxPadding(0x8000);
+    file.applyChanges(diag, progress);
+    if (!forcingRewrite) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("file not rewritten", static_cast<uint64>(originalData.size()), file.size());
+    }
+
+    // check whether the unmodified frames have been copied as-is and whether the MPEG frames are still intact
+    stringstream buffer;
+    buffer << ifstream(path, ios_base::in | ios_base::binary).rdbuf();
+    const string newData = buffer.str();
+    CPPUNIT_ASSERT_EQUAL("TIT2"s, newData.substr(10, 4));
+    CPPUNIT_ASSERT_MESSAGE("unmodified frames copied as-is", newData.find(unmodifiedFrames()) != string::npos);
+    CPPUNIT_ASSERT_EQUAL(originalData.substr(originalData.size() - 5 * 417), newData.substr(newData.size() - 5 * 417));
+
+    // check whether the tag can be parsed again
+    file.setParsingId3v2TagsLazily(false);
+    diag.clear();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(1_st, file.id3v2Tags().size());
+    const Id3v2Tag &newTag = *file.id3v2Tags().front();
+    CPPUNIT_ASSERT_EQUAL(4u, newTag.fieldCount());
+    CPPUNIT_ASSERT_EQUAL(newTitle, newTag.value(KnownField::Title).toString());
+    CPPUNIT_ASSERT_EQUAL("Artist"s, newTag.value(KnownField::Artist).toString());
+    CPPUNIT_ASSERT_EQUAL("Album"s, newTag.value(KnownField::Album).toString());
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Critical);
+    }
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests copying frames which have been decoded but not modified when updating the file in-place.
+ */
+void Id3Tests::testCopyingUnmodifiedFramesInPlace()
+{
+    testRoundTrip("id3-unmodified-in-place.mp3", false, false);
+}
+
+/*!
+ * \brief Tests copying frames which have been decoded but not modified when rewriting the file.
+ */
+void Id3Tests::testCopyingUnmodifiedFramesWhenRewriting()
+{
+    testRoundTrip("id3-unmodified-rewrite.mp3", false, true);
+}
+
+/*!
+ * \brief Tests copying frames which have not been decoded (when parsing lazily) when updating the file in-place.
+ */
+void Id3Tests::testCopyingPendingFramesInPlace()
+{
+    testRoundTrip("id3-pending-in-place.mp3", true, false);
+}
+
+/*!
+ * \brief Tests copying frames which have not been decoded (when parsing lazily) when rewriting the file.
+ */
+void Id3Tests::testCopyingPendingFramesWhenRewriting()
+{
+    testRoundTrip("id3-pending-rewrite.mp3", true, true);
+}
+
+/*!
+ * \brief Tests accessing values of a tag which has been parsed lazily.
+ */
+void Id3Tests::testDecodingPendingFrames()
+{
+    using namespace Id3TestHelper;
+    const string path = workingCopyPathMode("id3-decoding.mp3", WorkingCopyMode::NoCopy);
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeMp3File();
+
+    Diagnostics diag;
+    MediaFileInfo file(path);
+    file.setParsingId3v2TagsLazily(true);
+    file.open(true);
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(1_st, file.id3v2Tags().size());
+    Id3v2Tag &tag = *file.id3v2Tags().front();
+
+    // accessing values does not decode frames and pending frames are not visible via the Tag API
+    CPPUNIT_ASSERT_EQUAL(4_st, tag.pendingFrames().size());
+    CPPUNIT_ASSERT_EQUAL(0_st, tag.fields().size());
+    CPPUNIT_ASSERT_EQUAL(0u, tag.fieldCount());
+    CPPUNIT_ASSERT(tag.value(KnownField::Title).isEmpty());
+    CPPUNIT_ASSERT(!tag.hasField(KnownField::Title));
+
+    // decoding only the frames with a certain ID
+    tag.decodeFrames(Id3v2FrameIds::lTitle, diag);
+    CPPUNIT_ASSERT_EQUAL(3_st, tag.pendingFrames().size());
+    CPPUNIT_ASSERT_EQUAL(1u, tag.fieldCount());
+    CPPUNIT_ASSERT(tag.hasField(KnownField::Title));
+    const TagValue &title = tag.value(KnownField::Title);
+    CPPUNIT_ASSERT_EQUAL("Title"s, title.toString());
+    CPPUNIT_ASSERT(tag.value(KnownField::Artist).isEmpty());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("const getters do not invalidate references", "Title"s, title.toString());
+    CPPUNIT_ASSERT_EQUAL(1_st, tag.fields().size());
+
+    // setting a value replaces pending frames with the same ID
+    tag.setValue(KnownField::Artist, TagValue("Other artist"s));
+    CPPUNIT_ASSERT_EQUAL(2_st, tag.pendingFrames().size());
+    CPPUNIT_ASSERT_EQUAL(2u, tag.fieldCount());
+    CPPUNIT_ASSERT_EQUAL("Other artist"s, tag.value(KnownField::Artist).toString());
+    tag.setValue(KnownField::Album, TagValue());
+    CPPUNIT_ASSERT_EQUAL(1_st, tag.pendingFrames().size());
+    CPPUNIT_ASSERT_EQUAL(2u, tag.fieldCount());
+    CPPUNIT_ASSERT(!tag.hasField(KnownField::Album));
+
+    // decoding the remaining frames
+    tag.decodeFrames(diag);
+    CPPUNIT_ASSERT(tag.pendingFrames().empty());
+    CPPUNIT_ASSERT_EQUAL(3_st, tag.fields().size());
+    CPPUNIT_ASSERT_EQUAL(3u, tag.fieldCount());
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Warning);
+    }
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests whether frames which have not been decoded are made at the position they would have when being decoded.
+ */
+void Id3Tests::testOrderOfPendingFrames()
+{
+    using namespace Id3TestHelper;
+    const string path = workingCopyPathMode("id3-order.mp3", WorkingCopyMode::NoCopy);
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeMp3File();
+
+    Diagnostics diag;
+    MediaFileInfo file(path);
+    file.setParsingId3v2TagsLazily(true);
+    file.open(true);
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(1_st, file.id3v2Tags().size());
+    Id3v2Tag &tag = *file.id3v2Tags().front();
+    tag.setValue(KnownField::Title, TagValue("New title"s));
+    tag.setValue(KnownField::Bpm, TagValue("120"s));
+    stringstream made;
+    tag.make(made, 0, diag);
+
+    // expected order: title first, then other text frames ordered by ID, then other frames
+    const string data = made.str();
+    const char *const ids[] = { "TIT2", "TALB", "TBPM", "TPE1", "PRIV" };
+    string::size_type previousPos = 0;
+    for (const char *const id : ids) {
+        const auto pos = data.find(id);
+        CPPUNIT_ASSERT_MESSAGE(id, pos != string::npos && pos > previousPos);
+        previousPos = pos;
+    }
+    CPPUNIT_ASSERT_MESSAGE("pending frames copied as-is", data.find(unmodifiedFrames().substr(0, unmodifiedFrames().find("TPE1"))) != string::npos);
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests whether values of frames which have not been decoded are transferred when creating an ID3v1 tag.
+ */
+void Id3Tests::testTransferringPendingFrames()
+{
+    using namespace Id3TestHelper;
+    const string path = workingCopyPathMode("id3-transfer.mp3", WorkingCopyMode::NoCopy);
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeMp3File();
+
+    Diagnostics diag;
+    MediaFileInfo file(path);
+    file.setParsingId3v2TagsLazily(true);
+    file.open(true);
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(1_st, file.id3v2Tags().size());
+    CPPUNIT_ASSERT_EQUAL(4_st, file.id3v2Tags().front()->pendingFrames().size());
+    TagCreationSettings settings;
+    settings.id3v1usage = TagUsage::Always;
+    settings.flags += TagCreationFlags::Id3InitOnCreate;
+    CPPUNIT_ASSERT(file.createAppropriateTags(settings));
+    CPPUNIT_ASSERT(file.id3v1Tag());
+    CPPUNIT_ASSERT_EQUAL("Title"s, file.id3v1Tag()->value(KnownField::Title).toString());
+    CPPUNIT_ASSERT_EQUAL("Artist"s, file.id3v1Tag()->value(KnownField::Artist).toString());
+    CPPUNIT_ASSERT_EQUAL("Album"s, file.id3v1Tag()->value(KnownField::Album).toString());
+    const Id3v2Tag &tag = *file.id3v2Tags().front();
+    CPPUNIT_ASSERT(tag.pendingFrames().empty());
+    CPPUNIT_ASSERT_EQUAL(4u, tag.fieldCount());
+    file.close();
+    remove(path.data());
+}
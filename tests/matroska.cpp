@@ -0,0 +1,802 @@
+#include "./helper.h"
+
+#include "../abstractattachment.h"
+#include "../matroska/ebmlelement.h"
+#include "../matroska/matroskaclusterscanner.h"
+#include "../matroska/matroskacontainer.h"
+#include "../matroska/matroskaid.h"
+#include "../matroska/matroskatrack.h"
+#include "../mediafileinfo.h"
+#include "../mediaformat.h"
+#include "../progressfeedback.h"
+#include "../tag.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+using namespace TestUtilities::Literals;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The MatroskaTests class tests Matroska-specific helpers which can be tested without test files.
+ * \remarks Parsing and making Matroska files is tested in OverallTests.
+ */
+class MatroskaTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(MatroskaTests);
+    CPPUNIT_TEST(testCodecIdToMediaFormat);
+    CPPUNIT_TEST(testUpdatingClusterPositions);
+    CPPUNIT_TEST(testScanningClustersConcurrently);
+    CPPUNIT_TEST(testReadingTrackStatisticsFromBlocks);
+    CPPUNIT_TEST(testValidatingChecksums);
+    CPPUNIT_TEST(testParsingSegmentsLazily);
+    CPPUNIT_TEST(testCopyingAttachments);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testCodecIdToMediaFormat();
+    void testUpdatingClusterPositions();
+    void testScanningClustersConcurrently();
+    void testReadingTrackStatisticsFromBlocks();
+    void testValidatingChecksums();
+    void testParsingSegmentsLazily();
+    void testCopyingAttachments();
+};
+
+/// \cond
+
+namespace MatroskaTestHelper {
+
+/*!
+ * \brief Returns an EBML element with the specified \a id and \a data.
+ */
+string makeElement(EbmlElement::IdentifierType id, const string &data)
+{
+    char buff[8];
+    string element(buff, EbmlElement::makeId(id, buff));
+    element.append(buff, EbmlElement::makeSizeDenotation(data.size(), buff));
+    return element += data;
+}
+
+/*!
+ * \brief Returns an EBML element with the specified \a id holding the specified unsigned integer \a value.
+ */
+string makeUIntegerElement(EbmlElement::IdentifierType id, uint64 value, byte minBytes = 1)
+{
+    char buff[8];
+    return makeElement(id, string(buff, EbmlElement::makeUInteger(value, buff, minBytes)));
+}
+
+/*!
+ * \brief Returns a "CRC-32"-element for the specified \a data.
+ */
+string makeCrc32Element(const string &data)
+{
+    char buff[4];
+    LE::getBytes(static_cast<uint32>(crc32(0, reinterpret_cast<const Bytef *>(data.data()), static_cast<uInt>(data.size()))), buff);
+    return makeElement(EbmlIds::Crc32, string(buff, sizeof(buff)));
+}
+
+/*!
+ * \brief Returns a "Cluster"-element whose "Position"-element is not its first child.
+ * \remarks The "Position"-element has a bogus value which is supposed to be updated when applying changes.
+ */
+string makeCluster(uint64 timecode, bool withCrc32)
+{
+    const string children = makeUIntegerElement(MatroskaIds::Timecode, timecode) + makeUIntegerElement(MatroskaIds::Position, 0, 4)
+        + makeElement(MatroskaIds::SimpleBlock, "\x81\x00\x00\x80 frame data"s);
+    return makeElement(MatroskaIds::Cluster, withCrc32 ? makeCrc32Element(children) + children : children);
+}
+
+/*!
+ * \brief Returns the "EBML"-element and the "Info"- and "Tracks"-elements of the segment of the generated test files.
+ * \remarks
+ * - The "DefaultDuration"-element of the track is only present if \a defaultDuration is not 0.
+ * - The "Info"-element has a "CRC-32"-element if \a infoWithCrc32 is true.
+ */
+pair<string, string> makeHeaderElements(uint64 defaultDuration = 0, bool infoWithCrc32 = false)
+{
+    const string ebmlHeader = makeElement(EbmlIds::Header,
+        makeUIntegerElement(EbmlIds::Version, 1) + makeUIntegerElement(EbmlIds::ReadVersion, 1) + makeUIntegerElement(EbmlIds::MaxIdLength, 4)
+            + makeUIntegerElement(EbmlIds::MaxSizeLength, 8) + makeElement(EbmlIds::DocType, "matroska")
+            + makeUIntegerElement(EbmlIds::DocTypeVersion, 4) + makeUIntegerElement(EbmlIds::DocTypeReadVersion, 2));
+    const string infoChildren = makeUIntegerElement(MatroskaIds::TimeCodeScale, 1000000) + makeElement(MatroskaIds::MuxingApp, "test")
+        + makeElement(MatroskaIds::WrittingApp, "test");
+    const string info = makeElement(MatroskaIds::SegmentInfo, infoWithCrc32 ? makeCrc32Element(infoChildren) + infoChildren : infoChildren);
+    const string tracks = makeElement(MatroskaIds::Tracks,
+        makeElement(MatroskaIds::TrackEntry,
+            makeUIntegerElement(MatroskaIds::TrackNumber, 1) + makeUIntegerElement(MatroskaIds::TrackUID, 1234)
+                + makeUIntegerElement(MatroskaIds::TrackType, 2) + makeElement(MatroskaIds::CodecID, "A_PCM/INT/LIT")
+                + (defaultDuration ? makeUIntegerElement(MatroskaIds::DefaultDuration, defaultDuration) : string())));
+    return make_pair(ebmlHeader, info + tracks);
+}
+
+/*!
+ * \brief Returns a minimal Matroska file with padding before two clusters (the first with "CRC-32"-element, the second without).
+ */
+string makeFileWithClusters()
+{
+    const auto headerElements = makeHeaderElements();
+    const string padding = makeElement(EbmlIds::Void, string(2048, '\0'));
+    return headerElements.first
+        + makeElement(MatroskaIds::Segment, headerElements.second + padding + makeCluster(0, true) + makeCluster(1000, false));
+}
+
+/*!
+ * \brief Returns a Matroska file with "Cues"-element and many big clusters.
+ * \remarks
+ * - The cluster with the index 10 has an unknown size and a "Void"-element is placed after the cluster with the index 20.
+ * - The "Cues"-element references every 8th cluster plus an offset which does not point to a cluster.
+ * - The offsets of the clusters (relative to the file) are stored in \a clusterOffsets.
+ */
+string makeFileWithManyClusters(vector<uint64> &clusterOffsets)
+{
+    constexpr unsigned int clusterCount = 40;
+    const auto headerElements = makeHeaderElements();
+    string clusters;
+    vector<uint64> relativeClusterOffsets;
+    for (unsigned int i = 0; i != clusterCount; ++i) {
+        relativeClusterOffsets.emplace_back(clusters.size());
+        const string children = makeUIntegerElement(MatroskaIds::Timecode, i * 1000)
+            + makeElement(MatroskaIds::SimpleBlock, "\x81\x00\x00\x80"s + string(0x10000, static_cast<char>(i)));
+        if (i == 10) {
+            char buff[4];
+            clusters.append(buff, EbmlElement::makeId(MatroskaIds::Cluster, buff));
+            clusters += "\xFF"s + children;
+        } else {
+            clusters += makeElement(MatroskaIds::Cluster, children);
+        }
+        if (i == 20) {
+            clusters += makeElement(EbmlIds::Void, string(100, '\0'));
+        }
+    }
+    const auto makeCues = [&relativeClusterOffsets](uint64 clustersOffset) {
+        string cuePoints;
+        for (unsigned int i = 0; i < clusterCount; i += 8) {
+            cuePoints += makeElement(MatroskaIds::CuePoint,
+                makeUIntegerElement(MatroskaIds::CueTime, i * 1000)
+                    + makeElement(MatroskaIds::CueTrackPositions,
+                        makeUIntegerElement(MatroskaIds::CueTrack, 1)
+                            + makeUIntegerElement(MatroskaIds::CueClusterPosition, clustersOffset + relativeClusterOffsets[i], 4)));
+        }
+        cuePoints += makeElement(MatroskaIds::CuePoint,
+            makeUIntegerElement(MatroskaIds::CueTime, 1)
+                + makeElement(MatroskaIds::CueTrackPositions,
+                    makeUIntegerElement(MatroskaIds::CueTrack, 1)
+                        + makeUIntegerElement(MatroskaIds::CueClusterPosition, clustersOffset + relativeClusterOffsets[1] + 1, 4)));
+        return makeElement(MatroskaIds::Cues, cuePoints);
+    };
+    const uint64 clustersOffset = headerElements.second.size() + makeCues(0).size();
+    const string segment = makeElement(MatroskaIds::Segment, headerElements.second + makeCues(clustersOffset) + clusters);
+    const uint64 segmentDataOffset = headerElements.first.size() + segment.size() - clusters.size() - clustersOffset;
+    clusterOffsets.clear();
+    for (const uint64 relativeClusterOffset : relativeClusterOffsets) {
+        clusterOffsets.emplace_back(segmentDataOffset + clustersOffset + relativeClusterOffset);
+    }
+    return headerElements.first + segment;
+}
+
+/*!
+ * \brief Returns the data of a block of track 1 with the specified \a relativeTimecode, \a flags and \a frameSize.
+ */
+string makeBlock(int16 relativeTimecode, byte flags, size_t frameSize)
+{
+    char header[4] = { '\x81' };
+    BE::getBytes(relativeTimecode, header + 1);
+    header[3] = static_cast<char>(flags);
+    return string(header, sizeof(header)) + string(frameSize, '\0');
+}
+
+/*!
+ * \brief Returns a Matroska file for testing MatroskaContainer::readTrackStatisticsFromBlocks().
+ * \remarks
+ * - The timecode scale is 1 ms and the track has a default duration of 20 ms.
+ * - The first cluster contains 50 "SimpleBlock"-elements with 100 bytes every 20 ms; every 10th is a keyframe.
+ * - The second cluster starts at 1 s and contains a "BlockGroup"-element (300 bytes, not a keyframe) followed by 24
+ *   "SimpleBlock"-elements with 300 bytes every 20 ms; every 10th is a keyframe.
+ * - So the last frame ends at 1.5 s.
+ */
+string makeFileWithBlocks()
+{
+    const auto headerElements = makeHeaderElements(20000000);
+    string firstCluster = makeUIntegerElement(MatroskaIds::Timecode, 0);
+    for (int16 i = 0; i != 50; ++i) {
+        firstCluster += makeElement(MatroskaIds::SimpleBlock, makeBlock(i * 20, i % 10 ? 0x00 : 0x80, 100));
+    }
+    string secondCluster = makeUIntegerElement(MatroskaIds::Timecode, 1000)
+        + makeElement(MatroskaIds::BlockGroup,
+            makeElement(MatroskaIds::Block, makeBlock(0, 0x00, 300)) + makeUIntegerElement(MatroskaIds::BlockDuration, 20)
+                + makeUIntegerElement(MatroskaIds::ReferenceBlock, 20));
+    for (int16 i = 1; i != 25; ++i) {
+        secondCluster += makeElement(MatroskaIds::SimpleBlock, makeBlock(i * 20, i % 10 ? 0x00 : 0x80, 300));
+    }
+    return headerElements.first
+        + makeElement(MatroskaIds::Segment,
+            headerElements.second + makeElement(MatroskaIds::Cluster, firstCluster) + makeElement(MatroskaIds::Cluster, secondCluster));
+}
+
+/*!
+ * \brief Returns a Matroska file where the segment, the "Info"-element and all (big) clusters have a "CRC-32"-element.
+ * \remarks The clusters are big enough to be split into multiple ranges when validating them concurrently.
+ */
+string makeFileWithChecksums()
+{
+    const auto headerElements = makeHeaderElements(0, true);
+    string children = headerElements.second;
+    for (unsigned int i = 0; i != 12; ++i) {
+        const string clusterChildren = makeUIntegerElement(MatroskaIds::Timecode, i * 1000)
+            + makeElement(MatroskaIds::SimpleBlock, "\x81\x00\x00\x80"s + string(0x40000, static_cast<char>(i)));
+        children += makeElement(MatroskaIds::Cluster, makeCrc32Element(clusterChildren) + clusterChildren);
+    }
+    return headerElements.first + makeElement(MatroskaIds::Segment, makeCrc32Element(children) + children);
+}
+
+/*!
+ * \brief Returns a Matroska file with a "Tags"-element (setting the title to "lazy") behind three clusters.
+ * \remarks
+ * - If \a withSeekHead is true, the segment starts with a "SeekHead"-element referring to the "Tags"-element.
+ * - If \a unknownClusterSizes is true, the size of the clusters is unknown (as in live recordings).
+ */
+string makeFileWithTagsBehindClusters(bool withSeekHead, bool unknownClusterSizes)
+{
+    const auto headerElements = makeHeaderElements();
+    string clusters;
+    for (unsigned int i = 0; i != 3; ++i) {
+        string cluster = makeCluster(i * 1000, false);
+        if (unknownClusterSizes) {
+            // replace the 1-byte size denotation following the 4-byte ID with the 1-byte denotation for an unknown size
+            cluster[4] = '\xFF';
+        }
+        clusters += cluster;
+    }
+    const string tags = makeElement(MatroskaIds::Tags,
+        makeElement(MatroskaIds::Tag,
+            makeElement(MatroskaIds::Targets, makeUIntegerElement(MatroskaIds::TargetTypeValue, 50))
+                + makeElement(MatroskaIds::SimpleTag, makeElement(MatroskaIds::TagName, "TITLE") + makeElement(MatroskaIds::TagString, "lazy"))));
+    const auto makeSeekHead = [](uint64 tagsPosition) {
+        char buff[4];
+        return makeElement(MatroskaIds::SeekHead,
+            makeElement(MatroskaIds::Seek,
+                makeElement(MatroskaIds::SeekID, string(buff, EbmlElement::makeId(MatroskaIds::Tags, buff)))
+                    + makeUIntegerElement(MatroskaIds::SeekPosition, tagsPosition, 4)));
+    };
+    const string seekHead = withSeekHead ? makeSeekHead(makeSeekHead(0).size() + headerElements.second.size() + clusters.size()) : string();
+    return headerElements.first + makeElement(MatroskaIds::Segment, seekHead + headerElements.second + clusters + tags);
+}
+
+/*!
+ * \brief Returns the data of the attachment used in the generated files.
+ * \remarks The data is bigger than the chunks it is copied in so the order of the chunks matters.
+ */
+const string &attachmentData()
+{
+    static const string data = [] {
+        string data;
+        for (unsigned int i = 0; i != 0x30000; ++i) {
+            data += static_cast<char>(i * 13 + (i >> 16));
+        }
+        return data;
+    }();
+    return data;
+}
+
+/*!
+ * \brief Returns a Matroska file with an attachment and 4 KiB padding in front of the cluster.
+ * \remarks
+ * - The segment starts with a "SeekHead"-element referring to the "Attachments"-element.
+ * - If \a paddingBeforeAttachments is true, the padding is placed in front of the "Attachments"-element instead.
+ */
+string makeFileWithAttachment(bool paddingBeforeAttachments)
+{
+    const auto headerElements = makeHeaderElements();
+    const string attachments = makeElement(MatroskaIds::Attachments,
+        makeElement(MatroskaIds::AttachedFile,
+            makeElement(MatroskaIds::FileName, "data.bin") + makeElement(MatroskaIds::FileMimeType, "application/octet-stream")
+                + makeUIntegerElement(MatroskaIds::FileUID, 4321) + makeElement(MatroskaIds::FileData, attachmentData())));
+    const string padding = makeElement(EbmlIds::Void, string(0x1000, '\0'));
+    const auto makeSeekHead = [](uint64 attachmentsPosition) {
+        char buff[4];
+        return makeElement(MatroskaIds::SeekHead,
+            makeElement(MatroskaIds::Seek,
+                makeElement(MatroskaIds::SeekID, string(buff, EbmlElement::makeId(MatroskaIds::Attachments, buff)))
+                    + makeUIntegerElement(MatroskaIds::SeekPosition, attachmentsPosition, 4)));
+    };
+    const uint64 attachmentsPosition = makeSeekHead(0).size() + headerElements.second.size() + (paddingBeforeAttachments ? padding.size() : 0);
+    const string children = paddingBeforeAttachments ? padding + attachments : attachments + padding;
+    return headerElements.first
+        + makeElement(MatroskaIds::Segment, makeSeekHead(attachmentsPosition) + headerElements.second + children + makeCluster(0, false));
+}
+
+} // namespace MatroskaTestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MatroskaTests);
+
+void MatroskaTests::setUp()
+{
+}
+
+void MatroskaTests::tearDown()
+{
+}
+
+/*!
+ * \brief Tests MatroskaTrack::codecIdToMediaFormat() with all known codec IDs and with near-misses.
+ */
+void MatroskaTests::testCodecIdToMediaFormat()
+{
+    using namespace SubFormats;
+    using namespace ExtensionFormats;
+    struct {
+        const char *codecId;
+        GeneralMediaFormat general;
+        unsigned char sub;
+        unsigned char extension;
+    } const knownCodecIds[] = {
+        { "V_MS/VFW/FOURCC", GeneralMediaFormat::MicrosoftVideoCodecManager, 0, 0 },
+        { "V_UNCOMPRESSED", GeneralMediaFormat::UncompressedVideoFrames, 0, 0 },
+        { "V_MPEG4", GeneralMediaFormat::Mpeg4Video, 0, 0 },
+        { "V_MPEG4/ISO/SP", GeneralMediaFormat::Mpeg4Video, Mpeg4SimpleProfile1, 0 },
+        { "V_MPEG4/ISO/ASP", GeneralMediaFormat::Mpeg4Video, Mpeg4AdvancedSimpleProfile1, 0 },
+        { "V_MPEG4/ISO/AVC", GeneralMediaFormat::Avc, 0, 0 },
+        { "V_MPEG4/MS/V3", GeneralMediaFormat::Mpeg4Video, Mpeg4SimpleProfile1, 0 },
+        { "V_MPEG1", GeneralMediaFormat::Mpeg1Video, 0, 0 },
+        { "V_MPEG2", GeneralMediaFormat::Mpeg2Video, 0, 0 },
+        { "V_REAL", GeneralMediaFormat::RealVideo, 0, 0 },
+        { "V_QUICKTIME", GeneralMediaFormat::QuicktimeVideo, 0, 0 },
+        { "V_THEORA", GeneralMediaFormat::Theora, 0, 0 },
+        { "V_PRORES", GeneralMediaFormat::ProRes, 0, 0 },
+        { "V_VP8", GeneralMediaFormat::Vp8, 0, 0 },
+        { "V_VP9", GeneralMediaFormat::Vp9, 0, 0 },
+        { "A_MPEG", GeneralMediaFormat::Mpeg1Audio, 0, 0 },
+        { "A_MPEG/L1", GeneralMediaFormat::Mpeg1Audio, Mpeg1Layer1, 0 },
+        { "A_MPEG/L2", GeneralMediaFormat::Mpeg1Audio, Mpeg1Layer2, 0 },
+        { "A_MPEG/L3", GeneralMediaFormat::Mpeg1Audio, Mpeg1Layer3, 0 },
+        { "V_MPEGH/ISO/HEVC", GeneralMediaFormat::Hevc, 0, 0 },
+        { "A_PCM", GeneralMediaFormat::Pcm, 0, 0 },
+        { "A_PCM/INT/BIG", GeneralMediaFormat::Pcm, PcmIntBe, 0 },
+        { "A_PCM/INT/LIT", GeneralMediaFormat::Pcm, PcmIntLe, 0 },
+        { "A_PCM/FLOAT/IEEE", GeneralMediaFormat::Pcm, PcmFloatIeee, 0 },
+        { "A_MPC", GeneralMediaFormat::Mpc, 0, 0 },
+        { "A_AC3", GeneralMediaFormat::Ac3, 0, 0 },
+        { "A_ALAC", GeneralMediaFormat::Alac, 0, 0 },
+        { "A_DTS", GeneralMediaFormat::Dts, 0, 0 },
+        { "A_DTS/EXPRESS", GeneralMediaFormat::Dts, DtsExpress, 0 },
+        { "A_DTS/LOSSLESS", GeneralMediaFormat::Dts, DtsLossless, 0 },
+        { "A_VORBIS", GeneralMediaFormat::Vorbis, 0, 0 },
+        { "A_FLAC", GeneralMediaFormat::Flac, 0, 0 },
+        { "A_OPUS", GeneralMediaFormat::Opus, 0, 0 },
+        { "A_REAL", GeneralMediaFormat::RealAudio, 0, 0 },
+        { "A_MS/ACM", GeneralMediaFormat::MicrosoftAudioCodecManager, 0, 0 },
+        { "A_AAC", GeneralMediaFormat::Aac, 0, 0 },
+        { "A_AAC/MPEG2/MAIN", GeneralMediaFormat::Aac, AacMpeg2MainProfile, 0 },
+        { "A_AAC/MPEG2/LC", GeneralMediaFormat::Aac, AacMpeg2LowComplexityProfile, 0 },
+        { "A_AAC/MPEG2/SBR", GeneralMediaFormat::Aac, AacMpeg2LowComplexityProfile, SpectralBandReplication },
+        { "A_AAC/MPEG2/SSR", GeneralMediaFormat::Aac, AacMpeg2ScalableSamplingRateProfile, 0 },
+        { "A_AAC/MPEG4/MAIN", GeneralMediaFormat::Aac, AacMpeg4MainProfile, 0 },
+        { "A_AAC/MPEG4/LC", GeneralMediaFormat::Aac, AacMpeg4LowComplexityProfile, 0 },
+        { "A_AAC/MPEG4/SBR", GeneralMediaFormat::Aac, AacMpeg4LowComplexityProfile, SpectralBandReplication },
+        { "A_AAC/MPEG4/SSR", GeneralMediaFormat::Aac, AacMpeg4ScalableSamplingRateProfile, 0 },
+        { "A_AAC/MPEG4/LTP", GeneralMediaFormat::Aac, AacMpeg4LongTermPrediction, 0 },
+        { "A_QUICKTIME", GeneralMediaFormat::QuicktimeAudio, 0, 0 },
+        { "A_TTA1", GeneralMediaFormat::Tta, 0, 0 },
+        { "A_WAVPACK4", GeneralMediaFormat::WavPack, 0, 0 },
+        { "S_TEXT", GeneralMediaFormat::TextSubtitle, 0, 0 },
+        { "S_TEXT/UTF8", GeneralMediaFormat::TextSubtitle, PlainUtf8Subtitle, 0 },
+        { "S_TEXT/SSA", GeneralMediaFormat::TextSubtitle, SubStationAlpha, 0 },
+        { "S_TEXT/ASS", GeneralMediaFormat::TextSubtitle, AdvancedSubStationAlpha, 0 },
+        { "S_TEXT/USF", GeneralMediaFormat::TextSubtitle, UniversalSubtitleFormat, 0 },
+        { "S_TEXT/WEBVTT", GeneralMediaFormat::TextSubtitle, WebVideoTextTracksFormat, 0 },
+        { "S_IMAGE", GeneralMediaFormat::ImageSubtitle, 0, 0 },
+        { "S_IMAGE/BMP", GeneralMediaFormat::ImageSubtitle, ImgSubBmp, 0 },
+        { "S_VOBSUB", GeneralMediaFormat::VobSub, 0, 0 },
+        { "S_KATE", GeneralMediaFormat::OggKate, 0, 0 },
+        { "B_VOBBTN", GeneralMediaFormat::VobBtn, 0, 0 },
+        { "S_DVBSUB", GeneralMediaFormat::DvbSub, 0, 0 },
+        { "V_MSWMV", GeneralMediaFormat::Vc1, 0, 0 },
+    };
+
+    for (const auto &known : knownCodecIds) {
+        const string codecId(known.codecId);
+        const auto format = MatroskaTrack::codecIdToMediaFormat(codecId);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(codecId, known.general, format.general);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(codecId, static_cast<int>(known.sub), static_cast<int>(format.sub));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(codecId, static_cast<int>(known.extension), static_cast<int>(format.extension));
+
+        // codec IDs are case-sensitive
+        string lowerCodecId(codecId);
+        for (auto &c : lowerCodecId) {
+            c = static_cast<char>(tolower(c));
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(lowerCodecId, GeneralMediaFormat::Unknown, MatroskaTrack::codecIdToMediaFormat(lowerCodecId).general);
+
+        // near-misses must not resolve to the specific format; they might only fall back to the format of the first part
+        const auto firstSlash = codecId.find('/');
+        const auto fallbackGeneral
+            = firstSlash != string::npos ? MatroskaTrack::codecIdToMediaFormat(codecId.substr(0, firstSlash)).general : GeneralMediaFormat::Unknown;
+        for (const auto &nearMiss : { codecId + 'X', codecId.substr(0, codecId.size() - 1) + '#', codecId.substr(0, codecId.size() - 1) }) {
+            const auto nearMissFormat = MatroskaTrack::codecIdToMediaFormat(nearMiss);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(nearMiss, fallbackGeneral, nearMissFormat.general);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(nearMiss, 0, static_cast<int>(nearMissFormat.sub));
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(nearMiss, 0, static_cast<int>(nearMissFormat.extension));
+        }
+    }
+
+    // unknown profiles fall back to the general format
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Aac, MatroskaTrack::codecIdToMediaFormat("A_AAC/MPEG4/FOO").general);
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Aac, MatroskaTrack::codecIdToMediaFormat("A_AAC/").general);
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(MatroskaTrack::codecIdToMediaFormat("A_AAC/MPEG4/LC/FOO").sub));
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Mpeg4Video, MatroskaTrack::codecIdToMediaFormat("V_MPEG4/ISO/FOO").general);
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::TextSubtitle, MatroskaTrack::codecIdToMediaFormat("S_TEXT/FOO").general);
+
+    // completely unknown codec IDs
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Unknown, MatroskaTrack::codecIdToMediaFormat(string()).general);
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Unknown, MatroskaTrack::codecIdToMediaFormat("/").general);
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Unknown, MatroskaTrack::codecIdToMediaFormat("V_MS/VFW").general);
+    CPPUNIT_ASSERT_EQUAL(GeneralMediaFormat::Unknown, MatroskaTrack::codecIdToMediaFormat("X_FOO/BAR/BAZ").general);
+}
+
+/*!
+ * \brief Tests updating the "Position"-elements of clusters when applying changes without rewriting the file.
+ * \remarks The "Position"-elements are not the first children of the clusters and only the first cluster has a "CRC-32"-element.
+ */
+void MatroskaTests::testUpdatingClusterPositions()
+{
+    using namespace MatroskaTestHelper;
+    const string path = workingCopyPathMode("matroska-cluster-positions.mkv", WorkingCopyMode::NoCopy);
+    const string originalData = makeFileWithClusters();
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << originalData;
+
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(path);
+    file.open();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+    CPPUNIT_ASSERT(file.container());
+    file.container()->createTag()->setValue(KnownField::Title, TagValue("test"));
+    file.setForceRewrite(false);
+    file.setMaxPadding(4096);
+    file.applyChanges(diag, progress);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("file not rewritten", static_cast<uint64>(originalData.size()), file.size());
+
+    // check whether the "Position"-elements have been updated and whether the checksum of the first cluster is still valid
+    diag.clear();
+    file.parseEverything(diag);
+    auto *const container = static_cast<MatroskaContainer *>(file.container());
+    EbmlElement *const segment = container->firstElement()->siblingById(MatroskaIds::Segment, diag);
+    CPPUNIT_ASSERT(segment);
+    unsigned int clusterCount = 0;
+    for (EbmlElement *cluster = segment->childById(MatroskaIds::Cluster, diag); cluster;
+         cluster = cluster->siblingById(MatroskaIds::Cluster, diag), ++clusterCount) {
+        EbmlElement *const position = cluster->childById(MatroskaIds::Position, diag);
+        CPPUNIT_ASSERT(position);
+        CPPUNIT_ASSERT_EQUAL(cluster->startOffset() - segment->dataOffset(), position->readUInteger());
+        const EbmlElement::IdentifierType expectedFirstChildId
+            = clusterCount ? static_cast<EbmlElement::IdentifierType>(MatroskaIds::Timecode) : static_cast<EbmlElement::IdentifierType>(EbmlIds::Crc32);
+        CPPUNIT_ASSERT_EQUAL(expectedFirstChildId, cluster->firstChild()->id());
+    }
+    CPPUNIT_ASSERT_EQUAL(2u, clusterCount);
+    CPPUNIT_ASSERT_EQUAL("test"s, file.tags().at(0)->value(KnownField::Title).toString());
+    container->validateChecksums(diag);
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Warning);
+    }
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests splitting the clusters into ranges and validating them concurrently.
+ * \remarks The resulting messages must not depend on the number of threads.
+ */
+void MatroskaTests::testScanningClustersConcurrently()
+{
+    using namespace MatroskaTestHelper;
+    const string path = workingCopyPathMode("matroska-many-clusters.mkv", WorkingCopyMode::NoCopy);
+    vector<uint64> clusterOffsets;
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeFileWithManyClusters(clusterOffsets);
+
+    Diagnostics diag;
+    MediaFileInfo file(path);
+    file.open(true);
+    file.parseContainerFormat(diag);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+    auto *const container = static_cast<MatroskaContainer *>(file.container());
+
+    // check ranges: clusters are found only by reading headers, also the one with unknown size
+    // note: Parsing the container itself does not support elements with unknown size and is therefore not expected to succeed without warnings.
+    diag.clear();
+    MatroskaClusterScanner scanner(*container);
+    scanner.setThreadCount(4);
+    scanner.determineRanges(diag);
+    for (const auto &message : diag) {
+        CPPUNIT_FAIL(message.message());
+    }
+    CPPUNIT_ASSERT(clusterOffsets == scanner.clusterOffsets());
+    const auto &ranges = scanner.ranges();
+    CPPUNIT_ASSERT(ranges.size() > 1);
+    CPPUNIT_ASSERT_EQUAL(clusterOffsets.front(), ranges.front().startOffset);
+    CPPUNIT_ASSERT_EQUAL(file.size(), ranges.back().endOffset);
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, ranges[i].index);
+        CPPUNIT_ASSERT_EQUAL(ranges[i - 1].endOffset, ranges[i].startOffset);
+        CPPUNIT_ASSERT(scanner.isCluster(ranges[i].startOffset));
+    }
+    CPPUNIT_ASSERT(!scanner.isCluster(clusterOffsets[1] + 1));
+    const vector<EbmlElement::IdentifierType> expectedSegmentChildren{
+        MatroskaIds::SegmentInfo, MatroskaIds::Tracks, MatroskaIds::Cues, EbmlIds::Void
+    };
+    vector<EbmlElement::IdentifierType> segmentChildren;
+    for (const auto &header : scanner.segmentChildren()) {
+        segmentChildren.emplace_back(header.id);
+    }
+    CPPUNIT_ASSERT(expectedSegmentChildren == segmentChildren);
+
+    // check whether validation yields the same messages regardless of the number of threads
+    vector<vector<string>> messages;
+    vector<uint64> paddingSizes;
+    for (const unsigned int threadCount : { 1u, 4u }) {
+        Diagnostics validationDiag;
+        uint64 paddingSize = 0;
+        container->validateConcurrently(validationDiag, &paddingSize, threadCount);
+        messages.emplace_back();
+        for (const auto &message : validationDiag) {
+            messages.back().emplace_back(argsToString(static_cast<int>(message.level()), ' ', message.context(), ": ", message.message()));
+        }
+        paddingSizes.emplace_back(paddingSize);
+        const auto criticalCount = count_if(
+            validationDiag.cbegin(), validationDiag.cend(), [](const DiagMessage &message) { return message.level() == DiagLevel::Critical; });
+        CPPUNIT_ASSERT_EQUAL(1l, static_cast<long>(criticalCount));
+    }
+    CPPUNIT_ASSERT(messages[0] == messages[1]);
+    CPPUNIT_ASSERT_EQUAL(paddingSizes[0], paddingSizes[1]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(102), paddingSizes[0]);
+
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests MatroskaContainer::readTrackStatisticsFromBlocks().
+ * \remarks Statistics are read twice to check whether reading them again yields the same results.
+ */
+void MatroskaTests::testReadingTrackStatisticsFromBlocks()
+{
+    using namespace MatroskaTestHelper;
+    const string path = workingCopyPathMode("matroska-block-statistics.mkv", WorkingCopyMode::NoCopy);
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << makeFileWithBlocks();
+
+    Diagnostics diag;
+    MediaFileInfo file(path);
+    file.open(true);
+    file.parseContainerFormat(diag);
+    file.parseTracks(diag);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+    auto *const container = static_cast<MatroskaContainer *>(file.container());
+    CPPUNIT_ASSERT_EQUAL(1_st, container->tracks().size());
+    MatroskaTrack *const track = container->tracks().front().get();
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(20000000), track->defaultDuration());
+
+    for (const unsigned int threadCount : { 1u, 2u }) {
+        const auto statistics = container->readTrackStatisticsFromBlocks(diag, threadCount);
+        CPPUNIT_ASSERT_EQUAL(1_st, statistics.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(1), statistics.front().trackNumber);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(7), statistics.front().keyframeCount);
+        CPPUNIT_ASSERT_EQUAL(static_cast<int64>(0), statistics.front().firstTimestamp);
+        CPPUNIT_ASSERT_EQUAL(static_cast<int64>(1500000000), statistics.front().lastTimestamp);
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(75), track->sampleCount());
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(7), track->keyframeCount());
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(50 * 100 + 25 * 300), track->size());
+        CPPUNIT_ASSERT_EQUAL(ChronoUtilities::TimeSpan::fromSeconds(1.5), track->duration());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(12500 * 0.008 / 1.5, track->bitrate(), 0.0001);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(7500 * 0.008, track->maxBitrate(), 0.0001);
+    }
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Warning);
+    }
+
+    file.close();
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests MatroskaContainer::validateChecksums() with an intact file and with files where a byte of the "Info"-element
+ *        or of a cluster has been altered.
+ * \remarks The checksum of the altered element and the checksum of the segment must mismatch, regardless of the number of threads.
+ */
+void MatroskaTests::testValidatingChecksums()
+{
+    using namespace MatroskaTestHelper;
+    const string path = workingCopyPathMode("matroska-checksums.mkv", WorkingCopyMode::NoCopy);
+    const string originalData = makeFileWithChecksums();
+    const auto findElement = [&originalData](EbmlElement::IdentifierType id, size_t startOffset) {
+        char buff[4];
+        return originalData.find(string(buff, EbmlElement::makeId(id, buff)), startOffset);
+    };
+    const auto segmentOffset = findElement(MatroskaIds::Segment, 0);
+    const auto infoOffset = findElement(MatroskaIds::SegmentInfo, segmentOffset);
+    auto clusterOffset = findElement(MatroskaIds::Cluster, segmentOffset);
+    for (unsigned int i = 0; i != 7; ++i) {
+        clusterOffset = findElement(MatroskaIds::Cluster, clusterOffset + 1);
+    }
+    const struct {
+        const char *description;
+        size_t alteredOffset;
+        vector<size_t> mismatchingElementOffsets;
+    } testCases[] = {
+        { "intact", string::npos, {} },
+        { "altered info", originalData.find("test", infoOffset), { segmentOffset, infoOffset } },
+        { "altered cluster", clusterOffset + 0x1000, { segmentOffset, clusterOffset } },
+    };
+
+    for (const auto &testCase : testCases) {
+        string data = originalData;
+        if (testCase.alteredOffset != string::npos) {
+            data[testCase.alteredOffset] ^= 0x20;
+        }
+        ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << data;
+
+        Diagnostics diag;
+        MediaFileInfo file(path);
+        file.open(true);
+        file.parseContainerFormat(diag);
+        CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+        auto *const container = static_cast<MatroskaContainer *>(file.container());
+        for (const unsigned int threadCount : { 1u, 4u }) {
+            Diagnostics validationDiag;
+            container->validateChecksums(validationDiag, threadCount);
+            vector<size_t> mismatchingElementOffsets;
+            for (const auto &message : validationDiag) {
+                CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() == DiagLevel::Critical);
+                for (const size_t offset : testCase.mismatchingElementOffsets) {
+                    if (message.message().find(argsToString("\" at ", offset, " is 0x")) != string::npos) {
+                        mismatchingElementOffsets.emplace_back(offset);
+                    }
+                }
+            }
+            sort(mismatchingElementOffsets.begin(), mismatchingElementOffsets.end());
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(testCase.description, testCase.mismatchingElementOffsets.size(), validationDiag.size());
+            CPPUNIT_ASSERT_MESSAGE(testCase.description, testCase.mismatchingElementOffsets == mismatchingElementOffsets);
+        }
+        file.close();
+    }
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests parsing Matroska segments lazily (see MediaFileInfo::setParsingSegmentsLazily()).
+ * \remarks
+ * - The "Tags"-element behind the clusters must be found either via the "SeekHead"-element or by hopping over the clusters
+ *   (also if their size is unknown).
+ * - When parsing lazily, no element behind the first cluster is supposed to be parsed as part of the element tree.
+ */
+void MatroskaTests::testParsingSegmentsLazily()
+{
+    using namespace MatroskaTestHelper;
+    const string path = workingCopyPathMode("matroska-lazy-parsing.mkv", WorkingCopyMode::NoCopy);
+    const struct {
+        bool withSeekHead;
+        bool unknownClusterSizes;
+        bool parsingLazily;
+        size_t parsedSegmentChildCount;
+    } testCases[] = {
+        { true, false, true, 4 }, // "SeekHead", "Info", "Tracks" and the first "Cluster"
+        { false, false, true, 3 }, // "Info", "Tracks" and the first "Cluster"
+        { false, true, true, 3 }, // "Info", "Tracks" and the first "Cluster"
+        { false, false, false, 6 }, // all children
+    };
+
+    for (const auto &testCase : testCases) {
+        ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary)
+            << makeFileWithTagsBehindClusters(testCase.withSeekHead, testCase.unknownClusterSizes);
+
+        Diagnostics diag;
+        MediaFileInfo file(path);
+        file.setParsingSegmentsLazily(testCase.parsingLazily);
+        file.open(true);
+        file.parseContainerFormat(diag);
+        file.parseTracks(diag);
+        file.parseTags(diag);
+        CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+        CPPUNIT_ASSERT_EQUAL(1_st, file.tracks().size());
+        CPPUNIT_ASSERT_EQUAL(1_st, file.tags().size());
+        CPPUNIT_ASSERT_EQUAL("lazy"s, file.tags().front()->value(KnownField::Title).toString());
+        for (const auto &message : diag) {
+            CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Warning);
+        }
+
+        auto *const container = static_cast<MatroskaContainer *>(file.container());
+        const EbmlElement *const segment = container->firstElement()->nextSibling();
+        CPPUNIT_ASSERT(segment);
+        CPPUNIT_ASSERT_EQUAL(MatroskaIds::Segment, segment->id());
+        size_t parsedSegmentChildCount = 0;
+        for (const EbmlElement *child = segment->firstChild(); child && child->isParsed(); child = child->nextSibling()) {
+            ++parsedSegmentChildCount;
+        }
+        CPPUNIT_ASSERT_EQUAL(testCase.parsedSegmentChildCount, parsedSegmentChildCount);
+        file.close();
+    }
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests whether attachments are copied correctly when adding a tag in front of them.
+ * \remarks
+ * - When updating the file in-place, the attachment is either moved behind its original location (and hence needs to be buffered)
+ *   or in front of its original location (and hence is copied within the file in chunks).
+ * - The "Attachments"-element is placed at the same location when rewriting the file.
+ */
+void MatroskaTests::testCopyingAttachments()
+{
+    using namespace MatroskaTestHelper;
+    const string path = workingCopyPathMode("matroska-attachment.mkv", WorkingCopyMode::NoCopy);
+    const struct {
+        bool paddingBeforeAttachments;
+        bool forcingRewrite;
+    } testCases[] = {
+        { false, false },
+        { true, false },
+        { false, true },
+    };
+
+    for (const auto &testCase : testCases) {
+        const string originalData = makeFileWithAttachment(testCase.paddingBeforeAttachments);
+        ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << originalData;
+
+        Diagnostics diag;
+        AbortableProgressFeedback progress;
+        MediaFileInfo file(path);
+        file.open();
+        file.parseEverything(diag);
+        CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+        CPPUNIT_ASSERT_EQUAL(1_st, file.attachments().size());
+        CPPUNIT_ASSERT(file.attachments().front()->data());
+        CPPUNIT_ASSERT_EQUAL(static_cast<streamoff>(attachmentData().size()), static_cast<streamoff>(file.attachments().front()->data()->size()));
+        file.container()->createTag()->setValue(KnownField::Title, TagValue("attachment test"));
+        file.setForceRewrite(testCase.forcingRewrite);
+        file.setMaxPadding(0x2000);
+        file.applyChanges(diag, progress);
+        if (!testCase.forcingRewrite) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("file not rewritten", static_cast<uint64>(originalData.size()), file.size());
+        }
+
+        // check whether the attachment has been copied correctly
+        diag.clear();
+        file.parseEverything(diag);
+        CPPUNIT_ASSERT_EQUAL(1_st, file.tags().size());
+        CPPUNIT_ASSERT_EQUAL("attachment test"s, file.tags().front()->value(KnownField::Title).toString());
+        CPPUNIT_ASSERT_EQUAL(1_st, file.attachments().size());
+        const AbstractAttachment &attachment = *file.attachments().front();
+        CPPUNIT_ASSERT_EQUAL("data.bin"s, attachment.name());
+        CPPUNIT_ASSERT_EQUAL("application/octet-stream"s, attachment.mimeType());
+        CPPUNIT_ASSERT(attachment.data());
+        stringstream copiedData(ios_base::in | ios_base::out | ios_base::binary);
+        attachment.data()->copyTo(copiedData);
+        CPPUNIT_ASSERT_MESSAGE("attachment data intact", attachmentData() == copiedData.str());
+        for (const auto &message : diag) {
+            CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Warning);
+        }
+        file.close();
+    }
+    remove(path.data());
+}
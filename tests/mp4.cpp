@@ -0,0 +1,183 @@
+#include "./helper.h"
+
+#include "../abstractattachment.h"
+#include "../mediafileinfo.h"
+#include "../mp4/mp4ids.h"
+#include "../mp4/mp4tag.h"
+#include "../progressfeedback.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+using namespace TestUtilities::Literals;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The Mp4Tests class tests making MP4 tags with covers referring to the original file.
+ * \remarks Parsing and making MP4 files in general is tested in OverallTests.
+ */
+class Mp4Tests : public TestFixture {
+    CPPUNIT_TEST_SUITE(Mp4Tests);
+    CPPUNIT_TEST(testCopyingReferencedCoverInPlace);
+    CPPUNIT_TEST(testCopyingReferencedCoverWhenRewriting);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testCopyingReferencedCoverInPlace();
+    void testCopyingReferencedCoverWhenRewriting();
+
+private:
+    void testRoundTrip(const char *fileName, bool forcingRewrite);
+};
+
+/// \cond
+
+namespace Mp4TestHelper {
+
+/*!
+ * \brief Returns an MP4 atom with the specified \a id and \a data.
+ */
+string makeAtom(const char *id, const string &data)
+{
+    char size[4];
+    BE::getBytes(static_cast<uint32>(8 + data.size()), size);
+    return string(size, sizeof(size)) + string(id, 4) + data;
+}
+
+/*!
+ * \brief Returns the data of the cover used in the generated file.
+ */
+const string &coverData()
+{
+    static const string data = [] {
+        string data("\xFF\xD8\xFF\xE0"s);
+        for (unsigned int i = 0; i != 0x1000; ++i) {
+            data += static_cast<char>(i * 7);
+        }
+        return data;
+    }();
+    return data;
+}
+
+/*!
+ * \brief Returns an MP4 file with a tag containing only a JPEG cover, followed by 4 KiB padding and a small "mdat"-atom.
+ */
+string makeMp4File()
+{
+    const string fileType = makeAtom("ftyp", "M4A \x00\x00\x02\x00M4A mp42isom"s);
+    char movieHeader[100] = { 0 };
+    BE::getBytes(static_cast<uint32>(1000), movieHeader + 12); // time scale
+    BE::getBytes(static_cast<uint32>(0x00010000), movieHeader + 20); // rate
+    BE::getBytes(static_cast<uint16>(0x0100), movieHeader + 24); // volume
+    BE::getBytes(static_cast<uint32>(1), movieHeader + 96); // next track ID
+    const string handler = makeAtom("hdlr", string(8, '\0') + "mdirappl" + string(9, '\0'));
+    const string cover = makeAtom("covr", makeAtom("data", "\x00\x00\x00\x0D\x00\x00\x00\x00"s + coverData()));
+    const string meta = makeAtom("meta", string(4, '\0') + handler + makeAtom("ilst", cover));
+    const string movie = makeAtom("moov", makeAtom("mvhd", string(movieHeader, sizeof(movieHeader))) + makeAtom("udta", meta));
+    return fileType + movie + makeAtom("free", string(0x1000, '\0')) + makeAtom("mdat", string(16, '\x42'));
+}
+
+} // namespace Mp4TestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(Mp4Tests);
+
+void Mp4Tests::setUp()
+{
+}
+
+void Mp4Tests::tearDown()
+{
+}
+
+/*!
+ * \brief Adds a long field in front of the cover of a generated MP4 file and checks whether the cover has been copied
+ *        correctly although it has only been referenced.
+ * \remarks When updating the file in-place the cover is moved behind its original location so its original location
+ *          has already been overwritten when making the cover.
+ */
+void Mp4Tests::testRoundTrip(const char *fileName, bool forcingRewrite)
+{
+    using namespace Mp4TestHelper;
+    const string path = workingCopyPathMode(fileName, WorkingCopyMode::NoCopy);
+    const string originalData = makeMp4File();
+    ofstream(path, ios_base::out | ios_base::trunc | ios_base::binary) << originalData;
+
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(path);
+    file.setReferencingPictureData(true);
+    file.open();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Mp4, file.containerFormat());
+    CPPUNIT_ASSERT(file.mp4Tag());
+    Mp4Tag &tag = *file.mp4Tag();
+    const TagValue &cover = tag.value(KnownField::Cover);
+    CPPUNIT_ASSERT_MESSAGE("cover referenced", cover.dataBlock());
+    CPPUNIT_ASSERT_EQUAL(coverData().size(), cover.dataSize());
+
+    // preparing to make the tag must not read the cover
+    tag.prepareMaking(diag);
+    CPPUNIT_ASSERT_MESSAGE("cover still referenced", cover.dataBlock());
+    CPPUNIT_ASSERT_MESSAGE("cover not read when preparing", !cover.dataBlock()->buffer());
+
+    // copies of the cover which are supposed to outlive applying changes must be read before
+    TagValue keptCover(cover);
+    CPPUNIT_ASSERT(keptCover.dataPointer());
+
+    const string albumArtist(0x800, 'x');
+    tag.setValue(Mp4TagAtomIds::AlbumArtist, TagValue(albumArtist));
+    file.setForceRewrite(forcingRewrite);
+    file.setMaxPadding(0x1000);
+    file.applyChanges(diag, progress);
+    if (!forcingRewrite) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("file not rewritten", static_cast<uint64>(originalData.size()), file.size());
+    }
+
+    // check whether the cover has been copied correctly
+    diag.clear();
+    file.parseEverything(diag);
+    CPPUNIT_ASSERT(file.mp4Tag());
+    const Mp4Tag &newTag = *file.mp4Tag();
+    CPPUNIT_ASSERT_EQUAL(albumArtist, newTag.value(Mp4TagAtomIds::AlbumArtist).toString());
+    const TagValue &newCover = newTag.value(KnownField::Cover);
+    CPPUNIT_ASSERT_EQUAL(coverData().size(), newCover.dataSize());
+    CPPUNIT_ASSERT_EQUAL(coverData(), string(newCover.dataPointer(), newCover.dataSize()));
+    for (const auto &message : diag) {
+        CPPUNIT_ASSERT_MESSAGE(message.message(), message.level() < DiagLevel::Critical);
+    }
+    file.close();
+    CPPUNIT_ASSERT_EQUAL(coverData(), string(keptCover.dataPointer(), keptCover.dataSize()));
+    remove(path.data());
+}
+
+/*!
+ * \brief Tests copying a referenced cover when updating the file in-place.
+ */
+void Mp4Tests::testCopyingReferencedCoverInPlace()
+{
+    testRoundTrip("mp4-referenced-cover-in-place.m4a", false);
+}
+
+/*!
+ * \brief Tests copying a referenced cover when rewriting the file.
+ */
+void Mp4Tests::testCopyingReferencedCoverWhenRewriting()
+{
+    testRoundTrip("mp4-referenced-cover-rewrite.m4a", true);
+}
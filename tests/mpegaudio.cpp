@@ -0,0 +1,266 @@
+#include "./helper.h"
+
+#include "../mpegaudio/mpegaudioframestream.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/tests/testutils.h>
+using namespace TestUtilities;
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace TagParser;
+using namespace ConversionUtilities;
+using namespace ChronoUtilities;
+using namespace TestUtilities::Literals;
+
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The MpegAudioTests class tests scanning the frames of generated MPEG audio streams.
+ * \remarks Parsing and making MP3 files in general is tested in OverallTests.
+ */
+class MpegAudioTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(MpegAudioTests);
+    CPPUNIT_TEST(testScanningFrames);
+    CPPUNIT_TEST(testBuildingSeekIndexFromXingToc);
+    CPPUNIT_TEST(testBuildingSeekIndexFromVbriToc);
+    CPPUNIT_TEST(testBuildingSeekIndexByScanning);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testScanningFrames();
+    void testBuildingSeekIndexFromXingToc();
+    void testBuildingSeekIndexFromVbriToc();
+    void testBuildingSeekIndexByScanning();
+};
+
+/// \cond
+
+namespace MpegAudioTestHelper {
+
+/// \brief The size of a frame of a 128 kbit/s MPEG-1 layer 3 stream with 44.1 kHz (without padding).
+constexpr std::size_t frameSize = 417;
+/// \brief The number of samples per frame of an MPEG-1 layer 3 stream.
+constexpr std::size_t samplesPerFrame = 1152;
+
+/*!
+ * \brief Returns a frame of a 128 kbit/s MPEG-1 layer 3 stream with 44.1 kHz and the specified \a data.
+ */
+string makeFrame(const string &data = string())
+{
+    return "\xFF\xFB\x90\x00"s + data + string(frameSize - 4 - data.size(), '\0');
+}
+
+/*!
+ * \brief Returns a frame containing a Xing header with frame count, byte count and the specified \a toc.
+ */
+string makeXingFrame(uint32 frameCount, const string &toc)
+{
+    char buffer[4];
+    string data(0x20, '\0');
+    data += "Xing";
+    for (const uint32 value : { 0x7u, frameCount, static_cast<uint32>((frameCount + 1) * frameSize) }) { // flags, frame count and byte count
+        BE::getBytes(value, buffer);
+        data.append(buffer, 4);
+    }
+    return makeFrame(data + toc);
+}
+
+/*!
+ * \brief Returns a frame containing a VBRI header with a TOC consisting of two entries each covering ten frames.
+ */
+string makeVbriFrame(uint32 frameCount)
+{
+    char buffer[4];
+    string data(0x20, '\0');
+    data += "VBRI";
+    BE::getBytes(static_cast<uint16>(1), buffer); // version
+    data.append(buffer, 2);
+    data.append(4, '\0'); // delay and quality
+    BE::getBytes(static_cast<uint32>((frameCount + 1) * frameSize), buffer);
+    data.append(buffer, 4);
+    BE::getBytes(frameCount, buffer);
+    data.append(buffer, 4);
+    for (const uint16 value : { 2, 1, 2, 10 }) { // entry count, scale, entry size and frames per entry
+        BE::getBytes(value, buffer);
+        data.append(buffer, 2);
+    }
+    for (auto entry = 0; entry != 2; ++entry) {
+        BE::getBytes(static_cast<uint16>(10 * frameSize), buffer);
+        data.append(buffer, 2);
+    }
+    return makeFrame(data);
+}
+
+/*!
+ * \brief Returns a frame containing an "Info" header without any fields.
+ */
+string makeInfoFrame()
+{
+    return makeFrame(string(0x20, '\0') + "Info"s + string(4, '\0'));
+}
+
+/*!
+ * \brief Returns an ID3v1 tag which happens to contain a frame header.
+ */
+string makeId3v1Tag()
+{
+    return "TAG\xFF\xFB\x90\x00"s + string(121, '\0');
+}
+
+} // namespace MpegAudioTestHelper
+
+/// \endcond
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MpegAudioTests);
+
+void MpegAudioTests::setUp()
+{
+}
+
+void MpegAudioTests::tearDown()
+{
+}
+
+/*!
+ * \brief Tests scanning the frames of a stream with VBRI header and garbage between the frames.
+ */
+void MpegAudioTests::testScanningFrames()
+{
+    using namespace MpegAudioTestHelper;
+    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+    stream << makeVbriFrame(30);
+    for (auto i = 0; i != 20; ++i) {
+        stream << makeFrame();
+    }
+    // write garbage containing a valid frame header which is not followed by another frame header
+    stream << "garbage..."s << makeFrame().substr(0, 4) << string(36, 'x');
+    for (auto i = 0; i != 10; ++i) {
+        stream << makeFrame();
+    }
+    stream << makeId3v1Tag();
+
+    Diagnostics diag;
+    MpegAudioFrameStream track(stream, 0);
+    track.setScanningFrames(true);
+    track.parseHeader(diag);
+    CPPUNIT_ASSERT_EQUAL(1_st, diag.size());
+    CPPUNIT_ASSERT_EQUAL(DiagLevel::Warning, diag.front().level());
+    CPPUNIT_ASSERT_EQUAL("50 bytes between the frames could not be assigned to a valid frame."s, diag.front().message());
+
+    // the frame containing the VBRI header contains no audio data
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(30 * samplesPerFrame), track.sampleCount());
+    CPPUNIT_ASSERT_EQUAL(30_st, track.frameOffsets().size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32>(frameSize), track.frameOffsets().front());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32>(21 * frameSize + 50), track.frameOffsets()[20]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32>(30 * frameSize + 50), track.frameOffsets().back());
+    CPPUNIT_ASSERT_EQUAL(128.0, track.maxBitrate());
+}
+
+/*!
+ * \brief Tests building the seek index from the TOC of the Xing header.
+ * \remarks The TOC is not monotonic at 50 % which is supposed to be corrected.
+ */
+void MpegAudioTests::testBuildingSeekIndexFromXingToc()
+{
+    using namespace MpegAudioTestHelper;
+    string toc;
+    for (unsigned int index = 0; index != 100; ++index) {
+        toc += static_cast<char>(index * 256 / 100);
+    }
+    toc[50] = 0;
+    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+    stream << makeXingFrame(100, toc);
+    for (auto i = 0; i != 100; ++i) {
+        stream << makeFrame();
+    }
+    stream << makeId3v1Tag();
+
+    Diagnostics diag;
+    MpegAudioFrameStream track(stream, 0);
+    track.parseHeader(diag);
+    track.buildSeekIndex(diag);
+    CPPUNIT_ASSERT_EQUAL(0_st, diag.size());
+    CPPUNIT_ASSERT_MESSAGE("frames not scanned", track.frameOffsets().empty());
+    const auto &seekIndex = track.seekIndex();
+    CPPUNIT_ASSERT_EQUAL(100_st, seekIndex.size());
+    const double duration = 100.0 * samplesPerFrame / 44100;
+    const uint64 totalSize = 101 * frameSize;
+    for (std::size_t index = 0; index != 100; ++index) {
+        CPPUNIT_ASSERT_EQUAL(TimeSpan::fromSeconds(duration * index / 100.0), seekIndex[index].time);
+        const std::size_t tocIndex = index == 50 ? 49 : index;
+        CPPUNIT_ASSERT_EQUAL(totalSize * (tocIndex * 256 / 100) / 256, seekIndex[index].offset);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(0), track.seekOffset(TimeSpan()));
+    CPPUNIT_ASSERT_EQUAL(totalSize * (25 * 256 / 100) / 256, track.seekOffset(TimeSpan::fromSeconds(duration * 0.255)));
+}
+
+/*!
+ * \brief Tests building the seek index from the TOC of the VBRI header.
+ */
+void MpegAudioTests::testBuildingSeekIndexFromVbriToc()
+{
+    using namespace MpegAudioTestHelper;
+    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+    stream << makeVbriFrame(20);
+    for (auto i = 0; i != 20; ++i) {
+        stream << makeFrame();
+    }
+    stream << makeId3v1Tag();
+
+    Diagnostics diag;
+    MpegAudioFrameStream track(stream, 0);
+    track.parseHeader(diag);
+    track.buildSeekIndex(diag);
+    CPPUNIT_ASSERT_EQUAL(0_st, diag.size());
+    const auto &seekIndex = track.seekIndex();
+    CPPUNIT_ASSERT_EQUAL(3_st, seekIndex.size());
+    for (std::size_t index = 0; index != 3; ++index) {
+        CPPUNIT_ASSERT_EQUAL(TimeSpan::fromSeconds(10.0 * samplesPerFrame / 44100 * index), seekIndex[index].time);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(10 * index * frameSize), seekIndex[index].offset);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(10 * frameSize), track.seekOffset(TimeSpan::fromSeconds(0.3)));
+}
+
+/*!
+ * \brief Tests building the seek index by scanning the frames of a stream with "Info" header (not containing a TOC).
+ */
+void MpegAudioTests::testBuildingSeekIndexByScanning()
+{
+    using namespace MpegAudioTestHelper;
+    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+    stream << makeInfoFrame();
+    for (auto i = 0; i != 100; ++i) {
+        stream << makeFrame();
+    }
+    stream << makeId3v1Tag();
+
+    Diagnostics diag;
+    MpegAudioFrameStream track(stream, 0);
+    track.parseHeader(diag);
+    CPPUNIT_ASSERT(track.frameOffsets().empty());
+    track.buildSeekIndex(diag);
+    CPPUNIT_ASSERT_EQUAL(0_st, diag.size());
+
+    // the frames are scanned and the frame containing the "Info" header is skipped
+    CPPUNIT_ASSERT_EQUAL(100_st, track.frameOffsets().size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(100 * samplesPerFrame), track.sampleCount());
+
+    // there is a seek point for every 38 frames (roughly every second)
+    const auto &seekIndex = track.seekIndex();
+    CPPUNIT_ASSERT_EQUAL(3_st, seekIndex.size());
+    for (std::size_t index = 0; index != 3; ++index) {
+        CPPUNIT_ASSERT_EQUAL(TimeSpan::fromSeconds(38.0 * index * samplesPerFrame / 44100), seekIndex[index].time);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64>((38 * index + 1) * frameSize), seekIndex[index].offset);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(frameSize), track.seekOffset(TimeSpan()));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(39 * frameSize), track.seekOffset(TimeSpan::fromSeconds(1.5)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(77 * frameSize), track.seekOffset(TimeSpan::fromSeconds(60.0)));
+}
@@ -1,11 +1,14 @@
 #include "./helper.h"
 
+#include "../abstractattachment.h"
 #include "../id3/id3genres.h"
 #include "../tagvalue.h"
 
 #include <c++utilities/chrono/format.h>
 #include <c++utilities/conversion/conversionexception.h>
 
+#include <sstream>
+
 using namespace TestUtilities;
 
 #include <cppunit/TestFixture.h>
@@ -25,12 +28,15 @@ class TagValueTests : public TestFixture {
     CPPUNIT_TEST_SUITE(TagValueTests);
     CPPUNIT_TEST(testBasics);
     CPPUNIT_TEST(testBinary);
+    CPPUNIT_TEST(testDataBlock);
     CPPUNIT_TEST(testInteger);
     CPPUNIT_TEST(testPositionInSet);
     CPPUNIT_TEST(testTimeSpan);
     CPPUNIT_TEST(testDateTime);
     CPPUNIT_TEST(testString);
     CPPUNIT_TEST(testEqualityOperator);
+    CPPUNIT_TEST(testAssigningOwnData);
+    CPPUNIT_TEST(testMoving);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -39,12 +45,15 @@ public:
 
     void testBasics();
     void testBinary();
+    void testDataBlock();
     void testInteger();
     void testPositionInSet();
     void testTimeSpan();
     void testDateTime();
     void testString();
     void testEqualityOperator();
+    void testAssigningOwnData();
+    void testMoving();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TagValueTests);
@@ -72,6 +81,53 @@ void TagValueTests::testBinary()
     CPPUNIT_ASSERT_THROW(binary.toInteger(), ConversionException);
     CPPUNIT_ASSERT_THROW(binary.toPositionInSet(), ConversionException);
     CPPUNIT_ASSERT_THROW(binary.toStandardGenreIndex(), ConversionException);
+
+    // small data is stored within the value itself and hence copied
+    TagValue copy(binary);
+    CPPUNIT_ASSERT(binary.dataPointer() != static_cast<const TagValue &>(copy).dataPointer());
+    copy.dataPointer()[0] = '4';
+    CPPUNIT_ASSERT_EQUAL("123"s, string(binary.dataPointer(), binary.dataSize()));
+    CPPUNIT_ASSERT_EQUAL("423"s, string(copy.dataPointer(), copy.dataSize()));
+
+    // copies share bigger data until it is modified
+    const string bigData(100, '1');
+    const TagValue bigBinary(bigData.data(), bigData.size(), TagDataType::Binary);
+    TagValue bigCopy(bigBinary);
+    CPPUNIT_ASSERT(bigBinary.dataPointer() == static_cast<const TagValue &>(bigCopy).dataPointer());
+    bigCopy.dataPointer()[0] = '4';
+    CPPUNIT_ASSERT(bigBinary.dataPointer() != static_cast<const TagValue &>(bigCopy).dataPointer());
+    CPPUNIT_ASSERT_EQUAL(bigData, string(bigBinary.dataPointer(), bigBinary.dataSize()));
+    CPPUNIT_ASSERT_EQUAL('4', bigCopy.dataPointer()[0]);
+
+    // moving leaves the source empty
+    const TagValue moved(move(bigCopy));
+    CPPUNIT_ASSERT(bigCopy.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(bigData.size(), moved.dataSize());
+    CPPUNIT_ASSERT_EQUAL('4', moved.dataPointer()[0]);
+}
+
+void TagValueTests::testDataBlock()
+{
+    stringstream stream("foo-bar-baz"s, ios_base::in | ios_base::out | ios_base::binary);
+    const auto dataBlock = make_shared<StreamDataBlock>([&stream]() -> istream & { return stream; }, 4, ios_base::beg, 7, ios_base::beg);
+    TagValue picture(dataBlock, TagDataType::Picture);
+    CPPUNIT_ASSERT(!picture.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), picture.dataSize());
+    CPPUNIT_ASSERT_EQUAL(static_cast<const StreamDataBlock *>(dataBlock.get()), picture.dataBlock());
+
+    // copies share the data block; copying data is done directly from the stream
+    const TagValue copy(picture);
+    CPPUNIT_ASSERT_EQUAL(picture.dataBlock(), copy.dataBlock());
+    stringstream output(ios_base::in | ios_base::out | ios_base::binary);
+    copy.copyDataTo(output);
+    CPPUNIT_ASSERT_EQUAL("bar"s, output.str());
+
+    // data is read on access
+    CPPUNIT_ASSERT_EQUAL("bar"s, string(picture.dataPointer(), picture.dataSize()));
+    CPPUNIT_ASSERT(!picture.dataBlock());
+    CPPUNIT_ASSERT(copy == picture);
+    picture.clearData();
+    CPPUNIT_ASSERT(picture.isEmpty());
 }
 
 void TagValueTests::testInteger()
@@ -163,6 +219,14 @@ void TagValueTests::testString()
         TagValue("\xfe\xfft\0\xe4\0s\0t\0", 10, TagTextEncoding::Utf16BigEndian).toString(TagTextEncoding::Unspecified));
     CPPUNIT_ASSERT_EQUAL_MESSAGE("conversion via c'tor", "15\xe4"s,
         TagValue("\xef\xbb\xbf\x31\x35ä", 7, TagTextEncoding::Utf8, TagTextEncoding::Latin1).toString(TagTextEncoding::Unspecified));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("conversion from Latin-1 to UTF-16", "\0t\0\xe4\0s\0t"s,
+        TagValue("t\xe4st", 4, TagTextEncoding::Latin1).toString(TagTextEncoding::Utf16BigEndian));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("conversion of surrogate pair", "\x3c\xd8\xb5\xdf"s,
+        TagValue("\xf0\x9f\x8e\xb5", 4, TagTextEncoding::Utf8).toString(TagTextEncoding::Utf16LittleEndian));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("conversion of surrogate pair", "\xf0\x9f\x8e\xb5"s,
+        TagValue("\xd8\x3c\xdf\xb5", 4, TagTextEncoding::Utf16BigEndian).toString(TagTextEncoding::Utf8));
+    CPPUNIT_ASSERT_THROW_MESSAGE("failing conversion to Latin-1", TagValue("\xe2\x82\xac", 3, TagTextEncoding::Utf8).toString(TagTextEncoding::Latin1),
+        ConversionException);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("conversion to int", -15, TagValue(" - 156", 5, TagTextEncoding::Utf8).toInteger());
     CPPUNIT_ASSERT_EQUAL_MESSAGE("conversion to int", 15, TagValue("\0\x31\0\x35", 4, TagTextEncoding::Utf16BigEndian).toInteger());
     CPPUNIT_ASSERT_THROW_MESSAGE("failing conversion to int", TagValue("15ä", 4, TagTextEncoding::Utf8).toInteger(), ConversionException);
@@ -207,3 +271,64 @@ void TagValueTests::testEqualityOperator()
     withDescription.setMimeType(withDescription2.mimeType());
     CPPUNIT_ASSERT_EQUAL(withDescription, withDescription2);
 }
+
+void TagValueTests::testAssigningOwnData()
+{
+    // small data stored within the value itself
+    TagValue small("0123456789", 10, TagDataType::Binary);
+    small.assignData(static_cast<const TagValue &>(small).dataPointer() + 2, 5);
+    CPPUNIT_ASSERT_EQUAL("23456"s, string(small.dataPointer(), small.dataSize()));
+    small.assignData(static_cast<const TagValue &>(small).dataPointer(), small.dataSize());
+    CPPUNIT_ASSERT_EQUAL("23456"s, string(small.dataPointer(), small.dataSize()));
+
+    // bigger data shrinking to data which is stored within the value itself
+    const string bigData = string(50, 'a') + string(50, 'b');
+    TagValue big(bigData.data(), bigData.size(), TagDataType::Binary);
+    big.assignData(static_cast<const TagValue &>(big).dataPointer() + 80, 20);
+    CPPUNIT_ASSERT_EQUAL(string(20, 'b'), string(big.dataPointer(), big.dataSize()));
+
+    // bigger data which is not shared (the current buffer would be re-used if the data would not be aliased)
+    big.assignData(bigData.data(), bigData.size());
+    big.assignData(static_cast<const TagValue &>(big).dataPointer() + 40, 60);
+    CPPUNIT_ASSERT_EQUAL(bigData.substr(40), string(big.dataPointer(), big.dataSize()));
+    big.assignData(static_cast<const TagValue &>(big).dataPointer(), big.dataSize());
+    CPPUNIT_ASSERT_EQUAL(bigData.substr(40), string(big.dataPointer(), big.dataSize()));
+
+    // bigger data which is shared with another value
+    big.assignData(bigData.data(), bigData.size());
+    const TagValue copy(big);
+    big.assignData(static_cast<const TagValue &>(big).dataPointer() + 50, 50);
+    CPPUNIT_ASSERT_EQUAL(bigData.substr(50), string(big.dataPointer(), big.dataSize()));
+    CPPUNIT_ASSERT_EQUAL(bigData, string(copy.dataPointer(), copy.dataSize()));
+}
+
+void TagValueTests::testMoving()
+{
+    // small data is moved along with the value so the pointer changes
+    TagValue small("foo", 3, TagTextEncoding::Latin1);
+    small.setDescription("description");
+    const char *const smallData = static_cast<const TagValue &>(small).dataPointer();
+    TagValue movedSmall(move(small));
+    CPPUNIT_ASSERT(small.isEmpty());
+    CPPUNIT_ASSERT(small.description().empty());
+    CPPUNIT_ASSERT(smallData != static_cast<const TagValue &>(movedSmall).dataPointer());
+    CPPUNIT_ASSERT_EQUAL("foo"s, movedSmall.toString());
+    CPPUNIT_ASSERT_EQUAL("description"s, movedSmall.description());
+
+    // bigger data is not affected by moving the value
+    const string bigData(100, 'x');
+    TagValue big(bigData, TagTextEncoding::Latin1);
+    const char *const bigDataPointer = static_cast<const TagValue &>(big).dataPointer();
+    TagValue movedBig;
+    movedBig = move(big);
+    CPPUNIT_ASSERT(big.isEmpty());
+    CPPUNIT_ASSERT(bigDataPointer == static_cast<const TagValue &>(movedBig).dataPointer());
+    CPPUNIT_ASSERT_EQUAL(bigData, movedBig.toString());
+
+    // assigning small data to a moved-from value
+    small.assignText("bar", 3);
+    CPPUNIT_ASSERT_EQUAL("bar"s, small.toString());
+    movedSmall = move(small);
+    CPPUNIT_ASSERT_EQUAL("bar"s, movedSmall.toString());
+    CPPUNIT_ASSERT(movedSmall.description().empty());
+}
@@ -1,17 +1,24 @@
 #include "./helper.h"
 
+#include "../abstractattachment.h"
 #include "../aspectratio.h"
 #include "../backuphelper.h"
+#include "../bufferedsyncscanner.h"
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../flatmultimap.h"
 #include "../margin.h"
+#include "../matroska/matroskatag.h"
 #include "../mediafileinfo.h"
 #include "../mediaformat.h"
+#include "../namehashtable.h"
+#include "../paddinghelper.h"
 #include "../positioninset.h"
 #include "../progressfeedback.h"
 #include "../signature.h"
 #include "../size.h"
 #include "../tagtarget.h"
+#include "../vorbis/vorbiscomment.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/catchiofailure.h>
@@ -22,6 +29,8 @@ using namespace TestUtilities;
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <cstdio>
+#include <sstream>
+#include <type_traits>
 
 using namespace std;
 using namespace TagParser;
@@ -46,6 +55,12 @@ class UtilitiesTests : public TestFixture {
     CPPUNIT_TEST(testProgressFeedback);
     CPPUNIT_TEST(testAbortableProgressFeedback);
     CPPUNIT_TEST(testDiagnostics);
+    CPPUNIT_TEST(testNameHashTable);
+    CPPUNIT_TEST(testKnownFieldLookup);
+    CPPUNIT_TEST(testFlatMultiMap);
+    CPPUNIT_TEST(testBufferedSyncScanner);
+    CPPUNIT_TEST(testPaddingHelper);
+    CPPUNIT_TEST(testCopyingStreamDataBlock);
 #ifdef PLATFORM_UNIX
     CPPUNIT_TEST(testBackupFile);
 #endif
@@ -66,6 +81,12 @@ public:
     void testProgressFeedback();
     void testAbortableProgressFeedback();
     void testDiagnostics();
+    void testNameHashTable();
+    void testKnownFieldLookup();
+    void testFlatMultiMap();
+    void testBufferedSyncScanner();
+    void testPaddingHelper();
+    void testCopyingStreamDataBlock();
 #ifdef PLATFORM_UNIX
     void testBackupFile();
 #endif
@@ -281,6 +302,53 @@ void UtilitiesTests::testAbortableProgressFeedback()
     CPPUNIT_ASSERT_EQUAL("bar"s, step);
     CPPUNIT_ASSERT_EQUAL(33u, stepPercentage);
     CPPUNIT_ASSERT_EQUAL(25u, overallPercentage);
+
+    // polling without callbacks
+    AbortableProgressFeedback polledProgress;
+    polledProgress.updateStep("foo", 10);
+    polledProgress.updateBytesProcessed(50, 200);
+    const ProgressSnapshot snapshot = polledProgress.snapshot();
+    CPPUNIT_ASSERT_EQUAL("foo"s, snapshot.step);
+    CPPUNIT_ASSERT_EQUAL(static_cast<byte>(25), snapshot.stepPercentage);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(50), snapshot.bytesProcessed);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(200), snapshot.bytesTotal);
+
+    polledProgress.updateBytesProcessed(250, 200);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("bytes processed clamped to total", static_cast<uint64>(200), polledProgress.bytesProcessed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<byte>(100), polledProgress.stepPercentage());
+    const string &previousStep = polledProgress.step();
+    polledProgress.updateStep("bar");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("reference to previous step stays valid", "foo"s, previousStep);
+    CPPUNIT_ASSERT_EQUAL("bar"s, polledProgress.snapshot().step);
+    polledProgress.updateStep("foo");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("step names are reused", &previousStep, &polledProgress.step());
+
+    // throttling percentage callbacks
+    progress.setCallbackInterval(chrono::hours(1));
+    progress.updateStepPercentage(40);
+    progress.updateStepPercentage(50);
+    CPPUNIT_ASSERT_EQUAL(40u, stepPercentage);
+    CPPUNIT_ASSERT_EQUAL(static_cast<byte>(50), progress.stepPercentage());
+    progress.updateStepPercentage(100);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("callback always invoked at 100 %", 100u, stepPercentage);
+    progress.updateStepPercentage(30);
+    CPPUNIT_ASSERT_EQUAL(100u, stepPercentage);
+
+    // flushing pending percentage callback when entering the next step
+    vector<string> invocations;
+    ProgressFeedback throttledProgress(
+        [&](const ProgressFeedback &progress) { invocations.emplace_back("step " + progress.step()); },
+        [&](const ProgressFeedback &progress) {
+            invocations.emplace_back(argsToString("percentage ", static_cast<unsigned int>(progress.stepPercentage())));
+        });
+    throttledProgress.setCallbackInterval(chrono::hours(1));
+    throttledProgress.updateStep("foo");
+    throttledProgress.updateStepPercentage(10);
+    throttledProgress.updateStepPercentage(20);
+    throttledProgress.updateStep("bar");
+    throttledProgress.updateStep("baz");
+    const vector<string> expectedInvocations{ "step foo", "percentage 10", "percentage 20", "step bar", "step baz" };
+    CPPUNIT_ASSERT(expectedInvocations == invocations);
 }
 
 void UtilitiesTests::testDiagnostics()
@@ -293,6 +361,294 @@ void UtilitiesTests::testDiagnostics()
     diag.emplace_back(DiagLevel::Critical, "critical msg", "context");
     CPPUNIT_ASSERT_EQUAL(DiagLevel::Critical, diag.level());
     CPPUNIT_ASSERT(diag.has(DiagLevel::Critical));
+
+    // messages below the minimum level are discarded
+    Diagnostics filteredDiag;
+    filteredDiag.setMinimumLevel(DiagLevel::Critical);
+    CPPUNIT_ASSERT(!filteredDiag.isRecording(DiagLevel::Warning));
+    filteredDiag.emplace_back(DiagLevel::Warning, "warning msg", "context");
+    filteredDiag.emplaceFormatted(DiagLevel::Information, "context", 5, " bytes have been skipped");
+    CPPUNIT_ASSERT(filteredDiag.empty());
+    filteredDiag.setRecordingCreationTime(false);
+    filteredDiag.emplaceFormatted(DiagLevel::Critical, "context", 5, " bytes have been skipped");
+    CPPUNIT_ASSERT_EQUAL(1_st, filteredDiag.size());
+    CPPUNIT_ASSERT_EQUAL("5 bytes have been skipped"s, filteredDiag.front().message());
+    CPPUNIT_ASSERT(filteredDiag.front().creationTime().isNull());
+
+    // context is only computed if the message is recorded
+    unsigned int contextComputations = 0;
+    const auto contextFunction = [&contextComputations] {
+        ++contextComputations;
+        return "computed context"s;
+    };
+    filteredDiag.emplaceFormatted(DiagLevel::Warning, contextFunction, "not recorded");
+    CPPUNIT_ASSERT_EQUAL(0u, contextComputations);
+    filteredDiag.emplaceFormatted(DiagLevel::Critical, contextFunction, "recorded");
+    CPPUNIT_ASSERT_EQUAL(1u, contextComputations);
+    CPPUNIT_ASSERT_EQUAL(2_st, filteredDiag.size());
+    CPPUNIT_ASSERT_EQUAL("computed context"s, filteredDiag.back().context());
+
+    // other ways to add messages are filtered as well
+    filteredDiag.clear();
+    const DiagMessage warning(DiagLevel::Warning, "warning msg", "context");
+    const DiagMessage critical(DiagLevel::Critical, "critical msg", "context");
+    filteredDiag.push_back(warning);
+    filteredDiag.push_back(DiagMessage(DiagLevel::Information, "info msg", "context"));
+    filteredDiag.insert(filteredDiag.cend(), warning);
+    filteredDiag.insert(filteredDiag.cend(), 3, warning);
+    filteredDiag.insert(filteredDiag.cend(), { warning, warning });
+    CPPUNIT_ASSERT(filteredDiag.empty());
+    filteredDiag.push_back(critical);
+    const auto inserted = filteredDiag.insert(filteredDiag.cbegin(), diag.cbegin(), diag.cend());
+    CPPUNIT_ASSERT_EQUAL(2_st, filteredDiag.size());
+    CPPUNIT_ASSERT_EQUAL("critical msg"s, inserted->message());
+    Diagnostics temporaryDiag;
+    temporaryDiag.push_back(warning);
+    temporaryDiag.push_back(critical);
+    filteredDiag.append(temporaryDiag);
+    CPPUNIT_ASSERT_EQUAL(3_st, filteredDiag.size());
+    filteredDiag.append(move(temporaryDiag));
+    CPPUNIT_ASSERT_EQUAL(4_st, filteredDiag.size());
+    CPPUNIT_ASSERT(temporaryDiag.empty());
+    for (const auto &message : filteredDiag) {
+        CPPUNIT_ASSERT_EQUAL(DiagLevel::Critical, message.level());
+    }
+
+    // the underlying vector (which would allow bypassing the filter) is not accessible
+    static_assert(!is_convertible<Diagnostics &, vector<DiagMessage> &>::value, "vector not exposed");
+    filteredDiag.erase(filteredDiag.cbegin());
+    CPPUNIT_ASSERT_EQUAL(3_st, filteredDiag.size());
+}
+
+void UtilitiesTests::testNameHashTable()
+{
+    static constexpr NameHashTableEntry<int> entries[] = {
+        { "TITLE", 0 },
+        { "ALBUM", 1 },
+        { "ARTIST", 2 },
+        { "ALBUMARTIST", 3 },
+        { "A", 4 },
+        { "AB", 5 },
+        { "", 6 },
+        { "TRACKNUMBER", 7 },
+        { "TRACKTOTAL", 8 },
+        { "DISCNUMBER", 9 },
+        { "DISCTOTAL", 10 },
+    };
+    static constexpr auto caseSensitiveTable = makeNameHashTable<false>(entries);
+    static constexpr auto caseInsensitiveTable = makeNameHashTable<true>(entries);
+
+    // all known names must be found
+    for (const auto &entry : entries) {
+        const int *const caseSensitiveValue = caseSensitiveTable.find(string(entry.name));
+        const int *const caseInsensitiveValue = caseInsensitiveTable.find(string(entry.name));
+        CPPUNIT_ASSERT_MESSAGE(argsToString("found \"", entry.name, '\"'), caseSensitiveValue && caseInsensitiveValue);
+        CPPUNIT_ASSERT_EQUAL(entry.value, *caseSensitiveValue);
+        CPPUNIT_ASSERT_EQUAL(entry.value, *caseInsensitiveValue);
+    }
+
+    // case-folding only applies to the case-insensitive table
+    CPPUNIT_ASSERT(!caseSensitiveTable.find("Title"s));
+    CPPUNIT_ASSERT_EQUAL(0, *caseInsensitiveTable.find("Title"s));
+    CPPUNIT_ASSERT_EQUAL(3, *caseInsensitiveTable.find("albumartist"s));
+
+    // near-misses must not be found
+    for (const auto &entry : entries) {
+        const string name(entry.name);
+        const string nearMisses[] = {
+            name + '_',
+            '_' + name,
+            name.empty() ? " "s : name.substr(0, name.size() - 1),
+            name.empty() ? "\0"s : name.substr(0, name.size() - 1) + '#',
+        };
+        for (const auto &nearMiss : nearMisses) {
+            if (nearMiss == "A" || nearMiss == "AB" || nearMiss.empty()) {
+                continue; // those are known names as well
+            }
+            CPPUNIT_ASSERT_MESSAGE(argsToString("not found \"", nearMiss, '\"'), !caseSensitiveTable.find(nearMiss));
+            CPPUNIT_ASSERT_MESSAGE(argsToString("not found \"", nearMiss, '\"'), !caseInsensitiveTable.find(nearMiss));
+        }
+    }
+    CPPUNIT_ASSERT(!caseInsensitiveTable.find("ALBUMARTIST", 6));
+    CPPUNIT_ASSERT_EQUAL(2, *caseInsensitiveTable.find("ARTISTS", 6));
+}
+
+void UtilitiesTests::testKnownFieldLookup()
+{
+    const VorbisComment vorbisComment;
+    const MatroskaTag matroskaTag;
+    for (auto field = firstKnownField; field != KnownField::Invalid; field = nextKnownField(field)) {
+        // all field names must map back to the field (or at least to a field with the same name)
+        const auto vorbisId = vorbisComment.fieldId(field);
+        if (!vorbisId.empty()) {
+            CPPUNIT_ASSERT_EQUAL(vorbisId, vorbisComment.fieldId(vorbisComment.knownField(vorbisId)));
+            string lowerId(vorbisId);
+            for (auto &c : lowerId) {
+                c = static_cast<char>(tolower(c));
+            }
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Vorbis comment field names are case-insensitive", vorbisId,
+                vorbisComment.fieldId(vorbisComment.knownField(lowerId)));
+            CPPUNIT_ASSERT(vorbisComment.knownField(vorbisId + 'X') == KnownField::Invalid);
+            CPPUNIT_ASSERT(vorbisComment.knownField(vorbisId.substr(0, vorbisId.size() - 1) + '#') == KnownField::Invalid);
+        }
+        const auto matroskaId = matroskaTag.fieldId(field);
+        if (!matroskaId.empty()) {
+            CPPUNIT_ASSERT_EQUAL(matroskaId, matroskaTag.fieldId(matroskaTag.knownField(matroskaId)));
+            CPPUNIT_ASSERT(matroskaTag.knownField(matroskaId + 'X') == KnownField::Invalid);
+            CPPUNIT_ASSERT(matroskaTag.knownField(matroskaId.substr(0, matroskaId.size() - 1) + '#') == KnownField::Invalid);
+        }
+    }
+    CPPUNIT_ASSERT(vorbisComment.knownField(string()) == KnownField::Invalid);
+    CPPUNIT_ASSERT(matroskaTag.knownField(string()) == KnownField::Invalid);
+    CPPUNIT_ASSERT(matroskaTag.knownField("title"s) == KnownField::Invalid);
+}
+
+void UtilitiesTests::testFlatMultiMap()
+{
+    using Map = FlatMultiMap<int, string>;
+    const auto valuesOf = [](const Map &map) {
+        string values;
+        for (const auto &element : map) {
+            values += element.second;
+        }
+        return values;
+    };
+
+    // ordering: elements are sorted by key, elements with equivalent keys keep the order of insertion
+    Map map;
+    CPPUNIT_ASSERT(map.empty());
+    CPPUNIT_ASSERT(map.find(1) == map.end());
+    map.emplace(3, "a");
+    map.emplace(1, "b");
+    map.insert(make_pair(3, "c"s));
+    map.emplace(2, "d");
+    const Map::value_type element(1, "e");
+    map.insert(element);
+    map.emplace(3, "f");
+    CPPUNIT_ASSERT_EQUAL(6_st, map.size());
+    CPPUNIT_ASSERT_EQUAL("bedacf"s, valuesOf(map));
+
+    // lookup
+    CPPUNIT_ASSERT_EQUAL("b"s, map.find(1)->second);
+    CPPUNIT_ASSERT_EQUAL("a"s, map.find(3)->second);
+    CPPUNIT_ASSERT(map.find(0) == map.end());
+    CPPUNIT_ASSERT(map.find(4) == map.end());
+    CPPUNIT_ASSERT_EQUAL(3_st, map.count(3));
+    CPPUNIT_ASSERT_EQUAL(0_st, map.count(5));
+    CPPUNIT_ASSERT(map.lower_bound(2) == map.find(2));
+    CPPUNIT_ASSERT(map.upper_bound(2) == map.find(3));
+    CPPUNIT_ASSERT(map.upper_bound(3) == map.end());
+    const auto range = static_cast<const Map &>(map).equal_range(3);
+    CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(range.second - range.first));
+    CPPUNIT_ASSERT_EQUAL("a"s, range.first->second);
+    CPPUNIT_ASSERT_EQUAL("f"s, (range.second - 1)->second);
+    const auto emptyRange = map.equal_range(0);
+    CPPUNIT_ASSERT(emptyRange.first == emptyRange.second);
+    CPPUNIT_ASSERT(emptyRange.first == map.begin());
+
+    // inserting after a lookup (the iterator obtained before is invalidated so the element needs to be looked up again)
+    map.find(2)->second = "g";
+    map.emplace(2, "h");
+    map.emplace(0, "i");
+    CPPUNIT_ASSERT_EQUAL("g"s, map.find(2)->second);
+    CPPUNIT_ASSERT_EQUAL("ibeghacf"s, valuesOf(map));
+
+    // erasing
+    CPPUNIT_ASSERT_EQUAL(2_st, map.erase(2));
+    CPPUNIT_ASSERT_EQUAL(0_st, map.erase(2));
+    CPPUNIT_ASSERT_EQUAL("ibeacf"s, valuesOf(map));
+    auto next = map.erase(map.find(3));
+    CPPUNIT_ASSERT_EQUAL("c"s, next->second);
+    CPPUNIT_ASSERT_EQUAL("ibecf"s, valuesOf(map));
+    const auto ones = map.equal_range(1);
+    next = map.erase(ones.first, ones.second);
+    CPPUNIT_ASSERT_EQUAL(3, next->first);
+    CPPUNIT_ASSERT_EQUAL("icf"s, valuesOf(map));
+    map.emplace(1, "j");
+    CPPUNIT_ASSERT_EQUAL("ijcf"s, valuesOf(map));
+    map.clear();
+    CPPUNIT_ASSERT(map.empty());
+    CPPUNIT_ASSERT(map.begin() == map.end());
+
+    // custom comparison
+    FlatMultiMap<string, int, CaseInsensitiveStringComparer> caseInsensitiveMap;
+    caseInsensitiveMap.emplace("TITLE", 1);
+    caseInsensitiveMap.emplace("artist", 2);
+    caseInsensitiveMap.emplace("Title", 3);
+    CPPUNIT_ASSERT_EQUAL(2_st, caseInsensitiveMap.count("title"));
+    CPPUNIT_ASSERT_EQUAL(2, caseInsensitiveMap.begin()->second);
+    CPPUNIT_ASSERT_EQUAL(3, (--caseInsensitiveMap.end())->second);
+}
+
+void UtilitiesTests::testBufferedSyncScanner()
+{
+    // use a buffer size of 16 byte so sync codes are located at the boundary of buffered chunks
+    string data(100, '\0');
+    data[15] = data[40] = data[60] = data[97] = '\xFF';
+    data[16] = data[41] = '\xF8';
+    data[98] = '\xF9';
+    stringstream stream(data, ios_base::in | ios_base::binary);
+    BufferedSyncScanner scanner(stream, data.size(), 16);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(100), scanner.endOffset());
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(15), scanner.findSync(0, 0xFE, 0xF8, 2));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(40), scanner.findSync(16, 0xFE, 0xF8, 2));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(97), scanner.findSync(41, 0xFE, 0xF8, 2));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("sync code not followed by enough bytes", static_cast<uint64>(100), scanner.findSync(41, 0xFE, 0xF8, 4));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(100), scanner.findSync(98, 0xFE, 0xF8, 2));
+
+    // read bytes at arbitrary offsets
+    const char *bytes = scanner.bytesAt(40, 2);
+    CPPUNIT_ASSERT(bytes);
+    CPPUNIT_ASSERT_EQUAL("\xFF\xF8"s, string(bytes, 2));
+    CPPUNIT_ASSERT(bytes = scanner.bytesAt(14, 4));
+    CPPUNIT_ASSERT_EQUAL("\0\xFF\xF8\0"s, string(bytes, 4));
+    CPPUNIT_ASSERT(bytes = scanner.bytesAt(98, 2));
+    CPPUNIT_ASSERT_EQUAL("\xF9\0"s, string(bytes, 2));
+    CPPUNIT_ASSERT(!scanner.bytesAt(99, 2));
+
+    // ensure nothing is read after the end offset
+    BufferedSyncScanner limitedScanner(stream, 50, 16);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(50), limitedScanner.findSync(41, 0xFE, 0xF8, 2));
+    CPPUNIT_ASSERT(!limitedScanner.bytesAt(49, 2));
+}
+
+void UtilitiesTests::testPaddingHelper()
+{
+    // write padding of different sizes behind existing data, including sizes exceeding the size of the internal block of zeroes
+    for (const uint64 size : { 0ul, 1ul, 0xFFFFul, 0x10000ul, 0x10001ul, 0x30005ul }) {
+        stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+        stream << "data";
+        PaddingHelper::writeZeroes(stream, size);
+        const string data = stream.str();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4 + size), data.size());
+        CPPUNIT_ASSERT_EQUAL("data"s, data.substr(0, 4));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("only zeroes written", string::npos, data.find_first_not_of('\0', 4));
+    }
+}
+
+void UtilitiesTests::testCopyingStreamDataBlock()
+{
+    // copy to another stream in chunks
+    string data;
+    for (unsigned int i = 0; i != 0x28000; ++i) {
+        data += static_cast<char>(i * 7 + (i >> 16));
+    }
+    stringstream source(data, ios_base::in | ios_base::out | ios_base::binary);
+    const auto blockSize = static_cast<string::size_type>(0x20000);
+    StreamDataBlock block([&source]() -> istream & { return source; }, 0x1000, ios_base::beg, 0x1000 + blockSize, ios_base::beg);
+    stringstream target(ios_base::in | ios_base::out | ios_base::binary);
+    block.copyTo(target);
+    CPPUNIT_ASSERT_EQUAL(data.substr(0x1000, blockSize), target.str());
+
+    // move the data within the same stream to overlapping ranges in front of and behind the original location
+    for (const auto targetOffset : { static_cast<streamoff>(0x800), static_cast<streamoff>(0x8000) }) {
+        stringstream stream(data, ios_base::in | ios_base::out | ios_base::binary);
+        StreamDataBlock sameStreamBlock([&stream]() -> istream & { return stream; }, 0x1000, ios_base::beg, 0x1000 + blockSize, ios_base::beg);
+        stream.seekp(targetOffset);
+        sameStreamBlock.copyTo(stream);
+        CPPUNIT_ASSERT_EQUAL(static_cast<streamoff>(targetOffset + static_cast<streamoff>(blockSize)), static_cast<streamoff>(stream.tellp()));
+        CPPUNIT_ASSERT_MESSAGE("data moved", data.substr(0x1000, blockSize) == stream.str().substr(static_cast<size_t>(targetOffset), blockSize));
+    }
 }
 
 #ifdef PLATFORM_UNIX
@@ -0,0 +1,468 @@
+#include "./textconversion.h"
+
+#include <c++utilities/conversion/types.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+using namespace std;
+using namespace ConversionUtilities;
+
+namespace TagParser {
+
+/*!
+ * \brief Returns the encoding parameter (name of the character set and bytes per character) for the specified \a tagTextEncoding.
+ */
+pair<const char *, float> encodingParameter(TagTextEncoding tagTextEncoding)
+{
+    switch (tagTextEncoding) {
+    case TagTextEncoding::Latin1:
+        return make_pair("ISO-8859-1", 1.0f);
+    case TagTextEncoding::Utf8:
+        return make_pair("UTF-8", 1.0f);
+    case TagTextEncoding::Utf16LittleEndian:
+        return make_pair("UTF-16LE", 2.0f);
+    case TagTextEncoding::Utf16BigEndian:
+        return make_pair("UTF-16BE", 2.0f);
+    default:
+        return make_pair(nullptr, 0.0f);
+    }
+}
+
+/*!
+ * \namespace TagParser::TextConversion
+ * \brief Converts text between the encodings specified by TagTextEncoding without relying on iconv.
+ *
+ * The conversion is done in two passes: convertedSize() validates the input and computes the size of the
+ * output so the output can be written directly into a buffer of the exact size via convert(). ASCII characters
+ * are processed in blocks of 8 bytes. The convertString() functions combine both passes and fall back to the
+ * conversion functions of c++utilities (which use iconv) if the built-in conversion can not be used, eg. because the
+ * input is invalid or the output encoding can not represent a character. In that case the fallback also takes
+ * care of raising a ConversionException.
+ *
+ * Byte order marks are not handled specifically. Use TagValue::stripBom() to remove them before the conversion.
+ */
+
+namespace TextConversion {
+
+namespace {
+
+/*!
+ * \brief The Latin1Codec struct decodes and encodes ISO/IEC 8859-1.
+ */
+struct Latin1Codec {
+    static constexpr bool isAsciiCompatible = true;
+    static constexpr size_t asciiSize = 1;
+
+    static bool decode(const byte *&input, const byte *, char32_t &codePoint)
+    {
+        codePoint = *input++;
+        return true;
+    }
+
+    static size_t size(char32_t codePoint)
+    {
+        return codePoint <= 0xFF ? 1 : 0;
+    }
+
+    static char *encode(char32_t codePoint, char *output)
+    {
+        *output = static_cast<char>(codePoint);
+        return output + 1;
+    }
+
+    static char *encodeAscii(const byte *input, size_t size, char *output)
+    {
+        memcpy(output, input, size);
+        return output + size;
+    }
+};
+
+/*!
+ * \brief The Utf8Codec struct decodes and encodes UTF-8.
+ */
+struct Utf8Codec {
+    static constexpr bool isAsciiCompatible = true;
+    static constexpr size_t asciiSize = 1;
+
+    static bool decode(const byte *&input, const byte *end, char32_t &codePoint)
+    {
+        const byte leadByte = *input;
+        size_t length;
+        char32_t minimum;
+        if (leadByte < 0x80) {
+            codePoint = leadByte;
+            ++input;
+            return true;
+        } else if ((leadByte & 0xE0) == 0xC0) {
+            length = 2;
+            codePoint = leadByte & 0x1F;
+            minimum = 0x80;
+        } else if ((leadByte & 0xF0) == 0xE0) {
+            length = 3;
+            codePoint = leadByte & 0x0F;
+            minimum = 0x800;
+        } else if ((leadByte & 0xF8) == 0xF0) {
+            length = 4;
+            codePoint = leadByte & 0x07;
+            minimum = 0x10000;
+        } else {
+            return false;
+        }
+        if (static_cast<size_t>(end - input) < length) {
+            return false;
+        }
+        for (size_t index = 1; index < length; ++index) {
+            if ((input[index] & 0xC0) != 0x80) {
+                return false;
+            }
+            codePoint = (codePoint << 6) | (input[index] & 0x3F);
+        }
+        input += length;
+        // reject overlong sequences, surrogates and code points beyond the Unicode range
+        return codePoint >= minimum && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF);
+    }
+
+    static size_t size(char32_t codePoint)
+    {
+        return codePoint < 0x80 ? 1 : (codePoint < 0x800 ? 2 : (codePoint < 0x10000 ? 3 : 4));
+    }
+
+    static char *encode(char32_t codePoint, char *output)
+    {
+        if (codePoint < 0x80) {
+            *output++ = static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            *output++ = static_cast<char>(0xC0 | (codePoint >> 6));
+            *output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            *output++ = static_cast<char>(0xE0 | (codePoint >> 12));
+            *output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            *output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            *output++ = static_cast<char>(0xF0 | (codePoint >> 18));
+            *output++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            *output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            *output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        return output;
+    }
+
+    static char *encodeAscii(const byte *input, size_t size, char *output)
+    {
+        memcpy(output, input, size);
+        return output + size;
+    }
+};
+
+/*!
+ * \brief The Utf16Codec struct decodes and encodes UTF-16 with the byte order specified via \a isBigEndian.
+ */
+template <bool isBigEndian> struct Utf16Codec {
+    static constexpr bool isAsciiCompatible = false;
+    static constexpr size_t asciiSize = 2;
+
+    static char32_t readUnit(const byte *input)
+    {
+        return isBigEndian ? static_cast<char32_t>((input[0] << 8) | input[1]) : static_cast<char32_t>((input[1] << 8) | input[0]);
+    }
+
+    static void writeUnit(char32_t unit, char *output)
+    {
+        output[isBigEndian ? 0 : 1] = static_cast<char>(unit >> 8);
+        output[isBigEndian ? 1 : 0] = static_cast<char>(unit & 0xFF);
+    }
+
+    static bool decode(const byte *&input, const byte *end, char32_t &codePoint)
+    {
+        if (end - input < 2) {
+            return false;
+        }
+        codePoint = readUnit(input);
+        input += 2;
+        if (codePoint < 0xD800 || codePoint > 0xDFFF) {
+            return true;
+        }
+        // read low surrogate following the high surrogate
+        if (codePoint > 0xDBFF || end - input < 2) {
+            return false;
+        }
+        const char32_t lowSurrogate = readUnit(input);
+        if (lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+            return false;
+        }
+        input += 2;
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+        return true;
+    }
+
+    static size_t size(char32_t codePoint)
+    {
+        return codePoint < 0x10000 ? 2 : 4;
+    }
+
+    static char *encode(char32_t codePoint, char *output)
+    {
+        if (codePoint < 0x10000) {
+            writeUnit(codePoint, output);
+            return output + 2;
+        }
+        codePoint -= 0x10000;
+        writeUnit(0xD800 + (codePoint >> 10), output);
+        writeUnit(0xDC00 + (codePoint & 0x3FF), output + 2);
+        return output + 4;
+    }
+
+    static char *encodeAscii(const byte *input, size_t size, char *output)
+    {
+        for (const byte *const end = input + size; input != end; ++input, output += 2) {
+            writeUnit(*input, output);
+        }
+        return output;
+    }
+};
+
+using Utf16LECodec = Utf16Codec<false>;
+using Utf16BECodec = Utf16Codec<true>;
+
+/*!
+ * \brief Returns the number of leading ASCII characters if \a InputCodec is ASCII-compatible; otherwise returns 0.
+ */
+template <class InputCodec> inline size_t asciiPrefixSize(const byte *input, const byte *end)
+{
+    return InputCodec::isAsciiCompatible ? TextConversion::asciiPrefixSize(reinterpret_cast<const char *>(input), static_cast<size_t>(end - input))
+                                         : 0;
+}
+
+template <class InputCodec, class OutputCodec> size_t convertedSize(const byte *input, const byte *end)
+{
+    size_t size = 0;
+    for (char32_t codePoint; input != end;) {
+        const auto asciiSize = asciiPrefixSize<InputCodec>(input, end);
+        input += asciiSize;
+        size += asciiSize * OutputCodec::asciiSize;
+        if (input == end) {
+            break;
+        }
+        if (!InputCodec::decode(input, end, codePoint)) {
+            return invalidSize;
+        }
+        const auto codePointSize = OutputCodec::size(codePoint);
+        if (!codePointSize) {
+            return invalidSize;
+        }
+        size += codePointSize;
+    }
+    return size;
+}
+
+template <class InputCodec, class OutputCodec> char *convert(const byte *input, const byte *end, char *output)
+{
+    for (char32_t codePoint; input != end;) {
+        const auto asciiSize = asciiPrefixSize<InputCodec>(input, end);
+        output = OutputCodec::encodeAscii(input, asciiSize, output);
+        input += asciiSize;
+        if (input == end) {
+            break;
+        }
+        InputCodec::decode(input, end, codePoint);
+        output = OutputCodec::encode(codePoint, output);
+    }
+    return output;
+}
+
+template <class InputCodec> size_t convertedSize(const byte *input, const byte *end, TagTextEncoding outputEncoding)
+{
+    switch (outputEncoding) {
+    case TagTextEncoding::Latin1:
+        return convertedSize<InputCodec, Latin1Codec>(input, end);
+    case TagTextEncoding::Utf8:
+        return convertedSize<InputCodec, Utf8Codec>(input, end);
+    case TagTextEncoding::Utf16LittleEndian:
+        return convertedSize<InputCodec, Utf16LECodec>(input, end);
+    case TagTextEncoding::Utf16BigEndian:
+        return convertedSize<InputCodec, Utf16BECodec>(input, end);
+    default:
+        return invalidSize;
+    }
+}
+
+template <class InputCodec> char *convert(const byte *input, const byte *end, TagTextEncoding outputEncoding, char *output)
+{
+    switch (outputEncoding) {
+    case TagTextEncoding::Latin1:
+        return convert<InputCodec, Latin1Codec>(input, end, output);
+    case TagTextEncoding::Utf8:
+        return convert<InputCodec, Utf8Codec>(input, end, output);
+    case TagTextEncoding::Utf16LittleEndian:
+        return convert<InputCodec, Utf16LECodec>(input, end, output);
+    case TagTextEncoding::Utf16BigEndian:
+        return convert<InputCodec, Utf16BECodec>(input, end, output);
+    default:
+        return output;
+    }
+}
+
+/*!
+ * \brief Converts the specified \a input using the conversion functions of c++utilities (which use iconv).
+ */
+StringData convertStringViaIconv(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding)
+{
+    // use pre-defined methods when converting from/to UTF-8
+    if (outputEncoding == TagTextEncoding::Utf8) {
+        switch (inputEncoding) {
+        case TagTextEncoding::Latin1:
+            return convertLatin1ToUtf8(input, inputSize);
+        case TagTextEncoding::Utf16LittleEndian:
+            return convertUtf16LEToUtf8(input, inputSize);
+        case TagTextEncoding::Utf16BigEndian:
+            return convertUtf16BEToUtf8(input, inputSize);
+        default:;
+        }
+    } else if (inputEncoding == TagTextEncoding::Utf8) {
+        switch (outputEncoding) {
+        case TagTextEncoding::Latin1:
+            return convertUtf8ToLatin1(input, inputSize);
+        case TagTextEncoding::Utf16LittleEndian:
+            return convertUtf8ToUtf16LE(input, inputSize);
+        case TagTextEncoding::Utf16BigEndian:
+            return convertUtf8ToUtf16BE(input, inputSize);
+        default:;
+        }
+    }
+    // otherwise, determine input and output parameter to use general covertString method
+    const auto inputParameter = encodingParameter(inputEncoding);
+    const auto outputParameter = encodingParameter(outputEncoding);
+    return ConversionUtilities::convertString(
+        inputParameter.first, outputParameter.first, input, inputSize, outputParameter.second / inputParameter.second);
+}
+
+/*!
+ * \brief Converts the specified \a input into the specified \a output string.
+ */
+template <class StringType>
+void convertStringInto(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, StringType &output)
+{
+    using CharType = typename StringType::value_type;
+    const auto size = TextConversion::convertedSize(input, inputSize, inputEncoding, outputEncoding);
+    if (size == invalidSize) {
+        const auto convertedData = convertStringViaIconv(input, inputSize, inputEncoding, outputEncoding);
+        output.assign(reinterpret_cast<const CharType *>(convertedData.first.get()), convertedData.second / sizeof(CharType));
+        return;
+    }
+    output.resize(size / sizeof(CharType));
+    if (size) {
+        TextConversion::convert(input, inputSize, inputEncoding, outputEncoding, reinterpret_cast<char *>(&output[0]));
+    }
+}
+
+} // namespace
+
+/*!
+ * \brief Returns the number of leading ASCII characters of the specified \a text.
+ * \remarks Checks 8 bytes at once.
+ */
+size_t asciiPrefixSize(const char *text, size_t size)
+{
+    size_t index = 0;
+    for (uint64 block; index + sizeof(block) <= size; index += sizeof(block)) {
+        memcpy(&block, text + index, sizeof(block));
+        if (block & 0x8080808080808080ul) {
+            break;
+        }
+    }
+    for (; index < size && !(static_cast<byte>(text[index]) & 0x80); ++index)
+        ;
+    return index;
+}
+
+/*!
+ * \brief Returns the size of the specified \a input when converted from \a inputEncoding to \a outputEncoding.
+ * \returns Returns invalidSize if the \a input is not valid or contains characters which can not be represented
+ *          using \a outputEncoding or if one of the encodings is TagTextEncoding::Unspecified.
+ */
+size_t convertedSize(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding)
+{
+    const auto *const begin = reinterpret_cast<const byte *>(input), *const end = begin + inputSize;
+    switch (inputEncoding) {
+    case TagTextEncoding::Latin1:
+        return convertedSize<Latin1Codec>(begin, end, outputEncoding);
+    case TagTextEncoding::Utf8:
+        return convertedSize<Utf8Codec>(begin, end, outputEncoding);
+    case TagTextEncoding::Utf16LittleEndian:
+        return convertedSize<Utf16LECodec>(begin, end, outputEncoding);
+    case TagTextEncoding::Utf16BigEndian:
+        return convertedSize<Utf16BECodec>(begin, end, outputEncoding);
+    default:
+        return invalidSize;
+    }
+}
+
+/*!
+ * \brief Converts the specified \a input from \a inputEncoding to \a outputEncoding and writes the result to \a output.
+ * \returns Returns a pointer to the end of the written data.
+ * \remarks The conversion must be possible and \a output must be big enough which is ensured by checking convertedSize()
+ *          before. The \a input and the \a output must not overlap.
+ */
+char *convert(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, char *output)
+{
+    const auto *const begin = reinterpret_cast<const byte *>(input), *const end = begin + inputSize;
+    switch (inputEncoding) {
+    case TagTextEncoding::Latin1:
+        return convert<Latin1Codec>(begin, end, outputEncoding, output);
+    case TagTextEncoding::Utf8:
+        return convert<Utf8Codec>(begin, end, outputEncoding, output);
+    case TagTextEncoding::Utf16LittleEndian:
+        return convert<Utf16LECodec>(begin, end, outputEncoding, output);
+    case TagTextEncoding::Utf16BigEndian:
+        return convert<Utf16BECodec>(begin, end, outputEncoding, output);
+    default:
+        return output;
+    }
+}
+
+/*!
+ * \brief Converts the specified \a input from \a inputEncoding to \a outputEncoding.
+ * \throws Throws ConversionUtilities::ConversionException if the conversion fails.
+ * \remarks Falls back to iconv if the built-in conversion can not be used.
+ */
+StringData convertString(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding)
+{
+    const auto size = convertedSize(input, inputSize, inputEncoding, outputEncoding);
+    if (size == invalidSize) {
+        return convertStringViaIconv(input, inputSize, inputEncoding, outputEncoding);
+    }
+    // allocate the buffer via malloc() since StringData releases it via free()
+    StringData convertedData(unique_ptr<char[], StringDataDeleter>(static_cast<char *>(malloc(size ? size : 1))), size);
+    if (!convertedData.first) {
+        throw bad_alloc();
+    }
+    convert(input, inputSize, inputEncoding, outputEncoding, convertedData.first.get());
+    return convertedData;
+}
+
+/*!
+ * \brief Converts the specified \a input from \a inputEncoding to \a outputEncoding and assigns the result to \a output.
+ * \throws Throws ConversionUtilities::ConversionException if the conversion fails.
+ * \remarks Falls back to iconv if the built-in conversion can not be used. The \a input must not refer to \a output.
+ */
+void convertString(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, string &output)
+{
+    convertStringInto(input, inputSize, inputEncoding, outputEncoding, output);
+}
+
+/*!
+ * \brief Converts the specified \a input from \a inputEncoding to \a outputEncoding and assigns the result to \a output.
+ * \throws Throws ConversionUtilities::ConversionException if the conversion fails.
+ * \remarks Falls back to iconv if the built-in conversion can not be used. The \a input must not refer to \a output.
+ */
+void convertString(const char *input, size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, u16string &output)
+{
+    convertStringInto(input, inputSize, inputEncoding, outputEncoding, output);
+}
+
+} // namespace TextConversion
+
+} // namespace TagParser
@@ -0,0 +1,32 @@
+#ifndef TAG_PARSER_TEXTCONVERSION_H
+#define TAG_PARSER_TEXTCONVERSION_H
+
+#include "./tagvalue.h"
+
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <limits>
+#include <string>
+
+namespace TagParser {
+
+namespace TextConversion {
+
+/// \brief The size returned by convertedSize() if the built-in conversion can not be used.
+constexpr std::size_t invalidSize = std::numeric_limits<std::size_t>::max();
+
+TAG_PARSER_EXPORT std::size_t asciiPrefixSize(const char *text, std::size_t size);
+TAG_PARSER_EXPORT std::size_t convertedSize(const char *input, std::size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding);
+TAG_PARSER_EXPORT char *convert(const char *input, std::size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, char *output);
+TAG_PARSER_EXPORT ConversionUtilities::StringData convertString(
+    const char *input, std::size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding);
+TAG_PARSER_EXPORT void convertString(
+    const char *input, std::size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, std::string &output);
+TAG_PARSER_EXPORT void convertString(
+    const char *input, std::size_t inputSize, TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, std::u16string &output);
+
+} // namespace TextConversion
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_TEXTCONVERSION_H
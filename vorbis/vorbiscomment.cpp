@@ -5,12 +5,12 @@
 
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../namehashtable.h"
 
 #include <c++utilities/io/binaryreader.h>
 #include <c++utilities/io/binarywriter.h>
 #include <c++utilities/io/copy.h>
 
-#include <map>
 #include <memory>
 
 using namespace std;
@@ -45,6 +45,17 @@ bool VorbisComment::setValue(KnownField field, const TagValue &value)
     }
 }
 
+bool VorbisComment::setValue(KnownField field, TagValue &&value)
+{
+    switch (field) {
+    case KnownField::Vendor:
+        m_vendor = move(value);
+        return true;
+    default:
+        return FieldMapBasedTag<VorbisComment>::setValue(field, move(value));
+    }
+}
+
 VorbisComment::IdentifierType VorbisComment::internallyGetFieldId(KnownField field) const
 {
     using namespace VorbisCommentIds;
@@ -93,14 +104,15 @@ VorbisComment::IdentifierType VorbisComment::internallyGetFieldId(KnownField fie
 KnownField VorbisComment::internallyGetKnownField(const IdentifierType &id) const
 {
     using namespace VorbisCommentIds;
-    static const map<string, KnownField, CaseInsensitiveStringComparer> fieldMap({ { album(), KnownField::Album }, { artist(), KnownField::Artist },
+    static constexpr NameHashTableEntry<KnownField> fieldNames[] = { { album(), KnownField::Album }, { artist(), KnownField::Artist },
         { comment(), KnownField::Comment }, { cover(), KnownField::Cover }, { date(), KnownField::Year }, { title(), KnownField::Title },
         { genre(), KnownField::Genre }, { trackNumber(), KnownField::TrackPosition }, { diskNumber(), KnownField::DiskPosition },
         { partNumber(), KnownField::PartNumber }, { composer(), KnownField::Composer }, { encoder(), KnownField::Encoder },
         { encoderSettings(), KnownField::EncoderSettings }, { description(), KnownField::Description }, { label(), KnownField::RecordLabel },
-        { performer(), KnownField::Performers }, { lyricist(), KnownField::Lyricist } });
-    const auto knownField(fieldMap.find(id));
-    return knownField != fieldMap.cend() ? knownField->second : KnownField::Invalid;
+        { performer(), KnownField::Performers }, { language(), KnownField::Language }, { lyricist(), KnownField::Lyricist } };
+    static constexpr auto fieldTable = makeNameHashTable<true>(fieldNames);
+    const KnownField *const knownField = fieldTable.find(id);
+    return knownField ? *knownField : KnownField::Invalid;
 }
 
 /*!
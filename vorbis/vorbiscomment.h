@@ -37,6 +37,7 @@ public:
     const TagValue &value(KnownField field) const override;
     using FieldMapBasedTag<VorbisComment>::setValue;
     bool setValue(KnownField field, const TagValue &value) override;
+    bool setValue(KnownField field, TagValue &&value) override;
 
     void parse(OggIterator &iterator, VorbisCommentFlags flags, Diagnostics &diag);
     void parse(std::istream &stream, uint64 maxSize, VorbisCommentFlags flags, Diagnostics &diag);
@@ -45,6 +45,14 @@ VorbisCommentField::VorbisCommentField(const IdentifierType &id, const TagValue
 {
 }
 
+/*!
+ * \brief Constructs a new Vorbis comment field with the specified \a id moving the specified \a value into the field.
+ */
+VorbisCommentField::VorbisCommentField(const IdentifierType &id, TagValue &&value)
+    : TagField<VorbisCommentField>(id, move(value))
+{
+}
+
 /*!
  * \brief Internal implementation for parsing.
  */
@@ -50,6 +50,7 @@ class TAG_PARSER_EXPORT VorbisCommentField : public TagField<VorbisCommentField>
 public:
     VorbisCommentField();
     VorbisCommentField(const IdentifierType &id, const TagValue &value);
+    VorbisCommentField(const IdentifierType &id, TagValue &&value);
 
     void parse(OggIterator &iterator, Diagnostics &diag);
     void parse(OggIterator &iterator, uint64 &maxSize, Diagnostics &diag);